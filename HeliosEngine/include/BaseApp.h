@@ -12,6 +12,15 @@
 #include "MeshComponent.h"
 #include "ModelLoader.h"
 #include "Buffer.h"
+#include "MeshCache.h"
+#include "VertexQuantizer.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "Picker.h"
+#include "InstanceList.h"
+#include "RenderQueue.h"
+#include "ConstantBufferManager.h"
+#include "JobSystem.h"
 #include "SamplerState.h"
 #include "ModelLoader.h"
 
@@ -36,6 +45,9 @@ public:
     void    render();
     void    destroy();
 
+    // Tringulo bajo el pxel (x, y) del cliente; false si el rayo no toca el modelo
+    bool    pick(int x, int y, PickResult& out) const;
+
 private:
     // WndProc esttico (guardamos this en GWLP_USERDATA)
     static LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam);
@@ -58,14 +70,63 @@ private:
 
     // --- Geometra y buffers ---
     MeshComponent m_mesh;
+    MeshCache     m_meshCache;            // Cach .hmesh mapeada hasta crear VB/IB
     Buffer        m_vertexBuffer;
     Buffer        m_indexBuffer;
-    Buffer        m_cbNeverChanges;       // b0 (view)
-    Buffer        m_cbChangeOnResize;     // b1 (projection)
-    Buffer        m_cbChangesEveryFrame;  // b2 (world/color)
+    ConstantBufferManager m_constantBuffers;  // Bloques versionados (slo suben si cambian) + ring por draw
+    unsigned int  m_cbNeverChanges = ConstantBufferManager::kInvalid;       // b0 (view)
+    unsigned int  m_cbChangeOnResize = ConstantBufferManager::kInvalid;     // b1 (projection)
+    unsigned int  m_cbChangesEveryFrame = ConstantBufferManager::kInvalid;  // b2 (world/color)
+    ConstantUploadStats m_constantStats;      // Subidas de constantes del ltimo frame
     Texture       m_textureCube;          // Wrapper de textura (opcional)
     SamplerState  m_samplerState;
 
+    // --- Formato de vrtice ---
+    bool     m_usePackedVertices = true;  // VB con PackedVertex (16 B) en lugar de SimpleVertex (32 B)
+    XMMATRIX m_meshToObject = XMMatrixIdentity(); // Decuantizacin de posiciones (identidad sin PackedVertex)
+
+    // --- Niveles de detalle ---
+    std::vector<float> m_lodRatios{ 0.5f, 0.25f, 0.125f, 0.0625f }; // Vaco = slo la malla original
+    MeshLODChain       m_lodChain;             // Rangos por LOD dentro de m_indexBuffer
+    unsigned int       m_currentLOD = 0;       // Elegido en update() por error en pantalla
+    float              m_lodPixelError = 1.0f; // Error mximo tolerado (pxeles)
+
+    // --- Culling de la malla completa ---
+    bool m_meshVisible = true;  // Esfera y OBB de m_mesh contra el frustum de update()
+
+    // --- Meshlets (culling de clusters en CPU) ---
+    bool                       m_meshletCulling = true;     // Dibuja slo los meshlets visibles (m_visibleIndexBuffer)
+    bool                       m_meshletConeCulling = false; // Descarta adems los vistos por detrs (requiere CULL_BACK)
+    std::vector<MeshletData>   m_lodMeshlets;               // Un conjunto de meshlets por LOD
+    Buffer                     m_visibleIndexBuffer;        // IB dinmico con los ndices visibles
+    std::vector<unsigned char> m_meshletVisible;            // Resultado de Cull del frame actual
+    std::vector<unsigned char> m_meshletVisiblePrev;        // Mscara con la que se escribi el IB
+    unsigned int               m_visibleLOD = ~0u;          // LOD con el que se escribi el IB
+    std::vector<MeshSubset>    m_visibleRanges;             // Rangos a dibujar dentro de m_visibleIndexBuffer
+
+    // --- Instancing: copias de la malla en rejilla con un DrawIndexedInstanced por rango ---
+    unsigned int  m_instanceGrid = 0;      // Rejilla N x N de copias alrededor del modelo (0 = desactivado)
+    ShaderProgram m_instancedShader;       // Mismo VS/PS con la World por instancia (slot 1)
+    Buffer        m_instanceBuffer;        // Stream por instancia con las copias visibles
+    InstanceList  m_instances;             // World, color y esfera en mundo de cada copia
+    unsigned int  m_visibleInstances = 0;  // Copias escritas en m_instanceBuffer este frame
+
+    // --- Cola de render: draws del frame ordenados por clave (shader, material, profundidad) ---
+    RenderQueue             m_renderQueue;
+    std::vector<DrawPacket> m_drawPackets;     // Packets del frame (la cola guarda punteros)
+    RenderQueueStats        m_renderStats;     // Cambios de estado del ltimo frame
+    DeviceContextStats      m_contextStats;    // Llamadas Set* filtradas/emitidas por DeviceContext en el ltimo frame
+
+    // --- Picking ---
+    MeshBVH    m_meshBVH;   // BVH del LOD 0 en espacio objeto (vrtices sin cuantizar)
+    Picker     m_picker;    // m_meshBVH con la World de update()
+    PickResult m_lastPick;  // ltimo click sobre el modelo
+    JobCounter m_bvhBuild;  // Construccin de m_meshBVH en el JobSystem, lanzada en init()
+    bool       m_bvhPending = false;  // m_meshBVH an no est en m_picker
+
+    // Registra m_meshBVH en m_picker y cierra la cach cuando termina su construccin
+    void attachPickingBVH(bool wait);
+
     // --- Transformaciones / cmara ---
     XMMATRIX m_World;
     XMMATRIX m_View;
@@ -77,6 +138,7 @@ private:
 
     // --- Cmara y animacin ---
     float m_cameraDistance = 6.0f;   // zoom base (rueda del mouse)
+    float m_fovY = XM_PIDIV4;        // campo de visin vertical (radianes)
     float m_spinAngle = 0.0f;   // rotacin del modelo (radianes)
     float m_orbitAngle = 0.0f;   // rbita de cmara (radianes)
     float m_spinSpeedDeg = 20.0f;  // vel. giro del modelo (grados/seg)
@@ -84,6 +146,7 @@ private:
 
     // Entrada
     void onMouseWheel(int zDelta);
+    void onMouseClick(int x, int y);
 
     // --- Payloads CPU para Constant Buffers ---
     CBChangeOnResize    cbChangesOnResize;
@@ -0,0 +1,98 @@
+#pragma once
+#include "CorePrerequisites.h"
+
+/**
+ * @file BoundingVolumes.h
+ * @brief Volúmenes envolventes (AABB, esfera y OBB) calculados con SSE sobre arreglos de
+ *        posiciones con stride arbitrario.
+ */
+
+/**
+ * @struct BoundingSphere
+ * @brief Esfera envolvente.
+ */
+struct BoundingSphere {
+    XMFLOAT3 center = XMFLOAT3(0, 0, 0);
+    float    radius = 0.0f;
+};
+
+/**
+ * @struct OrientedBox
+ * @brief Caja orientada: centro, tres ejes ortonormales y la semiextensión sobre cada eje.
+ */
+struct OrientedBox {
+    XMFLOAT3 center = XMFLOAT3(0, 0, 0);
+    XMFLOAT3 axes[3] = { XMFLOAT3(1, 0, 0), XMFLOAT3(0, 1, 0), XMFLOAT3(0, 0, 1) };
+    XMFLOAT3 extents = XMFLOAT3(0, 0, 0);
+
+    float
+        volume() const { return 8.0f * extents.x * extents.y * extents.z; }
+};
+
+/**
+ * @struct PointStream
+ * @brief Vista de un arreglo de posiciones XMFLOAT3 dentro de vértices de @c stride bytes.
+ *
+ * Si @c indices no es nulo, el punto i es el vértice @c indices[i] y @c count cuenta
+ * índices (los vértices repetidos se visitan varias veces, sin efecto en AABB ni esfera).
+ */
+struct PointStream {
+    const void*         positions = nullptr;  // Primer XMFLOAT3 (p. ej. &vertices[0].Pos)
+    size_t              stride = sizeof(XMFLOAT3);
+    size_t              count = 0;
+    const unsigned int* indices = nullptr;
+};
+
+/**
+ * @class BoundingVolumes
+ * @brief Kernels SSE2 de volúmenes envolventes.
+ *
+ * - AABB: min/max de 4 puntos por iteración con acumuladores independientes.
+ * - Esfera: EPOS-14 (puntos extremos sobre 7 direcciones, proyectadas en SoA) seguido de
+ *   una pasada de Ritter que sólo sale del camino vectorial cuando un punto queda fuera.
+ * - OBB: ejes principales de la covarianza (Jacobi 3x3); si la caja resultante es más
+ *   grande que el AABB se devuelve el AABB.
+ *
+ * Las cargas son de 16 bytes sin alinear: con @c stride menor que 16 el último punto se lee
+ * componente a componente para no pasar del final del arreglo.
+ */
+class
+    BoundingVolumes {
+public:
+    /**
+     * @brief AABB de los puntos; (0,0,0)-(0,0,0) si no hay puntos.
+     */
+    static void
+        ComputeAABB(const PointStream& points, XMFLOAT3& outMin, XMFLOAT3& outMax);
+
+    /**
+     * @brief Esfera envolvente ajustada (contiene todos los puntos).
+     */
+    static BoundingSphere
+        ComputeSphere(const PointStream& points);
+
+    /**
+     * @brief OBB por análisis de componentes principales.
+     */
+    static OrientedBox
+        ComputeOBB(const PointStream& points);
+
+    /**
+     * @brief AABB, esfera y OBB en una sola llamada.
+     */
+    static void
+        ComputeAll(const PointStream& points, XMFLOAT3& outMin, XMFLOAT3& outMax,
+            BoundingSphere& outSphere, OrientedBox& outBox);
+
+    /**
+     * @brief Esfera que contiene a un AABB (centro y semidiagonal).
+     */
+    static BoundingSphere
+        SphereFromAABB(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+
+    /**
+     * @brief OBB alineada a los ejes equivalente a un AABB.
+     */
+    static OrientedBox
+        BoxFromAABB(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+};
@@ -10,7 +10,7 @@ class DeviceContext;
  * @brief Declaracin del wrapper de buffers de Direct3D 11 (VB/IB/CB).
  *
  * Esta clase encapsula la creacin, actualizacin, enlace (bind) y liberacin
- * de buffers en GPU para vrtices, ndices y constantes.
+ * de buffers en GPU para vrtices, ndices, constantes y datos por instancia.
  */
 
  /**
@@ -46,6 +46,105 @@ public:
     HRESULT
         init(Device& device, const MeshComponent& mesh, unsigned int bindFlag);
 
+    /**
+     * @brief Inicializa el buffer como VB o IB a partir de un bloque de memoria arbitrario.
+     *
+     * Permite subir datos que no viven en un @c MeshComponent (p. ej. la vista mapeada de
+     * una cach .hmesh) sin copiarlos antes a un @c std::vector.
+     * @param device       Dispositivo de D3D11.
+     * @param data         Datos iniciales (no nulo).
+     * @param elementCount Cantidad de elementos (vrtices o ndices).
+     * @param stride       Tamao de un elemento en bytes.
+     * @param bindFlag     D3D11_BIND_VERTEX_BUFFER o D3D11_BIND_INDEX_BUFFER.
+     * @return S_OK en xito o HRESULT de error.
+     */
+    HRESULT
+        init(Device& device,
+            const void* data,
+            unsigned int elementCount,
+            unsigned int stride,
+            unsigned int bindFlag);
+
+    /**
+     * @brief Inicializa un index buffer eligiendo el formato ms pequeo posible.
+     *
+     * Cada ndice de un rango se almacena relativo a su @c MeshSubset::baseVertex. Si todos
+     * caben en 16 bits el buffer es R16_UINT; si no, R32_UINT (sin copia cuando todos los
+     * @c baseVertex son 0). Los rangos deben cubrir todos los ndices que se dibujan.
+     * @param device     Dispositivo de D3D11.
+     * @param indices    ndices absolutos (p. ej. @c MeshComponent::m_index o la cach mapeada).
+     * @param indexCount Cantidad de ndices.
+     * @param ranges     Subsets con su @c baseVertex; vaco equivale a un solo rango con base 0.
+     * @return S_OK en xito o HRESULT de error.
+     */
+    HRESULT
+        initIndexBuffer(Device& device,
+            const unsigned int* indices,
+            unsigned int indexCount,
+            const std::vector<MeshSubset>& ranges);
+
+    /**
+     * @brief Crea un VB/IB dinmico sin datos iniciales que la CPU reescribe con @c map.
+     *
+     * Pensado para contenidos que cambian por frame (p. ej. los ndices de los meshlets
+     * visibles). Si es IB, el formato se deduce del stride (2 bytes: R16_UINT).
+     * @param device       Dispositivo de D3D11.
+     * @param elementCount Capacidad en elementos.
+     * @param stride       Tamao de un elemento en bytes.
+     * @param bindFlag     D3D11_BIND_VERTEX_BUFFER o D3D11_BIND_INDEX_BUFFER.
+     * @return S_OK en xito o HRESULT de error.
+     */
+    HRESULT
+        initDynamic(Device& device,
+            unsigned int elementCount,
+            unsigned int stride,
+            unsigned int bindFlag);
+
+    /**
+     * @brief Crea un stream de datos por instancia (VB dinmico ledo con
+     *        D3D11_INPUT_PER_INSTANCE_DATA) que la CPU reescribe cada frame con @c map.
+     *
+     * Se enlaza con @c render en su propio slot (normalmente 1, junto al VB de vrtices en
+     * el 0) y se consume con @c DeviceContext::DrawIndexedInstanced.
+     * @param device   Dispositivo de D3D11.
+     * @param capacity Cantidad mxima de instancias.
+     * @param stride   Tamao de los datos de una instancia (p. ej. sizeof(InstanceData)).
+     * @return S_OK en xito o HRESULT de error.
+     */
+    HRESULT
+        initInstanceBuffer(Device& device,
+            unsigned int capacity,
+            unsigned int stride);
+
+    /**
+     * @brief Crea un constant buffer dinmico que la CPU escribe con @c map.
+     *
+     * Con D3D11.1 puede superar los 64 KB y enlazarse por rangos con @c renderRange
+     * (p. ej. el ring de constantes por draw de @c ConstantBufferManager).
+     * @param device    Dispositivo de D3D11.
+     * @param ByteWidth Tamao en bytes (mltiplo de 16).
+     * @return S_OK en xito o HRESULT de error.
+     */
+    HRESULT
+        initDynamicConstant(Device& device, unsigned int ByteWidth);
+
+    /**
+     * @brief Mapea un buffer dinmico para escribirlo.
+     * @param deviceContext Contexto inmediato de D3D11.
+     * @param mapType D3D11_MAP_WRITE_DISCARD (memoria nueva) o D3D11_MAP_WRITE_NO_OVERWRITE
+     *                (la misma memoria; slo se deben escribir zonas que la GPU no est leyendo).
+     * @return Puntero al inicio del buffer, o nullptr si falla.
+     */
+    void*
+        map(DeviceContext& deviceContext, D3D11_MAP mapType = D3D11_MAP_WRITE_DISCARD);
+
+    /**
+     * @brief Libera el mapeo hecho con @c map.
+     * @param deviceContext Contexto inmediato de D3D11.
+     */
+    void
+        unmap(DeviceContext& deviceContext);
+
     /**
      * @brief Inicializa un Constant Buffer (CB) con el tamao indicado.
      * @param device Dispositivo de D3D11.
@@ -80,7 +179,7 @@ public:
      * @param StartSlot Slot inicial (VB/CB/PS).
      * @param NumBuffers Nmero de buffers a enlazar.
      * @param setPixelShader Si true y es CB, tambin lo enlaza a PS.
-     * @param format Formato del ndice (si es IB), por defecto UNKNOWN.
+     * @param format Formato del ndice (si es IB); UNKNOWN usa el elegido al crearlo.
      */
     void
         render(DeviceContext& deviceContext,
@@ -89,6 +188,21 @@ public:
             bool           setPixelShader = false,
             DXGI_FORMAT    format = DXGI_FORMAT_UNKNOWN);
 
+    /**
+     * @brief Enlaza un rango de un constant buffer al VS (y opcionalmente al PS). Requiere D3D11.1.
+     * @param deviceContext Contexto inmediato de D3D11.
+     * @param StartSlot Slot del CB.
+     * @param firstConstant Primera constante (16 bytes) del rango; mltiplo de 16.
+     * @param numConstants Constantes del rango; mltiplo de 16.
+     * @param setPixelShader Si true, tambin lo enlaza a PS.
+     */
+    void
+        renderRange(DeviceContext& deviceContext,
+            unsigned int StartSlot,
+            unsigned int firstConstant,
+            unsigned int numConstants,
+            bool         setPixelShader = false);
+
     /**
      * @brief Libera el recurso de GPU asociado al buffer.
      */
@@ -107,6 +221,24 @@ public:
             D3D11_BUFFER_DESC& desc,
             D3D11_SUBRESOURCE_DATA* initData);
 
+    /**
+     * @brief Formato de ndice del buffer (R16_UINT o R32_UINT; slo para IB).
+     */
+    DXGI_FORMAT
+        getIndexFormat() const { return m_indexFormat; }
+
+    /**
+     * @brief Cantidad de elementos con la que se cre un VB/IB.
+     */
+    unsigned int
+        getCapacity() const { return m_capacity; }
+
+    /**
+     * @brief @c true si el buffer es un stream por instancia (ver @c initInstanceBuffer).
+     */
+    bool
+        isPerInstance() const { return m_perInstance; }
+
 private:
     /** @brief Recurso de buffer en GPU. */
     ID3D11Buffer* m_buffer = nullptr;
@@ -119,4 +251,13 @@ private:
 
     /** @brief Bandera de enlace usada al crear el buffer (VB/IB/CB). */
     unsigned int m_bindFlag = 0;
+
+    /** @brief Formato de ndice con el que se cre el IB. */
+    DXGI_FORMAT m_indexFormat = DXGI_FORMAT_R32_UINT;
+
+    /** @brief Cantidad de elementos del VB/IB. */
+    unsigned int m_capacity = 0;
+
+    /** @brief VB con datos por instancia en lugar de por vrtice. */
+    bool m_perInstance = false;
 };
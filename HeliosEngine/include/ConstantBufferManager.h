@@ -0,0 +1,188 @@
+#pragma once
+#include "Prerequisites.h"
+#include "Buffer.h"
+
+class Device;
+class DeviceContext;
+
+/**
+ * @file ConstantBufferManager.h
+ * @brief Constant buffers por frecuencia de cambio: bloques versionados y un ring por draw.
+ */
+
+/**
+ * @struct ConstantAllocation
+ * @brief Rango del ring con las constantes de un draw, en constantes de 16 bytes.
+ */
+struct ConstantAllocation {
+    unsigned int firstConstant = 0;
+    unsigned int constantCount = 0;  // 0 = asignación fallida
+
+    bool valid() const { return constantCount > 0; }
+};
+
+/**
+ * @struct ConstantUploadStats
+ * @brief Lo que costó subir constantes desde el último @c beginFrame.
+ */
+struct ConstantUploadStats {
+    unsigned int blockUploads = 0;     // UpdateSubresource de bloques con versión nueva
+    size_t       blockBytes = 0;
+    unsigned int unchangedSets = 0;    // set() con los mismos bytes: no suben
+    unsigned int ringAllocations = 0;
+    size_t       ringBytes = 0;        // Bytes escritos en el ring (alineados a 256)
+    unsigned int discardMaps = 0;      // Map WRITE_DISCARD (ring nuevo o camino sin D3D11.1)
+    unsigned int noOverwriteMaps = 0;  // Map WRITE_NO_OVERWRITE
+    unsigned int ringOverflows = 0;    // Asignaciones que no cupieron en el tramo mapeado
+
+    size_t
+        uploadBytes() const { return blockBytes + ringBytes; }
+
+    unsigned int
+        maps() const { return discardMaps + noOverwriteMaps; }
+};
+
+/**
+ * @class ConstantBufferManager
+ * @brief Sube cada constant buffer sólo cuando cambia y agrupa las constantes por draw.
+ *
+ * Bloques: un CB por frecuencia (vista, proyección, objeto...) con copia en CPU. @c set compara
+ * los bytes nuevos con la copia y sólo si difieren incrementa la versión; @c commit sube con
+ * UpdateSubresource únicamente los bloques cuya versión no es la subida.
+ *
+ * Ring: las constantes por draw se copian con @c allocate en un CB dinámico grande. El primer
+ * @c allocate tras un @c flush lo mapea una vez (NO_OVERWRITE a continuación de lo ya escrito,
+ * DISCARD al dar la vuelta) y @c flush lo desmapea antes de dibujar, así que miles de draws
+ * cuestan un solo Map. Cada draw enlaza su rango con @c bindAllocation (D3D11.1). Un tramo
+ * mapeado no puede dar la vuelta: el ring debe poder con las asignaciones de un frame.
+ *
+ * Sin D3D11.1 (rangos de CB y NO_OVERWRITE sobre CBs) las asignaciones quedan en CPU y
+ * @c bindAllocation las copia con un Map DISCARD por draw a un CB de 64 KB.
+ */
+class
+    ConstantBufferManager {
+public:
+    /** @brief Handle inválido. */
+    static const unsigned int kInvalid = ~0u;
+
+    /** @brief Alineación de cada asignación del ring (D3D11.1 pide múltiplos de 16 constantes). */
+    static const unsigned int kRingAlignment = 256;
+
+    /** @brief Tamaño máximo de una asignación (4096 constantes, lo que ve un shader). */
+    static const unsigned int kMaxAllocation = 65536;
+
+    ConstantBufferManager() = default;
+
+    /**
+     * @brief Crea el ring (o el CB del camino sin D3D11.1).
+     * @param device        Dispositivo de D3D11.
+     * @param deviceContext Contexto inmediato (para comprobar D3D11.1).
+     * @param ringBytes     Capacidad del ring; se redondea a @c kRingAlignment.
+     * @return S_OK en éxito o HRESULT de error.
+     */
+    HRESULT
+        init(Device& device, DeviceContext& deviceContext, unsigned int ringBytes = 4u << 20);
+
+    /**
+     * @brief Crea un bloque (un CB de uso DEFAULT) de @p byteWidth bytes.
+     * @return Handle del bloque o @c kInvalid si falla.
+     */
+    unsigned int
+        createBlock(Device& device, unsigned int byteWidth);
+
+    /**
+     * @brief Copia los datos del bloque; si son iguales a los actuales no cambia la versión.
+     * @param size Bytes a copiar desde el inicio (no mayor que el bloque).
+     */
+    void
+        set(unsigned int block, const void* data, unsigned int size);
+
+    /** @brief @c set con el tamaño del struct. */
+    template <typename T>
+    void
+        set(unsigned int block, const T& data) { set(block, &data, unsigned(sizeof(T))); }
+
+    /** @brief Versión del bloque (sube en cada @c set que cambia algo). */
+    unsigned int
+        getVersion(unsigned int block) const { return m_blocks[block].version; }
+
+    /**
+     * @brief Sube los bloques cuya versión cambió desde el último @c commit.
+     */
+    void
+        commit(DeviceContext& deviceContext);
+
+    /**
+     * @brief Enlaza un bloque al VS (y al PS si @p setPixelShader).
+     */
+    void
+        bind(DeviceContext& deviceContext, unsigned int block, unsigned int slot, bool setPixelShader = true);
+
+    /**
+     * @brief Empieza un frame: pone a cero las estadísticas y libera lo asignado en CPU.
+     */
+    void
+        beginFrame();
+
+    /**
+     * @brief Copia las constantes de un draw al ring.
+     * @return Rango asignado; inválido si @p size es 0, supera @c kMaxAllocation o no cabe.
+     */
+    ConstantAllocation
+        allocate(DeviceContext& deviceContext, const void* data, unsigned int size);
+
+    /** @brief @c allocate con el tamaño del struct. */
+    template <typename T>
+    ConstantAllocation
+        allocate(DeviceContext& deviceContext, const T& data) { return allocate(deviceContext, &data, unsigned(sizeof(T))); }
+
+    /**
+     * @brief Desmapea el ring; hay que llamarlo antes de dibujar con lo asignado.
+     */
+    void
+        flush(DeviceContext& deviceContext);
+
+    /**
+     * @brief Enlaza el rango de un draw al VS (y al PS si @p setPixelShader).
+     */
+    void
+        bindAllocation(DeviceContext& deviceContext, const ConstantAllocation& allocation,
+            unsigned int slot, bool setPixelShader = true);
+
+    /** @brief @c true si el ring usa rangos de CB (D3D11.1). */
+    bool
+        hasRingOffsets() const { return m_ringOffsets; }
+
+    /** @brief Estadísticas desde el último @c beginFrame. */
+    const ConstantUploadStats&
+        getStats() const { return m_stats; }
+
+    /**
+     * @brief Libera los bloques y el ring.
+     */
+    void
+        destroy();
+
+private:
+    struct Block {
+        Buffer                     buffer;
+        std::vector<unsigned char> data;                 // Copia en CPU (tamaño múltiplo de 16)
+        unsigned int               version = 1;
+        unsigned int               uploadedVersion = 0;  // 0: nunca subido
+    };
+
+    std::vector<Block>         m_blocks;
+
+    Buffer                     m_ring;
+    bool                       m_ringOffsets = false;
+    unsigned int               m_ringCapacity = 0;
+    unsigned int               m_head = 0;             // Siguiente byte libre
+    unsigned int               m_segmentStart = 0;     // Inicio del tramo mapeado
+    unsigned int               m_lastSegmentBytes = 0; // Bytes del tramo anterior (para prever la vuelta)
+    unsigned char*             m_mapped = nullptr;     // Ring mapeado (nullptr entre flush y allocate)
+    bool                       m_ringWritten = false;  // Algún tramo ya usó el ring
+
+    std::vector<unsigned char> m_cpuRing;              // Camino sin D3D11.1: asignaciones del frame
+
+    ConstantUploadStats        m_stats;
+};
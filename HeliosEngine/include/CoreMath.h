@@ -0,0 +1,273 @@
+#pragma once
+/**
+ * @file CoreMath.h
+ * @brief Subconjunto de XNA Math (tipos y funciones) para compilar el núcleo fuera de Windows.
+ *
+ * Sólo lo incluye @c CorePrerequisites.h cuando no hay <xnamath.h>. Reproduce la convención de
+ * XNA Math: vectores fila, matrices por filas (@c XMMATRIX::r) y @c XMVECTOR como registro SSE.
+ * Contiene únicamente lo que usan las consultas de escena (BVH, octree, frustum y picking) y
+ * sus pruebas; lo demás sigue exigiendo la biblioteca original.
+ */
+
+#include <cmath>
+#include <emmintrin.h>
+
+typedef __m128 XMVECTOR;
+typedef const XMVECTOR FXMVECTOR;
+
+#define XM_PI       3.141592654f
+#define XM_PIDIV2   1.570796327f
+#define XM_PIDIV4   0.785398163f
+
+struct XMFLOAT2 {
+    float x, y;
+
+    XMFLOAT2() {}
+    XMFLOAT2(float _x, float _y) : x(_x), y(_y) {}
+};
+
+struct XMFLOAT3 {
+    float x, y, z;
+
+    XMFLOAT3() {}
+    XMFLOAT3(float _x, float _y, float _z) : x(_x), y(_y), z(_z) {}
+};
+
+struct XMFLOAT4 {
+    float x, y, z, w;
+
+    XMFLOAT4() {}
+    XMFLOAT4(float _x, float _y, float _z, float _w) : x(_x), y(_y), z(_z), w(_w) {}
+};
+
+struct XMFLOAT4X4 {
+    float m[4][4];
+};
+
+struct XMMATRIX {
+    XMVECTOR r[4];
+};
+
+typedef const XMMATRIX& CXMMATRIX;
+
+inline float
+XMConvertToRadians(float degrees) { return degrees * (XM_PI / 180.0f); }
+
+// == Vectores ==
+
+inline XMVECTOR
+XMVectorSet(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+
+inline XMVECTOR
+XMVectorZero() { return _mm_setzero_ps(); }
+
+inline XMVECTOR
+XMVectorReplicate(float value) { return _mm_set1_ps(value); }
+
+inline float
+XMVectorGetX(FXMVECTOR v) { return _mm_cvtss_f32(v); }
+
+inline float
+XMVectorGetY(FXMVECTOR v) { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))); }
+
+inline float
+XMVectorGetZ(FXMVECTOR v) { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))); }
+
+inline float
+XMVectorGetW(FXMVECTOR v) { return _mm_cvtss_f32(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))); }
+
+inline XMVECTOR
+XMVectorAdd(FXMVECTOR a, FXMVECTOR b) { return _mm_add_ps(a, b); }
+
+inline XMVECTOR
+XMVectorSubtract(FXMVECTOR a, FXMVECTOR b) { return _mm_sub_ps(a, b); }
+
+inline XMVECTOR
+XMVectorMultiply(FXMVECTOR a, FXMVECTOR b) { return _mm_mul_ps(a, b); }
+
+inline XMVECTOR
+XMVectorScale(FXMVECTOR v, float scale) { return _mm_mul_ps(v, _mm_set1_ps(scale)); }
+
+inline XMVECTOR
+XMVectorMin(FXMVECTOR a, FXMVECTOR b) { return _mm_min_ps(a, b); }
+
+inline XMVECTOR
+XMVectorMax(FXMVECTOR a, FXMVECTOR b) { return _mm_max_ps(a, b); }
+
+inline XMVECTOR
+XMLoadFloat3(const XMFLOAT3* source) { return _mm_setr_ps(source->x, source->y, source->z, 0.0f); }
+
+inline XMVECTOR
+XMLoadFloat4(const XMFLOAT4* source) { return _mm_loadu_ps(&source->x); }
+
+inline void
+XMStoreFloat3(XMFLOAT3* destination, FXMVECTOR v) {
+    destination->x = XMVectorGetX(v);
+    destination->y = XMVectorGetY(v);
+    destination->z = XMVectorGetZ(v);
+}
+
+inline void
+XMStoreFloat4(XMFLOAT4* destination, FXMVECTOR v) { _mm_storeu_ps(&destination->x, v); }
+
+/** @brief Producto punto de xyz replicado en las cuatro componentes. */
+inline XMVECTOR
+XMVector3Dot(FXMVECTOR a, FXMVECTOR b) {
+    const XMVECTOR p = _mm_mul_ps(a, b);
+    const float dot = XMVectorGetX(p) + XMVectorGetY(p) + XMVectorGetZ(p);
+    return _mm_set1_ps(dot);
+}
+
+inline XMVECTOR
+XMVector3Cross(FXMVECTOR a, FXMVECTOR b) {
+    // (a.yzx * b.zxy) - (a.zxy * b.yzx); w queda en 0
+    const XMVECTOR aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    const XMVECTOR bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+    const XMVECTOR aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+    const XMVECTOR bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    const XMVECTOR c = _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+    return _mm_and_ps(c, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+}
+
+inline XMVECTOR
+XMVector3Length(FXMVECTOR v) { return _mm_sqrt_ps(XMVector3Dot(v, v)); }
+
+/** @brief xyz con longitud 1; un vector nulo se devuelve tal cual. */
+inline XMVECTOR
+XMVector3Normalize(FXMVECTOR v) {
+    const float length = XMVectorGetX(XMVector3Length(v));
+    return length > 0.0f ? _mm_div_ps(v, _mm_set1_ps(length)) : v;
+}
+
+// == Matrices ==
+
+inline XMMATRIX
+XMMatrixSet(float m00, float m01, float m02, float m03,
+    float m10, float m11, float m12, float m13,
+    float m20, float m21, float m22, float m23,
+    float m30, float m31, float m32, float m33) {
+    XMMATRIX m;
+    m.r[0] = _mm_setr_ps(m00, m01, m02, m03);
+    m.r[1] = _mm_setr_ps(m10, m11, m12, m13);
+    m.r[2] = _mm_setr_ps(m20, m21, m22, m23);
+    m.r[3] = _mm_setr_ps(m30, m31, m32, m33);
+    return m;
+}
+
+inline XMMATRIX
+XMMatrixIdentity() {
+    return XMMatrixSet(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+}
+
+inline XMMATRIX
+XMMatrixTranslation(float x, float y, float z) {
+    return XMMatrixSet(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, x, y, z, 1);
+}
+
+inline XMMATRIX
+XMMatrixScaling(float x, float y, float z) {
+    return XMMatrixSet(x, 0, 0, 0, 0, y, 0, 0, 0, 0, z, 0, 0, 0, 0, 1);
+}
+
+/** @brief Proyección en perspectiva de mano izquierda (z en [0, 1]). */
+inline XMMATRIX
+XMMatrixPerspectiveFovLH(float fovAngleY, float aspectRatio, float nearZ, float farZ) {
+    const float h = 1.0f / std::tan(fovAngleY * 0.5f);
+    const float w = h / aspectRatio;
+    const float range = farZ / (farZ - nearZ);
+    return XMMatrixSet(w, 0, 0, 0, 0, h, 0, 0, 0, 0, range, 1, 0, 0, -range * nearZ, 0);
+}
+
+inline void
+XMStoreFloat4x4(XMFLOAT4X4* destination, CXMMATRIX m) {
+    for (int i = 0; i < 4; ++i) _mm_storeu_ps(destination->m[i], m.r[i]);
+}
+
+inline XMMATRIX
+XMLoadFloat4x4(const XMFLOAT4X4* source) {
+    XMMATRIX m;
+    for (int i = 0; i < 4; ++i) m.r[i] = _mm_loadu_ps(source->m[i]);
+    return m;
+}
+
+/** @brief v * m como vector fila (combinación de las filas de @p m). */
+inline XMVECTOR
+XMVector4Transform(FXMVECTOR v, CXMMATRIX m) {
+    const XMVECTOR x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+    const XMVECTOR y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+    const XMVECTOR z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+    const XMVECTOR w = _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.r[0]), _mm_mul_ps(y, m.r[1])),
+        _mm_add_ps(_mm_mul_ps(z, m.r[2]), _mm_mul_ps(w, m.r[3])));
+}
+
+inline XMMATRIX
+XMMatrixMultiply(CXMMATRIX a, CXMMATRIX b) {
+    XMMATRIX m;
+    for (int i = 0; i < 4; ++i) m.r[i] = XMVector4Transform(a.r[i], b);
+    return m;
+}
+
+inline XMMATRIX
+XMMatrixTranspose(CXMMATRIX m) {
+    XMMATRIX t = m;
+    _MM_TRANSPOSE4_PS(t.r[0], t.r[1], t.r[2], t.r[3]);
+    return t;
+}
+
+/** @brief Punto (w = 1) transformado y dividido por w. */
+inline XMVECTOR
+XMVector3TransformCoord(FXMVECTOR v, CXMMATRIX m) {
+    const XMVECTOR point = _mm_or_ps(_mm_and_ps(v, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))),
+        _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f));
+    const XMVECTOR r = XMVector4Transform(point, m);
+    return _mm_div_ps(r, _mm_shuffle_ps(r, r, _MM_SHUFFLE(3, 3, 3, 3)));
+}
+
+/** @brief Dirección (w = 0) transformada, sin traslación. */
+inline XMVECTOR
+XMVector3TransformNormal(FXMVECTOR v, CXMMATRIX m) {
+    const XMVECTOR x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+    const XMVECTOR y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+    const XMVECTOR z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, m.r[0]), _mm_mul_ps(y, m.r[1])), _mm_mul_ps(z, m.r[2]));
+}
+
+/**
+ * @brief Inversa por cofactores.
+ * @param determinant Si no es nulo, recibe el determinante replicado.
+ *
+ * Como en XNA Math, una matriz singular devuelve valores no finitos.
+ */
+inline XMMATRIX
+XMMatrixInverse(XMVECTOR* determinant, CXMMATRIX matrix) {
+    XMFLOAT4X4 src;
+    XMStoreFloat4x4(&src, matrix);
+    const float* a = &src.m[0][0];
+
+    float inv[16];
+    inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    const float det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+    if (determinant) *determinant = _mm_set1_ps(det);
+
+    const float scale = 1.0f / det;
+    XMFLOAT4X4 result;
+    for (int i = 0; i < 16; ++i) result.m[i / 4][i % 4] = inv[i] * scale;
+    return XMLoadFloat4x4(&result);
+}
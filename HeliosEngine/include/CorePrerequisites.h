@@ -0,0 +1,97 @@
+#pragma once
+/**
+ * @file CorePrerequisites.h
+ * @brief Dependencias del núcleo que no toca la GPU: STL, matemática, logging y vértices.
+ * @details Lo incluyen las consultas de escena (BVH, octree, frustum, picking), las mallas y
+ *          el @c JobSystem. No depende de Direct3D: en Windows usa XNA Math y la ventana de
+ *          depuración; en otras plataformas, @c CoreMath.h y la salida de error estándar, así
+ *          que este núcleo compila y se prueba sin dispositivo (ver CMakeLists.txt).
+ *          @c Prerequisites.h lo incluye y añade lo de Direct3D.
+ */
+
+ // = STD ==
+#include <string>
+#include <sstream>
+#include <vector>
+#include <thread>
+#include <cfloat>
+#include <cstdint>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+
+// == Math ==
+#include <windows.h>
+#include <xnamath.h>
+
+/** @brief Destino de @c MESSAGE y @c ERROR: la ventana de depuración. */
+#define HELIOS_DEBUG_OUTPUT(text) OutputDebugStringW(text)
+#else
+#include <cstdio>
+#include "CoreMath.h"
+
+#define HELIOS_DEBUG_OUTPUT(text) std::fputws(text, stderr)
+#endif
+
+// == MACROS ==
+
+ /**
+  * @def MESSAGE(classObj, method, state)
+  * @brief Traza un mensaje de creación/estado a la salida de depuración.
+  * @details Formatea y manda a @c HELIOS_DEBUG_OUTPUT un mensaje con
+  *          clase, método y estado, útil para diagnosticar creación de recursos.
+  * @param classObj Nombre de la clase (literal amplio o <tt>LPCWSTR</tt> imprimible).
+  * @param method   Nombre del método.
+  * @param state    Texto del estado (por ejemplo: <tt>"OK"</tt>, <tt>"FAILED"</tt>).
+  */
+#define MESSAGE( classObj, method, state )   \
+{                                            \
+   std::wostringstream os_;                  \
+   os_ << classObj << L"::" << method << L" : " << L"[CREATION OF RESOURCE : " << state << L"]\n"; \
+   HELIOS_DEBUG_OUTPUT( os_.str().c_str() ); \
+}
+
+  /**
+   * @def ERROR(classObj, method, errorMSG)
+   * @brief Registra un mensaje de error en la salida de depuración.
+   * @details Captura clase, método y la descripción del error. Envía el texto a
+   *          @c HELIOS_DEBUG_OUTPUT. En caso de excepción al formatear, informa el fallo.
+   * @param classObj Nombre de la clase donde ocurre el error.
+   * @param method   Nombre del método que reporta el error.
+   * @param errorMSG Mensaje descriptivo del error (amplio o convertible a <tt>std::wstring</tt>).
+   */
+#define ERROR(classObj, method, errorMSG)                     \
+{                                                             \
+    try {                                                     \
+        std::wostringstream os_;                              \
+        os_ << L"ERROR : " << classObj << L"::" << method     \
+            << L" : " << errorMSG << L"\n";                   \
+        HELIOS_DEBUG_OUTPUT(os_.str().c_str());               \
+    } catch (...) {                                           \
+        HELIOS_DEBUG_OUTPUT(L"Failed to log error message.\n");\
+    }                                                         \
+}
+
+   // == Tipos del Engine ==
+
+/** Vértice completo con posición, textura y normal. */
+struct SimpleVertex {
+    XMFLOAT3 Pos;
+    XMFLOAT2 Tex;
+    XMFLOAT3 Normal;
+};
+
+/**
+ * Vértice cuantizado de 16 bytes (la mitad de @c SimpleVertex); ver @c VertexQuantizer.
+ * Posición UNORM16 relativa al AABB de la malla, normal octaédrica SNORM16 y UV en half.
+ */
+struct PackedVertex {
+    uint16_t Pos[4];     // x, y, z, 0
+    int16_t  Normal[2];
+    uint16_t Tex[2];
+};
@@ -0,0 +1,327 @@
+#pragma once
+#include "Prerequisites.h"
+#include <d3d11_1.h>
+
+/**
+ * @file CountingDevice.h
+ * @brief Dispositivo y contexto de D3D11 falsos que cuentan lo que sube la CPU.
+ *
+ * Sirven para comprobar sin GPU el tráfico de constantes (@c ConstantBufferManager): los
+ * buffers viven en memoria de CPU, @c Map entrega esa memoria y @c Unmap compara con lo que
+ * había para saber cuántos bytes se escribieron. Con DISCARD el buffer empieza "renombrado"
+ * (relleno con @c kFreshByte); con NO_OVERWRITE se cuenta como error escribir un byte ya
+ * escrito desde el último DISCARD, porque la GPU aún podría estar leyéndolo.
+ *
+ * Sólo hacen algo las llamadas que usan los constant buffers; el resto son no-ops.
+ */
+
+/**
+ * @struct CountingDeviceStats
+ * @brief Contadores del contexto falso desde el último @c resetStats.
+ */
+struct CountingDeviceStats {
+    unsigned int updates = 0;          // UpdateSubresource
+    size_t       updateBytes = 0;
+    unsigned int discardMaps = 0;      // Map WRITE_DISCARD
+    unsigned int noOverwriteMaps = 0;  // Map WRITE_NO_OVERWRITE
+    size_t       mappedBytes = 0;      // Bytes que cambiaron entre Map y Unmap
+    unsigned int overwrites = 0;       // Maps NO_OVERWRITE que pisaron bytes del tramo vigente
+    unsigned int rangeBinds = 0;       // VS/PSSetConstantBuffers1
+
+    /** @brief Bytes subidos por cualquier camino. */
+    size_t
+        uploadBytes() const { return updateBytes + mappedBytes; }
+};
+
+/** @brief Declara un método que no hace nada (la interfaz de D3D11 exige implementarlos todos). */
+#define HELIOS_COUNTING_NOOP(name, params) \
+    void STDMETHODCALLTYPE name params override {}
+
+/** @brief Igual que @c HELIOS_COUNTING_NOOP para métodos que devuelven un valor. */
+#define HELIOS_COUNTING_RETURN(type, name, params, value) \
+    type STDMETHODCALLTYPE name params override { return value; }
+
+/** @brief Referencias COM sin borrar: el dispositivo y el contexto viven en la pila del test. */
+#define HELIOS_COUNTING_UNKNOWN                                                  \
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refCount; }           \
+    ULONG STDMETHODCALLTYPE Release() override { return --m_refCount; }
+
+/** @brief Métodos de @c ID3D11DeviceChild. */
+#define HELIOS_COUNTING_DEVICE_CHILD                                             \
+    void STDMETHODCALLTYPE GetDevice(ID3D11Device** ppDevice) override {         \
+        if (ppDevice) *ppDevice = nullptr;                                       \
+    }                                                                            \
+    HELIOS_COUNTING_RETURN(HRESULT, GetPrivateData, (REFGUID, UINT*, void*), E_NOTIMPL) \
+    HELIOS_COUNTING_RETURN(HRESULT, SetPrivateData, (REFGUID, UINT, const void*), E_NOTIMPL) \
+    HELIOS_COUNTING_RETURN(HRESULT, SetPrivateDataInterface, (REFGUID, const IUnknown*), E_NOTIMPL)
+
+/** @brief Métodos de una etapa de shader salvo el enlace de constant buffers. */
+#define HELIOS_COUNTING_STAGE(stage, Shader)                                                     \
+    HELIOS_COUNTING_NOOP(stage##SetShaderResources, (UINT, UINT, ID3D11ShaderResourceView* const*)) \
+    HELIOS_COUNTING_NOOP(stage##SetSamplers, (UINT, UINT, ID3D11SamplerState* const*))           \
+    HELIOS_COUNTING_NOOP(stage##SetShader, (Shader*, ID3D11ClassInstance* const*, UINT))         \
+    HELIOS_COUNTING_NOOP(stage##GetShaderResources, (UINT, UINT, ID3D11ShaderResourceView**))    \
+    HELIOS_COUNTING_NOOP(stage##GetSamplers, (UINT, UINT, ID3D11SamplerState**))                 \
+    HELIOS_COUNTING_NOOP(stage##GetShader, (Shader**, ID3D11ClassInstance**, UINT*))             \
+    HELIOS_COUNTING_NOOP(stage##GetConstantBuffers, (UINT, UINT, ID3D11Buffer**))                \
+    HELIOS_COUNTING_NOOP(stage##GetConstantBuffers1, (UINT, UINT, ID3D11Buffer**, UINT*, UINT*))
+
+/**
+ * @class CountingBuffer
+ * @brief Buffer en memoria de CPU creado por @c CountingDevice.
+ */
+class
+    CountingBuffer final : public ID3D11Buffer {
+public:
+    /** @brief Byte con el que se rellena la memoria nueva de un DISCARD. */
+    static const unsigned char kFreshByte = 0xCD;
+
+    explicit CountingBuffer(const D3D11_BUFFER_DESC& desc);
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refCount; }
+    ULONG STDMETHODCALLTYPE Release() override;
+    HELIOS_COUNTING_DEVICE_CHILD
+    void STDMETHODCALLTYPE GetType(D3D11_RESOURCE_DIMENSION* pResourceDimension) override {
+        *pResourceDimension = D3D11_RESOURCE_DIMENSION_BUFFER;
+    }
+    HELIOS_COUNTING_NOOP(SetEvictionPriority, (UINT))
+    HELIOS_COUNTING_RETURN(UINT, GetEvictionPriority, (), 0)
+    void STDMETHODCALLTYPE GetDesc(D3D11_BUFFER_DESC* pDesc) override { *pDesc = m_desc; }
+
+    /** @brief Contenido actual (lo que leería la GPU). */
+    const unsigned char*
+        data() const { return m_data.data(); }
+
+    /** @brief Tamaño en bytes. */
+    size_t
+        size() const { return m_data.size(); }
+
+private:
+    friend class CountingDevice;
+    friend class CountingDeviceContext;
+
+    D3D11_BUFFER_DESC          m_desc;
+    std::vector<unsigned char> m_data;
+    std::vector<unsigned char> m_beforeMap;  // Copia al mapear, para contar lo escrito
+    std::vector<bool>          m_written;    // Bytes escritos desde el último DISCARD
+    D3D11_MAP                  m_mapType = D3D11_MAP_WRITE_DISCARD;
+    bool                       m_mapped = false;
+    ULONG                      m_refCount = 1;
+};
+
+/**
+ * @class CountingDevice
+ * @brief Dispositivo falso: crea @c CountingBuffer y responde a @c CheckFeatureSupport.
+ */
+class
+    CountingDevice : public ID3D11Device {
+public:
+    /**
+     * @param constantBufferOffsets Si anuncia rangos de CB y NO_OVERWRITE sobre CBs (D3D11.1).
+     */
+    explicit CountingDevice(bool constantBufferOffsets) : m_constantBufferOffsets(constantBufferOffsets) {}
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
+    HELIOS_COUNTING_UNKNOWN
+
+    HRESULT STDMETHODCALLTYPE CreateBuffer(const D3D11_BUFFER_DESC* pDesc,
+        const D3D11_SUBRESOURCE_DATA* pInitialData, ID3D11Buffer** ppBuffer) override;
+    HRESULT STDMETHODCALLTYPE CheckFeatureSupport(D3D11_FEATURE Feature, void* pFeatureSupportData,
+        UINT FeatureSupportDataSize) override;
+
+    HELIOS_COUNTING_RETURN(HRESULT, CreateTexture1D, (const D3D11_TEXTURE1D_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Texture1D**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateTexture2D, (const D3D11_TEXTURE2D_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Texture2D**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateTexture3D, (const D3D11_TEXTURE3D_DESC*, const D3D11_SUBRESOURCE_DATA*, ID3D11Texture3D**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateShaderResourceView, (ID3D11Resource*, const D3D11_SHADER_RESOURCE_VIEW_DESC*, ID3D11ShaderResourceView**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateUnorderedAccessView, (ID3D11Resource*, const D3D11_UNORDERED_ACCESS_VIEW_DESC*, ID3D11UnorderedAccessView**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateRenderTargetView, (ID3D11Resource*, const D3D11_RENDER_TARGET_VIEW_DESC*, ID3D11RenderTargetView**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateDepthStencilView, (ID3D11Resource*, const D3D11_DEPTH_STENCIL_VIEW_DESC*, ID3D11DepthStencilView**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateInputLayout, (const D3D11_INPUT_ELEMENT_DESC*, UINT, const void*, SIZE_T, ID3D11InputLayout**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateVertexShader, (const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11VertexShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateGeometryShader, (const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11GeometryShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateGeometryShaderWithStreamOutput, (const void*, SIZE_T, const D3D11_SO_DECLARATION_ENTRY*, UINT, const UINT*, UINT, UINT, ID3D11ClassLinkage*, ID3D11GeometryShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreatePixelShader, (const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11PixelShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateHullShader, (const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11HullShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateDomainShader, (const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11DomainShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateComputeShader, (const void*, SIZE_T, ID3D11ClassLinkage*, ID3D11ComputeShader**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateClassLinkage, (ID3D11ClassLinkage**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateBlendState, (const D3D11_BLEND_DESC*, ID3D11BlendState**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateDepthStencilState, (const D3D11_DEPTH_STENCIL_DESC*, ID3D11DepthStencilState**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateRasterizerState, (const D3D11_RASTERIZER_DESC*, ID3D11RasterizerState**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateSamplerState, (const D3D11_SAMPLER_DESC*, ID3D11SamplerState**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateQuery, (const D3D11_QUERY_DESC*, ID3D11Query**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreatePredicate, (const D3D11_QUERY_DESC*, ID3D11Predicate**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateCounter, (const D3D11_COUNTER_DESC*, ID3D11Counter**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CreateDeferredContext, (UINT, ID3D11DeviceContext**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, OpenSharedResource, (HANDLE, REFIID, void**), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CheckFormatSupport, (DXGI_FORMAT, UINT*), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, CheckMultisampleQualityLevels, (DXGI_FORMAT, UINT, UINT*), E_NOTIMPL)
+    HELIOS_COUNTING_NOOP(CheckCounterInfo, (D3D11_COUNTER_INFO*))
+    HELIOS_COUNTING_RETURN(HRESULT, CheckCounter, (const D3D11_COUNTER_DESC*, D3D11_COUNTER_TYPE*, UINT*, LPSTR, UINT*, LPSTR, UINT*, LPSTR, UINT*), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, GetPrivateData, (REFGUID, UINT*, void*), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, SetPrivateData, (REFGUID, UINT, const void*), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(HRESULT, SetPrivateDataInterface, (REFGUID, const IUnknown*), E_NOTIMPL)
+    HELIOS_COUNTING_RETURN(D3D_FEATURE_LEVEL, GetFeatureLevel, (), D3D_FEATURE_LEVEL_11_0)
+    HELIOS_COUNTING_RETURN(UINT, GetCreationFlags, (), 0)
+    HELIOS_COUNTING_RETURN(HRESULT, GetDeviceRemovedReason, (), S_OK)
+    void STDMETHODCALLTYPE GetImmediateContext(ID3D11DeviceContext** ppImmediateContext) override {
+        if (ppImmediateContext) *ppImmediateContext = nullptr;
+    }
+    HELIOS_COUNTING_RETURN(HRESULT, SetExceptionMode, (UINT), S_OK)
+    HELIOS_COUNTING_RETURN(UINT, GetExceptionMode, (), 0)
+
+private:
+    bool  m_constantBufferOffsets;
+    ULONG m_refCount = 1;
+};
+
+/**
+ * @class CountingDeviceContext
+ * @brief Contexto falso: cuenta Maps y bytes subidos y recuerda los constant buffers del VS.
+ *
+ * Sólo responde a @c QueryInterface de @c ID3D11DeviceContext1 si se crea con rangos de CB,
+ * como un runtime anterior a D3D11.1.
+ */
+class
+    CountingDeviceContext : public ID3D11DeviceContext1 {
+public:
+    /** @brief Slots de constant buffer del VS que se recuerdan. */
+    static const unsigned int kConstantSlots = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+
+    explicit CountingDeviceContext(bool constantBufferOffsets) : m_constantBufferOffsets(constantBufferOffsets) {}
+
+    /** @brief Contadores desde el último @c resetStats. */
+    const CountingDeviceStats&
+        getStats() const { return m_stats; }
+
+    void
+        resetStats() { m_stats = CountingDeviceStats(); }
+
+    /**
+     * @brief Constantes que vería el VS en @p slot (buffer entero o rango de D3D11.1).
+     * @param slot  Slot de constant buffer.
+     * @param bytes Recibe el tamaño visible en bytes.
+     * @return Puntero al inicio del rango o @c nullptr si no hay buffer enlazado.
+     */
+    const unsigned char*
+        boundConstants(unsigned int slot, size_t& bytes) const;
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override;
+    HELIOS_COUNTING_UNKNOWN
+    HELIOS_COUNTING_DEVICE_CHILD
+
+    HRESULT STDMETHODCALLTYPE Map(ID3D11Resource* pResource, UINT Subresource, D3D11_MAP MapType,
+        UINT MapFlags, D3D11_MAPPED_SUBRESOURCE* pMappedResource) override;
+    void STDMETHODCALLTYPE Unmap(ID3D11Resource* pResource, UINT Subresource) override;
+    void STDMETHODCALLTYPE UpdateSubresource(ID3D11Resource* pDstResource, UINT DstSubresource,
+        const D3D11_BOX* pDstBox, const void* pSrcData, UINT SrcRowPitch, UINT SrcDepthPitch) override;
+    void STDMETHODCALLTYPE VSSetConstantBuffers(UINT StartSlot, UINT NumBuffers,
+        ID3D11Buffer* const* ppConstantBuffers) override;
+    void STDMETHODCALLTYPE VSSetConstantBuffers1(UINT StartSlot, UINT NumBuffers,
+        ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants) override;
+    void STDMETHODCALLTYPE PSSetConstantBuffers1(UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*) override {
+        ++m_stats.rangeBinds;
+    }
+    HELIOS_COUNTING_NOOP(PSSetConstantBuffers, (UINT, UINT, ID3D11Buffer* const*))
+
+    HELIOS_COUNTING_STAGE(VS, ID3D11VertexShader)
+    HELIOS_COUNTING_STAGE(PS, ID3D11PixelShader)
+    HELIOS_COUNTING_STAGE(GS, ID3D11GeometryShader)
+    HELIOS_COUNTING_STAGE(HS, ID3D11HullShader)
+    HELIOS_COUNTING_STAGE(DS, ID3D11DomainShader)
+    HELIOS_COUNTING_STAGE(CS, ID3D11ComputeShader)
+    HELIOS_COUNTING_NOOP(GSSetConstantBuffers, (UINT, UINT, ID3D11Buffer* const*))
+    HELIOS_COUNTING_NOOP(HSSetConstantBuffers, (UINT, UINT, ID3D11Buffer* const*))
+    HELIOS_COUNTING_NOOP(DSSetConstantBuffers, (UINT, UINT, ID3D11Buffer* const*))
+    HELIOS_COUNTING_NOOP(CSSetConstantBuffers, (UINT, UINT, ID3D11Buffer* const*))
+    HELIOS_COUNTING_NOOP(GSSetConstantBuffers1, (UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*))
+    HELIOS_COUNTING_NOOP(HSSetConstantBuffers1, (UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*))
+    HELIOS_COUNTING_NOOP(DSSetConstantBuffers1, (UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*))
+    HELIOS_COUNTING_NOOP(CSSetConstantBuffers1, (UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*))
+    HELIOS_COUNTING_NOOP(CSSetUnorderedAccessViews, (UINT, UINT, ID3D11UnorderedAccessView* const*, const UINT*))
+    HELIOS_COUNTING_NOOP(CSGetUnorderedAccessViews, (UINT, UINT, ID3D11UnorderedAccessView**))
+
+    HELIOS_COUNTING_NOOP(DrawIndexed, (UINT, UINT, INT))
+    HELIOS_COUNTING_NOOP(Draw, (UINT, UINT))
+    HELIOS_COUNTING_NOOP(DrawIndexedInstanced, (UINT, UINT, UINT, INT, UINT))
+    HELIOS_COUNTING_NOOP(DrawInstanced, (UINT, UINT, UINT, UINT))
+    HELIOS_COUNTING_NOOP(DrawAuto, ())
+    HELIOS_COUNTING_NOOP(DrawIndexedInstancedIndirect, (ID3D11Buffer*, UINT))
+    HELIOS_COUNTING_NOOP(DrawInstancedIndirect, (ID3D11Buffer*, UINT))
+    HELIOS_COUNTING_NOOP(Dispatch, (UINT, UINT, UINT))
+    HELIOS_COUNTING_NOOP(DispatchIndirect, (ID3D11Buffer*, UINT))
+    HELIOS_COUNTING_NOOP(IASetInputLayout, (ID3D11InputLayout*))
+    HELIOS_COUNTING_NOOP(IASetVertexBuffers, (UINT, UINT, ID3D11Buffer* const*, const UINT*, const UINT*))
+    HELIOS_COUNTING_NOOP(IASetIndexBuffer, (ID3D11Buffer*, DXGI_FORMAT, UINT))
+    HELIOS_COUNTING_NOOP(IASetPrimitiveTopology, (D3D11_PRIMITIVE_TOPOLOGY))
+    HELIOS_COUNTING_NOOP(IAGetInputLayout, (ID3D11InputLayout**))
+    HELIOS_COUNTING_NOOP(IAGetVertexBuffers, (UINT, UINT, ID3D11Buffer**, UINT*, UINT*))
+    HELIOS_COUNTING_NOOP(IAGetIndexBuffer, (ID3D11Buffer**, DXGI_FORMAT*, UINT*))
+    HELIOS_COUNTING_NOOP(IAGetPrimitiveTopology, (D3D11_PRIMITIVE_TOPOLOGY*))
+    HELIOS_COUNTING_NOOP(Begin, (ID3D11Asynchronous*))
+    HELIOS_COUNTING_NOOP(End, (ID3D11Asynchronous*))
+    HELIOS_COUNTING_RETURN(HRESULT, GetData, (ID3D11Asynchronous*, void*, UINT, UINT), E_NOTIMPL)
+    HELIOS_COUNTING_NOOP(SetPredication, (ID3D11Predicate*, BOOL))
+    HELIOS_COUNTING_NOOP(GetPredication, (ID3D11Predicate**, BOOL*))
+    HELIOS_COUNTING_NOOP(OMSetRenderTargets, (UINT, ID3D11RenderTargetView* const*, ID3D11DepthStencilView*))
+    HELIOS_COUNTING_NOOP(OMSetRenderTargetsAndUnorderedAccessViews, (UINT, ID3D11RenderTargetView* const*, ID3D11DepthStencilView*, UINT, UINT, ID3D11UnorderedAccessView* const*, const UINT*))
+    HELIOS_COUNTING_NOOP(OMSetBlendState, (ID3D11BlendState*, const FLOAT*, UINT))
+    HELIOS_COUNTING_NOOP(OMSetDepthStencilState, (ID3D11DepthStencilState*, UINT))
+    HELIOS_COUNTING_NOOP(OMGetRenderTargets, (UINT, ID3D11RenderTargetView**, ID3D11DepthStencilView**))
+    HELIOS_COUNTING_NOOP(OMGetRenderTargetsAndUnorderedAccessViews, (UINT, ID3D11RenderTargetView**, ID3D11DepthStencilView**, UINT, UINT, ID3D11UnorderedAccessView**))
+    HELIOS_COUNTING_NOOP(OMGetBlendState, (ID3D11BlendState**, FLOAT*, UINT*))
+    HELIOS_COUNTING_NOOP(OMGetDepthStencilState, (ID3D11DepthStencilState**, UINT*))
+    HELIOS_COUNTING_NOOP(SOSetTargets, (UINT, ID3D11Buffer* const*, const UINT*))
+    HELIOS_COUNTING_NOOP(SOGetTargets, (UINT, ID3D11Buffer**))
+    HELIOS_COUNTING_NOOP(RSSetState, (ID3D11RasterizerState*))
+    HELIOS_COUNTING_NOOP(RSSetViewports, (UINT, const D3D11_VIEWPORT*))
+    HELIOS_COUNTING_NOOP(RSSetScissorRects, (UINT, const D3D11_RECT*))
+    HELIOS_COUNTING_NOOP(RSGetState, (ID3D11RasterizerState**))
+    HELIOS_COUNTING_NOOP(RSGetViewports, (UINT*, D3D11_VIEWPORT*))
+    HELIOS_COUNTING_NOOP(RSGetScissorRects, (UINT*, D3D11_RECT*))
+    HELIOS_COUNTING_NOOP(CopySubresourceRegion, (ID3D11Resource*, UINT, UINT, UINT, UINT, ID3D11Resource*, UINT, const D3D11_BOX*))
+    HELIOS_COUNTING_NOOP(CopyResource, (ID3D11Resource*, ID3D11Resource*))
+    HELIOS_COUNTING_NOOP(CopyStructureCount, (ID3D11Buffer*, UINT, ID3D11UnorderedAccessView*))
+    HELIOS_COUNTING_NOOP(ClearRenderTargetView, (ID3D11RenderTargetView*, const FLOAT*))
+    HELIOS_COUNTING_NOOP(ClearUnorderedAccessViewUint, (ID3D11UnorderedAccessView*, const UINT*))
+    HELIOS_COUNTING_NOOP(ClearUnorderedAccessViewFloat, (ID3D11UnorderedAccessView*, const FLOAT*))
+    HELIOS_COUNTING_NOOP(ClearDepthStencilView, (ID3D11DepthStencilView*, UINT, FLOAT, UINT8))
+    HELIOS_COUNTING_NOOP(GenerateMips, (ID3D11ShaderResourceView*))
+    HELIOS_COUNTING_NOOP(SetResourceMinLOD, (ID3D11Resource*, FLOAT))
+    HELIOS_COUNTING_RETURN(FLOAT, GetResourceMinLOD, (ID3D11Resource*), 0.0f)
+    HELIOS_COUNTING_NOOP(ResolveSubresource, (ID3D11Resource*, UINT, ID3D11Resource*, UINT, DXGI_FORMAT))
+    HELIOS_COUNTING_NOOP(ExecuteCommandList, (ID3D11CommandList*, BOOL))
+    HELIOS_COUNTING_NOOP(ClearState, ())
+    HELIOS_COUNTING_NOOP(Flush, ())
+    HELIOS_COUNTING_RETURN(D3D11_DEVICE_CONTEXT_TYPE, GetType, (), D3D11_DEVICE_CONTEXT_IMMEDIATE)
+    HELIOS_COUNTING_RETURN(UINT, GetContextFlags, (), 0)
+    HELIOS_COUNTING_RETURN(HRESULT, FinishCommandList, (BOOL, ID3D11CommandList**), E_NOTIMPL)
+
+    HELIOS_COUNTING_NOOP(CopySubresourceRegion1, (ID3D11Resource*, UINT, UINT, UINT, UINT, ID3D11Resource*, UINT, const D3D11_BOX*, UINT))
+    HELIOS_COUNTING_NOOP(UpdateSubresource1, (ID3D11Resource*, UINT, const D3D11_BOX*, const void*, UINT, UINT, UINT))
+    HELIOS_COUNTING_NOOP(DiscardResource, (ID3D11Resource*))
+    HELIOS_COUNTING_NOOP(DiscardView, (ID3D11View*))
+    HELIOS_COUNTING_NOOP(SwapDeviceContextState, (ID3DDeviceContextState*, ID3DDeviceContextState**))
+    HELIOS_COUNTING_NOOP(ClearView, (ID3D11View*, const FLOAT*, const D3D11_RECT*, UINT))
+    HELIOS_COUNTING_NOOP(DiscardView1, (ID3D11View*, const D3D11_RECT*, UINT))
+
+private:
+    /** @brief Lo enlazado en un slot de constantes del VS. */
+    struct ConstantBinding {
+        CountingBuffer* buffer = nullptr;
+        UINT            firstConstant = 0;
+        UINT            numConstants = 0;  // 0 = buffer entero
+    };
+
+    bool                m_constantBufferOffsets;
+    ULONG               m_refCount = 1;
+    CountingDeviceStats m_stats;
+    ConstantBinding     m_vsConstants[kConstantSlots];
+};
+
+#undef HELIOS_COUNTING_STAGE
+#undef HELIOS_COUNTING_DEVICE_CHILD
+#undef HELIOS_COUNTING_UNKNOWN
+#undef HELIOS_COUNTING_RETURN
+#undef HELIOS_COUNTING_NOOP
@@ -1,5 +1,6 @@
 ﻿#pragma once
 #include "Prerequisites.h"
+#include <d3d11_1.h>
 
 /**
  * @file DeviceContext.h
@@ -11,11 +12,30 @@
  * (rasterizer/blend) y para emitir draw calls indexadas.
  */
 
+/**
+ * @struct DeviceContextStats
+ * @brief Llamadas de estado recibidas por el wrapper frente a las que llegaron a D3D.
+ */
+struct DeviceContextStats {
+    unsigned int requested = 0;  // Llamadas Set* recibidas
+    unsigned int issued = 0;     // Llamadas Set* emitidas a ID3D11DeviceContext
+
+    /** @brief Llamadas evitadas (redundantes o agrupadas en un mismo rango). */
+    unsigned int
+        filtered() const { return requested > issued ? requested - issued : 0; }
+};
+
  /**
   * @brief Encapsula el contexto de dispositivo de DirectX 11.
   *
   * La clase DeviceContext se encarga de administrar los estados,
   * buffers, shaders y recursos asociados al pipeline de renderizado.
+  *
+  * Guarda una copia (shadow state) de lo enlazado y descarta las llamadas Set* que no cambian
+  * nada. Los enlaces por slot (VB, CBs, SRVs y samplers) se difieren hasta el siguiente draw y
+  * se emiten como una sola llamada por rango de slots modificados. Como D3D no retiene los
+  * objetos diferidos hasta ese draw, deben seguir vivos hasta entonces. Si alguien cambia el
+  * estado sin pasar por el wrapper, debe llamar a @c invalidateState.
   */
 class
     DeviceContext {
@@ -148,6 +168,36 @@ public:
             unsigned int SrcRowPitch,
             unsigned int SrcDepthPitch);
 
+    /**
+     * @brief Mapea un recurso para escribirlo (o leerlo) desde CPU.
+     *
+     * @param pResource Recurso a mapear (p. ej. un buffer con D3D11_USAGE_DYNAMIC).
+     * @param Subresource Subrecurso a mapear.
+     * @param MapType Tipo de acceso (p. ej. D3D11_MAP_WRITE_DISCARD).
+     * @param MapFlags Banderas adicionales (normalmente 0).
+     * @param pMappedResource Recibe el puntero a los datos y sus pitches.
+     * @return S_OK si el mapeo fue exitoso.
+     *
+     * @see ID3D11DeviceContext::Map
+     */
+    HRESULT
+        Map(ID3D11Resource* pResource,
+            unsigned int Subresource,
+            D3D11_MAP MapType,
+            unsigned int MapFlags,
+            D3D11_MAPPED_SUBRESOURCE* pMappedResource);
+
+    /**
+     * @brief Libera el mapeo de un recurso mapeado con @c Map.
+     *
+     * @param pResource Recurso mapeado.
+     * @param Subresource Subrecurso mapeado.
+     *
+     * @see ID3D11DeviceContext::Unmap
+     */
+    void
+        Unmap(ID3D11Resource* pResource, unsigned int Subresource);
+
     /**
      * @brief Limpia un render target con un color específico (OM).
      *
@@ -220,6 +270,44 @@ public:
             UINT NumBuffers,
             ID3D11Buffer* const* ppConstantBuffers);
 
+    /**
+     * @brief @c true si el runtime permite enlazar un rango de un constant buffer (D3D11.1).
+     *
+     * La primera llamada obtiene el @c ID3D11DeviceContext1.
+     */
+    bool
+        supportsConstantBufferOffsets();
+
+    /**
+     * @brief Enlaza un rango de cada constant buffer al VS (D3D11.1).
+     *
+     * No se difiere ni se filtra: el mismo buffer con otro rango es otro enlace. Los slots
+     * afectados dejan de estar en el shadow state hasta el siguiente enlace completo.
+     * @param StartSlot Slot inicial.
+     * @param NumBuffers Número de buffers.
+     * @param ppConstantBuffers Array de buffers constantes.
+     * @param pFirstConstant Primera constante (16 bytes) de cada rango; múltiplo de 16.
+     * @param pNumConstants Constantes de cada rango; múltiplo de 16.
+     */
+    void
+        VSSetConstantBuffers1(UINT StartSlot,
+            UINT NumBuffers,
+            ID3D11Buffer* const* ppConstantBuffers,
+            const UINT* pFirstConstant,
+            const UINT* pNumConstants);
+
+    /**
+     * @brief Enlaza un rango de cada constant buffer al PS (D3D11.1).
+     *
+     * @see VSSetConstantBuffers1
+     */
+    void
+        PSSetConstantBuffers1(UINT StartSlot,
+            UINT NumBuffers,
+            ID3D11Buffer* const* ppConstantBuffers,
+            const UINT* pFirstConstant,
+            const UINT* pNumConstants);
+
     /**
      * @brief Asigna recursos de textura a la etapa de pixel shader (PS).
      *
@@ -258,6 +346,24 @@ public:
             UINT StartIndexLocation,
             INT BaseVertexLocation);
 
+    /**
+     * @brief Dibuja varias instancias de primitivas indexadas.
+     *
+     * @param IndexCountPerInstance Número de índices por instancia.
+     * @param InstanceCount Número de instancias.
+     * @param StartIndexLocation Índice inicial.
+     * @param BaseVertexLocation Desplazamiento base de vértices.
+     * @param StartInstanceLocation Primera instancia leída de los streams por instancia.
+     *
+     * @see ID3D11DeviceContext::DrawIndexedInstanced
+     */
+    void
+        DrawIndexedInstanced(UINT IndexCountPerInstance,
+            UINT InstanceCount,
+            UINT StartIndexLocation,
+            INT BaseVertexLocation,
+            UINT StartInstanceLocation);
+
     /**
      * @brief Establece el estado del rasterizador (RS).
      *
@@ -278,6 +384,171 @@ public:
             const float BlendFactor[4],
             unsigned int SampleMask);
 
+    /**
+     * @brief Devuelve el pipeline a su estado por defecto (todo desenlazado).
+     *
+     * El shadow state pasa a reflejar ese estado por defecto y se descartan los enlaces pendientes.
+     *
+     * @see ID3D11DeviceContext::ClearState
+     */
+    void
+        ClearState();
+
+    /**
+     * @brief Olvida el shadow state: la siguiente llamada de cada tipo se emite siempre.
+     *
+     * Para cuando se cambió el estado directamente sobre @c m_deviceContext.
+     */
+    void
+        invalidateState();
+
+    /** @brief Contadores desde el último @c resetStats. */
+    const DeviceContextStats&
+        getStats() const { return m_stats; }
+
+    /** @brief Pone los contadores a cero (p. ej. al empezar cada frame). */
+    void
+        resetStats() { m_stats = DeviceContextStats(); }
+
+private:
+    /**
+     * @brief Slots enlazados de una etapa y rango pendiente de emitir.
+     */
+    template <typename T, unsigned int N>
+    struct SlotCache {
+        T*           slots[N] = {};
+        unsigned int known = 0;        // Bit i: slots[i] coincide con lo enlazado en D3D
+        unsigned int dirtyBegin = N;   // Rango pendiente [dirtyBegin, dirtyEnd)
+        unsigned int dirtyEnd = 0;
+
+        /** @brief Copia los valores; devuelve si alguno cambió y amplía el rango pendiente. */
+        bool
+            set(unsigned int start, unsigned int count, T* const* values) {
+            bool changed = false;
+            for (unsigned int i = 0; i < count; ++i) {
+                const unsigned int slot = start + i;
+                if ((known & (1u << slot)) && slots[slot] == values[i]) continue;
+                slots[slot] = values[i];
+                known |= 1u << slot;
+                dirtyBegin = slot < dirtyBegin ? slot : dirtyBegin;
+                dirtyEnd = slot + 1 > dirtyEnd ? slot + 1 : dirtyEnd;
+                changed = true;
+            }
+            return changed;
+        }
+
+        bool dirty() const { return dirtyBegin < dirtyEnd; }
+        void clean() { dirtyBegin = N; dirtyEnd = 0; }
+
+        /** @brief Marca como desconocidos los slots seguidos de [start, start + count). */
+        void
+            forget(unsigned int start, unsigned int count) {
+            for (unsigned int slot = start; slot < start + count && slot < N; ++slot) known &= ~(1u << slot);
+        }
+
+        /**
+         * @brief Llama a @p emit(inicio, cantidad) por cada tramo de slots conocidos del rango
+         *        pendiente y lo limpia.
+         *
+         * Los slots desconocidos entre dos cambios no se reenvían: su valor guardado no es el
+         * de D3D (p. ej. un enlace con offset de @c VSSetConstantBuffers1) y se pisaría.
+         * @return Llamadas emitidas.
+         */
+        template <class Emit>
+        unsigned int
+            flush(Emit&& emit) {
+            unsigned int calls = 0;
+            unsigned int slot = dirtyBegin;
+            while (slot < dirtyEnd) {
+                if (!(known & (1u << slot))) {
+                    ++slot;
+                    continue;
+                }
+                const unsigned int begin = slot;
+                while (slot < dirtyEnd && (known & (1u << slot))) ++slot;
+                emit(begin, slot - begin);
+                ++calls;
+            }
+            clean();
+            return calls;
+        }
+
+        /** @brief Todos los slots a nulo (@p known = estado por defecto conocido) o desconocidos. */
+        void
+            reset(bool isKnown) {
+            for (unsigned int i = 0; i < N; ++i) slots[i] = nullptr;
+            known = isKnown ? ~0u : 0u;
+            clean();
+        }
+    };
+
+    /** @brief Slots de cada etapa que sigue el shadow state (los demás van directos a D3D). */
+    static const unsigned int kVertexBufferSlots = 16;
+    static const unsigned int kConstantBufferSlots = 14;
+    static const unsigned int kShaderResourceSlots = 16;
+    static const unsigned int kSamplerSlots = 16;
+    static const unsigned int kMaxViewports = 16;
+    static const unsigned int kMaxRenderTargets = 8;
+
+    /**
+     * @brief Shadow state del pipeline.
+     *
+     * Los @c known* indican si el valor guardado refleja D3D; si no, se emite sin comparar.
+     */
+    struct ShadowState {
+        SlotCache<ID3D11Buffer, kVertexBufferSlots>               vertexBuffers;
+        unsigned int                                              strides[kVertexBufferSlots] = {};
+        unsigned int                                              offsets[kVertexBufferSlots] = {};
+        SlotCache<ID3D11Buffer, kConstantBufferSlots>             vsConstantBuffers;
+        SlotCache<ID3D11Buffer, kConstantBufferSlots>             psConstantBuffers;
+        SlotCache<ID3D11ShaderResourceView, kShaderResourceSlots> psShaderResources;
+        SlotCache<ID3D11SamplerState, kSamplerSlots>              psSamplers;
+
+        bool                     knownInputLayout = false;
+        ID3D11InputLayout*       inputLayout = nullptr;
+        bool                     knownTopology = false;
+        D3D11_PRIMITIVE_TOPOLOGY topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+        bool                     knownIndexBuffer = false;
+        ID3D11Buffer*            indexBuffer = nullptr;
+        DXGI_FORMAT              indexFormat = DXGI_FORMAT_UNKNOWN;
+        unsigned int             indexOffset = 0;
+        bool                     knownVertexShader = false;
+        ID3D11VertexShader*      vertexShader = nullptr;
+        bool                     knownPixelShader = false;
+        ID3D11PixelShader*       pixelShader = nullptr;
+        bool                     knownViewports = false;
+        unsigned int             viewportCount = 0;
+        D3D11_VIEWPORT           viewports[kMaxViewports] = {};
+        bool                     knownRasterizer = false;
+        ID3D11RasterizerState*   rasterizerState = nullptr;
+        bool                     knownBlend = false;
+        ID3D11BlendState*        blendState = nullptr;
+        float                    blendFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        unsigned int             sampleMask = 0xffffffff;
+        bool                     knownRenderTargets = false;
+        unsigned int             renderTargetCount = 0;
+        ID3D11RenderTargetView*  renderTargets[kMaxRenderTargets] = {};
+        ID3D11DepthStencilView*  depthStencilView = nullptr;
+    };
+
+    /**
+     * @brief Emite los enlaces por slot pendientes antes de un draw: una llamada por etapa y
+     *        tramo de slots conocidos.
+     */
+    void
+        flushBindings();
+
+    /**
+     * @brief Shadow state con el valor por defecto de D3D (@p known) o desconocido.
+     */
+    void
+        resetShadow(bool known);
+
+    ShadowState           m_shadow;
+    DeviceContextStats    m_stats;
+    ID3D11DeviceContext1* m_deviceContext1 = nullptr;  // Sólo si el runtime es D3D11.1
+    bool                  m_queriedContext1 = false;
+
 public:
     /** @brief Puntero al contexto de dispositivo de DirectX subyacente. */
     ID3D11DeviceContext* m_deviceContext = nullptr; /**< Puntero al contexto de dispositivo de DirectX. */
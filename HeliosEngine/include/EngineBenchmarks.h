@@ -0,0 +1,240 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @file EngineBenchmarks.h
+ * @brief Benchmarks de los subsistemas de CPU del engine.
+ *
+ * No requieren dispositivo D3D: generan datos sintéticos, miden con
+ * QueryPerformanceCounter y reportan por la ventana de depuración.
+ */
+
+/**
+ * @struct BenchmarkResult
+ * @brief Resultado de una medición: tiempo total y throughput en la unidad indicada.
+ */
+struct BenchmarkResult {
+    /** @brief Nombre del caso medido. */
+    std::string name;
+
+    /** @brief Tiempo de pared en segundos. */
+    double      seconds = 0.0;
+
+    /** @brief Trabajo por segundo, expresado en @c unit. */
+    double      throughput = 0.0;
+
+    /** @brief Unidad del throughput (p. ej. "MB/s"). */
+    std::string unit;
+};
+
+/**
+ * @class EngineBenchmarks
+ * @brief Colección de benchmarks reproducibles del engine.
+ */
+class
+    EngineBenchmarks {
+public:
+    /**
+     * @brief Escribe un OBJ sintético (malla en rejilla con v/vt/vn) con @p faceCount triángulos.
+     * @param path      Ruta de salida.
+     * @param faceCount Número aproximado de caras triangulares.
+     * @return @c true si el archivo se escribió completo.
+     */
+    static bool
+        WriteSyntheticOBJ(const std::string& path, size_t faceCount);
+
+    /**
+     * @brief Mide el throughput de @c OBJParser::LoadOBJ en MB/s.
+     * @param scratchPath Ruta temporal donde se genera el OBJ sintético.
+     * @param faceCount   Número de caras (p. ej. 1'000'000).
+     * @param threadCount Hilos del parser (0 = automático, 1 = serial).
+     */
+    static BenchmarkResult
+        OBJThroughput(const std::string& scratchPath, size_t faceCount = 1000000,
+            unsigned int threadCount = 0);
+
+    /**
+     * @brief Compara la deduplicación de vértices con @c std::map frente a @c VertexIndexTable.
+     * @param cornerCount Número de esquinas de triángulo (p. ej. 10'000'000).
+     * @return Dos resultados (map, tabla plana) en esquinas por segundo.
+     */
+    static std::vector<BenchmarkResult>
+        VertexDedup(size_t cornerCount = 10000000);
+
+    /**
+     * @brief Mide @c MeshOptimizer::Optimize sobre una rejilla con triángulos barajados.
+     *
+     * El nombre del resultado incluye el ACMR/ATVR simulado antes y después.
+     * @param triangleCount Número de triángulos (p. ej. 1'000'000).
+     * @param cacheSize     Tamaño de la caché FIFO simulada.
+     * @return Throughput en millones de triángulos por segundo.
+     */
+    static BenchmarkResult
+        VertexCacheOptimization(size_t triangleCount = 1000000, unsigned int cacheSize = 16);
+
+    /**
+     * @brief Mide la construcción de @c MeshBVH y el throughput de rayos.
+     *
+     * Usa @p objPath si se indica (p. ej. Assets/Moto/repsol3.obj); si no, una rejilla
+     * ondulada de @p triangleCount triángulos. Los rayos van de una esfera que rodea la malla
+     * a puntos de su AABB; una muestra se compara contra fuerza bruta y las discrepancias
+     * se reportan en el nombre del resultado.
+     * @return Construcción serial y paralela (Mtris/s); raycast con 1 y N hilos,
+     *         segmentOccluded y fuerza bruta (Mrays/s).
+     */
+    static std::vector<BenchmarkResult>
+        BVHQueries(const std::string& objPath = std::string(), size_t triangleCount = 1000000,
+            size_t rayCount = 1000000);
+
+    /**
+     * @brief Mide @c Picker::pick sobre una escena de @p meshCount rejillas en cuadrícula.
+     *
+     * Cada pick parte de un píxel aleatorio de un viewport de 1280x720 (unproyección incluida).
+     * El nombre del resultado incluye la latencia media por pick en microsegundos.
+     * @param triangleCount Triángulos totales de la escena (p. ej. 1'000'000).
+     * @param meshCount     Mallas (cada una con su BVH y su World).
+     * @param pickCount     Picks a medir.
+     * @return Throughput en miles de picks por segundo.
+     */
+    static BenchmarkResult
+        Picking(size_t triangleCount = 1000000, unsigned int meshCount = 16, size_t pickCount = 10000);
+
+    /**
+     * @brief Compara los kernels de @c BoundingVolumes con sus equivalentes escalares.
+     *
+     * Nube de @p vertexCount @c SimpleVertex en una caja alargada y rotada, recorrida
+     * @p passes veces. Los nombres incluyen el radio de cada esfera y el volumen de la OBB
+     * relativo al AABB.
+     * @return AABB escalar y SSE, esfera de Ritter escalar y EPOS SSE, OBB PCA (Mverts/s).
+     */
+    static std::vector<BenchmarkResult>
+        BoundsComputation(size_t vertexCount = 1000000, unsigned int passes = 16);
+
+    /**
+     * @brief Compara la generación de normales y tangentes serial y multihilo.
+     *
+     * Rejilla ondulada de @p triangleCount triángulos: el scatter-add serial que usaba el
+     * cargador de OBJ frente a @c MeshNormals con 1 y con @p threadCount hilos.
+     * @param threadCount Hilos de la versión paralela (0 = todos los núcleos).
+     * @return Una entrada por variante (Mtris/s).
+     */
+    static std::vector<BenchmarkResult>
+        NormalGeneration(size_t triangleCount = 10000000, unsigned int threadCount = 0);
+
+    /**
+     * @brief Mide @c StaticBatcher sobre una cuadrícula de props pequeños.
+     *
+     * Los nombres incluyen draw calls, binds de VB/IB y cambios de material sin y con
+     * batching, para la escena completa y para lo visible desde una cámara a ras del suelo.
+     * @param propCount        Instancias estáticas.
+     * @param trianglesPerProp Triángulos de cada prop.
+     * @param materialCount    Mallas/materiales distintos que alternan las instancias.
+     * @return Construcción (Mtris/s) y culling por frame (Mobjs/s).
+     */
+    static std::vector<BenchmarkResult>
+        StaticBatching(unsigned int propCount = 4096, size_t trianglesPerProp = 256, unsigned int materialCount = 8);
+
+    /**
+     * @brief Mide el empaquetado por frame de @c InstanceList (culling + escritura del stream).
+     *
+     * Los nombres incluyen draw calls y actualizaciones de constant buffer con un draw por
+     * copia frente a un @c DrawIndexedInstanced por rango de índices.
+     * @param instanceCount Copias de la malla, en cuadrícula.
+     * @param subsetCount   Rangos de índices (subsets) de la malla.
+     * @return Escena completa y vista parcial (Minst/s).
+     */
+    static std::vector<BenchmarkResult>
+        Instancing(unsigned int instanceCount = 10000, unsigned int subsetCount = 4);
+
+    /**
+     * @brief Mide @c FrustumCuller sobre objetos aleatorios alrededor de la cámara (sin D3D).
+     * @param objectCount Esferas/AABBs.
+     * @param threadCount Hilos de la pasada multihilo (0 = automático).
+     * @return Escalar, SSE con 1 hilo y SSE multihilo (Mobjs/s).
+     */
+    static std::vector<BenchmarkResult>
+        FrustumCulling(size_t objectCount = 1000000, unsigned int threadCount = 0);
+
+    /**
+     * @brief Estrés de @c SceneOctree con objetos que se mueven cada frame.
+     *
+     * Mide inserción, movimiento de todos los objetos, culling jerárquico (comparado con el
+     * culling plano de @c FrustumCuller sobre los mismos AABBs) y consultas de esfera y rayo.
+     * @param objectCount Objetos en movimiento.
+     * @param frames      Frames simulados.
+     * @return Un resultado por operación (Mops/s).
+     */
+    static std::vector<BenchmarkResult>
+        ScenePartition(unsigned int objectCount = 100000, unsigned int frames = 10);
+
+    /**
+     * @brief Mide @c RenderQueue con packets aleatorios (sin D3D: sólo cuenta cambios de estado).
+     *
+     * Los nombres incluyen los cambios de shader, material y buffers por frame en orden de
+     * envío frente a orden de clave.
+     * @param packetCount   Draws por frame.
+     * @param shaderCount   Shaders distintos.
+     * @param materialCount Materiales (texturas) distintos.
+     * @param meshCount     Mallas (pares VB/IB) distintas; la malla m usa el material m % materialCount.
+     * @return Envío + orden por frame y recorrido de la cola ordenada (Mpackets/s).
+     *         Los packets se crean una vez; cada frame sólo se reenvían con su clave.
+     */
+    static std::vector<BenchmarkResult>
+        RenderQueueSort(unsigned int packetCount = 100000, unsigned int shaderCount = 8,
+            unsigned int materialCount = 64, unsigned int meshCount = 256);
+
+    /**
+     * @brief Escalado del @c JobSystem de 1 a @p maxThreads hilos.
+     *
+     * Cada paso crea un sistema propio con t hilos y mide un @c parallelFor con trabajo de
+     * coma flotante por elemento; el nombre incluye la aceleración frente a 1 hilo. Al final
+     * mide el coste de lanzar y esperar tareas vacías con todos los hilos.
+     * @param itemCount  Elementos del @c parallelFor.
+     * @param maxThreads Hilos del último paso (0 = núcleos de la máquina).
+     * @param jobCount   Tareas vacías de la prueba de lanzamiento.
+     * @return Un resultado por cantidad de hilos (Mitems/s) y el de lanzamiento (Mjobs/s).
+     */
+    static std::vector<BenchmarkResult>
+        JobScaling(size_t itemCount = 4000000, unsigned int maxThreads = 0, unsigned int jobCount = 200000);
+
+    /**
+     * @brief Estrés multihilo de @c HandleTable: asigna, valida y libera handles sin parar.
+     *
+     * Cada hilo mantiene una ventana de handles vivos y reemplaza uno por iteración, así que
+     * los índices se reciclan constantemente entre hilos. Tras cada operación comprueba que el
+     * handle nuevo resuelve a su puntero y que el liberado ya no valida; el nombre incluye los
+     * errores encontrados (deben ser 0).
+     * @param threadCount      Hilos (0 = máx(4, núcleos), para forzar contención).
+     * @param handlesPerThread Handles creados y destruidos por hilo.
+     * @param window           Handles vivos por hilo.
+     * @return Asignación + liberación (Mhandles/s).
+     */
+    static BenchmarkResult
+        HandleTableStress(unsigned int threadCount = 0, size_t handlesPerThread = 2000000,
+            unsigned int window = 256);
+
+    /**
+     * @brief Comprueba el tráfico de @c ConstantBufferManager sobre un dispositivo falso.
+     *
+     * Usa @c CountingDevice (sin GPU) con y sin D3D11.1. Cada frame actualiza tres bloques
+     * (sólo el del objeto cambia tras el primero) y asigna en el ring las constantes de
+     * @p drawsPerFrame draws; luego enlaza cada una y dibuja. Comprueba que los bytes subidos
+     * por frame coinciden con los esperados y con las estadísticas del manager, que cada draw ve
+     * sus constantes, que el ring se mapea una vez por frame y da la vuelta con DISCARD sólo
+     * cuando se llena (NO_OVERWRITE el resto) sin pisar datos del tramo vigente. El nombre
+     * incluye los errores encontrados (deben ser 0).
+     * @param frames        Frames simulados.
+     * @param drawsPerFrame Draws por frame.
+     * @param ringBytes     Capacidad pedida para el ring.
+     * @return Con ring D3D11.1 y sin él (Mdraws/s).
+     */
+    static std::vector<BenchmarkResult>
+        ConstantUploads(unsigned int frames = 64, unsigned int drawsPerFrame = 100,
+            unsigned int ringBytes = 65536);
+
+    /**
+     * @brief Envía el resultado a la ventana de depuración.
+     */
+    static void
+        Report(const BenchmarkResult& result);
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include "BoundingVolumes.h"
+
+/**
+ * @file Frustum.h
+ * @brief Planos de un frustum de vista para pruebas de visibilidad en CPU.
+ */
+
+/**
+ * @class Frustum
+ * @brief Seis planos (izquierda, derecha, abajo, arriba, cerca, lejos) extraídos de una matriz.
+ *
+ * Cada plano se guarda normalizado como (n.x, n.y, n.z, d): un punto p está dentro si
+ * dot(n, p) + d >= 0. Si la matriz es World * View * Projection los planos quedan en el
+ * espacio objeto de la malla, así sus cotas se prueban sin transformarlas.
+ */
+class
+    Frustum {
+public:
+    /** @brief Cantidad de planos. */
+    static const int kPlaneCount = 6;
+
+    Frustum() = default;
+
+    /**
+     * @brief Extrae los planos de una matriz de proyección combinada (convención D3D, z en [0,1]).
+     * @param viewProjection Matriz que lleva el espacio de interés a clip space (vector fila).
+     */
+    void
+        init(const XMMATRIX& viewProjection);
+
+    /**
+     * @brief Prueba conservadora de una esfera.
+     * @return @c false sólo si la esfera queda por completo fuera de algún plano.
+     */
+    bool
+        intersectsSphere(const XMFLOAT3& center, float radius) const;
+
+    /**
+     * @brief Prueba conservadora de un AABB (vértice positivo de cada plano).
+     */
+    bool
+        intersectsAABB(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) const;
+
+    /**
+     * @brief Prueba conservadora de una caja orientada (radio proyectado sobre cada normal).
+     */
+    bool
+        intersectsOBB(const OrientedBox& box) const;
+
+public:
+    /** @brief Planos normalizados (ver descripción de la clase). */
+    XMFLOAT4 m_planes[kPlaneCount];
+};
@@ -0,0 +1,128 @@
+#pragma once
+#include "Prerequisites.h"
+#include "BoundingVolumes.h"
+#include "Frustum.h"
+
+/**
+ * @file FrustumCuller.h
+ * @brief Culling de frustum en SoA con SSE2 sobre conjuntos grandes de esferas y AABBs.
+ */
+
+/**
+ * @class CullingBounds
+ * @brief Esferas y AABBs de muchos objetos en estructura de arreglos (SoA).
+ *
+ * Cada componente vive en su propio arreglo para que @c FrustumCuller pruebe 4 objetos por
+ * instrucción sin reordenar datos. El AABB se guarda como centro y semiextensión. Los arreglos
+ * se rellenan hasta múltiplo de 4; modificarlos sólo con los métodos de la clase.
+ */
+class
+    CullingBounds {
+public:
+    CullingBounds() = default;
+
+    /**
+     * @brief Añade un objeto con esfera y AABB.
+     * @return Índice del objeto.
+     */
+    unsigned int
+        add(const BoundingSphere& sphere, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+
+    /**
+     * @brief Añade un objeto sólo con esfera (su AABB es el cubo que la contiene).
+     */
+    unsigned int
+        add(const BoundingSphere& sphere);
+
+    /**
+     * @brief Reemplaza las cotas de un objeto.
+     */
+    void
+        set(unsigned int object, const BoundingSphere& sphere, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+
+    /**
+     * @brief Reemplaza la esfera de un objeto (y su AABB por el cubo que la contiene).
+     */
+    void
+        set(unsigned int object, const BoundingSphere& sphere);
+
+    /**
+     * @brief Reserva espacio para @p count objetos.
+     */
+    void
+        reserve(size_t count);
+
+    /**
+     * @brief Elimina todos los objetos.
+     */
+    void
+        clear();
+
+    /**
+     * @brief Esfera de un objeto.
+     */
+    BoundingSphere
+        getSphere(unsigned int object) const;
+
+    /** @brief Número de objetos. */
+    size_t size() const { return m_count; }
+
+    /** @brief Tamaño de los arreglos (múltiplo de 4). */
+    size_t paddedSize() const { return m_radius.size(); }
+
+public:
+    // Esferas
+    std::vector<float> m_centerX, m_centerY, m_centerZ, m_radius;
+    // AABBs (centro y semiextensión)
+    std::vector<float> m_boxX, m_boxY, m_boxZ, m_extentX, m_extentY, m_extentZ;
+
+private:
+    void
+        resizePadded(size_t count);
+
+    size_t m_count = 0;
+};
+
+/**
+ * @enum CullTest
+ * @brief Volúmenes que se prueban contra el frustum.
+ */
+enum class CullTest {
+    Sphere,         // Sólo la esfera (6 planos, el más barato)
+    AABB,           // Sólo el AABB (centro + semiextensión proyectada sobre la normal)
+    SphereAndAABB   // Visible sólo si pasan las dos pruebas
+};
+
+/**
+ * @class FrustumCuller
+ * @brief Prueba un @c CullingBounds contra un @c Frustum y compacta los índices visibles.
+ *
+ * Cada plano se difunde a registros SSE y se prueban 4 objetos por iteración. La máscara de
+ * visibles se compacta con una tabla de 16 permutaciones: se escriben siempre 4 índices y se
+ * avanza por la cantidad de visibles, sin saltos por objeto. Los conjuntos grandes se reparten
+ * en rangos contiguos entre hilos; cada hilo compacta sobre su propio rango de la salida y al
+ * final los rangos se juntan, de modo que el resultado queda en orden creciente.
+ */
+class
+    FrustumCuller {
+public:
+    /**
+     * @brief Índices de los objetos visibles.
+     * @param frustum     Frustum en el espacio de las cotas (p. ej. View * Projection).
+     * @param bounds      Cotas de los objetos.
+     * @param test        Volúmenes a probar.
+     * @param outVisible  Índices visibles en orden creciente (se redimensiona).
+     * @param threadCount Hilos (0 = automático, 1 = serial).
+     * @return Cantidad de visibles.
+     */
+    static size_t
+        Cull(const Frustum& frustum, const CullingBounds& bounds, CullTest test,
+            std::vector<unsigned int>& outVisible, unsigned int threadCount = 0);
+
+    /**
+     * @brief Referencia escalar con @c Frustum::intersectsSphere / @c intersectsAABB.
+     */
+    static size_t
+        CullScalar(const Frustum& frustum, const CullingBounds& bounds, CullTest test,
+            std::vector<unsigned int>& outVisible);
+};
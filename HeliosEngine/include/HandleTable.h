@@ -0,0 +1,125 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+/**
+ * @file HandleTable.h
+ * @brief Tabla de handles (índice + generación) con asignación y liberación sin bloqueo.
+ */
+
+/**
+ * @struct Handle
+ * @brief Índice de 32 bits en una @c HandleTable y la generación con la que se asignó.
+ *
+ * Las generaciones vivas son impares: un handle con generación 0 nunca es válido.
+ */
+struct Handle {
+    uint32_t index = 0;
+    uint32_t generation = 0;
+
+    bool valid() const { return generation != 0; }
+
+    /** @brief Handle empaquetado en 64 bits (generación en la parte alta). */
+    uint64_t toU64() const { return (uint64_t(generation) << 32) | index; }
+
+    static Handle FromU64(uint64_t value) { return Handle{ uint32_t(value), uint32_t(value >> 32) }; }
+
+    bool operator==(const Handle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const Handle& o) const { return !(*this == o); }
+};
+
+/**
+ * @class HandleTable
+ * @brief Asocia handles a punteros; cualquier hilo puede asignar, liberar y consultar.
+ *
+ * Las entradas viven en bloques de @c kChunkSize que se crean al llegar a ellos y no se mueven
+ * nunca, así que validar y consultar es O(1) sin bloqueo: bloque, entrada y comparación de
+ * generación. Cada entrada guarda una generación que sube al asignarla (queda impar) y al
+ * liberarla (queda par); un handle viejo deja de validar en cuanto su entrada se libera, aunque
+ * el índice se vuelva a usar. Los índices libres forman una pila sin bloqueo (Treiber) con una
+ * etiqueta de 32 bits en la cabeza contra el problema ABA; si está vacía se toma el siguiente
+ * índice nunca usado.
+ */
+class
+    HandleTable {
+public:
+    /** @brief Entradas por bloque. */
+    static const uint32_t kChunkSize = 4096;
+
+    /**
+     * @param maxHandles Handles vivos como máximo; se redondea a bloques enteros.
+     */
+    explicit HandleTable(uint32_t maxHandles = 1u << 22);
+    HandleTable(const HandleTable&) = delete;
+    HandleTable& operator=(const HandleTable&) = delete;
+    ~HandleTable();
+
+    /**
+     * @brief Asigna un handle que apunta a @p value.
+     * @return Handle nuevo; inválido si la tabla está llena.
+     */
+    Handle
+        allocate(void* value);
+
+    /**
+     * @brief Libera el handle; su índice se reutiliza con otra generación.
+     * @return @c false si ya no era válido (liberado dos veces o viejo).
+     */
+    bool
+        release(Handle handle);
+
+    /** @brief @c true si el handle sigue asignado. */
+    bool
+        isValid(Handle handle) const;
+
+    /**
+     * @brief Puntero del handle; nullptr si no es válido.
+     *
+     * Si otro hilo libera el handle a la vez, devuelve el puntero anterior o nullptr, nunca el
+     * de la asignación siguiente.
+     */
+    void*
+        get(Handle handle) const;
+
+    /** @brief @c get con el tipo del puntero. */
+    template <typename T>
+    T*
+        get(Handle handle) const { return static_cast<T*>(get(handle)); }
+
+    /**
+     * @brief Cambia el puntero de un handle válido (p. ej. al mover el objeto).
+     * @return @c false si el handle no es válido.
+     */
+    bool
+        set(Handle handle, void* value);
+
+    /** @brief Handles asignados en este momento (aproximado si hay otros hilos). */
+    uint32_t
+        size() const { return m_live.load(std::memory_order_relaxed); }
+
+    /** @brief Índices usados alguna vez (las entradas que ocupa la tabla). */
+    uint32_t
+        highWater() const { return std::min(m_next.load(std::memory_order_relaxed), m_capacity); }
+
+private:
+    struct Entry {
+        std::atomic<uint32_t> generation{ 0 };  // Impar = asignada
+        std::atomic<uint32_t> nextFree{ 0 };    // Índice + 1 del siguiente libre (0 = fin)
+        std::atomic<void*>    value{ nullptr };
+    };
+
+    Entry*
+        entry(uint32_t index) const;
+
+    Entry*
+        entryOrCreate(uint32_t index);
+
+    uint32_t                          m_capacity;
+    std::unique_ptr<std::atomic<Entry*>[]> m_chunks;
+    uint32_t                          m_chunkCount;
+    std::atomic<uint32_t>             m_next{ 0 };      // Siguiente índice nunca usado
+    std::atomic<uint64_t>             m_freeHead{ 0 };  // (etiqueta << 32) | (índice + 1)
+    std::atomic<uint32_t>             m_live{ 0 };
+};
@@ -1,5 +1,6 @@
 #pragma once
-#include "Prerequisites.h"
+#include "CorePrerequisites.h"
+#include "HandleTable.h"
 #include <string>
 #include <cstdint> 
 #include <cstddef> 
@@ -34,18 +35,39 @@ public:
         : m_name(name)
         , m_type(type)
         , m_state(ResourceState::Unloaded)
-        , m_id(GenerateID()) {
+        , m_id(Registry().allocate(this)) {
     }
 
-    virtual ~IResource() = default;
+    virtual ~IResource() { Registry().release(m_id); }
 
     // evita duplicar handlers
     IResource(const IResource&) = delete;
     IResource& operator=(const IResource&) = delete;
 
-    // Movible si lo necesitas
-    IResource(IResource&&) = default;
-    IResource& operator=(IResource&&) = default;
+    // Movible si lo necesitas: el ID pasa al objeto nuevo y el registro apunta a l
+    IResource(IResource&& other)
+        : m_name(std::move(other.m_name))
+        , m_filePath(std::move(other.m_filePath))
+        , m_type(other.m_type)
+        , m_state(other.m_state)
+        , m_id(other.m_id) {
+        other.m_id = Handle();
+        Registry().set(m_id, this);
+    }
+
+    IResource& operator=(IResource&& other) {
+        if (this != &other) {
+            Registry().release(m_id);
+            m_name = std::move(other.m_name);
+            m_filePath = std::move(other.m_filePath);
+            m_type = other.m_type;
+            m_state = other.m_state;
+            m_id = other.m_id;
+            other.m_id = Handle();
+            Registry().set(m_id, this);
+        }
+        return *this;
+    }
 
     // ---- API mnima del ciclo de vida ----
     // Crear recursos GPU
@@ -60,12 +82,18 @@ public:
     // Para profiler/estadsticas
     virtual size_t getSizeInBytes() const = 0;
 
+    // Memoria de GPU propia del recurso (0 si sus buffers los crea otro)
+    virtual size_t getGpuSizeInBytes() const { return 0; }
+
     // ---- Getters comunes ----
     const std::string& GetName()   const { return m_name; }
     const std::string& GetPath()   const { return m_filePath; }
     ResourceType       GetType()   const { return m_type; }
     ResourceState      GetState()  const { return m_state; }
-    uint64_t           GetID()     const { return m_id; }
+    Handle             GetID()     const { return m_id; }
+
+    // Recurso vivo con ese ID (O(1), desde cualquier hilo); nullptr si ya se destruy
+    static IResource*  Find(Handle id) { return Registry().get<IResource>(id); }
 
 protected:
     // salos desde las clases derivadas
@@ -78,11 +106,12 @@ protected:
     std::string   m_filePath;   // ruta en disco
     ResourceType  m_type;       // tipo de recurso
     ResourceState m_state;      // estado de carga
-    uint64_t      m_id;         // identificador nico
+    Handle        m_id;         // identificador nico (handle en Registry)
 
 private:
-    static uint64_t GenerateID() {
-        static uint64_t nextID = 1; 
-        return nextID++;
+    // IDs de todos los recursos vivos; se pueden crear y destruir recursos desde cualquier hilo
+    static HandleTable& Registry() {
+        static HandleTable registry;
+        return registry;
     }
 };
@@ -0,0 +1,109 @@
+#pragma once
+#include "Prerequisites.h"
+#include "BoundingVolumes.h"
+#include "FrustumCuller.h"
+
+/**
+ * @file InstanceList.h
+ * @brief Lista de instancias de una malla y empaquetado de las visibles en un stream por instancia.
+ */
+
+/**
+ * @struct InstanceData
+ * @brief Datos de una instancia tal como los lee el vertex shader (64 bytes).
+ *
+ * @c world son las tres primeras columnas de la World (vector fila), es decir, las filas de
+ * su transpuesta: la posición en mundo es (dot(world[0], p), dot(world[1], p), dot(world[2], p))
+ * con p = float4(pos, 1).
+ */
+struct InstanceData {
+    XMFLOAT4 world[3];  // INSTANCE_WORLD0..2
+    XMFLOAT4 color;     // INSTANCE_COLOR
+};
+
+/**
+ * @class InstanceList
+ * @brief Instancias de una misma malla con su World, color y esfera envolvente en mundo.
+ *
+ * Cada frame @c writeVisible prueba las esferas (en SoA, con @c FrustumCuller) contra el frustum
+ * y escribe las instancias
+ * visibles, ya en formato @c InstanceData, directamente en un @c Buffer por instancia mapeado.
+ * Así N copias cuestan un único @c DrawIndexedInstanced por rango de índices en lugar de N
+ * actualizaciones del constant buffer y N draws.
+ */
+class
+    InstanceList {
+public:
+    InstanceList() = default;
+
+    /**
+     * @brief Esfera envolvente de la malla en el espacio al que se aplica cada World.
+     */
+    void
+        setBounds(const BoundingSphere& sphere);
+
+    /**
+     * @brief Transformación previa de los vértices (p. ej. la decuantización de PackedVertex).
+     *
+     * Se antepone a cada World al escribir el stream; no afecta a las cotas.
+     */
+    void
+        setVertexTransform(const XMMATRIX& transform);
+
+    /**
+     * @brief Añade una instancia.
+     * @return Índice de la instancia.
+     */
+    unsigned int
+        add(const XMMATRIX& world, const XMFLOAT4& color = XMFLOAT4(1, 1, 1, 1));
+
+    /**
+     * @brief Cambia la World de una instancia (y recalcula su esfera en mundo).
+     */
+    void
+        setWorld(unsigned int instance, const XMMATRIX& world);
+
+    /**
+     * @brief Elimina todas las instancias.
+     */
+    void
+        clear();
+
+    /**
+     * @brief Escribe en @p dst las instancias cuya esfera toca el frustum, en orden de índice.
+     * @param frustum  Frustum en espacio mundo (View * Projection).
+     * @param dst      Destino (p. ej. @c Buffer::map de un stream por instancia).
+     * @param capacity Instancias que caben en @p dst.
+     * @return Instancias escritas.
+     */
+    size_t
+        writeVisible(const Frustum& frustum, InstanceData* dst, size_t capacity) const;
+
+    /**
+     * @brief Layout de vértices más los elementos por instancia de @c InstanceData.
+     * @param vertexLayout Elementos por vértice (slot 0).
+     * @param slot         Slot del stream por instancia.
+     */
+    static std::vector<D3D11_INPUT_ELEMENT_DESC>
+        AppendInputLayout(std::vector<D3D11_INPUT_ELEMENT_DESC> vertexLayout, unsigned int slot = 1);
+
+    /** @brief Número de instancias. */
+    size_t size() const { return m_worlds.size(); }
+
+    /** @brief World de una instancia. */
+    const XMFLOAT4X4& getWorld(unsigned int instance) const { return m_worlds[instance]; }
+
+    /** @brief Esfera en mundo de una instancia. */
+    BoundingSphere getWorldSphere(unsigned int instance) const { return m_bounds.getSphere(instance); }
+
+private:
+    void
+        updateSphere(unsigned int instance);
+
+    BoundingSphere                    m_localSphere;
+    XMFLOAT4X4                        m_vertexTransform = XMFLOAT4X4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+    std::vector<XMFLOAT4X4>           m_worlds;
+    std::vector<XMFLOAT4>             m_colors;
+    CullingBounds                     m_bounds;   // Esfera de cada instancia en mundo
+    mutable std::vector<unsigned int> m_visible;  // Índices visibles del último writeVisible
+};
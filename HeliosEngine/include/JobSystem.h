@@ -0,0 +1,208 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+/**
+ * @file JobSystem.h
+ * @brief Sistema de tareas con colas Chase-Lev por hilo y robo de trabajo.
+ */
+
+struct Job;
+
+/**
+ * @class JobCounter
+ * @brief Cuenta las tareas pendientes de un grupo; se espera con @c JobSystem::wait.
+ *
+ * También guarda las continuaciones (@c JobSystem::runAfter) que se lanzan cuando llega a
+ * cero. Debe seguir vivo hasta que @c wait vuelva. Se puede reutilizar una vez en cero.
+ */
+class
+    JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /** @brief @c true si no quedan tareas del grupo. */
+    bool
+        done() const { return m_pending.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int>  m_pending{ 0 };
+    std::mutex        m_mutex;          // Protege el paso a cero y las continuaciones
+    std::vector<Job*> m_continuations;
+};
+
+/**
+ * @class JobDeque
+ * @brief Cola de trabajo Chase-Lev: el dueño apila y desapila por abajo (LIFO) y los demás
+ *        hilos roban por arriba (FIFO) sin bloqueo.
+ *
+ * El buffer circular crece al llenarse; los buffers viejos se conservan hasta destruir la cola
+ * porque un ladrón puede estar leyéndolos.
+ */
+class
+    JobDeque {
+public:
+    explicit JobDeque(size_t capacity = 1024);
+    JobDeque(const JobDeque&) = delete;
+    JobDeque& operator=(const JobDeque&) = delete;
+
+    /** @brief Apila una tarea (sólo el hilo dueño). */
+    void
+        push(Job* job);
+
+    /** @brief Desapila la última tarea apilada (sólo el hilo dueño); nullptr si está vacía. */
+    Job*
+        pop();
+
+    /** @brief Roba la tarea más antigua (cualquier hilo); nullptr si está vacía o perdió la carrera. */
+    Job*
+        steal();
+
+    /** @brief Tareas aproximadas en la cola. */
+    size_t
+        size() const;
+
+private:
+    struct Ring {
+        explicit Ring(size_t capacity) : mask(capacity - 1), slots(new std::atomic<Job*>[capacity]) {}
+        size_t                             mask;
+        std::unique_ptr<std::atomic<Job*>[]> slots;
+
+        Job* get(int64_t i) const { return slots[size_t(i) & mask].load(std::memory_order_relaxed); }
+        void put(int64_t i, Job* job) { slots[size_t(i) & mask].store(job, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64_t>               m_top{ 0 };
+    std::atomic<int64_t>               m_bottom{ 0 };
+    std::atomic<Ring*>                 m_ring{ nullptr };
+    std::vector<std::unique_ptr<Ring>> m_rings;  // El actual y los retirados
+};
+
+/**
+ * @class JobSystem
+ * @brief Hilos trabajadores con una @c JobDeque cada uno y robo de trabajo entre ellos.
+ *
+ * El hilo que llama a @c init es el trabajador 0 y sólo ejecuta tareas dentro de @c wait
+ * (espera ayudando), así que con un solo núcleo todo corre en él sin cambiar de hilo. Las
+ * tareas lanzadas desde un trabajador van a su propia cola; las de otros hilos, a una cola
+ * común protegida por mutex. Un trabajador sin tareas desapila la suya, luego la común y luego
+ * roba a otro elegido al azar; si no encuentra nada, gira un poco y se duerme.
+ *
+ * Sin @c init (o tras @c shutdown) las tareas se ejecutan al momento en el hilo que las lanza.
+ */
+class
+    JobSystem {
+public:
+    JobSystem() = default;
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+    ~JobSystem();
+
+    /**
+     * @brief Lanza los trabajadores.
+     *
+     * Si el llamador ya era trabajador de otro sistema, lo vuelve a ser tras @c shutdown.
+     * @param threadCount Hilos en total contando el llamador; 0 = núcleos de la máquina.
+     */
+    void
+        init(unsigned int threadCount = 0);
+
+    /**
+     * @brief Termina las tareas pendientes y detiene los trabajadores.
+     */
+    void
+        shutdown();
+
+    /** @brief Hilos que ejecutan tareas (incluido el que llamó a @c init). */
+    unsigned int
+        getThreadCount() const { return unsigned(m_queues.size()); }
+
+    /**
+     * @brief Lanza una tarea.
+     * @param task    Trabajo a ejecutar.
+     * @param counter Grupo al que pertenece (opcional) para esperarla con @c wait.
+     */
+    void
+        run(std::function<void()> task, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Lanza una tarea cuando @p dependency llegue a cero (al momento si ya lo está).
+     * @param counter Grupo de la continuación; cuenta como pendiente desde ya.
+     */
+    void
+        runAfter(JobCounter& dependency, std::function<void()> task, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Espera a que @p counter llegue a cero ejecutando tareas mientras tanto.
+     *
+     * Se puede llamar desde cualquier hilo, también desde dentro de una tarea.
+     */
+    void
+        wait(JobCounter& counter);
+
+    /**
+     * @brief Ejecuta @p body sobre subrangos de [begin, end) en paralelo y espera a que terminen.
+     *
+     * El rango se parte por la mitad hasta quedar en @p grain elementos: la mitad derecha se
+     * lanza como tarea (la que roban los demás) y la izquierda sigue en el hilo actual.
+     * @param body  Recibe [subBegin, subEnd).
+     * @param grain Elementos mínimos por tarea; 0 = unas 8 tareas por hilo.
+     */
+    void
+        parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body,
+            size_t grain = 0);
+
+    /**
+     * @brief Sistema compartido por el motor, con un hilo por núcleo.
+     *
+     * Se crea en la primera llamada, cuyo hilo pasa a ser el trabajador 0: debe hacerse desde
+     * el hilo principal (p. ej. en @c BaseApp::init).
+     */
+    static JobSystem&
+        Default();
+
+private:
+    void
+        workerLoop(unsigned int index);
+
+    Job*
+        findJob(unsigned int self);
+
+    bool
+        hasWork();
+
+    void
+        execute(Job* job);
+
+    void
+        push(Job* job);
+
+    void
+        split(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body,
+            JobCounter& counter);
+
+    std::vector<std::unique_ptr<JobDeque>> m_queues;   // Una por trabajador (0 = hilo de init)
+    std::vector<std::thread>               m_threads;  // Trabajadores 1..N-1
+
+    std::mutex                             m_sharedMutex;
+    std::deque<Job*>                       m_shared;   // Tareas lanzadas desde hilos ajenos
+
+    std::mutex                             m_sleepMutex;
+    std::condition_variable                m_wake;
+    uint64_t                               m_wakeEpoch = 0;  // Sube con cada aviso (bajo m_sleepMutex)
+    std::atomic<int>                       m_sleeping{ 0 };
+    std::atomic<bool>                      m_stop{ false };
+
+    JobSystem*                             m_previousSystem = nullptr;  // Sistema del hilo de init antes de init
+    unsigned int                           m_previousIndex = ~0u;
+};
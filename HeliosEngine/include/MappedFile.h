@@ -0,0 +1,72 @@
+#pragma once
+#include "Prerequisites.h"
+
+/**
+ * @file MappedFile.h
+ * @brief Declaración de @c MappedFile: vista de solo lectura de un archivo mapeado en memoria.
+ */
+
+/**
+ * @class MappedFile
+ * @brief Mapea un archivo completo en memoria (CreateFileMapping/MapViewOfFile).
+ *
+ * Permite recorrer el contenido del archivo como un bloque contiguo de bytes sin
+ * copiarlo a buffers intermedios; el sistema operativo pagina los datos bajo demanda.
+ * Se usa en los loaders de mallas para tokenizar el archivo "in place".
+ */
+class
+    MappedFile {
+public:
+    /**
+     * @brief Constructor por defecto (sin archivo abierto).
+     */
+    MappedFile() = default;
+
+    /**
+     * @brief Destructor. Cierra la vista y los handles si siguen abiertos.
+     */
+    ~MappedFile() { close(); }
+
+    // Un mapeo tiene un único dueño
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @brief Abre y mapea el archivo indicado en modo lectura.
+     * @param path Ruta del archivo en disco.
+     * @return @c true si el archivo quedó mapeado (un archivo vacío es válido, con @c size() == 0).
+     */
+    bool
+        open(const std::string& path);
+
+    /**
+     * @brief Libera la vista y los handles del archivo.
+     */
+    void
+        close();
+
+    /** @brief Primer byte del archivo (o @c nullptr si está vacío/cerrado). */
+    const char* data() const { return m_data; }
+
+    /** @brief Tamaño del archivo en bytes. */
+    size_t      size() const { return m_size; }
+
+    /** @brief Indica si hay un archivo abierto. */
+    bool        isOpen() const { return m_file != INVALID_HANDLE_VALUE; }
+
+private:
+    /** @brief Handle del archivo abierto. */
+    HANDLE      m_file = INVALID_HANDLE_VALUE;
+
+    /** @brief Handle del objeto de mapeo. */
+    HANDLE      m_mapping = nullptr;
+
+    /** @brief Inicio de la vista mapeada. */
+    const char* m_data = nullptr;
+
+    /** @brief Tamaño de la vista en bytes. */
+    size_t      m_size = 0;
+};
@@ -0,0 +1,163 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include "MeshComponent.h"
+
+/**
+ * @file MeshBVH.h
+ * @brief Jerarquía de volúmenes envolventes (BVH) sobre los triángulos de una malla para
+ *        consultas de rayos y segmentos.
+ */
+
+/**
+ * @struct BVHNode4
+ * @brief Nodo de 4 hijos con sus cajas en SoA (128 bytes, dos líneas de caché).
+ *
+ * Por hijo: si @c count es 0, @c child es el índice de otro nodo (o -1 si la ranura
+ * está vacía); si no, es una hoja con @c count triángulos a partir de @c child.
+ */
+struct alignas(16) BVHNode4 {
+    float minX[4], minY[4], minZ[4];
+    float maxX[4], maxY[4], maxZ[4];
+    int          child[4];
+    unsigned int count[4];
+};
+
+/**
+ * @struct RayHit
+ * @brief Intersección más cercana de un rayo o segmento.
+ */
+struct RayHit {
+    /** @brief Parámetro del impacto: origen + t * dirección. */
+    float t = FLT_MAX;
+
+    /** @brief Triángulo impactado (posición en los índices / 3); ~0u si no hubo impacto. */
+    unsigned int triangle = ~0u;
+
+    /** @brief Coordenadas baricéntricas del impacto respecto a los vértices 1 y 2. */
+    float u = 0.0f;
+    float v = 0.0f;
+
+    bool
+        hit() const { return triangle != ~0u; }
+};
+
+/**
+ * @struct BVHStats
+ * @brief Métricas de la última construcción.
+ */
+struct BVHStats {
+    size_t triangles = 0;
+    size_t nodes = 0;
+    size_t leaves = 0;
+    unsigned int maxDepth = 0;
+    double sahCost = 0.0;   // Costo SAH del árbol de 4 hijos (relativo a la caja raíz)
+};
+
+/**
+ * @class MeshBVH
+ * @brief BVH de 4 hijos construido con SAH por bins y recorrido con SSE.
+ *
+ * La construcción genera un árbol binario con SAH de @c kBinCount bins (los subárboles
+ * grandes se construyen como tareas del @c JobSystem), lo colapsa a 4 hijos y lo guarda aplanado en
+ * preorden. Los triángulos se copian reordenados por hoja como (v0, v1 - v0, v2 - v0),
+ * así las consultas no dependen de la malla de origen.
+ */
+class
+    MeshBVH {
+public:
+    /** @brief Bins por eje al evaluar el SAH. */
+    static const unsigned int kBinCount = 16;
+
+    /** @brief Máximo de triángulos por hoja. */
+    static const unsigned int kMaxLeafTriangles = 8;
+
+    MeshBVH() = default;
+
+    /**
+     * @brief Construye el BVH sobre una lista de triángulos.
+     * @param vertices    Vértices.
+     * @param vertexCount Cantidad de vértices.
+     * @param indices     Índices absolutos (3 por triángulo).
+     * @param indexCount  Cantidad de índices.
+     * @param threadCount Tareas de construcción en paralelo (0 = hilos del @c JobSystem, 1 = serial).
+     * @return @c false si no hay triángulos o algún índice está fuera de rango.
+     */
+    bool
+        build(const SimpleVertex* vertices, size_t vertexCount,
+            const unsigned int* indices, size_t indexCount,
+            unsigned int threadCount = 0);
+
+    /**
+     * @brief @c build sobre los vértices e índices de @p mesh.
+     */
+    bool
+        build(const MeshComponent& mesh, unsigned int threadCount = 0);
+
+    /**
+     * @brief Libera nodos y triángulos.
+     */
+    void
+        clear();
+
+    /**
+     * @brief Impacto más cercano de un rayo (ambas caras).
+     * @param origin    Origen en el espacio de la malla.
+     * @param direction Dirección (no necesita estar normalizada; @c t se mide en sus unidades).
+     * @param hit       Resultado; sólo se modifica si hay impacto.
+     * @param tMax      Distancia máxima.
+     * @return @c true si el rayo impacta algún triángulo en [0, tMax].
+     */
+    bool
+        raycast(const XMFLOAT3& origin, const XMFLOAT3& direction, RayHit& hit,
+            float tMax = FLT_MAX) const;
+
+    /**
+     * @brief Impacto más cercano a @p a sobre el segmento [a, b]; @c hit.t queda en [0, 1].
+     */
+    bool
+        segmentHit(const XMFLOAT3& a, const XMFLOAT3& b, RayHit& hit) const;
+
+    /**
+     * @brief @c true si el segmento [a, b] cruza algún triángulo (termina en el primero).
+     */
+    bool
+        segmentOccluded(const XMFLOAT3& a, const XMFLOAT3& b) const;
+
+    /**
+     * @brief @c true si hay un BVH construido.
+     */
+    bool
+        isBuilt() const { return !m_nodes.empty(); }
+
+    /**
+     * @brief Caja envolvente de la raíz.
+     */
+    void
+        getBounds(XMFLOAT3& outMin, XMFLOAT3& outMax) const;
+
+    /**
+     * @brief Métricas de la última construcción.
+     */
+    const BVHStats&
+        getStats() const { return m_stats; }
+
+    /**
+     * @brief Memoria ocupada por nodos y triángulos, en bytes.
+     */
+    size_t
+        getSizeInBytes() const;
+
+private:
+    // Recorrido común: más cercano (anyHit = false) o el primero que se encuentre
+    bool
+        traverse(const XMFLOAT3& origin, const XMFLOAT3& direction, float tMax, bool anyHit,
+            RayHit& hit) const;
+
+private:
+    std::vector<BVHNode4>     m_nodes;        // Preorden; m_nodes[0] es la raíz
+    std::vector<XMFLOAT3>     m_triangles;    // (v0, e1, e2) por triángulo, en orden de hoja
+    std::vector<unsigned int> m_triangleIds;  // Triángulo original de cada entrada de m_triangles
+    XMFLOAT3                  m_rootMin = XMFLOAT3(0, 0, 0);
+    XMFLOAT3                  m_rootMax = XMFLOAT3(0, 0, 0);
+    BVHStats                  m_stats;
+};
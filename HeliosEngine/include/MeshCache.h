@@ -0,0 +1,254 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+#include "MeshSimplifier.h"
+#include "MeshletBuilder.h"
+#include "MappedFile.h"
+#include <cstdint>
+
+/**
+ * @file MeshCache.h
+ * @brief Caché binaria de mallas (.hmesh) con carga sin copias vía archivo mapeado.
+ *
+ * Formato (little-endian, secciones alineadas a 16 bytes):
+ *  - @c HMeshHeader
+ *  - SimpleVertex[vertexCount]
+ *  - XMFLOAT4[vertexCount] con las tangentes, sólo si la malla las tiene (@c tangentOffset != 0)
+ *  - uint32[indexCount]
+ *  - HMeshSubset[subsetCount]
+ *  - materialCount registros @c HMeshMaterial, cada uno seguido de sus cadenas (nombre y
+ *    textura difusa, sin terminador) y relleno hasta múltiplo de 4 bytes
+ *  - Cadena de LODs, sólo si se guardó (@c lodCount != 0): float[lodRatioCount] con los ratios
+ *    pedidos, HMeshLOD[lodCount], HMeshSubset[lodSubsetCount] y uint32[lodIndexCount]
+ *  - Meshlets de cada LOD, sólo si se guardaron (@c meshletSetCount == @c lodCount):
+ *    HMeshMeshletSet[meshletSetCount] y, por conjunto, sus datos a partir de @c offset
+ *
+ * La caché se invalida si cambia el contenido del archivo fuente (hash de 64 bits),
+ * la versión del formato o @c MeshCache::kLoaderVersion. El hash sólo se recalcula si el
+ * tamaño o la fecha de modificación del fuente no coinciden con los guardados.
+ */
+
+/**
+ * @struct HMeshBounds
+ * @brief Esfera y OBB tal como se guardan en disco (ver @c BoundingSphere y @c OrientedBox).
+ */
+struct HMeshBounds {
+    float    sphere[4];       // Centro y radio.
+    float    obbCenter[3];
+    float    obbExtents[3];
+    float    obbAxes[9];      // Tres ejes ortonormales, uno tras otro.
+    uint32_t reserved;
+};
+
+/**
+ * @struct HMeshHeader
+ * @brief Cabecera del archivo .hmesh.
+ */
+struct HMeshHeader {
+    char     magic[4];        // "HMSH"
+    uint32_t formatVersion;   // Versión del layout binario.
+    uint32_t loaderVersion;   // Versión del loader que generó los datos.
+    uint32_t vertexStride;    // sizeof(SimpleVertex) al escribir.
+    uint64_t sourceHash;      // Hash del contenido del archivo fuente.
+    uint64_t sourceSize;      // Tamaño del archivo fuente en bytes.
+    uint64_t sourceWriteTime; // Última escritura del archivo fuente (FILETIME).
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t subsetCount;
+    uint32_t materialCount;
+    float    aabbMin[3];
+    float    aabbMax[3];
+    uint64_t vertexOffset;    // Offsets en bytes desde el inicio del archivo.
+    uint64_t indexOffset;
+    uint64_t subsetOffset;
+    uint64_t materialOffset;
+    uint64_t tangentOffset;   // 0 si la malla no tiene tangentes.
+    HMeshBounds bounds;
+    uint32_t lodRatioCount;   // Ratios con los que se construyó la cadena de LODs.
+    uint32_t lodCount;        // 0 si la caché no guarda LODs.
+    uint32_t lodSubsetCount;
+    uint32_t lodIndexCount;
+    uint64_t lodRatioOffset;
+    uint64_t lodOffset;
+    uint64_t lodSubsetOffset;
+    uint64_t lodIndexOffset;
+    uint32_t meshletSetCount;     // Uno por LOD; 0 si la caché no guarda meshlets.
+    uint32_t meshletMaxVertices;  // Límites de MeshletBuilder con los que se construyeron.
+    uint32_t meshletMaxTriangles;
+    uint32_t reserved;
+    uint64_t meshletOffset;
+};
+
+/**
+ * @struct HMeshSubset
+ * @brief Subset tal como se guarda en disco (ver @c MeshSubset).
+ */
+struct HMeshSubset {
+    uint32_t startIndex;
+    uint32_t indexCount;
+    uint32_t materialId;
+    uint32_t baseVertex;
+    float    aabbMin[3];
+    float    aabbMax[3];
+    HMeshBounds bounds;
+};
+
+/**
+ * @struct HMeshLOD
+ * @brief Nivel de detalle en disco (ver @c MeshLOD); sus rangos son
+ *        @c subsetCount registros de la sección de subsets de LOD a partir de @c firstSubset.
+ */
+struct HMeshLOD {
+    uint32_t firstSubset;
+    uint32_t subsetCount;
+    uint64_t triangleCount;
+    float    targetRatio;
+    float    error;
+    uint32_t reserved[2];
+};
+
+/**
+ * @struct HMeshMeshletSet
+ * @brief Meshlets de un LOD en disco (ver @c MeshletData).
+ *
+ * A partir de @c offset, cada arreglo alineado a 16 bytes: Meshlet[meshletCount],
+ * uint32[vertexCount], uint8[triangleBytes], HMeshSubset[subsetCount] y las ocho cotas
+ * (centro, radio, eje y corte del cono), cada una float[boundsCount].
+ */
+struct HMeshMeshletSet {
+    uint32_t meshletCount;
+    uint32_t vertexCount;     // Entradas de MeshletData::vertices.
+    uint32_t triangleBytes;   // Bytes de MeshletData::triangles.
+    uint32_t subsetCount;
+    uint32_t boundsCount;     // Largo de cada arreglo de cotas (múltiplo de 4).
+    uint32_t fitsIndex16;
+    uint64_t triangleCount;
+    uint64_t offset;
+};
+
+/**
+ * @struct HMeshMaterial
+ * @brief Cabecera de un material en disco (ver @c MeshMaterial).
+ */
+struct HMeshMaterial {
+    uint32_t nameLength;
+    uint32_t diffuseMapLength;
+    float    diffuse[3];
+    uint32_t reserved;
+};
+
+/**
+ * @class MeshCache
+ * @brief Escribe y abre archivos .hmesh.
+ *
+ * Un @c MeshCache abierto mantiene el archivo mapeado: @c vertices() e @c indices()
+ * apuntan directamente a la vista, listos para pasarse a @c Buffer::init sin copias.
+ */
+class
+    MeshCache {
+public:
+    /** @brief Versión del loader de OBJ; incrementarla invalida todas las cachés. */
+    static const uint32_t kLoaderVersion = 4;
+
+    /** @brief Versión del layout binario del archivo. */
+    static const uint32_t kFormatVersion = 8;
+
+    MeshCache() = default;
+    ~MeshCache() = default;
+
+    /**
+     * @brief Ruta de la caché asociada a un archivo fuente (mismo nombre + ".hmesh").
+     */
+    static std::string
+        GetCachePath(const std::string& sourcePath) { return sourcePath + ".hmesh"; }
+
+    /**
+     * @brief Hash XXH64 (semilla 0) de un bloque de memoria.
+     */
+    static uint64_t
+        HashBytes(const void* data, size_t size);
+
+    /**
+     * @brief Hash del contenido de un archivo (leído mapeado).
+     * @param path     Archivo fuente.
+     * @param outHash  Hash resultante.
+     * @param outSize  Tamaño del archivo.
+     * @return @c false si no se pudo abrir.
+     */
+    static bool
+        HashFile(const std::string& path, uint64_t& outHash, uint64_t& outSize);
+
+    /**
+     * @brief Escribe la malla en @p cachePath (vía archivo temporal + rename).
+     * @param cachePath  Ruta del .hmesh.
+     * @param mesh       Malla con vértices, índices, subsets y volúmenes calculados.
+     * @param sourcePath Archivo fuente cuyo contenido valida la caché.
+     * @param lods       Cadena de LODs de la malla (con sus índices) para no recalcularla al abrir; opcional.
+     * @param meshlets   Meshlets de cada nivel de @p lods (límites por defecto de @c MeshletBuilder); opcional.
+     */
+    static bool
+        write(const std::string& cachePath, const MeshComponent& mesh, const std::string& sourcePath,
+            const MeshLODChain* lods = nullptr, const std::vector<MeshletData>* meshlets = nullptr);
+
+    /**
+     * @brief Abre y valida la caché contra el contenido actual de @p sourcePath.
+     *
+     * Un subset con rango de índices o @c baseVertex fuera de la malla, o un índice que no
+     * apunta a un vértice, invalida la caché. El contenido del fuente sólo se vuelve a
+     * hashear si su tamaño o su fecha de modificación cambiaron.
+     * @return @c true si la caché existe y sigue vigente.
+     */
+    bool
+        open(const std::string& cachePath, const std::string& sourcePath);
+
+    /**
+     * @brief Cierra el mapeo (invalida los punteros devueltos por los accesores).
+     */
+    void
+        close();
+
+    /**
+     * @brief Copia contadores, subsets, materiales y volúmenes envolventes a @p mesh, sin copiar vértices ni índices.
+     */
+    void
+        fillMetadata(MeshComponent& mesh) const;
+
+    /**
+     * @brief Copia la malla completa a @p mesh (para quien necesita los datos en CPU).
+     */
+    void
+        copyTo(MeshComponent& mesh) const;
+
+    /**
+     * @brief Copia los niveles guardados a @p chain si se construyeron con @p ratios.
+     *
+     * Los índices no se copian: @c chain.indices queda vacío y los de todos los niveles se leen
+     * de @c lodIndices(). Un rango o un índice fuera de la malla cuenta como caché sin LODs.
+     * @return @c false si no hay LODs guardados para esos ratios (hay que construirlos).
+     */
+    bool
+        readLODs(const std::vector<float>& ratios, MeshLODChain& chain) const;
+
+    /**
+     * @brief Copia los meshlets guardados de cada LOD a @p out (uno por nivel de @c readLODs).
+     *
+     * Se rechazan si se construyeron con otros límites de @c MeshletBuilder o si algún rango,
+     * vértice o índice local se sale de sus arreglos.
+     * @return @c false si no hay meshlets utilizables (hay que construirlos).
+     */
+    bool
+        readMeshlets(std::vector<MeshletData>& out) const;
+
+    bool                isOpen() const { return m_header != nullptr; }
+    const SimpleVertex* vertices() const;
+    const XMFLOAT4*     tangents() const;     // nullptr si la caché no tiene tangentes
+    const unsigned int* indices() const;
+    unsigned int        vertexCount() const { return m_header ? m_header->vertexCount : 0; }
+    unsigned int        indexCount() const { return m_header ? m_header->indexCount : 0; }
+    const unsigned int* lodIndices() const;   // Índices de todos los LODs (ver readLODs)
+    unsigned int        lodIndexCount() const { return m_header ? m_header->lodIndexCount : 0; }
+
+private:
+    MappedFile         m_file;
+    const HMeshHeader* m_header = nullptr;
+};
@@ -1,5 +1,6 @@
 #pragma once
-#include "Prerequisites.h"
+#include "CorePrerequisites.h"
+#include "BoundingVolumes.h"
 
 /**
  * @file MeshComponent.h
@@ -9,6 +10,59 @@
 
 class DeviceContext;
 
+/**
+ * @struct MeshMaterial
+ * @brief Material mnimo ledo de un .mtl (nombre, color y textura difusa).
+ */
+struct MeshMaterial {
+    /** @brief Nombre del material (@c newmtl); vaco para el material por defecto. */
+    std::string name;
+
+    /** @brief Textura difusa (@c map_Kd), relativa al directorio del modelo; vaca si no hay. */
+    std::string diffuseMap;
+
+    /** @brief Color difuso (@c Kd). */
+    XMFLOAT3 diffuse = XMFLOAT3(1, 1, 1);
+};
+
+/**
+ * @struct MeshSubset
+ * @brief Rango contiguo de @c m_index que comparte material, con sus volmenes envolventes.
+ *
+ * Permite dibujar partes de la malla por separado (un DrawIndexed por subset) y
+ * descartarlas individualmente usando su AABB, esfera u OBB en espacio objeto.
+ */
+struct MeshSubset {
+    /** @brief Primer ndice del rango dentro de @c MeshComponent::m_index. */
+    unsigned int startIndex = 0;
+
+    /** @brief Cantidad de ndices del rango (mltiplo de 3). */
+    unsigned int indexCount = 0;
+
+    /** @brief ndice del material en @c MeshComponent::m_materials. */
+    unsigned int materialId = 0;
+
+    /**
+     * @brief Vrtice base del rango (BaseVertexLocation de DrawIndexed).
+     *
+     * Los ndices del rango se guardan absolutos en @c m_index; el index buffer de GPU
+     * almacena @c ndice - baseVertex, que cabe en 16 bits tras @c splitForIndex16.
+     */
+    unsigned int baseVertex = 0;
+
+    /** @brief Esquina mnima del AABB del subset. */
+    XMFLOAT3 aabbMin = XMFLOAT3(0, 0, 0);
+
+    /** @brief Esquina mxima del AABB del subset. */
+    XMFLOAT3 aabbMax = XMFLOAT3(0, 0, 0);
+
+    /** @brief Esfera envolvente del subset. */
+    BoundingSphere sphere;
+
+    /** @brief Caja orientada (PCA) del subset. */
+    OrientedBox obb;
+};
+
 /**
  * @class MeshComponent
  * @brief Representa una malla 3D bsica: nombre, arreglo de vrtices e ndices, y contadores.
@@ -61,6 +115,33 @@ public:
     void
         destroy();
 
+    /**
+     * @brief Recalcula AABB, esfera y OBB de la malla y de cada subset a partir de los vrtices
+     *        (ver @c BoundingVolumes).
+     *
+     * Si no hay subsets, crea uno que cubre todo @c m_index. Los resultados quedan guardados
+     * en la malla (y en la cach .hmesh): quien los consume no recorre los vrtices.
+     */
+    void
+        computeBounds();
+
+    /**
+     * @brief Divide los subsets para que cada rango referencie como mximo
+     *        @c kMaxVertices16 vrtices a partir de su @c baseVertex.
+     *
+     * Si la malla ya cabe en ndices de 16 bits slo pone @c baseVertex a 0. En otro caso
+     * reordena @c m_vertex (y @c m_tangents, si las hay) por rango (orden de primer uso,
+     * duplicando los vrtices compartidos entre rangos), parte los subsets que no caben y recalcula los AABB.
+     * Si duplicar vrtices cuesta ms memoria de la que ahorran los ndices de 16 bits,
+     * la malla no se modifica (se dibujar con ndices de 32 bits). Los ndices de @c m_index siguen siendo absolutos. Debe ser el ltimo paso tras
+     * @c MeshOptimizer, porque @c OptimizeVertexFetch deshace la divisin.
+     */
+    void
+        splitForIndex16();
+
+    /** @brief Vrtices direccionables por un rango con ndices de 16 bits. */
+    static const unsigned int kMaxVertices16 = 65536;
+
 public:
     /** @brief Nombre simblico/descriptivo de la malla. */
     std::string m_name;
@@ -68,6 +149,13 @@ public:
     /** @brief Arreglo de vrtices (posicin, UV, normal, etc.) de la malla. */
     std::vector<SimpleVertex> m_vertex;
 
+    /**
+     * @brief Tangentes por vrtice (xyz, w = orientacin de la bitangente), paralelas a @c m_vertex.
+     *
+     * Vaco si no se generaron (ver @c MeshNormals::ComputeTangents).
+     */
+    std::vector<XMFLOAT4> m_tangents;
+
     /** @brief Arreglo de ndices (tringulos u otra topologa) de la malla. */
     std::vector<unsigned int> m_index;
 
@@ -76,4 +164,22 @@ public:
 
     /** @brief Cantidad de ndices vlidos en @c m_index. */
     int m_numIndex;
+
+    /** @brief Rangos de ndices por material (ver @c MeshSubset), ordenados por material. */
+    std::vector<MeshSubset> m_subsets;
+
+    /** @brief Materiales referenciados por los subsets. */
+    std::vector<MeshMaterial> m_materials;
+
+    /** @brief Esquina mnima del AABB de toda la malla. */
+    XMFLOAT3 m_aabbMin = XMFLOAT3(0, 0, 0);
+
+    /** @brief Esquina mxima del AABB de toda la malla. */
+    XMFLOAT3 m_aabbMax = XMFLOAT3(0, 0, 0);
+
+    /** @brief Esfera envolvente de toda la malla. */
+    BoundingSphere m_sphere;
+
+    /** @brief Caja orientada (PCA) de toda la malla. */
+    OrientedBox m_obb;
 };
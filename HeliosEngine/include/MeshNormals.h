@@ -0,0 +1,88 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+
+/**
+ * @file MeshNormals.h
+ * @brief Generación paralela de normales y tangentes por vértice sobre una adyacencia CSR.
+ */
+
+/**
+ * @enum NormalWeighting
+ * @brief Peso de cada triángulo en la normal de sus vértices.
+ */
+enum class NormalWeighting {
+    Area,   // Producto cruz sin normalizar (proporcional al área)
+    Angle   // Normal unitaria por el ángulo de la esquina (independiente de la teselación)
+};
+
+/**
+ * @struct VertexAdjacency
+ * @brief Esquinas de triángulo incidentes en cada grupo, en formato CSR.
+ *
+ * Las esquinas del grupo g son @c corners[offsets[g] .. offsets[g + 1]), en orden creciente;
+ * una esquina es @c triángulo * 3 + k, es decir, su posición en el index buffer.
+ */
+struct VertexAdjacency {
+    std::vector<unsigned int> offsets;  // groupCount + 1 entradas
+    std::vector<unsigned int> corners;  // Una entrada por índice
+};
+
+/**
+ * @class MeshNormals
+ * @brief Etapa de procesado geométrico: normales suavizadas y tangentes estilo MikkTSpace.
+ *
+ * Ambas pasadas son de recolección: cada hilo recorre un rango de grupos (o vértices) y
+ * suma las contribuciones de sus esquinas, así que no hay escrituras compartidas ni
+ * atómicos. La adyacencia es un counting sort paralelo: cada hilo cuenta su rango de
+ * esquinas en un histograma propio, una suma prefija los combina y cada hilo escribe sus
+ * esquinas en posiciones reservadas para él.
+ */
+class
+    MeshNormals {
+public:
+    /** @brief Id de grupo que excluye a un vértice de @c ComputeNormals. */
+    static const unsigned int kKeepNormal = ~0u;
+
+    /**
+     * @brief Construye la adyacencia grupo -> esquinas.
+     * @param indices     Índices (3 por triángulo).
+     * @param indexCount  Cantidad de índices.
+     * @param groupOf     Grupo de cada vértice (< @p groupCount, o @c kKeepNormal para omitirlo);
+     *                    nulo = el grupo es el propio vértice.
+     * @param groupCount  Cantidad de grupos.
+     * @param threadCount Hilos (0 = automático, 1 = serial).
+     */
+    static void
+        BuildAdjacency(const unsigned int* indices, size_t indexCount, const unsigned int* groupOf,
+            size_t groupCount, VertexAdjacency& out, unsigned int threadCount = 0);
+
+    /**
+     * @brief Normales suavizadas por grupo de soldadura.
+     *
+     * Los vértices con el mismo @p weldGroup comparten normal: el cargador de OBJ agrupa por
+     * (posición, grupo de suavizado), así las costuras de UV no se notan y las aristas entre
+     * grupos quedan duras. Los vértices con @c kKeepNormal conservan la suya.
+     * @param weldGroup   Grupo de cada vértice (índice de un vértice representante); nulo = el propio vértice.
+     * @param weighting   Peso de cada triángulo.
+     * @param threadCount Hilos (0 = automático, 1 = serial).
+     */
+    static void
+        ComputeNormals(std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices,
+            const unsigned int* weldGroup = nullptr, NormalWeighting weighting = NormalWeighting::Angle,
+            unsigned int threadCount = 0);
+
+    /**
+     * @brief Tangentes compatibles con MikkTSpace en @c mesh.m_tangents.
+     *
+     * Por esquina: tangente del triángulo según sus UV, proyectada al plano de la normal del
+     * vértice y pesada por el ángulo de la esquina. @c w es la orientación (bitangente =
+     * w * cross(N, T)). Si un vértice recibe triángulos con orientaciones opuestas (UV
+     * espejadas) se divide: las esquinas de orientación negativa pasan a una copia del vértice.
+     * Requiere normales unitarias; las esquinas con UV degeneradas no aportan.
+     * @param threadCount Hilos (0 = automático, 1 = serial).
+     * @return Cantidad de vértices añadidos por divisiones.
+     */
+    static size_t
+        ComputeTangents(MeshComponent& mesh, unsigned int threadCount = 0);
+};
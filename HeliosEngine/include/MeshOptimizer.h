@@ -0,0 +1,86 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+
+/**
+ * @file MeshOptimizer.h
+ * @brief Optimización de mallas para la caché post-transform de vértices y el fetch de vértices.
+ */
+
+/**
+ * @struct VertexCacheStats
+ * @brief Resultado del simulador de caché de vértices.
+ *
+ * - ACMR (average cache miss ratio): vértices transformados / triángulos. Mínimo teórico ~0.5.
+ * - ATVR (average transform to vertex ratio): vértices transformados / vértices únicos. Ideal 1.0.
+ */
+struct VertexCacheStats {
+    /** @brief Vértices que fallaron en la caché (= invocaciones del vertex shader). */
+    size_t transformed = 0;
+
+    /** @brief Triángulos procesados. */
+    size_t triangles = 0;
+
+    /** @brief Vértices distintos referenciados por los índices. */
+    size_t uniqueVertices = 0;
+
+    float acmr() const { return triangles ? float(transformed) / float(triangles) : 0.0f; }
+    float atvr() const { return uniqueVertices ? float(transformed) / float(uniqueVertices) : 0.0f; }
+};
+
+/**
+ * @struct MeshOptimizeReport
+ * @brief Estadísticas antes y después de @c MeshOptimizer::Optimize.
+ */
+struct MeshOptimizeReport {
+    VertexCacheStats before;
+    VertexCacheStats after;
+    unsigned int     cacheSize = 0;
+};
+
+/**
+ * @class MeshOptimizer
+ * @brief Reordenamiento de índices (Tipsify) y de vértices (orden de primer uso).
+ *
+ * Ambos pasos respetan los @c MeshSubset: los triángulos nunca cruzan de un rango de
+ * material a otro, así que el orden por material de @c OBJParser se conserva.
+ */
+class
+    MeshOptimizer {
+public:
+    /** @brief Tamaño de caché FIFO que se asume por defecto (hardware D3D11 típico). */
+    static const unsigned int kDefaultCacheSize = 16;
+
+    /**
+     * @brief Reordena los triángulos de cada subset para la caché post-transform (Tipsify).
+     * @param mesh      Malla a modificar (sólo cambia @c m_index).
+     * @param cacheSize Tamaño de la caché objetivo en vértices.
+     */
+    static void
+        OptimizeVertexCache(MeshComponent& mesh, unsigned int cacheSize = kDefaultCacheSize);
+
+    /**
+     * @brief Reordena @c m_vertex por orden de primer uso en @c m_index y remapea los índices.
+     *
+     * Vértices no referenciados se conservan al final. Los AABB no cambian.
+     */
+    static void
+        OptimizeVertexFetch(MeshComponent& mesh);
+
+    /**
+     * @brief Simula una caché FIFO de vértices sobre una lista de triángulos.
+     * @param indices     Índices (3 por triángulo).
+     * @param indexCount  Número de índices.
+     * @param vertexCount Número de vértices del buffer (cota de los índices).
+     * @param cacheSize   Entradas de la caché.
+     */
+    static VertexCacheStats
+        AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+            unsigned int cacheSize = kDefaultCacheSize);
+
+    /**
+     * @brief Aplica @c OptimizeVertexCache y @c OptimizeVertexFetch midiendo ACMR/ATVR.
+     */
+    static MeshOptimizeReport
+        Optimize(MeshComponent& mesh, unsigned int cacheSize = kDefaultCacheSize);
+};
@@ -0,0 +1,111 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+
+/**
+ * @file MeshSimplifier.h
+ * @brief Simplificación por colapso de aristas con métricas cuádricas y cadena de LODs.
+ */
+
+/**
+ * @struct MeshLOD
+ * @brief Un nivel de detalle: rangos de índices dentro de @c MeshLODChain::indices.
+ */
+struct MeshLOD {
+    /** @brief Un rango por subset de la malla original (mismo material y @c baseVertex). */
+    std::vector<MeshSubset> subsets;
+
+    /** @brief Triángulos del nivel. */
+    size_t triangleCount = 0;
+
+    /** @brief Fracción de triángulos pedida respecto a la malla original. */
+    float targetRatio = 1.0f;
+
+    /** @brief Error geométrico acumulado (distancia en unidades de la malla; 0 en el LOD 0). */
+    float error = 0.0f;
+};
+
+/**
+ * @struct MeshLODChain
+ * @brief Cadena de LODs que comparten el vertex buffer de la malla original.
+ *
+ * Todos los niveles se guardan concatenados en @c indices para crear un único index buffer;
+ * cada @c MeshLOD dibuja sus @c subsets con su propio @c startIndex.
+ */
+struct MeshLODChain {
+    /** @brief Índices absolutos de todos los niveles, del más detallado al más simple. */
+    std::vector<unsigned int> indices;
+
+    /** @brief Niveles; @c levels[0] es la malla original. */
+    std::vector<MeshLOD> levels;
+
+    /** @brief Ratios pedidos a @c BuildLODChain (una cadena guardada sólo sirve para los mismos). */
+    std::vector<float> ratios;
+};
+
+/**
+ * @class MeshSimplifier
+ * @brief Simplificador de Garland-Heckbert que sólo reordena índices (no crea vértices).
+ *
+ * Cada vértice se clasifica por su topología: interior, borde abierto, costura (dos vértices
+ * en la misma posición con UV o normal distintas) o bloqueado. Los bordes y costuras sólo
+ * colapsan a lo largo de sí mismos, y en una costura ambos lados colapsan a la vez, así que
+ * no se abren grietas ni se mezclan UVs. Los vértices compartidos entre subsets quedan
+ * bloqueados: los límites de material y los rangos de @c splitForIndex16 se conservan.
+ */
+class
+    MeshSimplifier {
+public:
+    /**
+     * @brief Simplifica una lista de triángulos hasta @p targetTriangles (o hasta donde se pueda).
+     * @param vertices        Vértices de la malla.
+     * @param vertexCount     Cantidad de vértices.
+     * @param indices         Índices de entrada/salida (3 por triángulo).
+     * @param targetTriangles Triángulos objetivo.
+     * @return Error geométrico máximo de los colapsos aplicados, en unidades de la malla.
+     */
+    static float
+        Simplify(const SimpleVertex* vertices, size_t vertexCount,
+            std::vector<unsigned int>& indices, size_t targetTriangles);
+
+    /**
+     * @brief Construye la cadena de LODs de una malla.
+     * @param vertices    Vértices (p. ej. @c m_vertex o la caché mapeada).
+     * @param vertexCount Cantidad de vértices.
+     * @param indices     Índices absolutos.
+     * @param indexCount  Cantidad de índices.
+     * @param subsets     Rangos de la malla; vacío equivale a un único rango.
+     * @param ratios      Fracción de triángulos de cada LOD después del 0, decreciente.
+     * @param outChain    Cadena resultante (@c levels[0] = malla original).
+     */
+    static void
+        BuildLODChain(const SimpleVertex* vertices, size_t vertexCount,
+            const unsigned int* indices, size_t indexCount,
+            const std::vector<MeshSubset>& subsets,
+            const std::vector<float>& ratios,
+            MeshLODChain& outChain);
+
+    /**
+     * @brief @c BuildLODChain con los objetivos por defecto (50/25/12.5/6.25 %).
+     */
+    static void
+        BuildLODChain(const MeshComponent& mesh, MeshLODChain& outChain);
+
+    /**
+     * @brief Error en píxeles de un error geométrico visto a @p distance.
+     * @param error          Error en unidades de mundo.
+     * @param distance       Distancia de la cámara al punto más cercano de la malla.
+     * @param fovY           Campo de visión vertical (radianes).
+     * @param viewportHeight Alto del viewport en píxeles.
+     */
+    static float
+        ProjectedError(float error, float distance, float fovY, float viewportHeight);
+
+    /**
+     * @brief Elige el LOD más simple cuyo error proyectado no supera @p maxPixelError.
+     * @return Índice en @c chain.levels (0 si la cadena está vacía).
+     */
+    static unsigned int
+        SelectLOD(const MeshLODChain& chain, float distance, float fovY, float viewportHeight,
+            float maxPixelError = 1.0f);
+};
@@ -0,0 +1,118 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+#include "Frustum.h"
+
+/**
+ * @file MeshletBuilder.h
+ * @brief Partición de mallas en meshlets (clusters pequeños) con cotas para culling en CPU.
+ */
+
+/**
+ * @struct Meshlet
+ * @brief Cluster de hasta @c MeshletBuilder::kMaxVertices vértices y
+ *        @c MeshletBuilder::kMaxTriangles triángulos de un mismo subset.
+ */
+struct Meshlet {
+    unsigned int vertexOffset = 0;    // Primer vértice en MeshletData::vertices
+    unsigned int triangleOffset = 0;  // Primer byte en MeshletData::triangles
+    unsigned int vertexCount = 0;
+    unsigned int triangleCount = 0;
+    unsigned int subset = 0;          // Índice en MeshletData::subsets
+};
+
+/**
+ * @struct MeshletData
+ * @brief Meshlets de una malla, sus listas de vértices/triángulos y sus cotas en SoA.
+ *
+ * Las cotas se guardan en arreglos separados (rellenados hasta múltiplo de 4) para que
+ * @c MeshletBuilder::Cull procese cuatro meshlets por instrucción SSE.
+ */
+struct MeshletData {
+    std::vector<Meshlet>       meshlets;
+    std::vector<unsigned int>  vertices;   // Índices absolutos al vertex buffer
+    std::vector<unsigned char> triangles;  // 3 índices locales (< 256) por triángulo
+
+    /** @brief Subsets de origen (material y @c baseVertex de cada meshlet). */
+    std::vector<MeshSubset>    subsets;
+
+    // Esfera envolvente por meshlet
+    std::vector<float> centerX, centerY, centerZ, radius;
+
+    // Cono de normales: el meshlet mira hacia atrás si
+    // dot(center - cam, axis) >= cutoff * |center - cam| + radius (cutoff >= 1: nunca)
+    std::vector<float> coneAxisX, coneAxisY, coneAxisZ, coneCutoff;
+
+    /** @brief Triángulos totales (para estadísticas y capacidad del index buffer). */
+    size_t triangleCount = 0;
+
+    /** @brief Todos los índices caben en 16 bits relativos al @c baseVertex de su subset. */
+    bool fitsIndex16 = true;
+};
+
+/**
+ * @class MeshletBuilder
+ * @brief Construye meshlets y selecciona los visibles para un index buffer compactado.
+ */
+class
+    MeshletBuilder {
+public:
+    /** @brief Límite de vértices por meshlet. */
+    static const unsigned int kMaxVertices = 64;
+
+    /** @brief Límite de triángulos por meshlet. */
+    static const unsigned int kMaxTriangles = 124;
+
+    /**
+     * @brief Particiona los rangos de índices en meshlets.
+     *
+     * Recorre los triángulos en el orden del index buffer (tras @c MeshOptimizer ese orden
+     * ya es local) y cierra un meshlet cuando se excede algún límite o cambia el subset.
+     * @param vertices    Vértices (para las cotas).
+     * @param vertexCount Cantidad de vértices.
+     * @param indices     Índices absolutos.
+     * @param indexCount  Cantidad de índices.
+     * @param subsets     Rangos a particionar; vacío equivale a un único rango.
+     * @param out         Resultado.
+     */
+    static void
+        Build(const SimpleVertex* vertices, size_t vertexCount,
+            const unsigned int* indices, size_t indexCount,
+            const std::vector<MeshSubset>& subsets,
+            MeshletData& out,
+            unsigned int maxVertices = kMaxVertices,
+            unsigned int maxTriangles = kMaxTriangles);
+
+    /**
+     * @brief @c Build sobre los vértices, índices y subsets de @p mesh.
+     */
+    static void
+        Build(const MeshComponent& mesh, MeshletData& out);
+
+    /**
+     * @brief Marca los meshlets visibles (SSE, 4 por iteración).
+     * @param data           Meshlets con sus cotas.
+     * @param frustum        Frustum en el espacio de los vértices (World*View*Proj).
+     * @param cameraPosition Cámara en ese mismo espacio.
+     * @param coneCulling    Si @c true descarta también los meshlets vistos por detrás.
+     * @param outVisible     1 por meshlet visible, 0 si se descarta.
+     * @return Cantidad de meshlets visibles.
+     */
+    static size_t
+        Cull(const MeshletData& data, const Frustum& frustum, const XMFLOAT3& cameraPosition,
+            bool coneCulling, std::vector<unsigned char>& outVisible);
+
+    /**
+     * @brief Escribe los índices de los meshlets visibles, relativos al @c baseVertex de su subset.
+     * @param data       Meshlets.
+     * @param visible    Resultado de @c Cull.
+     * @param use16Bit   Escribe @c uint16_t (R16_UINT) en lugar de @c uint32_t.
+     * @param dst        Destino (p. ej. un index buffer dinámico mapeado).
+     * @param capacity   Índices que caben en @p dst.
+     * @param outRanges  Un rango por subset con triángulos visibles (para DrawIndexed).
+     * @return Índices escritos.
+     */
+    static size_t
+        WriteVisibleIndices(const MeshletData& data, const std::vector<unsigned char>& visible,
+            bool use16Bit, void* dst, size_t capacity, std::vector<MeshSubset>& outRanges);
+};
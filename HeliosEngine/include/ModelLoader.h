@@ -2,6 +2,7 @@
 #include "Prerequisites.h"
 #include "IResource.h"
 #include "MeshComponent.h"
+#include "MeshBVH.h"
 
 #include <string>
 #include <vector>
@@ -26,9 +27,17 @@ enum class ModelType {
 class OBJParser
 {
 public:
+    // Mapea el archivo en memoria y lo tokeniza in-place (sin asignaciones por línea).
     // flipV=true para coord. V en estilo D3D
     bool LoadOBJ(const std::string& objPath, MeshComponent& outMesh, bool flipV = true);
 
+    // Chunks del parseo, cada uno una tarea de JobSystem::Default(): 0 = uno por hilo, 1 = serial.
+    // La salida es idéntica bit a bit en cualquier modo.
+    void SetThreadCount(unsigned int threadCount) { m_threadCount = threadCount; }
+
+    // Tangentes (MeshComponent::m_tangents) cuando el OBJ trae UV; activado por defecto.
+    void SetGenerateTangents(bool generate) { m_generateTangents = generate; }
+
 private:
     struct VertexIndices {
         int v = 0;
@@ -41,6 +50,30 @@ private:
             return vn < o.vn;
         }
     };
+
+    // Conteo de atributos previos a un chunk (sin el slot 0 reservado)
+    struct ChunkBase {
+        size_t positions = 0;
+        size_t texCoords = 0;
+        size_t normals = 0;
+    };
+
+    // Atributos y caras de un rango de líneas (definido en ModelLoader.cpp)
+    struct ParseChunk;
+
+    // Pasada 1 del modo paralelo: cuenta registros v/vt/vn en [begin, end)
+    static void CountRecords(const char* begin, const char* end, ChunkBase& outCounts);
+
+    // Pasada 2: parsea [begin, end) resolviendo índices con los offsets de 'base'
+    static void ParseRange(const char* begin, const char* end, const ChunkBase& base,
+        bool flipV, ParseChunk& out);
+
+    // Añade a outMaterials los materiales (newmtl/Kd/map_Kd) de un .mtl relativo al OBJ
+    static void LoadMTL(const std::string& objDir, const std::string& libPath,
+        std::vector<MeshMaterial>& outMaterials);
+
+    unsigned int m_threadCount = 0;
+    bool         m_generateTangents = true;
 };
 
 //--------------------------------------------------------------------------------------
@@ -76,6 +109,10 @@ public:
     ModelType                        GetModelType() const { return m_modelType; }
     const std::vector<std::string>& GetTextureFiles() const { return m_textureFileNames; }
 
+    // BVH por malla para raycasts/picking (vacío hasta llamar BuildBVHs)
+    bool                          BuildBVHs(unsigned int threadCount = 0);
+    const std::vector<MeshBVH>&   GetBVHs() const { return m_bvhs; }
+
 private:
     // ---------- Implementaciones por formato ----------
     bool loadOBJ_Internal(const std::string& path);
@@ -113,4 +150,7 @@ private:
 
     // Texturas detectadas (mtl / material FBX) – opcional
     std::vector<std::string> m_textureFileNames;
+
+    // Aceleración de consultas de rayos, una por malla de m_meshes
+    std::vector<MeshBVH> m_bvhs;
 };
@@ -0,0 +1,126 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include "MeshBVH.h"
+#include "SceneOctree.h"
+
+/**
+ * @file Picker.h
+ * @brief Selección de triángulos con el mouse: rayo desde la cámara contra los BVH de la escena.
+ */
+
+/**
+ * @struct PickResult
+ * @brief Impacto más cercano de un pick.
+ */
+struct PickResult {
+    /** @brief Malla impactada (índice devuelto por @c Picker::addMesh); ~0u si no hubo impacto. */
+    unsigned int mesh = ~0u;
+
+    /** @brief Triángulo de esa malla (posición en sus índices / 3). */
+    unsigned int triangle = ~0u;
+
+    /** @brief Coordenadas baricéntricas respecto a los vértices 1 y 2 del triángulo. */
+    float u = 0.0f;
+    float v = 0.0f;
+
+    /** @brief Distancia en unidades de mundo desde el origen del rayo. */
+    float distance = FLT_MAX;
+
+    /** @brief Punto de impacto en espacio mundo. */
+    XMFLOAT3 position = XMFLOAT3(0, 0, 0);
+
+    bool
+        hit() const { return mesh != ~0u; }
+};
+
+/**
+ * @class Picker
+ * @brief Consulta de picking sin dependencias de ventana ni dispositivo.
+ *
+ * Cada malla registrada aporta su @c MeshBVH (en su espacio objeto) y su matriz World.
+ * El rayo se lleva al espacio de cada malla con la inversa de World; como la transformación
+ * es afín el parámetro del impacto no cambia, así que las distancias se comparan en mundo.
+ * Las mallas candidatas salen de un @c SceneOctree con sus AABB en mundo, ordenadas por
+ * distancia de entrada: en cuanto una entra más lejos que el mejor impacto se deja de buscar.
+ */
+class
+    Picker {
+public:
+    Picker() = default;
+
+    /**
+     * @brief Quita todas las mallas registradas.
+     */
+    void
+        clear();
+
+    /**
+     * @brief Registra una malla.
+     * @param bvh   BVH en espacio objeto (debe seguir vivo mientras se use el picker).
+     * @param world Matriz objeto -> mundo.
+     * @return Índice de la malla, devuelto en @c PickResult::mesh.
+     */
+    unsigned int
+        addMesh(const MeshBVH* bvh, const XMMATRIX& world);
+
+    /**
+     * @brief Actualiza la matriz World de una malla registrada.
+     */
+    void
+        setWorld(unsigned int mesh, const XMMATRIX& world);
+
+    /**
+     * @brief Rayo en espacio mundo que pasa por un píxel.
+     * @param x              Columna del píxel (0 = izquierda).
+     * @param y              Fila del píxel (0 = arriba).
+     * @param viewportWidth  Ancho del viewport en píxeles.
+     * @param viewportHeight Alto del viewport en píxeles.
+     * @param view           Matriz de vista.
+     * @param projection     Matriz de proyección.
+     * @param outOrigin      Punto en el plano cercano.
+     * @param outDirection   Dirección normalizada hacia el plano lejano.
+     */
+    static void
+        ScreenRay(float x, float y, float viewportWidth, float viewportHeight,
+            const XMMATRIX& view, const XMMATRIX& projection,
+            XMFLOAT3& outOrigin, XMFLOAT3& outDirection);
+
+    /**
+     * @brief Impacto más cercano de un rayo en espacio mundo.
+     * @param origin    Origen del rayo.
+     * @param direction Dirección (se normaliza).
+     * @param out       Resultado; sólo se modifica si hay impacto.
+     * @return @c true si el rayo impacta alguna malla.
+     */
+    bool
+        pick(const XMFLOAT3& origin, const XMFLOAT3& direction, PickResult& out) const;
+
+    /**
+     * @brief @c ScreenRay seguido de @c pick.
+     */
+    bool
+        pick(float x, float y, float viewportWidth, float viewportHeight,
+            const XMMATRIX& view, const XMMATRIX& projection, PickResult& out) const;
+
+    /**
+     * @brief Cantidad de mallas registradas.
+     */
+    size_t
+        getMeshCount() const { return m_entries.size(); }
+
+private:
+    struct Entry {
+        const MeshBVH* bvh = nullptr;
+        XMFLOAT4X4     world;
+        XMFLOAT4X4     invWorld;
+        XMFLOAT3       worldMin;  // AABB en mundo: descarta la malla sin recorrer su BVH
+        XMFLOAT3       worldMax;
+        unsigned int   object = SceneOctree::kInvalid;  // Handle en m_partition
+    };
+
+    void
+        updateEntry(Entry& entry, const XMMATRIX& world);
+
+    std::vector<Entry> m_entries;
+    SceneOctree        m_partition;  // AABB en mundo de cada malla (userData = índice de malla)
+};
@@ -0,0 +1,162 @@
+#pragma once
+#include "Prerequisites.h"
+#include "ConstantBufferManager.h"
+
+class DeviceContext;
+class ShaderProgram;
+class Texture;
+class Buffer;
+
+/**
+ * @file RenderQueue.h
+ * @brief Cola de draws con claves de orden de 64 bits y ordenamiento radix.
+ */
+
+/**
+ * @struct DrawPacket
+ * @brief Todo lo que necesita un draw; los punteros nulos no se enlazan.
+ *
+ * La cola guarda punteros a los packets: el packet, sus recursos y @c constants deben seguir
+ * vivos hasta @c RenderQueue::execute. Lo normal es que cada objeto de la escena tenga el suyo
+ * y lo reenvíe cada frame con una clave nueva.
+ */
+struct DrawPacket {
+    ShaderProgram* shader = nullptr;          // VS/PS + input layout
+    Texture*       texture = nullptr;         // Material: textura difusa en t0
+    Buffer*        vertexBuffer = nullptr;    // Slot 0
+    Buffer*        instanceBuffer = nullptr;  // Slot 1 (datos por instancia, opcional)
+    Buffer*        indexBuffer = nullptr;
+    Buffer*        constantBuffer = nullptr;  // b2 (VS y PS)
+    const void*    constants = nullptr;       // Si no es nulo, se sube a constantBuffer antes del draw
+
+    ConstantBufferManager* constantRing = nullptr;  // Si no es nulo, constantRange se enlaza en b2
+    ConstantAllocation     constantRange;            // Constantes del draw en el ring (ver allocate)
+
+    unsigned int indexCount = 0;
+    unsigned int startIndex = 0;
+    int          baseVertex = 0;
+    unsigned int instanceCount = 0;           // 0 = DrawIndexed; > 0 = DrawIndexedInstanced
+};
+
+/**
+ * @struct RenderQueueStats
+ * @brief Cambios de estado que cuesta recorrer la cola en un orden dado.
+ */
+struct RenderQueueStats {
+    size_t packets = 0;
+    size_t drawCalls = 0;
+    size_t shaderBinds = 0;      // ShaderProgram::render
+    size_t materialBinds = 0;    // Texture::render
+    size_t bufferBinds = 0;      // VB, buffer por instancia, IB y CB
+    size_t constantUpdates = 0;  // Buffer::update de las constantes del packet o enlace de su rango del ring
+
+    size_t
+        stateChanges() const { return shaderBinds + materialBinds + bufferBinds; }
+};
+
+/**
+ * @class RenderQueue
+ * @brief Draws de un frame ordenados por clave para minimizar cambios de estado.
+ *
+ * La clave se arma con @c MakeKey: capa en los bits altos, luego shader, material y
+ * profundidad. Ordenar las claves agrupa los draws que comparten shader y, dentro de él,
+ * material; la profundidad ordena lo que queda (de delante hacia atrás para opacos, al revés
+ * para transparentes). @c sort es un radix LSD de 8 bits sobre pares (clave, puntero) de 16
+ * bytes, sin mover los packets: un solo recorrido arma los ocho histogramas y se saltan las
+ * pasadas cuyo dígito es igual en todas las claves. Es estable, así que a igual clave se
+ * conserva el orden de envío.
+ */
+class
+    RenderQueue {
+public:
+    /** @brief Bits de cada campo de la clave (de más a menos significativo). */
+    static const unsigned int kLayerBits = 8;
+    static const unsigned int kShaderBits = 12;
+    static const unsigned int kMaterialBits = 20;
+    static const unsigned int kDepthBits = 24;
+
+    RenderQueue() = default;
+
+    /**
+     * @brief Arma una clave de orden.
+     * @param layer       Capa (p. ej. 0 opacos, 1 transparentes, 2 UI); los valores se truncan a sus bits.
+     * @param shader      Identificador del shader.
+     * @param material    Identificador del material.
+     * @param depth       Profundidad normalizada en [0, 1].
+     * @param backToFront Invierte la profundidad (transparentes).
+     */
+    static uint64_t
+        MakeKey(unsigned int layer, unsigned int shader, unsigned int material, float depth,
+            bool backToFront = false);
+
+    /**
+     * @brief Vacía la cola (conserva la memoria reservada).
+     */
+    void
+        clear();
+
+    /**
+     * @brief Reserva espacio para @p count packets.
+     */
+    void
+        reserve(size_t count);
+
+    /**
+     * @brief Añade un draw.
+     * @param key    Clave de orden (ver @c MakeKey).
+     * @param packet Packet del draw, no nulo (debe seguir vivo hasta @c execute).
+     *
+     * En línea: se llama una vez por draw y por frame.
+     */
+    void
+        submit(uint64_t key, const DrawPacket* packet) {
+        m_sorted = m_sorted && (m_entries.empty() || m_entries.back().key <= key);
+        m_entries.push_back(SortEntry{ key, packet });
+    }
+
+    /**
+     * @brief Ordena los packets por clave.
+     */
+    void
+        sort();
+
+    /**
+     * @brief Enlaza y dibuja los packets en orden (llama a @c sort si hace falta).
+     *
+     * Sólo se vuelve a enlazar un recurso cuando cambia respecto al packet anterior.
+     * @return Cambios de estado y draws emitidos.
+     */
+    RenderQueueStats
+        execute(DeviceContext& deviceContext);
+
+    /**
+     * @brief Cuenta los cambios de estado del orden actual sin dispositivo.
+     *
+     * Antes de @c sort es el orden de envío; después, el de las claves.
+     */
+    RenderQueueStats
+        countStateChanges() const;
+
+    /** @brief Packets en la cola. */
+    size_t size() const { return m_entries.size(); }
+
+    /** @brief Packet en la posición @p i del orden actual. */
+    const DrawPacket& getPacket(size_t i) const { return *m_entries[i].packet; }
+
+    /** @brief Clave en la posición @p i del orden actual. */
+    uint64_t getKey(size_t i) const { return m_entries[i].key; }
+
+private:
+    struct SortEntry {
+        uint64_t          key;
+        const DrawPacket* packet;
+    };
+
+    template <bool kIssue>
+    RenderQueueStats
+        walk(DeviceContext* deviceContext) const;
+
+    std::vector<SortEntry> m_entries;  // Orden actual (de envío hasta sort)
+    std::vector<SortEntry> m_scratch;
+    bool                   m_sorted = true;
+};
@@ -0,0 +1,292 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include "IResource.h"
+#include "HandleTable.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * @file ResourceManager.h
+ * @brief Registro de recursos por ruta con carga en segundo plano y handles con generación.
+ */
+
+/**
+ * @brief Referencia a un recurso del @c ResourceManager (handle de su @c HandleTable).
+ *
+ * Al liberar el recurso el handle deja de resolver, aunque su índice se vuelva a usar.
+ */
+using ResourceHandle = Handle;
+
+/**
+ * @struct ResourceManagerStats
+ * @brief Contadores acumulados del @c ResourceManager.
+ */
+struct ResourceManagerStats {
+    unsigned int requests = 0;      // Llamadas a load
+    unsigned int deduplicated = 0;  // load de una ruta ya registrada (no vuelve a cargar)
+    unsigned int loaded = 0;        // load + init correctos
+    unsigned int failed = 0;
+    unsigned int pending = 0;       // En cola o cargando (al momento de getStats)
+    unsigned int awaitingInit = 0;  // Cargados en CPU esperando init en update
+};
+
+/** @brief Cantidad de valores de @c ResourceType. */
+const size_t kResourceTypeCount = size_t(ResourceType::Material) + 1;
+
+/**
+ * @struct ResourceTypeMemory
+ * @brief Memoria residente y presupuesto de un @c ResourceType.
+ */
+struct ResourceTypeMemory {
+    size_t       cpuBytes = 0;    // Suma de getSizeInBytes de los recursos cargados
+    size_t       gpuBytes = 0;    // Suma de getGpuSizeInBytes
+    size_t       cpuBudget = 0;   // 0 = sin límite
+    size_t       gpuBudget = 0;
+    unsigned int resident = 0;    // Recursos Loaded
+    unsigned int evictions = 0;   // Acumuladas desde init
+    bool         overBudget = false;  // Sigue excedido porque lo que queda está en uso
+};
+
+/**
+ * @struct ResourceMemoryReport
+ * @brief Memoria por tipo al terminar el último @c ResourceManager::update.
+ */
+struct ResourceMemoryReport {
+    ResourceTypeMemory types[kResourceTypeCount];
+
+    const ResourceTypeMemory&
+        operator[](ResourceType type) const { return types[size_t(type)]; }
+
+    size_t
+        totalCpuBytes() const {
+        size_t total = 0;
+        for (const ResourceTypeMemory& t : types) total += t.cpuBytes;
+        return total;
+    }
+
+    size_t
+        totalGpuBytes() const {
+        size_t total = 0;
+        for (const ResourceTypeMemory& t : types) total += t.gpuBytes;
+        return total;
+    }
+};
+
+/**
+ * @class ResourceManager
+ * @brief Asocia rutas con instancias de @c IResource y las carga fuera del hilo principal.
+ *
+ * @c load registra la ruta y devuelve un handle al instante; si la ruta ya está registrada
+ * devuelve el mismo handle, aunque la carga siga en curso. @c IResource::load corre en hilos
+ * de carga propios (no en el @c JobSystem: una lectura de disco larga no debe caer en el hilo
+ * principal cuando ayuda en @c JobSystem::wait). @c IResource::init, que crea los recursos de
+ * GPU, corre en el hilo principal dentro de @c update, que se detiene al agotar el presupuesto
+ * de tiempo del frame.
+ *
+ * Al terminar (cargado o fallido) se cumplen el future del recurso y luego sus callbacks,
+ * siempre desde @c update o @c wait en el hilo principal. Salvo @c getFuture, que puede
+ * esperarse desde cualquier hilo, la API es del hilo principal.
+ *
+ * Cada tipo puede tener presupuesto de CPU y de GPU (@c setBudget). Al final de @c update se
+ * suman los bytes de los recursos cargados y, si un tipo se pasa, se descargan con
+ * @c IResource::unload los menos usados recientemente hasta volver al presupuesto. No se
+ * desaloja lo fijado con @c pin ni lo usado (@c get o @c touch) en este frame o el anterior:
+ * @c update corre al inicio del frame, antes de que se use nada. Un recurso desalojado
+ * conserva su handle y su ruta; el siguiente @c get, @c load o @c wait lo vuelve a encolar
+ * por el camino normal, así que para quien lo usa es igual que una primera carga.
+ */
+class
+    ResourceManager {
+public:
+    /** @brief Crea el recurso vacío (sin cargar) de una ruta; se llama una vez por ruta. */
+    using Factory = std::function<std::unique_ptr<IResource>(const std::string& path)>;
+
+    /** @brief Se llama en el hilo principal cuando el recurso queda Loaded o Failed. */
+    using Callback = std::function<void(ResourceHandle handle, ResourceState state)>;
+
+    ResourceManager() = default;
+    ResourceManager(const ResourceManager&) = delete;
+    ResourceManager& operator=(const ResourceManager&) = delete;
+    ~ResourceManager();
+
+    /**
+     * @brief Lanza los hilos de carga.
+     * @param loaderThreads Hilos que ejecutan @c IResource::load (al menos 1).
+     */
+    void
+        init(unsigned int loaderThreads = 1);
+
+    /**
+     * @brief Pide un recurso; lo carga sólo si la ruta no estaba registrada.
+     *
+     * Una ruta que falló sigue registrada como Failed; @c release permite reintentarla.
+     * @param path    Ruta en disco (se compara sin distinguir mayúsculas ni '/' de '\\').
+     * @param factory Crea la instancia si hace falta.
+     * @param onReady Callback opcional; si el recurso ya terminó se llama en el próximo @c update.
+     * @return Handle del recurso; inválido si @p factory no devuelve nada.
+     */
+    ResourceHandle
+        load(const std::string& path, const Factory& factory, Callback onReady = Callback());
+
+    /** @brief Handle de una ruta registrada (inválido si no lo está). */
+    ResourceHandle
+        find(const std::string& path) const;
+
+    /** @brief Estado del recurso; Unloaded si el handle no resuelve. */
+    ResourceState
+        getState(ResourceHandle handle) const;
+
+    /**
+     * @brief Future que se cumple con Loaded o Failed.
+     *
+     * Se cumple tras @c init, que corre en @c update: en el hilo principal usar @c wait.
+     * Si el handle no resuelve, el future ya viene cumplido con Unloaded.
+     */
+    std::shared_future<ResourceState>
+        getFuture(ResourceHandle handle) const;
+
+    /**
+     * @brief Recurso ya cargado e inicializado; nullptr si no lo está o el handle no resuelve.
+     *
+     * Cuenta como uso en este frame (ver @c touch). Si fue desalojado lo vuelve a cargar.
+     */
+    IResource*
+        get(ResourceHandle handle);
+
+    /** @brief @c get con el tipo concreto; nullptr si no es un @p T. */
+    template <typename T>
+    T*
+        get(ResourceHandle handle) { return dynamic_cast<T*>(get(handle)); }
+
+    /**
+     * @brief Marca el recurso como usado en este frame (no se desaloja hasta dentro de dos).
+     */
+    void
+        touch(ResourceHandle handle);
+
+    /**
+     * @brief Impide desalojar el recurso hasta el @c unpin correspondiente (se pueden anidar).
+     */
+    void
+        pin(ResourceHandle handle);
+
+    /** @brief Deshace un @c pin. */
+    void
+        unpin(ResourceHandle handle);
+
+    /**
+     * @brief Presupuesto de memoria residente de un tipo.
+     * @param cpuBytes Límite de getSizeInBytes sumado (0 = sin límite).
+     * @param gpuBytes Límite de getGpuSizeInBytes sumado (0 = sin límite).
+     */
+    void
+        setBudget(ResourceType type, size_t cpuBytes, size_t gpuBytes);
+
+    /** @brief Memoria por tipo calculada en el último @c update. */
+    const ResourceMemoryReport&
+        getMemoryReport() const { return m_memory; }
+
+    /**
+     * @brief Empieza un frame: termina las cargas pendientes (init y callbacks) y aplica los
+     *        presupuestos de memoria.
+     * @param budgetMs Tiempo máximo para init; siempre procesa al menos un recurso si hay alguno.
+     * @return Recursos terminados en esta llamada.
+     */
+    unsigned int
+        update(double budgetMs = 2.0);
+
+    /**
+     * @brief Bloquea hasta que el recurso termine de cargar y lo inicializa al momento.
+     *
+     * Si fue desalojado lo vuelve a cargar antes.
+     * @return Estado final (Unloaded si el handle no resuelve).
+     */
+    ResourceState
+        wait(ResourceHandle handle);
+
+    /**
+     * @brief Descarga el recurso y libera su slot y su ruta.
+     *
+     * Si aún está cargando, se libera cuando termine. Los handles existentes dejan de resolver.
+     */
+    void
+        release(ResourceHandle handle);
+
+    /** @brief Contadores desde @c init. */
+    ResourceManagerStats
+        getStats() const;
+
+    /**
+     * @brief Detiene los hilos de carga y descarga todos los recursos.
+     *
+     * Los handles emitidos dejan de resolver y se olvidan las rutas; después se puede volver
+     * a llamar a @c init.
+     */
+    void
+        shutdown();
+
+private:
+    struct Slot {
+        std::unique_ptr<IResource>          resource;
+        std::string                         path;      // Normalizada (clave de m_byPath)
+        std::string                         sourcePath;  // Tal como llegó a load
+        ResourceHandle                      handle;    // Vivo en m_handles hasta freeSlot
+        bool                                used = false;
+        bool                                released = false;  // release durante la carga
+        bool                                loadDone = false;  // load terminó (falta init)
+        bool                                loadOk = false;
+        bool                                evicted = false;   // Descargado por presupuesto (sigue registrado)
+        ResourceType                        type = ResourceType::Unknown;
+        ResourceState                       state = ResourceState::Unloaded;
+        uint64_t                            lastUsedFrame = 0;
+        unsigned int                        pinCount = 0;
+        size_t                              cpuBytes = 0;      // Medidos en el último update
+        size_t                              gpuBytes = 0;
+        std::vector<Callback>               callbacks;
+        std::promise<ResourceState>         promise;
+        std::shared_future<ResourceState>   future;
+    };
+
+    static std::string
+        NormalizePath(const std::string& path);
+
+    Slot*
+        resolve(ResourceHandle handle) const;
+
+    void
+        loaderLoop();
+
+    void
+        finish(uint32_t index);
+
+    void
+        freeSlot(uint32_t index);
+
+    void
+        requeue(uint32_t index);
+
+    void
+        enforceBudgets();
+
+    mutable std::mutex                     m_mutex;
+    std::condition_variable                m_loadWake;      // Hay rutas en m_loadQueue
+    std::condition_variable                m_loadDone;      // Algún load terminó
+    HandleTable                            m_handles;       // Handle -> Slot*
+    std::vector<std::unique_ptr<Slot>>     m_slots;         // Por índice de handle (se reutilizan)
+    std::unordered_map<std::string, ResourceHandle> m_byPath;
+    std::deque<uint32_t>                   m_loadQueue;     // Para los hilos de carga
+    std::deque<uint32_t>                   m_initQueue;     // load terminado; init en update
+    std::vector<std::pair<ResourceHandle, Callback>> m_lateCallbacks;  // Pedidos de recursos ya terminados
+
+    std::vector<std::thread>               m_loaders;
+    bool                                   m_stop = false;
+    ResourceManagerStats                   m_stats;
+
+    uint64_t                               m_frame = 1;     // Sube en cada update
+    ResourceMemoryReport                   m_memory;        // Incluye los presupuestos
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include "CorePrerequisites.h"
+#include "Frustum.h"
+
+/**
+ * @file SceneOctree.h
+ * @brief Octree holgado (loose octree) dinámico sobre objetos de la escena con AABB en mundo.
+ */
+
+/**
+ * @struct RayCandidate
+ * @brief Objeto cuyo AABB cruza un rayo y distancia a la que el rayo entra en él.
+ */
+struct RayCandidate {
+    unsigned int object = ~0u;
+    float        tEnter = 0.0f;
+};
+
+/**
+ * @struct OctreeStats
+ * @brief Estado del octree (para depuración y benchmarks).
+ */
+struct OctreeStats {
+    size_t       nodes = 0;          // Nodos creados (incluye los que quedaron vacíos)
+    size_t       objects = 0;        // Objetos vivos
+    size_t       rootObjects = 0;    // En la raíz (grandes o fuera de los límites)
+    unsigned int maxDepth = 0;       // Nivel más profundo con algún objeto
+};
+
+/**
+ * @class SceneOctree
+ * @brief Partición espacial para culling jerárquico y consultas sobre objetos móviles.
+ *
+ * Cada nodo cubre un cubo (su celda) pero acepta objetos que se salen de ella hasta la mitad de
+ * su lado: la caja holgada mide el doble que la celda. Así un objeto baja por su centro hasta
+ * el nodo más profundo cuya semiextensión de celda no es menor que la del objeto, sin
+ * repartirlo entre varios nodos. Una hoja sólo crea sus ocho hijos al llegar a 16 objetos, así
+ * que la profundidad sigue a la densidad de la escena. Insertar, mover y quitar cuestan
+ * O(profundidad); mover un objeto que sigue dentro de su nodo sólo actualiza su AABB.
+ *
+ * Los objetos más grandes que la raíz o con el centro fuera de ella se quedan en la raíz, cuyos
+ * objetos se prueban siempre: las consultas siguen siendo correctas, sólo menos eficientes.
+ * Los nodos no se liberan al vaciarse; las consultas saltan los subárboles vacíos por su contador.
+ */
+class
+    SceneOctree {
+public:
+    /** @brief Handle inválido. */
+    static const unsigned int kInvalid = ~0u;
+
+    /**
+     * @brief Octree con raíz de semilado 1024 centrada en el origen y 8 niveles.
+     */
+    SceneOctree();
+
+    /**
+     * @brief Vacía el octree y fija la celda raíz.
+     * @param center   Centro de la raíz.
+     * @param halfSize Semilado de la celda raíz.
+     * @param maxDepth Niveles bajo la raíz.
+     */
+    void
+        init(const XMFLOAT3& center, float halfSize, unsigned int maxDepth = 8);
+
+    /**
+     * @brief Inserta un objeto.
+     * @param aabbMin  Mínimo del AABB en mundo.
+     * @param aabbMax  Máximo del AABB en mundo.
+     * @param userData Valor libre devuelto por @c getUserData.
+     * @return Handle del objeto (los handles de objetos quitados se reutilizan).
+     */
+    unsigned int
+        insert(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax, unsigned int userData = 0);
+
+    /**
+     * @brief Cambia el AABB de un objeto y lo reubica si cambió de nodo.
+     */
+    void
+        move(unsigned int object, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+
+    /**
+     * @brief Quita un objeto.
+     */
+    void
+        remove(unsigned int object);
+
+    /**
+     * @brief Quita todos los objetos y nodos (conserva la raíz configurada).
+     */
+    void
+        clear();
+
+    /**
+     * @brief Objetos cuyo AABB toca el frustum.
+     *
+     * Los planos que contienen por completo a un nodo no se vuelven a probar en su subárbol;
+     * si no queda ninguno, el subárbol entero se añade sin pruebas.
+     * @return Cantidad de objetos añadidos a @p out (que se vacía antes).
+     */
+    size_t
+        cullFrustum(const Frustum& frustum, std::vector<unsigned int>& out) const;
+
+    /**
+     * @brief Objetos cuyo AABB toca una esfera.
+     */
+    size_t
+        querySphere(const XMFLOAT3& center, float radius, std::vector<unsigned int>& out) const;
+
+    /**
+     * @brief Objetos cuyo AABB se solapa con una caja.
+     */
+    size_t
+        queryBox(const XMFLOAT3& boxMin, const XMFLOAT3& boxMax, std::vector<unsigned int>& out) const;
+
+    /**
+     * @brief Objetos cuyo AABB cruza un rayo, ordenados por distancia de entrada.
+     *
+     * Pensado para delegar en el BVH de cada malla: en cuanto @c tEnter supera el impacto más
+     * cercano encontrado, el resto de candidatos se puede descartar.
+     * @param origin      Origen del rayo.
+     * @param direction   Dirección (no hace falta normalizarla; t se mide en sus unidades).
+     * @param maxDistance Máximo t aceptado.
+     */
+    size_t
+        queryRay(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance,
+            std::vector<RayCandidate>& out) const;
+
+    /** @brief Valor asociado en @c insert. */
+    unsigned int
+        getUserData(unsigned int object) const { return m_objects[object].userData; }
+
+    /** @brief AABB de un objeto. */
+    void
+        getBounds(unsigned int object, XMFLOAT3& outMin, XMFLOAT3& outMax) const;
+
+    /** @brief Objetos vivos. */
+    size_t size() const { return m_liveObjects; }
+
+    /** @brief Estado del árbol. */
+    OctreeStats
+        getStats() const;
+
+private:
+    struct Node {
+        XMFLOAT3     center = XMFLOAT3(0, 0, 0);
+        float        halfSize = 0.0f;         // Semilado de la celda (la caja holgada mide el doble)
+        unsigned int parent = kInvalid;
+        unsigned int firstChild = kInvalid;   // Ocho hijos contiguos
+        unsigned int depth = 0;
+        unsigned int subtreeObjects = 0;      // Objetos en el nodo y sus descendientes
+        std::vector<unsigned int> objects;
+    };
+
+    struct Object {
+        XMFLOAT3     aabbMin = XMFLOAT3(0, 0, 0);
+        XMFLOAT3     aabbMax = XMFLOAT3(0, 0, 0);
+        unsigned int node = kInvalid;  // kInvalid = handle libre
+        unsigned int slot = 0;         // Posición en node.objects
+        unsigned int userData = 0;
+    };
+
+    unsigned int
+        findNode(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+
+    bool
+        fitsChild(unsigned int node, float extent) const;
+
+    unsigned int
+        childFor(unsigned int node, const XMFLOAT3& center) const;
+
+    void
+        split(unsigned int node);
+
+    bool
+        staysInNode(unsigned int object) const;
+
+    void
+        attach(unsigned int object, unsigned int node);
+
+    void
+        detach(unsigned int object);
+
+    void
+        collectSubtree(unsigned int node, std::vector<unsigned int>& out) const;
+
+    std::vector<Node>         m_nodes;
+    std::vector<Object>       m_objects;
+    std::vector<unsigned int> m_freeObjects;
+    size_t                    m_liveObjects = 0;
+    unsigned int              m_maxDepth = 8;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+#include "Frustum.h"
+
+/**
+ * @file StaticBatcher.h
+ * @brief Batching estático: mallas inmóviles pre-transformadas a mundo y fusionadas por material
+ *        en un único vertex/index buffer compartido.
+ */
+
+/**
+ * @struct StaticMeshInstance
+ * @brief Una malla estática de la escena y su transformación World.
+ */
+struct StaticMeshInstance {
+    const MeshComponent* mesh = nullptr;
+    XMFLOAT4X4           world = XMFLOAT4X4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
+};
+
+/**
+ * @struct DrawStats
+ * @brief Comandos que cuesta dibujar un conjunto de objetos.
+ */
+struct DrawStats {
+    size_t drawCalls = 0;      // DrawIndexed
+    size_t bufferBinds = 0;    // IASetVertexBuffers + IASetIndexBuffer
+    size_t materialBinds = 0;  // Cambios de textura/material
+};
+
+/**
+ * @struct StaticBatch
+ * @brief Objetos de un mismo material, contiguos en @c StaticBatchData::mesh.
+ */
+struct StaticBatch {
+    unsigned int materialId = 0;   // En mesh.m_materials
+    unsigned int firstObject = 0;  // Primer subset en mesh.m_subsets
+    unsigned int objectCount = 0;
+    XMFLOAT3     aabbMin = XMFLOAT3(0, 0, 0);
+    XMFLOAT3     aabbMax = XMFLOAT3(0, 0, 0);
+};
+
+/**
+ * @struct StaticBatchData
+ * @brief Resultado de @c StaticBatcher::Build.
+ *
+ * @c mesh tiene los vértices ya en espacio mundo y un subset por objeto (cada subset de cada
+ * instancia), con su rango de índices, su @c baseVertex y sus cotas en mundo. Los objetos de
+ * un material son contiguos y, dentro de un batch, los vértices se agrupan en ventanas de
+ * @c MeshComponent::kMaxVertices16: el index buffer de @c Buffer::initIndexBuffer con
+ * @c mesh.m_subsets queda en 16 bits y los objetos vecinos de una ventana se dibujan juntos.
+ */
+struct StaticBatchData {
+    MeshComponent             mesh;
+    std::vector<StaticBatch>  batches;
+    std::vector<unsigned int> objectInstance;  // Instancia de origen de cada subset
+
+    DrawStats before;  // Sin batching: VB/IB por malla, material y DrawIndexed por subset
+    DrawStats after;   // Batching con todos los objetos visibles
+};
+
+/**
+ * @class StaticBatcher
+ * @brief Construye los batches estáticos y selecciona los rangos visibles por frame.
+ */
+class
+    StaticBatcher {
+public:
+    /**
+     * @brief Hornea las transformaciones y fusiona las mallas por material.
+     *
+     * Posiciones por World; normales por la inversa transpuesta; tangentes (sólo si todas
+     * las mallas las tienen) por World, con la orientación invertida si World refleja, en
+     * cuyo caso también se invierte el orden de los triángulos. Cada objeto copia sólo los
+     * vértices que referencia su rango de índices.
+     * @param instances Mallas estáticas (las nulas o vacías se ignoran).
+     * @param out       Resultado.
+     * @return @c false si no queda ningún triángulo.
+     */
+    static bool
+        Build(const std::vector<StaticMeshInstance>& instances, StaticBatchData& out);
+
+    /**
+     * @brief Rangos a dibujar de los objetos visibles.
+     *
+     * Prueba cada batch por su AABB y cada objeto por esfera y AABB. Los objetos visibles
+     * consecutivos de una misma ventana se unen en un único rango.
+     * @param data      Batches.
+     * @param frustum   Frustum en espacio mundo (View * Projection).
+     * @param outDraws  Un @c MeshSubset por DrawIndexed (@c materialId del batch).
+     * @param outBefore Coste sin batching de los mismos objetos visibles (opcional).
+     * @param outAfter  Coste con batching (opcional).
+     * @return Cantidad de objetos visibles.
+     */
+    static size_t
+        Cull(const StaticBatchData& data, const Frustum& frustum, std::vector<MeshSubset>& outDraws,
+            DrawStats* outBefore = nullptr, DrawStats* outAfter = nullptr);
+};
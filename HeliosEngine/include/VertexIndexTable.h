@@ -0,0 +1,85 @@
+#pragma once
+#include "Prerequisites.h"
+#include <cstdint>
+
+/**
+ * @file VertexIndexTable.h
+ * @brief Tabla hash plana (open addressing) para deduplicar vértices OBJ por (v, vt, vn, grupo).
+ */
+
+/**
+ * @class VertexIndexTable
+ * @brief Mapa (v, vt, vn, grupo) -> índice de vértice final, con sondeo lineal sobre un arreglo contiguo.
+ *
+ * Sustituye al @c std::map de @c OBJParser: una búsqueda es un hash y, casi siempre, un solo
+ * acceso a caché; no hay un nodo por inserción. La capacidad se pre-dimensiona con @c reserve
+ * a partir de los registros contados (atributos y esquinas de cara), así que en la práctica
+ * no hay rehash durante la carga.
+ *
+ * El grupo separa vértices con los mismos atributos que no deben compartir normal (grupos
+ * de suavizado, caras planas); vale 0 cuando el vértice ya trae su normal.
+ *
+ * La posición @c v == 0 marca un slot vacío (los índices de posición OBJ válidos son >= 1).
+ */
+class
+    VertexIndexTable {
+public:
+    /**
+     * @brief Constructor por defecto (tabla vacía, sin memoria reservada).
+     */
+    VertexIndexTable() = default;
+
+    /**
+     * @brief Reserva espacio para @p maxKeys claves con factor de carga <= 0.5.
+     * @param maxKeys Cota superior del número de claves distintas.
+     */
+    void
+        reserve(size_t maxKeys);
+
+    /**
+     * @brief Busca la clave; si no existe la inserta con @p newValue.
+     * @param v,vt,vn  Índices de posición (> 0), textura y normal.
+     * @param group    Grupo de suavizado del vértice.
+     * @param newValue Valor a insertar si la clave es nueva.
+     * @param inserted Sale en @c true si la clave no existía.
+     * @return El valor asociado a la clave (el existente o @p newValue).
+     */
+    unsigned int
+        findOrInsert(int v, int vt, int vn, int group, unsigned int newValue, bool& inserted);
+
+    /**
+     * @brief Vacía la tabla conservando la capacidad.
+     */
+    void
+        clear();
+
+    /** @brief Número de claves almacenadas. */
+    size_t size() const { return m_count; }
+
+    /** @brief Número de slots reservados. */
+    size_t capacity() const { return m_slots.size(); }
+
+private:
+    struct Slot {
+        int          v;
+        int          vt;
+        int          vn;
+        int          group;
+        unsigned int value;
+    };
+
+    static inline size_t hash(int v, int vt, int vn, int group) {
+        uint64_t h = uint64_t(uint32_t(v)) * 0x9E3779B97F4A7C15ull;
+        h ^= uint64_t(uint32_t(vt)) * 0xC2B2AE3D27D4EB4Full;
+        h ^= uint64_t(uint32_t(vn)) * 0x165667B19E3779F9ull;
+        h ^= uint64_t(uint32_t(group)) * 0x27D4EB2F165667C5ull;
+        return size_t(h ^ (h >> 29));
+    }
+
+    void
+        rehash(size_t newCapacity);
+
+    std::vector<Slot> m_slots;
+    size_t            m_mask = 0;
+    size_t            m_count = 0;
+};
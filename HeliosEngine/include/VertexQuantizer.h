@@ -0,0 +1,97 @@
+#pragma once
+#include "Prerequisites.h"
+#include "MeshComponent.h"
+
+/**
+ * @file VertexQuantizer.h
+ * @brief Conversión SIMD entre @c SimpleVertex (32 bytes) y @c PackedVertex (16 bytes).
+ */
+
+/**
+ * @struct QuantizationParams
+ * @brief Transformación de decodificación de posiciones: pos = offset + unorm * scale.
+ */
+struct QuantizationParams {
+    /** @brief Esquina mínima del AABB cuantizado. */
+    XMFLOAT3 offset = XMFLOAT3(0, 0, 0);
+
+    /** @brief Extensión del AABB por eje (1 en ejes degenerados). */
+    XMFLOAT3 scale = XMFLOAT3(1, 1, 1);
+};
+
+/**
+ * @struct QuantizationError
+ * @brief Error de ida y vuelta de una malla cuantizada.
+ */
+struct QuantizationError {
+    size_t vertexCount = 0;
+    size_t bytesBefore = 0;           // vertexCount * sizeof(SimpleVertex)
+    size_t bytesAfter = 0;            // vertexCount * sizeof(PackedVertex)
+    float  maxPositionError = 0.0f;   // Distancia máxima en unidades de la malla.
+    float  rmsPositionError = 0.0f;
+    float  maxNormalErrorDeg = 0.0f;  // Ángulo máximo entre normal original y decodificada.
+    float  maxTexCoordError = 0.0f;   // Diferencia máxima por componente UV.
+};
+
+/**
+ * @class VertexQuantizer
+ * @brief Codificador/decodificador de @c PackedVertex con kernels SSE2 (4 vértices por iteración).
+ *
+ * - Posición: UNORM16 sobre el AABB de la malla. La decodificación (escala + offset) se
+ *   pliega en la matriz World con @c GetDequantizeMatrix, así el vertex shader no cambia.
+ * - Normal: proyección octaédrica a 2 componentes SNORM16 (el shader que use normales
+ *   debe aplicar la decodificación octaédrica a NORMAL.xy).
+ * - UV: half float con redondeo al par más cercano.
+ */
+class
+    VertexQuantizer {
+public:
+    /**
+     * @brief Parámetros de cuantización para el AABB dado.
+     */
+    static QuantizationParams
+        ComputeParams(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax);
+
+    /**
+     * @brief Codifica @p count vértices.
+     */
+    static void
+        Encode(const SimpleVertex* src, size_t count, const QuantizationParams& params, PackedVertex* dst);
+
+    /**
+     * @brief Decodifica @p count vértices (normales renormalizadas).
+     */
+    static void
+        Decode(const PackedVertex* src, size_t count, const QuantizationParams& params, SimpleVertex* dst);
+
+    /**
+     * @brief Mide el error de @p packed contra los vértices originales.
+     */
+    static QuantizationError
+        MeasureError(const SimpleVertex* original, const PackedVertex* packed, size_t count,
+            const QuantizationParams& params);
+
+    /**
+     * @brief Codifica todos los vértices de @p mesh usando su AABB y reporta el error.
+     * @param mesh      Malla con @c m_aabbMin/m_aabbMax calculados.
+     * @param outPacked Vértices cuantizados.
+     * @param outParams Parámetros usados (para @c GetDequantizeMatrix).
+     */
+    static QuantizationError
+        PackMesh(const MeshComponent& mesh, std::vector<PackedVertex>& outPacked,
+            QuantizationParams& outParams);
+
+    /**
+     * @brief Matriz que lleva posiciones UNORM [0,1]^3 a espacio de la malla.
+     *
+     * Se antepone a la World: @c World = GetDequantizeMatrix(p) * World.
+     */
+    static XMMATRIX
+        GetDequantizeMatrix(const QuantizationParams& params);
+
+    /**
+     * @brief Input layout de @c PackedVertex (POSITION, NORMAL, TEXCOORD en el slot 0).
+     */
+    static std::vector<D3D11_INPUT_ELEMENT_DESC>
+        GetInputLayout();
+};
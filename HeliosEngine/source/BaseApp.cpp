@@ -1,6 +1,9 @@
 ﻿#include "../include/BaseApp.h"
 #include "../include/ModelLoader.h" 
+#include "../include/MeshOptimizer.h"
+#include "../include/JobSystem.h"
 #include <algorithm>
+#include <cstdio>
 #include <cstring>
 #include <string> 
 #include <d3dx11.h> 
@@ -17,13 +20,31 @@ SamplerState gSamLinear : register(s0);
 struct VS_IN  { 
     float3 Pos   : POSITION; 
     float2 Tex   : TEXCOORD0; 
+#if PACKED_VERTEX
+    float2 NormalOct: NORMAL;   // R16G16_SNORM octaédrica (VertexQuantizer)
+#else
     float3 Normal: NORMAL; 
+#endif
 };
 struct VS_OUT { 
     float4 Pos:SV_POSITION; 
     float2 Tex:TEXCOORD0; 
+    float3 Normal:NORMAL; 
 };
 
+// Normal en espacio de malla; con PackedVertex se despliega el octaedro igual que VertexQuantizer::Decode
+float3 DecodeNormal(VS_IN i)
+{
+#if PACKED_VERTEX
+    float3 n = float3(i.NormalOct, 1.0 - abs(i.NormalOct.x) - abs(i.NormalOct.y));
+    float  t = saturate(-n.z);
+    n.xy += (n.xy >= 0.0) ? -t : t;
+    return normalize(n);
+#else
+    return i.Normal;
+#endif
+}
+
 VS_OUT VS(VS_IN i)
 {
     VS_OUT o;
@@ -31,6 +52,7 @@ VS_OUT VS(VS_IN i)
     float4 v = mul(w, gView);
     o.Pos    = mul(v, gProj);
     o.Tex    = i.Tex;
+    o.Normal = DecodeNormal(i);
     return o;
 }
 
@@ -42,20 +64,69 @@ float4 PS(VS_OUT i):SV_Target
     return gTxDiffuse.Sample(gSamLinear, i.Tex) * vMeshColor;
 }
 )";
-// ==================================================
 
-// ---- Helpers ----
-static void ComputeAABB(const std::vector<SimpleVertex>& vtx, XMFLOAT3& outMin, XMFLOAT3& outMax)
+// Variante instanciada: la World y el color llegan por el stream del slot 1 (InstanceData)
+static const char* kHlslInstancedSource = R"(
+cbuffer CBNeverChanges      : register(b0) { float4x4 gView; }
+cbuffer CBChangeOnResize    : register(b1) { float4x4 gProj; }
+
+Texture2D    gTxDiffuse : register(t0);
+SamplerState gSamLinear : register(s0);
+
+struct VS_IN  { 
+    float3 Pos   : POSITION; 
+    float2 Tex   : TEXCOORD0; 
+#if PACKED_VERTEX
+    float2 NormalOct: NORMAL;   // R16G16_SNORM octaédrica (VertexQuantizer)
+#else
+    float3 Normal: NORMAL; 
+#endif
+    float4 W0    : INSTANCE_WORLD0; 
+    float4 W1    : INSTANCE_WORLD1; 
+    float4 W2    : INSTANCE_WORLD2; 
+    float4 Color : INSTANCE_COLOR; 
+};
+struct VS_OUT { 
+    float4 Pos:SV_POSITION; 
+    float2 Tex:TEXCOORD0; 
+    float4 Color:COLOR0; 
+    float3 Normal:NORMAL; 
+};
+
+// Normal en espacio de malla; con PackedVertex se despliega el octaedro igual que VertexQuantizer::Decode
+float3 DecodeNormal(VS_IN i)
 {
-    if (vtx.empty()) { outMin = { 0,0,0 }; outMax = { 0,0,0 }; return; }
-    XMFLOAT3 mn = vtx[0].Pos, mx = vtx[0].Pos;
-    for (const auto& v : vtx) {
-        mn.x = std::min(mn.x, v.Pos.x); mn.y = std::min(mn.y, v.Pos.y); mn.z = std::min(mn.z, v.Pos.z);
-        mx.x = std::max(mx.x, v.Pos.x); mx.y = std::max(mx.y, v.Pos.y); mx.z = std::max(mx.z, v.Pos.z);
-    }
-    outMin = mn; outMax = mx;
+#if PACKED_VERTEX
+    float3 n = float3(i.NormalOct, 1.0 - abs(i.NormalOct.x) - abs(i.NormalOct.y));
+    float  t = saturate(-n.z);
+    n.xy += (n.xy >= 0.0) ? -t : t;
+    return normalize(n);
+#else
+    return i.Normal;
+#endif
+}
+
+VS_OUT VS(VS_IN i)
+{
+    VS_OUT o;
+    float4 p = float4(i.Pos,1);
+    float4 w = float4(dot(i.W0,p), dot(i.W1,p), dot(i.W2,p), 1);
+    float4 v = mul(w, gView);
+    o.Pos    = mul(v, gProj);
+    o.Tex    = i.Tex;
+    o.Color  = i.Color;
+    o.Normal = DecodeNormal(i);
+    return o;
+}
+
+float4 PS(VS_OUT i):SV_Target
+{
+    return gTxDiffuse.Sample(gSamLinear, i.Tex) * i.Color;
 }
+)";
+// ==================================================
 
+// ---- Helpers ----
 static std::string MakeAssetPath(const char* rel)
 {
     wchar_t exePathW[MAX_PATH]{};
@@ -104,6 +175,9 @@ HRESULT BaseApp::init()
 {
     HRESULT hr = S_OK;
 
+    // El JobSystem se crea aquí para que el hilo principal sea su trabajador 0
+    JobSystem::Default();
+
     // 1) SwapChain/Device/Context + 2) RTV
     hr = m_swapChain.init(m_device, m_deviceContext, m_backBuffer, m_window);
     if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed SwapChain"); return hr; }
@@ -125,7 +199,12 @@ HRESULT BaseApp::init()
 
     // 6) InputLayout (Pos, Tex, Normal)
     std::vector<D3D11_INPUT_ELEMENT_DESC> Layout;
-    {
+    if (m_usePackedVertices) {
+        // Mismo shader con PACKED_VERTEX: POSITION llega en [0,1]^3 y m_meshToObject la devuelve
+        // a espacio de malla; NORMAL llega octaédrica y el VS la despliega
+        Layout = VertexQuantizer::GetInputLayout();
+    }
+    else {
         D3D11_INPUT_ELEMENT_DESC p{};
         p.SemanticName = "POSITION"; p.Format = DXGI_FORMAT_R32G32B32_FLOAT;
         p.InputSlot = 0; p.AlignedByteOffset = 0; p.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
@@ -152,21 +231,50 @@ HRESULT BaseApp::init()
         ID3D11RasterizerState* pRS = nullptr;
         hr = m_device.m_device->CreateRasterizerState(&rsDesc, &pRS);
         if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed RasterizerState"); return hr; }
-        m_deviceContext.m_deviceContext->RSSetState(pRS);
+        m_deviceContext.RSSetState(pRS);
         pRS->Release();
+
+        // El cono de normales supone el mismo winding que el back-face culling: con caras
+        // dobles descartaría meshlets que sí se ven
+        m_meshletConeCulling = m_meshletConeCulling && rsDesc.CullMode == D3D11_CULL_BACK;
     }
 
-    // 7) ShaderProgram desde HLSL embebido
-    hr = m_shaderProgram.initFromSource(m_device, kHlslSource, Layout);
+    // 7) ShaderProgram desde HLSL embebido; PACKED_VERTEX elige la NORMAL que declara el layout
+    const std::string shaderDefines = m_usePackedVertices ? "#define PACKED_VERTEX 1\n" : "#define PACKED_VERTEX 0\n";
+    hr = m_shaderProgram.initFromSource(m_device, shaderDefines + kHlslSource, Layout);
     if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed ShaderProgram"); return hr; }
+    if (m_instanceGrid > 0) {
+        hr = m_instancedShader.initFromSource(m_device, shaderDefines + kHlslInstancedSource, InstanceList::AppendInputLayout(Layout));
+        if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed instanced ShaderProgram"); return hr; }
+    }
 
-    // 8) Cargar modelo OBJ 
+    // 8) Cargar modelo OBJ (o su caché .hmesh si sigue vigente)
+    const std::string objPath = MakeAssetPath("Assets\\Moto\\repsol3.obj");
+    const std::string cachePath = MeshCache::GetCachePath(objPath);
+    bool writeCache = false;  // La caché se escribe cuando también están los LODs y meshlets
     {
         OBJParser loader;
-        const std::string objPath = MakeAssetPath("Assets\\Moto\\repsol3.obj");
         OutputDebugStringA(("OBJ path: " + objPath + "\n").c_str());
 
-        if (!loader.LoadOBJ(objPath, m_mesh, /*flipV=*/true)) {
+        if (m_meshCache.open(cachePath, objPath)) {
+            // Sólo metadatos: VB/IB se crean en el paso 11 directo desde la vista mapeada
+            m_mesh.m_name = objPath;
+            m_meshCache.fillMetadata(m_mesh);
+            OutputDebugStringA("Mesh cache hit\n");
+        }
+        else if (loader.LoadOBJ(objPath, m_mesh, /*flipV=*/true)) {
+            // Se optimiza una sola vez: la caché guarda el orden ya optimizado
+            const MeshOptimizeReport opt = MeshOptimizer::Optimize(m_mesh);
+            char line[160];
+            snprintf(line, sizeof(line), "Vertex cache (FIFO %u): ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+                opt.cacheSize, opt.before.acmr(), opt.after.acmr(), opt.before.atvr(), opt.after.atvr());
+            OutputDebugStringA(line);
+
+            // Rangos con baseVertex para que el index buffer sea de 16 bits
+            m_mesh.splitForIndex16();
+            writeCache = true;
+        }
+        else {
             ERROR(L"BaseApp", L"init", L"OBJ Load FAILED -> using fallback quad");
             m_mesh.m_vertex = {
                 { XMFLOAT3(-1,0,-1), XMFLOAT2(0,0), XMFLOAT3(0,1,0) },
@@ -175,11 +283,11 @@ HRESULT BaseApp::init()
                 { XMFLOAT3(-1,0, 1), XMFLOAT2(0,1), XMFLOAT3(0,1,0) },
             };
             m_mesh.m_index = { 0,1,2, 0,2,3 };
+            m_mesh.m_numVertex = (int)m_mesh.m_vertex.size();
+            m_mesh.m_numIndex = (int)m_mesh.m_index.size();
+            m_mesh.computeBounds();
         }
 
-        m_mesh.m_numVertex = (int)m_mesh.m_vertex.size();
-        m_mesh.m_numIndex = (int)m_mesh.m_index.size();
-
         OutputDebugStringA(("Mesh loaded. V=" + std::to_string(m_mesh.m_numVertex) +
             " I=" + std::to_string(m_mesh.m_numIndex) + "\n").c_str());
     }
@@ -198,22 +306,24 @@ HRESULT BaseApp::init()
     }
 
 
-    // 9) Auto-encuadre por AABB (centra y calcula distancia)
+    // 8.7) Cuantización de posiciones: la decodificación va en la World
+    QuantizationParams quantParams;
+    if (m_usePackedVertices) {
+        quantParams = VertexQuantizer::ComputeParams(m_mesh.m_aabbMin, m_mesh.m_aabbMax);
+        m_meshToObject = VertexQuantizer::GetDequantizeMatrix(quantParams);
+    }
+
+    // 9) Auto-encuadre por la esfera envolvente guardada en la malla (centra y calcula distancia)
     {
-        XMFLOAT3 aabbMin, aabbMax; ComputeAABB(m_mesh.m_vertex, aabbMin, aabbMax);
-        XMVECTOR vMin = XMLoadFloat3(&aabbMin);
-        XMVECTOR vMax = XMLoadFloat3(&aabbMax);
-        XMVECTOR vCenter = 0.5f * (vMin + vMax);
-        XMVECTOR vExt = 0.5f * (vMax - vMin);
-        float radius = XMVectorGetX(XMVector3Length(vExt)); // esfera contenedora aprox
+        const XMFLOAT3 fCenter = m_mesh.m_sphere.center;
+        float radius = m_mesh.m_sphere.radius;
 
         // World: trasladar el modelo para que su centro quede en el origen
-        XMFLOAT3 fCenter; XMStoreFloat3(&fCenter, vCenter);
-        m_World = XMMatrixTranslation(-fCenter.x, -fCenter.y, -fCenter.z);
+        m_World = m_meshToObject * XMMatrixTranslation(-fCenter.x, -fCenter.y, -fCenter.z);
 
         // Proyección
         float aspect = (float)m_window.m_width / (float)m_window.m_height;
-        float fovY = XMConvertToRadians(45.0f);
+        float fovY = m_fovY;
         m_Projection = XMMatrixPerspectiveFovLH(fovY, aspect, 0.01f, 10000.0f);
 
         // Distancia de cámara cómoda
@@ -230,9 +340,12 @@ HRESULT BaseApp::init()
     }
 
     // 10) Constant Buffers
-    if (FAILED(m_cbNeverChanges.init(m_device, sizeof(CBNeverChanges))))         return E_FAIL;
-    if (FAILED(m_cbChangeOnResize.init(m_device, sizeof(CBChangeOnResize))))     return E_FAIL;
-    if (FAILED(m_cbChangesEveryFrame.init(m_device, sizeof(CBChangesEveryFrame)))) return E_FAIL;
+    if (FAILED(m_constantBuffers.init(m_device, m_deviceContext))) return E_FAIL;
+    m_cbNeverChanges = m_constantBuffers.createBlock(m_device, sizeof(CBNeverChanges));
+    m_cbChangeOnResize = m_constantBuffers.createBlock(m_device, sizeof(CBChangeOnResize));
+    m_cbChangesEveryFrame = m_constantBuffers.createBlock(m_device, sizeof(CBChangesEveryFrame));
+    if (m_cbNeverChanges == ConstantBufferManager::kInvalid || m_cbChangeOnResize == ConstantBufferManager::kInvalid ||
+        m_cbChangesEveryFrame == ConstantBufferManager::kInvalid) return E_FAIL;
 
     cbNeverChanges.mView = XMMatrixTranspose(m_View);
     cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
@@ -240,17 +353,149 @@ HRESULT BaseApp::init()
     cb.mWorld = XMMatrixTranspose(m_World);
     cb.vMeshColor = m_vMeshColor;
 
-    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
-    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
-    m_cbChangesEveryFrame.update(m_deviceContext, nullptr, 0, nullptr, &cb, 0, 0);
+    m_constantBuffers.set(m_cbNeverChanges, cbNeverChanges);
+    m_constantBuffers.set(m_cbChangeOnResize, cbChangesOnResize);
+    m_constantBuffers.set(m_cbChangesEveryFrame, cb);
+    m_constantBuffers.commit(m_deviceContext);
 
     // 11) VB/IB + Topology
-    hr = m_vertexBuffer.init(m_device, m_mesh, D3D11_BIND_VERTEX_BUFFER);
-    if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed VertexBuffer"); return hr; }
-    hr = m_indexBuffer.init(m_device, m_mesh, D3D11_BIND_INDEX_BUFFER);
-    if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed IndexBuffer"); return hr; }
+    if (m_usePackedVertices) {
+        // Los vértices salen de la caché mapeada o de m_mesh; se codifican una sola vez
+        const SimpleVertex* src = m_meshCache.isOpen() ? m_meshCache.vertices() : m_mesh.m_vertex.data();
+        const size_t count = m_meshCache.isOpen() ? m_meshCache.vertexCount() : m_mesh.m_vertex.size();
+
+        std::vector<PackedVertex> packed(count);
+        VertexQuantizer::Encode(src, count, quantParams, packed.data());
+        const QuantizationError qerr = VertexQuantizer::MeasureError(src, packed.data(), count, quantParams);
+
+        char line[200];
+        snprintf(line, sizeof(line),
+            "Packed vertices: %zu B -> %zu B, pos max %.6f rms %.6f, normal max %.3f deg, uv max %.6f\n",
+            qerr.bytesBefore, qerr.bytesAfter, qerr.maxPositionError, qerr.rmsPositionError,
+            qerr.maxNormalErrorDeg, qerr.maxTexCoordError);
+        OutputDebugStringA(line);
+
+        hr = m_vertexBuffer.init(m_device, packed.data(), unsigned(count), sizeof(PackedVertex),
+            D3D11_BIND_VERTEX_BUFFER);
+        if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed VertexBuffer"); return hr; }
+    }
+    else if (m_meshCache.isOpen()) {
+        // Subida sin copias intermedias: CreateBuffer lee directamente de la caché mapeada
+        hr = m_vertexBuffer.init(m_device, m_meshCache.vertices(), m_meshCache.vertexCount(),
+            sizeof(SimpleVertex), D3D11_BIND_VERTEX_BUFFER);
+        if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed VertexBuffer"); return hr; }
+    }
+    else {
+        hr = m_vertexBuffer.init(m_device, m_mesh, D3D11_BIND_VERTEX_BUFFER);
+        if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed VertexBuffer"); return hr; }
+    }
+
+    // Cadena de LODs: todos los niveles comparten el VB y van concatenados en un único IB.
+    // La caché la trae construida (índices sin copiar); sólo se simplifica si falta o se
+    // guardó con otros ratios
+    {
+        const bool cached = m_meshCache.isOpen();
+        const SimpleVertex* vertices = cached ? m_meshCache.vertices() : m_mesh.m_vertex.data();
+        const unsigned int* indices = cached ? m_meshCache.indices() : m_mesh.m_index.data();
+        const bool cachedLODs = cached && m_meshCache.readLODs(m_lodRatios, m_lodChain);
+        if (!cachedLODs) {
+            MeshSimplifier::BuildLODChain(vertices,
+                cached ? m_meshCache.vertexCount() : m_mesh.m_vertex.size(),
+                indices,
+                cached ? m_meshCache.indexCount() : m_mesh.m_index.size(),
+                m_mesh.m_subsets, m_lodRatios, m_lodChain);
+        }
+        const unsigned int* lodIndices = cachedLODs ? m_meshCache.lodIndices() : m_lodChain.indices.data();
+        const size_t lodIndexCount = cachedLODs ? m_meshCache.lodIndexCount() : m_lodChain.indices.size();
+
+        std::vector<MeshSubset> ranges;
+        for (size_t i = 0; i < m_lodChain.levels.size(); ++i) {
+            const MeshLOD& level = m_lodChain.levels[i];
+            ranges.insert(ranges.end(), level.subsets.begin(), level.subsets.end());
+
+            char line[128];
+            snprintf(line, sizeof(line), "LOD %u: %zu tris, error %.6f\n",
+                unsigned(i), level.triangleCount, level.error);
+            OutputDebugStringA(line);
+        }
+
+        if (m_meshletCulling) {
+            // Meshlets por nivel; el IB es dinámico y se rellena en update() con los visibles.
+            // Vienen de la caché con los LODs; sólo se construyen si los LODs se rehicieron
+            const bool cachedMeshlets = cachedLODs && m_meshCache.readMeshlets(m_lodMeshlets) &&
+                m_lodMeshlets.size() == m_lodChain.levels.size();
+            m_lodMeshlets.resize(m_lodChain.levels.size());
+            unsigned int capacity = 0;
+            bool fits16 = true;
+            for (size_t i = 0; i < m_lodChain.levels.size(); ++i) {
+                if (!cachedMeshlets) {
+                    MeshletBuilder::Build(vertices,
+                        cached ? m_meshCache.vertexCount() : m_mesh.m_vertex.size(),
+                        lodIndices, lodIndexCount,
+                        m_lodChain.levels[i].subsets, m_lodMeshlets[i]);
+                }
+                capacity = std::max(capacity, unsigned(m_lodMeshlets[i].triangleCount * 3));
+                fits16 &= m_lodMeshlets[i].fitsIndex16;
+
+                char line[128];
+                snprintf(line, sizeof(line), "LOD %u: %zu meshlets\n",
+                    unsigned(i), m_lodMeshlets[i].meshlets.size());
+                OutputDebugStringA(line);
+            }
+            hr = m_visibleIndexBuffer.initDynamic(m_device, std::max(capacity, 3u),
+                fits16 ? sizeof(uint16_t) : sizeof(unsigned int), D3D11_BIND_INDEX_BUFFER);
+            if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed visible IndexBuffer"); return hr; }
+        }
+        if (!m_meshletCulling || m_instanceGrid > 0) {
+            // Las copias instanciadas dibujan el LOD completo, sin meshlets
+            hr = m_indexBuffer.initIndexBuffer(m_device, lodIndices, unsigned(lodIndexCount), ranges);
+            if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed IndexBuffer"); return hr; }
+        }
+
+        // BVH para picking sobre la malla completa: se construye en el JobSystem mientras
+        // arranca el render; la caché sigue mapeada hasta que termine (ver attachPickingBVH)
+        const size_t bvhVertexCount = cached ? m_meshCache.vertexCount() : m_mesh.m_vertex.size();
+        const size_t bvhIndexCount = cached ? m_meshCache.indexCount() : m_mesh.m_index.size();
+        m_picker.clear();
+        m_bvhPending = true;
+        JobSystem::Default().run([this, vertices, bvhVertexCount, indices, bvhIndexCount]() {
+            m_meshBVH.build(vertices, bvhVertexCount, indices, bvhIndexCount);
+        }, &m_bvhBuild);
+
+        // Primera carga del OBJ: la próxima arranca desde la caché con LODs y meshlets hechos
+        if (writeCache) {
+            MeshCache::write(cachePath, m_mesh, objPath, &m_lodChain, m_meshletCulling ? &m_lodMeshlets : nullptr);
+        }
+
+        // Ya están en GPU: sólo se conservan los rangos por nivel
+        m_lodChain.indices.clear();
+        m_lodChain.indices.shrink_to_fit();
+    }
     m_deviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
+    // 11.5) Instancing: rejilla de copias en el plano XZ, separadas por el diámetro de la malla
+    if (m_instanceGrid > 0) {
+        const unsigned int count = m_instanceGrid * m_instanceGrid;
+        hr = m_instanceBuffer.initInstanceBuffer(m_device, count, sizeof(InstanceData));
+        if (FAILED(hr)) { ERROR(L"BaseApp", L"init", L"Failed InstanceBuffer"); return hr; }
+
+        m_instances.clear();
+        m_instances.setBounds(m_mesh.m_sphere);
+        m_instances.setVertexTransform(m_meshToObject);
+        const float spacing = std::max(m_mesh.m_sphere.radius, 0.5f) * 2.5f;
+        const float half = 0.5f * float(m_instanceGrid - 1);
+        for (unsigned int z = 0; z < m_instanceGrid; ++z) {
+            for (unsigned int x = 0; x < m_instanceGrid; ++x) {
+                const float ox = (float(x) - half) * spacing;
+                const float oz = (float(z) - half) * spacing;
+                if (ox == 0.0f && oz == 0.0f) continue;  // Ahí ya está el modelo
+                const XMFLOAT4 tint(0.6f + 0.4f * float(x) / float(m_instanceGrid),
+                    0.6f + 0.4f * float(z) / float(m_instanceGrid), 1.0f, 1.0f);
+                m_instances.add(XMMatrixTranslation(ox, 0.0f, oz), tint);
+            }
+        }
+    }
+
     // 12) Sampler
     if (FAILED(m_samplerState.init(m_device))) { ERROR(L"BaseApp", L"init", L"Failed SamplerState"); return E_FAIL; }
 
@@ -260,8 +505,27 @@ HRESULT BaseApp::init()
     return S_OK;
 }
 
+void BaseApp::attachPickingBVH(bool wait)
+{
+    if (!m_bvhPending) return;
+    if (!m_bvhBuild.done()) {
+        if (!wait) return;
+        JobSystem::Default().wait(m_bvhBuild);  // Ayuda a terminarlo (también con un solo núcleo)
+    }
+    m_bvhPending = false;
+
+    // El BVH ya copió sus triángulos: la vista mapeada de la caché deja de hacer falta
+    m_meshCache.close();
+    if (m_meshBVH.isBuilt()) {
+        m_picker.addMesh(&m_meshBVH, XMMatrixIdentity());
+    }
+}
+
 void BaseApp::update(float deltaTime)
 {
+    // BVH de picking terminado en segundo plano: se registra sin esperar
+    attachPickingBVH(false);
+
     // --- Velocidades (grados/seg) -> rad/seg
     const float spinW = XMConvertToRadians(m_spinSpeedDeg);   // rotación del modelo
     const float orbitW = XMConvertToRadians(m_orbitSpeedDeg);  // órbita de cámara
@@ -290,17 +554,80 @@ void BaseApp::update(float deltaTime)
     // --- World: inclina -90° en X para colocar la malla, + giro sobre Y
     XMMATRIX rotX = XMMatrixRotationX(XMConvertToRadians(0.0f));
     XMMATRIX rotY = XMMatrixRotationY(m_spinAngle);
-    m_World = rotX * rotY;
+    m_World = m_meshToObject * rotX * rotY;
+
+    // --- LOD: distancia al punto más cercano de la esfera envolvente
+    {
+        const XMVECTOR center = XMVector3TransformCoord(XMLoadFloat3(&m_mesh.m_sphere.center), rotX * rotY);
+        const float radius = m_mesh.m_sphere.radius;
+        const float distance = XMVectorGetX(XMVector3Length(Eye - center)) - radius;
+        m_currentLOD = MeshSimplifier::SelectLOD(m_lodChain, std::max(distance, 0.01f), m_fovY,
+            float(m_window.m_height), m_lodPixelError);
+    }
+
+    // --- Picking: el BVH está en el espacio de los vértices originales, como los meshlets
+    if (m_picker.getMeshCount() > 0) {
+        m_picker.setWorld(0, rotX * rotY);
+    }
+
+    // --- Culling de la malla: la esfera descarta barato, la OBB ajusta mejor
+    const XMMATRIX meshWorld = rotX * rotY;
+    Frustum frustum;
+    frustum.init(meshWorld * m_View * m_Projection);
+    m_meshVisible = frustum.intersectsSphere(m_mesh.m_sphere.center, m_mesh.m_sphere.radius) &&
+        frustum.intersectsOBB(m_mesh.m_obb);
+
+    // --- Meshlets: frustum y cono en el espacio de los vértices originales (World sin decuantizar)
+    if (m_meshVisible && m_meshletCulling && m_currentLOD < m_lodMeshlets.size()) {
+
+        XMFLOAT3 cameraPosition;
+        XMStoreFloat3(&cameraPosition, XMVector3TransformCoord(Eye, XMMatrixInverse(nullptr, meshWorld)));
+
+        const MeshletData& meshlets = m_lodMeshlets[m_currentLOD];
+        MeshletBuilder::Cull(meshlets, frustum, cameraPosition, m_meshletConeCulling, m_meshletVisible);
+
+        // Sólo se reescribe el IB si cambió el conjunto visible
+        if (m_visibleLOD != m_currentLOD || m_meshletVisible != m_meshletVisiblePrev) {
+            void* dst = m_visibleIndexBuffer.map(m_deviceContext);
+            if (dst) {
+                MeshletBuilder::WriteVisibleIndices(meshlets, m_meshletVisible,
+                    m_visibleIndexBuffer.getIndexFormat() == DXGI_FORMAT_R16_UINT,
+                    dst, m_visibleIndexBuffer.getCapacity(), m_visibleRanges);
+                m_visibleIndexBuffer.unmap(m_deviceContext);
+                m_meshletVisiblePrev = m_meshletVisible;
+                m_visibleLOD = m_currentLOD;
+            }
+        }
+    }
+
+    // --- Instancing: copias girando con el modelo; sólo las visibles llegan al stream
+    if (m_instanceGrid > 0 && m_instances.size() > 0) {
+        Frustum worldFrustum;
+        worldFrustum.init(m_View * m_Projection);
+        for (unsigned int i = 0; i < m_instances.size(); ++i) {
+            // La fila de traslación guarda la posición de la copia en la rejilla
+            const XMFLOAT4X4& previous = m_instances.getWorld(i);
+            m_instances.setWorld(i, meshWorld * XMMatrixTranslation(previous.m[3][0], previous.m[3][1], previous.m[3][2]));
+        }
+        void* dst = m_instanceBuffer.map(m_deviceContext);
+        if (dst) {
+            m_visibleInstances = unsigned(m_instances.writeVisible(worldFrustum,
+                static_cast<InstanceData*>(dst), m_instanceBuffer.getCapacity()));
+            m_instanceBuffer.unmap(m_deviceContext);
+        }
+    }
 
-    // --- Subir constantes
+    // --- Subir constantes: sólo los bloques que cambiaron (la proyección casi nunca)
     cbNeverChanges.mView = XMMatrixTranspose(m_View);
     cbChangesOnResize.mProjection = XMMatrixTranspose(m_Projection);
     cb.mWorld = XMMatrixTranspose(m_World);
     cb.vMeshColor = m_vMeshColor;
 
-    m_cbNeverChanges.update(m_deviceContext, nullptr, 0, nullptr, &cbNeverChanges, 0, 0);
-    m_cbChangeOnResize.update(m_deviceContext, nullptr, 0, nullptr, &cbChangesOnResize, 0, 0);
-    m_cbChangesEveryFrame.update(m_deviceContext, nullptr, 0, nullptr, &cb, 0, 0);
+    m_constantBuffers.beginFrame();
+    m_constantBuffers.set(m_cbNeverChanges, cbNeverChanges);
+    m_constantBuffers.set(m_cbChangeOnResize, cbChangesOnResize);
+    m_constantBuffers.set(m_cbChangesEveryFrame, cb);
+    m_constantBuffers.commit(m_deviceContext);
 }
 
 
@@ -316,6 +643,31 @@ void BaseApp::onMouseWheel(int zDelta)
     OutputDebugStringA(dbg.c_str());
 }
 
+bool BaseApp::pick(int x, int y, PickResult& out) const
+{
+    return m_picker.pick(float(x), float(y), float(m_window.m_width), float(m_window.m_height),
+        m_View, m_Projection, out);
+}
+
+void BaseApp::onMouseClick(int x, int y)
+{
+    // Un click antes de que termine el BVH espera a que esté (y ayuda a construirlo)
+    attachPickingBVH(true);
+
+    PickResult result;
+    if (!pick(x, y, result)) {
+        m_lastPick = PickResult();
+        OutputDebugStringA("Pick: sin impacto\n");
+        return;
+    }
+    m_lastPick = result;
+
+    char line[160];
+    snprintf(line, sizeof(line), "Pick: malla %u, triangulo %u, uv (%.3f, %.3f), distancia %.4f\n",
+        result.mesh, result.triangle, result.u, result.v, result.distance);
+    OutputDebugStringA(line);
+}
+
 void BaseApp::render()
 {
     const float Clear[4] = { 0.05f, 0.05f, 0.05f, 1.0f };
@@ -323,41 +675,87 @@ void BaseApp::render()
 
     m_viewport.render(m_deviceContext);
     m_depthStencilView.render(m_deviceContext);
-    m_shaderProgram.render(m_deviceContext);
-
-    // VB/IB
-    m_vertexBuffer.render(m_deviceContext, 0, 1);
-    m_indexBuffer.render(m_deviceContext, 0, 1, false, DXGI_FORMAT_R32_UINT);
-
-    // CBs + textura + sampler
-    m_cbNeverChanges.render(m_deviceContext, 0, 1);
-    m_cbChangeOnResize.render(m_deviceContext, 1, 1);
-    m_cbChangesEveryFrame.render(m_deviceContext, 2, 1);
-    m_cbChangesEveryFrame.render(m_deviceContext, 2, 1, true);
-    m_textureCube.render(m_deviceContext, 0, 1);
-    m_samplerState.render(m_deviceContext, 0, 1);
 
-    // Topología
+    // Estado común a todos los draws: CBs, sampler y topología
+    m_constantBuffers.bind(m_deviceContext, m_cbNeverChanges, 0, false);
+    m_constantBuffers.bind(m_deviceContext, m_cbChangeOnResize, 1, false);
+    m_constantBuffers.bind(m_deviceContext, m_cbChangesEveryFrame, 2, true);
+    m_samplerState.render(m_deviceContext, 0, 1);
     m_deviceContext.IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
-    // Draw
-    m_deviceContext.DrawIndexed(m_mesh.m_numIndex, 0, 0);
+    // Un packet por rango: shader, textura, VB e IB van por la cola, que sólo enlaza los cambios.
+    // Se arman todos antes de enviarlos porque la cola guarda punteros a m_drawPackets
+    m_drawPackets.clear();
+    DrawPacket base;
+    base.shader = &m_shaderProgram;
+    base.texture = &m_textureCube;
+    base.vertexBuffer = &m_vertexBuffer;
+
+    // Malla principal: meshlets visibles o LOD completo (nada si quedó fuera del frustum)
+    if (m_meshVisible) {
+        base.indexBuffer = m_meshletCulling ? &m_visibleIndexBuffer : &m_indexBuffer; // R16/R32 según se creó
+        const std::vector<MeshSubset>* ranges = m_meshletCulling ? &m_visibleRanges
+            : m_currentLOD < m_lodChain.levels.size() ? &m_lodChain.levels[m_currentLOD].subsets : nullptr;
+        if (ranges) {
+            for (const MeshSubset& subset : *ranges) {
+                DrawPacket packet = base;
+                packet.indexCount = subset.indexCount;
+                packet.startIndex = subset.startIndex;
+                packet.baseVertex = INT(subset.baseVertex);
+                m_drawPackets.push_back(packet);
+            }
+        }
+    }
+    const size_t mainPackets = m_drawPackets.size();
+
+    // Copias instanciadas: World/color por instancia en el slot 1 y un DrawIndexedInstanced por
+    // rango del LOD actual para todas las copias visibles
+    if (m_visibleInstances > 0 && m_currentLOD < m_lodChain.levels.size()) {
+        base.shader = &m_instancedShader;
+        base.instanceBuffer = &m_instanceBuffer;
+        base.indexBuffer = &m_indexBuffer;
+        base.instanceCount = m_visibleInstances;
+        for (const MeshSubset& subset : m_lodChain.levels[m_currentLOD].subsets) {
+            DrawPacket packet = base;
+            packet.indexCount = subset.indexCount;
+            packet.startIndex = subset.startIndex;
+            packet.baseVertex = INT(subset.baseVertex);
+            m_drawPackets.push_back(packet);
+        }
+    }
+
+    // Opacos de delante hacia atrás: la malla principal va delante de la rejilla que la rodea
+    m_renderQueue.clear();
+    for (size_t i = 0; i < m_drawPackets.size(); ++i) {
+        const unsigned int shader = i < mainPackets ? 0u : 1u;
+        m_renderQueue.submit(RenderQueue::MakeKey(0, shader, 0, i < mainPackets ? 0.0f : 1.0f), &m_drawPackets[i]);
+    }
+    m_constantBuffers.flush(m_deviceContext);  // El ring por draw no puede seguir mapeado al dibujar
+    m_renderStats = m_renderQueue.execute(m_deviceContext);
 
     m_swapChain.present();
+
+    // Contadores del shadow state y de las constantes de este frame
+    m_constantStats = m_constantBuffers.getStats();
+    m_contextStats = m_deviceContext.getStats();
+    m_deviceContext.resetStats();
 }
 
 void BaseApp::destroy()
 {
-    if (m_deviceContext.m_deviceContext) m_deviceContext.m_deviceContext->ClearState();
+    if (m_deviceContext.m_deviceContext) m_deviceContext.ClearState();
 
     m_samplerState.destroy();
     m_textureCube.destroy();
-    m_cbNeverChanges.destroy();
-    m_cbChangeOnResize.destroy();
-    m_cbChangesEveryFrame.destroy();
+    m_constantBuffers.destroy();
     m_vertexBuffer.destroy();
     m_indexBuffer.destroy();
+    m_visibleIndexBuffer.destroy();
+    m_instanceBuffer.destroy();
+    attachPickingBVH(true);  // La tarea del BVH lee la caché mapeada
+    m_meshCache.close();
     m_shaderProgram.destroy();
+    m_instancedShader.destroy();
     m_depthStencil.destroy();
     m_depthStencilView.destroy();
     m_renderTargetView.destroy();
@@ -365,6 +763,7 @@ void BaseApp::destroy()
     m_backBuffer.destroy();
     m_deviceContext.destroy();
     m_device.destroy();
+    JobSystem::Default().shutdown();
 }
 
 LRESULT CALLBACK BaseApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
@@ -384,6 +783,10 @@ LRESULT CALLBACK BaseApp::WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM
         if (pApp) { pApp->onMouseWheel(GET_WHEEL_DELTA_WPARAM(wParam)); }
         return 0;
 
+    case WM_LBUTTONDOWN:
+        if (pApp) { pApp->onMouseClick(short(LOWORD(lParam)), short(HIWORD(lParam))); }
+        return 0;
+
     case WM_KEYDOWN:
         if (pApp) {
             switch (wParam) {
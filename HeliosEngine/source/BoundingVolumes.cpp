@@ -0,0 +1,471 @@
+#include "../include/BoundingVolumes.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Acceso a los puntos de un PointStream. Wide: cada punto tiene 16 bytes legibles
+    // (stride >= 16), así que se carga con una lectura sin alinear y se anula el 4º carril
+    template <bool Indexed, bool Wide>
+    class PointReader {
+    public:
+        explicit PointReader(const PointStream& points)
+            : m_base(static_cast<const char*>(points.positions)), m_stride(points.stride),
+              m_count(points.count), m_indices(points.indices),
+              m_mask(_mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))) {}
+
+        const float* address(size_t i) const {
+            const size_t v = Indexed ? m_indices[i] : i;
+            return reinterpret_cast<const float*>(m_base + v * m_stride);
+        }
+
+        // Punto i como (x, y, z, 0). El carril 3 se anula: lo que haya tras la posición
+        // (UV, normal) podría ser un denormal o NaN y frenar o contaminar las operaciones
+        __m128 load(size_t i) const {
+            const float* p = address(i);
+            if (Wide || (!Indexed && i + 1 < m_count)) {
+                return _mm_and_ps(_mm_loadu_ps(p), m_mask);
+            }
+            return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+        }
+
+        size_t count() const { return m_count; }
+
+    private:
+        const char*         m_base;
+        size_t              m_stride;
+        size_t              m_count;
+        const unsigned int* m_indices;
+        __m128              m_mask;
+    };
+
+    // Invoca fn con el lector adecuado al stream
+    template <class Fn>
+    void withReader(const PointStream& points, Fn&& fn) {
+        const bool wide = points.stride >= 16;
+        if (points.indices) {
+            if (wide) fn(PointReader<true, true>(points));
+            else      fn(PointReader<true, false>(points));
+        }
+        else {
+            if (wide) fn(PointReader<false, true>(points));
+            else      fn(PointReader<false, false>(points));
+        }
+    }
+
+    // Cuatro puntos en SoA; en el último bloque los índices fuera de rango repiten el último punto
+    template <class Reader>
+    void loadSoA(const Reader& reader, size_t i, __m128& x, __m128& y, __m128& z) {
+        __m128 p0, p1, p2, p3;
+        if (i + 4 <= reader.count()) {
+            p0 = reader.load(i); p1 = reader.load(i + 1);
+            p2 = reader.load(i + 2); p3 = reader.load(i + 3);
+        }
+        else {
+            const size_t last = reader.count() - 1;
+            p0 = reader.load(i);
+            p1 = reader.load(std::min(i + 1, last));
+            p2 = reader.load(std::min(i + 2, last));
+            p3 = reader.load(std::min(i + 3, last));
+        }
+        _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+        x = p0; y = p1; z = p2;
+    }
+
+    inline float lane(__m128 v, int i) {
+        float f[4];
+        _mm_storeu_ps(f, v);
+        return f[i];
+    }
+
+    inline XMFLOAT3 toFloat3(__m128 v) {
+        float f[4];
+        _mm_storeu_ps(f, v);
+        return XMFLOAT3(f[0], f[1], f[2]);
+    }
+
+    inline float hsum(__m128 v) {
+        float f[4];
+        _mm_storeu_ps(f, v);
+        return (f[0] + f[1]) + (f[2] + f[3]);
+    }
+
+    inline __m128i selecti(__m128 mask, __m128i a, __m128i b) {
+        const __m128i m = _mm_castps_si128(mask);
+        return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+    }
+
+    // ---- AABB ----------------------------------------------------------------------------
+
+    template <class Reader>
+    void aabbKernel(const Reader& reader, XMFLOAT3& outMin, XMFLOAT3& outMax) {
+        const size_t count = reader.count();
+        __m128 mn0 = reader.load(0), mx0 = mn0;
+        __m128 mn1 = mn0, mx1 = mn0, mn2 = mn0, mx2 = mn0, mn3 = mn0, mx3 = mn0;
+
+        // Cuatro acumuladores: el bucle no queda limitado por la latencia de min/max
+        size_t i = 1;
+        for (; i + 4 <= count; i += 4) {
+            const __m128 a = reader.load(i), b = reader.load(i + 1);
+            const __m128 c = reader.load(i + 2), d = reader.load(i + 3);
+            mn0 = _mm_min_ps(mn0, a); mx0 = _mm_max_ps(mx0, a);
+            mn1 = _mm_min_ps(mn1, b); mx1 = _mm_max_ps(mx1, b);
+            mn2 = _mm_min_ps(mn2, c); mx2 = _mm_max_ps(mx2, c);
+            mn3 = _mm_min_ps(mn3, d); mx3 = _mm_max_ps(mx3, d);
+        }
+        for (; i < count; ++i) {
+            const __m128 a = reader.load(i);
+            mn0 = _mm_min_ps(mn0, a); mx0 = _mm_max_ps(mx0, a);
+        }
+        outMin = toFloat3(_mm_min_ps(_mm_min_ps(mn0, mn1), _mm_min_ps(mn2, mn3)));
+        outMax = toFloat3(_mm_max_ps(_mm_max_ps(mx0, mx1), _mm_max_ps(mx2, mx3)));
+    }
+
+    // ---- Esfera --------------------------------------------------------------------------
+
+    // Direcciones de EPOS-14: ejes y diagonales del cubo (sin normalizar: sólo importa el orden)
+    const int kEposDirections = 7;
+
+    // Crece la esfera lo justo para contener p (paso de Ritter)
+    void growSphere(BoundingSphere& s, const XMFLOAT3& p) {
+        const float dx = p.x - s.center.x, dy = p.y - s.center.y, dz = p.z - s.center.z;
+        const float d2 = dx * dx + dy * dy + dz * dz;
+        if (d2 <= s.radius * s.radius) return;
+        const float d = std::sqrt(d2);
+        const float newRadius = 0.5f * (s.radius + d);
+        const float k = (newRadius - s.radius) / d;
+        s.center.x += dx * k;
+        s.center.y += dy * k;
+        s.center.z += dz * k;
+        s.radius = newRadius;
+    }
+
+    template <class Reader>
+    BoundingSphere sphereKernel(const Reader& reader) {
+        const size_t count = reader.count();
+
+        // 1) Puntos extremos sobre las 7 direcciones, 4 puntos por iteración
+        __m128  minV[kEposDirections], maxV[kEposDirections];
+        __m128i minI[kEposDirections], maxI[kEposDirections];
+        for (int k = 0; k < kEposDirections; ++k) {
+            minV[k] = _mm_set1_ps(FLT_MAX);
+            maxV[k] = _mm_set1_ps(-FLT_MAX);
+            minI[k] = maxI[k] = _mm_setzero_si128();
+        }
+
+        __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+        const __m128i step = _mm_set1_epi32(4);
+        const __m128i lastIndex = _mm_set1_epi32(int(count - 1));
+        for (size_t i = 0; i < count; i += 4) {
+            __m128 x, y, z;
+            loadSoA(reader, i, x, y, z);
+            // En el último bloque los carriles repetidos apuntan al último punto
+            const __m128i idx = i + 4 <= count ? index
+                : selecti(_mm_castsi128_ps(_mm_cmpgt_epi32(index, lastIndex)), lastIndex, index);
+
+            const __m128 xy = _mm_add_ps(x, y), xmy = _mm_sub_ps(x, y);
+            const __m128 proj[kEposDirections] = {
+                x, y, z,
+                _mm_add_ps(xy, z), _mm_sub_ps(xy, z), _mm_add_ps(xmy, z), _mm_sub_ps(xmy, z)
+            };
+            // Los extremos cambian pocas veces tras los primeros bloques: se comprueba con
+            // una sola máscara y sólo entonces se actualizan valores e índices
+            __m128 changed = _mm_setzero_ps();
+            for (int k = 0; k < kEposDirections; ++k) {
+                changed = _mm_or_ps(changed, _mm_or_ps(_mm_cmplt_ps(proj[k], minV[k]), _mm_cmpgt_ps(proj[k], maxV[k])));
+            }
+            if (_mm_movemask_ps(changed)) {
+                for (int k = 0; k < kEposDirections; ++k) {
+                    const __m128 less = _mm_cmplt_ps(proj[k], minV[k]);
+                    const __m128 greater = _mm_cmpgt_ps(proj[k], maxV[k]);
+                    minV[k] = _mm_min_ps(minV[k], proj[k]);
+                    maxV[k] = _mm_max_ps(maxV[k], proj[k]);
+                    minI[k] = selecti(less, idx, minI[k]);
+                    maxI[k] = selecti(greater, idx, maxI[k]);
+                }
+            }
+            index = _mm_add_epi32(index, step);
+        }
+
+        // 2) Reducción de carriles: un par de puntos (mínimo, máximo) por dirección
+        XMFLOAT3 extremes[2 * kEposDirections];
+        for (int k = 0; k < kEposDirections; ++k) {
+            float mnv[4], mxv[4];
+            int   mni[4], mxi[4];
+            _mm_storeu_ps(mnv, minV[k]);
+            _mm_storeu_ps(mxv, maxV[k]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(mni), minI[k]);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(mxi), maxI[k]);
+            int bestMin = 0, bestMax = 0;
+            for (int l = 1; l < 4; ++l) {
+                if (mnv[l] < mnv[bestMin]) bestMin = l;
+                if (mxv[l] > mxv[bestMax]) bestMax = l;
+            }
+            const float* a = reader.address(size_t(mni[bestMin]));
+            const float* b = reader.address(size_t(mxi[bestMax]));
+            extremes[2 * k] = XMFLOAT3(a[0], a[1], a[2]);
+            extremes[2 * k + 1] = XMFLOAT3(b[0], b[1], b[2]);
+        }
+
+        // 3) Esfera inicial sobre el par más separado, ampliada a los 14 extremos
+        int bestPair = 0;
+        float bestDist2 = -1.0f;
+        for (int k = 0; k < kEposDirections; ++k) {
+            const XMFLOAT3& a = extremes[2 * k];
+            const XMFLOAT3& b = extremes[2 * k + 1];
+            const float d2 = (b.x - a.x) * (b.x - a.x) + (b.y - a.y) * (b.y - a.y) + (b.z - a.z) * (b.z - a.z);
+            if (d2 > bestDist2) { bestDist2 = d2; bestPair = k; }
+        }
+        BoundingSphere sphere;
+        const XMFLOAT3& a = extremes[2 * bestPair];
+        const XMFLOAT3& b = extremes[2 * bestPair + 1];
+        sphere.center = XMFLOAT3(0.5f * (a.x + b.x), 0.5f * (a.y + b.y), 0.5f * (a.z + b.z));
+        sphere.radius = 0.5f * std::sqrt(bestDist2);
+        for (const XMFLOAT3& p : extremes) growSphere(sphere, p);
+
+        // 4) Pasada de Ritter: la prueba es vectorial y casi nunca hay que crecer
+        __m128 cx = _mm_set1_ps(sphere.center.x), cy = _mm_set1_ps(sphere.center.y);
+        __m128 cz = _mm_set1_ps(sphere.center.z), r2 = _mm_set1_ps(sphere.radius * sphere.radius);
+        for (size_t i = 0; i < count; i += 4) {
+            __m128 x, y, z;
+            loadSoA(reader, i, x, y, z);
+            const __m128 dx = _mm_sub_ps(x, cx), dy = _mm_sub_ps(y, cy), dz = _mm_sub_ps(z, cz);
+            const __m128 d2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            int outside = _mm_movemask_ps(_mm_cmpgt_ps(d2, r2));
+            if (!outside) continue;
+
+            for (int l = 0; l < 4 && i + l < count; ++l) {
+                if (outside & (1 << l)) {
+                    growSphere(sphere, XMFLOAT3(lane(x, l), lane(y, l), lane(z, l)));
+                }
+            }
+            cx = _mm_set1_ps(sphere.center.x);
+            cy = _mm_set1_ps(sphere.center.y);
+            cz = _mm_set1_ps(sphere.center.z);
+            r2 = _mm_set1_ps(sphere.radius * sphere.radius);
+        }
+
+        // El redondeo de los pasos de crecimiento puede dejar puntos a una fracción de ulp del borde
+        sphere.radius *= 1.0f + 4.0f * FLT_EPSILON;
+        return sphere;
+    }
+
+    // ---- OBB -----------------------------------------------------------------------------
+
+    // Autovalores y autovectores (columnas de v) de una matriz simétrica 3x3 por Jacobi
+    void jacobiEigen(double a[3][3], double v[3][3], double w[3]) {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j) v[i][j] = i == j ? 1.0 : 0.0;
+
+        for (int sweep = 0; sweep < 32; ++sweep) {
+            const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+            const double diag = a[0][0] * a[0][0] + a[1][1] * a[1][1] + a[2][2] * a[2][2];
+            if (off <= 1e-24 * diag || off == 0.0) break;
+
+            static const int kPairs[3][2] = { { 0, 1 }, { 0, 2 }, { 1, 2 } };
+            for (const auto& pair : kPairs) {
+                const int p = pair[0], q = pair[1];
+                if (a[p][q] == 0.0) continue;
+                const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+                for (int k = 0; k < 3; ++k) {
+                    const double akp = a[k][p], akq = a[k][q];
+                    a[k][p] = c * akp - s * akq;
+                    a[k][q] = s * akp + c * akq;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double apk = a[p][k], aqk = a[q][k];
+                    a[p][k] = c * apk - s * aqk;
+                    a[q][k] = s * apk + c * aqk;
+                }
+                for (int k = 0; k < 3; ++k) {
+                    const double vkp = v[k][p], vkq = v[k][q];
+                    v[k][p] = c * vkp - s * vkq;
+                    v[k][q] = s * vkp + c * vkq;
+                }
+            }
+        }
+        for (int i = 0; i < 3; ++i) w[i] = a[i][i];
+    }
+
+    template <class Reader>
+    OrientedBox obbKernel(const Reader& reader, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+        const size_t count = reader.count();
+
+        // 1) Momentos de primer y segundo orden relativos al centro del AABB (evita la
+        //    cancelación de E[x²] - E[x]² lejos del origen). Acumuladores float por bloques
+        //    de 4096 puntos, volcados a double
+        const __m128 ox = _mm_set1_ps(0.5f * (aabbMin.x + aabbMax.x));
+        const __m128 oy = _mm_set1_ps(0.5f * (aabbMin.y + aabbMax.y));
+        const __m128 oz = _mm_set1_ps(0.5f * (aabbMin.z + aabbMax.z));
+        const __m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+        double moments[9] = {};  // x, y, z, xx, yy, zz, xy, xz, yz
+        for (size_t block = 0; block < count; block += 4096) {
+            const size_t blockEnd = std::min(block + 4096, count);
+            __m128 sx = _mm_setzero_ps(), sy = sx, sz = sx, sxx = sx, syy = sx, szz = sx;
+            __m128 sxy = sx, sxz = sx, syz = sx;
+            for (size_t i = block; i < blockEnd; i += 4) {
+                __m128 x, y, z;
+                loadSoA(reader, i, x, y, z);
+                x = _mm_sub_ps(x, ox); y = _mm_sub_ps(y, oy); z = _mm_sub_ps(z, oz);
+                if (i + 4 > blockEnd) {
+                    // Carriles repetidos del último bloque: no aportan
+                    const __m128 valid = _mm_castsi128_ps(_mm_cmplt_epi32(lanes, _mm_set1_epi32(int(blockEnd - i))));
+                    x = _mm_and_ps(x, valid); y = _mm_and_ps(y, valid); z = _mm_and_ps(z, valid);
+                }
+                sx = _mm_add_ps(sx, x); sy = _mm_add_ps(sy, y); sz = _mm_add_ps(sz, z);
+                sxx = _mm_add_ps(sxx, _mm_mul_ps(x, x));
+                syy = _mm_add_ps(syy, _mm_mul_ps(y, y));
+                szz = _mm_add_ps(szz, _mm_mul_ps(z, z));
+                sxy = _mm_add_ps(sxy, _mm_mul_ps(x, y));
+                sxz = _mm_add_ps(sxz, _mm_mul_ps(x, z));
+                syz = _mm_add_ps(syz, _mm_mul_ps(y, z));
+            }
+            const __m128 sums[9] = { sx, sy, sz, sxx, syy, szz, sxy, sxz, syz };
+            for (int k = 0; k < 9; ++k) moments[k] += hsum(sums[k]);
+        }
+
+        const double n = double(count);
+        const double mx = moments[0] / n, my = moments[1] / n, mz = moments[2] / n;
+        double cov[3][3];
+        cov[0][0] = moments[3] / n - mx * mx;
+        cov[1][1] = moments[4] / n - my * my;
+        cov[2][2] = moments[5] / n - mz * mz;
+        cov[0][1] = cov[1][0] = moments[6] / n - mx * my;
+        cov[0][2] = cov[2][0] = moments[7] / n - mx * mz;
+        cov[1][2] = cov[2][1] = moments[8] / n - my * mz;
+
+        // 2) Ejes principales ordenados por varianza; el tercero se rehace con el producto
+        //    cruz para que la base quede ortonormal y de mano izquierda como la del AABB
+        double vectors[3][3], values[3];
+        jacobiEigen(cov, vectors, values);
+        int order[3] = { 0, 1, 2 };
+        std::sort(order, order + 3, [&](int l, int r) { return values[l] > values[r]; });
+
+        XMVECTOR axis0 = XMVector3Normalize(XMVectorSet(float(vectors[0][order[0]]),
+            float(vectors[1][order[0]]), float(vectors[2][order[0]]), 0.0f));
+        XMVECTOR axis1 = XMVector3Normalize(XMVectorSet(float(vectors[0][order[1]]),
+            float(vectors[1][order[1]]), float(vectors[2][order[1]]), 0.0f));
+        axis1 = XMVector3Normalize(XMVectorSubtract(axis1, XMVectorScale(axis0, XMVectorGetX(XMVector3Dot(axis0, axis1)))));
+        const XMVECTOR axis2 = XMVector3Normalize(XMVector3Cross(axis0, axis1));
+
+        OrientedBox box;
+        XMStoreFloat3(&box.axes[0], axis0);
+        XMStoreFloat3(&box.axes[1], axis1);
+        XMStoreFloat3(&box.axes[2], axis2);
+
+        // 3) Extensión sobre cada eje
+        const __m128 a0x = _mm_set1_ps(box.axes[0].x), a0y = _mm_set1_ps(box.axes[0].y), a0z = _mm_set1_ps(box.axes[0].z);
+        const __m128 a1x = _mm_set1_ps(box.axes[1].x), a1y = _mm_set1_ps(box.axes[1].y), a1z = _mm_set1_ps(box.axes[1].z);
+        const __m128 a2x = _mm_set1_ps(box.axes[2].x), a2y = _mm_set1_ps(box.axes[2].y), a2z = _mm_set1_ps(box.axes[2].z);
+        __m128 mn0 = _mm_set1_ps(FLT_MAX), mn1 = mn0, mn2 = mn0;
+        __m128 mx0 = _mm_set1_ps(-FLT_MAX), mx1 = mx0, mx2 = mx0;
+        for (size_t i = 0; i < count; i += 4) {
+            __m128 x, y, z;
+            loadSoA(reader, i, x, y, z);
+            x = _mm_sub_ps(x, ox); y = _mm_sub_ps(y, oy); z = _mm_sub_ps(z, oz);
+            const __m128 u0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, a0x), _mm_mul_ps(y, a0y)), _mm_mul_ps(z, a0z));
+            const __m128 u1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, a1x), _mm_mul_ps(y, a1y)), _mm_mul_ps(z, a1z));
+            const __m128 u2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, a2x), _mm_mul_ps(y, a2y)), _mm_mul_ps(z, a2z));
+            mn0 = _mm_min_ps(mn0, u0); mx0 = _mm_max_ps(mx0, u0);
+            mn1 = _mm_min_ps(mn1, u1); mx1 = _mm_max_ps(mx1, u1);
+            mn2 = _mm_min_ps(mn2, u2); mx2 = _mm_max_ps(mx2, u2);
+        }
+
+        auto reduceMin = [](__m128 v) {
+            v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_cvtss_f32(_mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))));
+        };
+        auto reduceMax = [](__m128 v) {
+            v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+            return _mm_cvtss_f32(_mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))));
+        };
+        const float lo[3] = { reduceMin(mn0), reduceMin(mn1), reduceMin(mn2) };
+        const float hi[3] = { reduceMax(mx0), reduceMax(mx1), reduceMax(mx2) };
+
+        XMVECTOR center = XMVectorSet(lane(ox, 0), lane(oy, 0), lane(oz, 0), 0.0f);
+        const XMVECTOR axes[3] = { axis0, axis1, axis2 };
+        for (int k = 0; k < 3; ++k) {
+            center = XMVectorAdd(center, XMVectorScale(axes[k], 0.5f * (lo[k] + hi[k])));
+        }
+        XMStoreFloat3(&box.center, center);
+        box.extents = XMFLOAT3(0.5f * (hi[0] - lo[0]), 0.5f * (hi[1] - lo[1]), 0.5f * (hi[2] - lo[2]));
+
+        // PCA no garantiza la caja mínima: con mallas ya alineadas el AABB suele ganar
+        const OrientedBox aabbBox = BoundingVolumes::BoxFromAABB(aabbMin, aabbMax);
+        return box.volume() < aabbBox.volume() ? box : aabbBox;
+    }
+}
+
+void
+BoundingVolumes::ComputeAABB(const PointStream& points, XMFLOAT3& outMin, XMFLOAT3& outMax) {
+    if (points.count == 0 || !points.positions) {
+        outMin = outMax = XMFLOAT3(0, 0, 0);
+        return;
+    }
+    withReader(points, [&](const auto& reader) { aabbKernel(reader, outMin, outMax); });
+}
+
+BoundingSphere
+BoundingVolumes::ComputeSphere(const PointStream& points) {
+    BoundingSphere sphere;
+    if (points.count == 0 || !points.positions) return sphere;
+    withReader(points, [&](const auto& reader) { sphere = sphereKernel(reader); });
+    return sphere;
+}
+
+OrientedBox
+BoundingVolumes::ComputeOBB(const PointStream& points) {
+    OrientedBox box;
+    if (points.count == 0 || !points.positions) return box;
+    withReader(points, [&](const auto& reader) {
+        XMFLOAT3 mn, mx;
+        aabbKernel(reader, mn, mx);
+        box = obbKernel(reader, mn, mx);
+    });
+    return box;
+}
+
+void
+BoundingVolumes::ComputeAll(const PointStream& points, XMFLOAT3& outMin, XMFLOAT3& outMax,
+    BoundingSphere& outSphere, OrientedBox& outBox) {
+    if (points.count == 0 || !points.positions) {
+        outMin = outMax = XMFLOAT3(0, 0, 0);
+        outSphere = BoundingSphere();
+        outBox = OrientedBox();
+        return;
+    }
+    withReader(points, [&](const auto& reader) {
+        aabbKernel(reader, outMin, outMax);
+        outSphere = sphereKernel(reader);
+        outBox = obbKernel(reader, outMin, outMax);
+    });
+
+    // La esfera del AABB a veces es menor que la de EPOS (cajas casi cúbicas llenas)
+    const BoundingSphere aabbSphere = SphereFromAABB(outMin, outMax);
+    if (aabbSphere.radius < outSphere.radius) outSphere = aabbSphere;
+}
+
+BoundingSphere
+BoundingVolumes::SphereFromAABB(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    BoundingSphere sphere;
+    sphere.center = XMFLOAT3(0.5f * (aabbMin.x + aabbMax.x), 0.5f * (aabbMin.y + aabbMax.y),
+        0.5f * (aabbMin.z + aabbMax.z));
+    const float ex = 0.5f * (aabbMax.x - aabbMin.x);
+    const float ey = 0.5f * (aabbMax.y - aabbMin.y);
+    const float ez = 0.5f * (aabbMax.z - aabbMin.z);
+    sphere.radius = std::sqrt(ex * ex + ey * ey + ez * ez);
+    return sphere;
+}
+
+OrientedBox
+BoundingVolumes::BoxFromAABB(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    OrientedBox box;
+    box.center = XMFLOAT3(0.5f * (aabbMin.x + aabbMax.x), 0.5f * (aabbMin.y + aabbMax.y),
+        0.5f * (aabbMin.z + aabbMax.z));
+    box.extents = XMFLOAT3(0.5f * (aabbMax.x - aabbMin.x), 0.5f * (aabbMax.y - aabbMin.y),
+        0.5f * (aabbMax.z - aabbMin.z));
+    return box;
+}
@@ -21,30 +21,197 @@ Buffer::init(Device& device, const MeshComponent& mesh, unsigned int bindFlag) {
 		return E_INVALIDARG;
 	}
 
+	// Configura tamao/stride y datos iniciales segn el tipo de buffer
+	if (bindFlag & D3D11_BIND_VERTEX_BUFFER) {
+		return init(device, mesh.m_vertex.data(),
+			static_cast<unsigned int>(mesh.m_vertex.size()), sizeof(SimpleVertex), bindFlag);
+	}
+	if (bindFlag & D3D11_BIND_INDEX_BUFFER) {
+		return initIndexBuffer(device, mesh.m_index.data(),
+			static_cast<unsigned int>(mesh.m_index.size()), mesh.m_subsets);
+	}
+
+	ERROR("Buffer", "init", "Unsupported BindFlag");
+	return E_INVALIDARG;
+}
+
+HRESULT
+Buffer::init(Device& device,
+	const void* data,
+	unsigned int elementCount,
+	unsigned int stride,
+	unsigned int bindFlag) {
+	// Valida que el dispositivo exista
+	if (!device.m_device) {
+		ERROR("Buffer", "init", "Device is null.");
+		return E_POINTER;
+	}
+	// Debe haber datos que subir
+	if (!data || elementCount == 0 || stride == 0) {
+		ERROR("Buffer", "init", "Initial data is empty");
+		return E_INVALIDARG;
+	}
+
 	// Descriptores base para crear el buffer
 	D3D11_BUFFER_DESC desc = {};
-	D3D11_SUBRESOURCE_DATA data = {};
+	D3D11_SUBRESOURCE_DATA initData = {};
 
 	desc.Usage = D3D11_USAGE_DEFAULT;     // GPU read / GPU write por comandos
 	desc.CPUAccessFlags = 0;               // CPU no escribe directamente
+	desc.ByteWidth = stride * elementCount;
+	desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
 	m_bindFlag = bindFlag;                 // Guardar tipo de enlace (VB/IB/CB)
+	m_stride = stride;
+	m_capacity = elementCount;
+	m_indexFormat = (stride == sizeof(uint16_t)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	initData.pSysMem = data;               // CreateBuffer copia los datos: no hace falta que sigan vivos
 
-	// Configura tamao/stride y datos iniciales segn el tipo de buffer
-	if (bindFlag & D3D11_BIND_VERTEX_BUFFER) {
-		m_stride = sizeof(SimpleVertex);
-		desc.ByteWidth = m_stride * static_cast<unsigned int>(mesh.m_vertex.size());
-		desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
-		data.pSysMem = mesh.m_vertex.data();  // datos de vrtices
+	// Crea el buffer en GPU
+	return createBuffer(device, desc, &initData);
+}
+
+HRESULT
+Buffer::initIndexBuffer(Device& device,
+	const unsigned int* indices,
+	unsigned int indexCount,
+	const std::vector<MeshSubset>& ranges) {
+	if (!indices || indexCount == 0) {
+		ERROR("Buffer", "initIndexBuffer", "Index buffer is empty");
+		return E_INVALIDARG;
 	}
-	else if (bindFlag & D3D11_BIND_INDEX_BUFFER) {
-		m_stride = sizeof(unsigned int);
-		desc.ByteWidth = m_stride * static_cast<unsigned int>(mesh.m_index.size());
-		desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
-		data.pSysMem = mesh.m_index.data();   // datos de ndices
+
+	MeshSubset whole;
+	whole.indexCount = indexCount;
+	const MeshSubset* first = ranges.empty() ? &whole : ranges.data();
+	const MeshSubset* last = ranges.empty() ? &whole + 1 : ranges.data() + ranges.size();
+
+	// Comprueba que cada ndice quede en [baseVertex, baseVertex + 65535] de su rango
+	bool fits16 = true;
+	bool rebased = false;
+	for (const MeshSubset* r = first; r != last; ++r) {
+		if (uint64_t(r->startIndex) + r->indexCount > indexCount) {
+			ERROR("Buffer", "initIndexBuffer", "Subset out of range");
+			return E_INVALIDARG;
+		}
+		rebased |= (r->baseVertex != 0);
+		for (unsigned int i = r->startIndex; i < r->startIndex + r->indexCount; ++i) {
+			if (indices[i] < r->baseVertex) {
+				ERROR("Buffer", "initIndexBuffer", "Index below subset baseVertex");
+				return E_INVALIDARG;
+			}
+			fits16 &= (indices[i] - r->baseVertex < MeshComponent::kMaxVertices16);
+		}
 	}
 
-	// Crea el buffer en GPU
-	return createBuffer(device, desc, &data);
+	if (fits16) {
+		std::vector<uint16_t> local(indexCount, 0);
+		for (const MeshSubset* r = first; r != last; ++r) {
+			for (unsigned int i = r->startIndex; i < r->startIndex + r->indexCount; ++i) {
+				local[i] = static_cast<uint16_t>(indices[i] - r->baseVertex);
+			}
+		}
+		return init(device, local.data(), indexCount, sizeof(uint16_t), D3D11_BIND_INDEX_BUFFER);
+	}
+	if (!rebased) {
+		return init(device, indices, indexCount, sizeof(unsigned int), D3D11_BIND_INDEX_BUFFER);
+	}
+
+	std::vector<unsigned int> local(indices, indices + indexCount);
+	for (const MeshSubset* r = first; r != last; ++r) {
+		for (unsigned int i = r->startIndex; i < r->startIndex + r->indexCount; ++i) {
+			local[i] -= r->baseVertex;
+		}
+	}
+	return init(device, local.data(), indexCount, sizeof(unsigned int), D3D11_BIND_INDEX_BUFFER);
+}
+
+HRESULT
+Buffer::initDynamic(Device& device,
+	unsigned int elementCount,
+	unsigned int stride,
+	unsigned int bindFlag) {
+	// Valida que el dispositivo exista
+	if (!device.m_device) {
+		ERROR("Buffer", "initDynamic", "Device is null.");
+		return E_POINTER;
+	}
+	if (elementCount == 0 || stride == 0) {
+		ERROR("Buffer", "initDynamic", "Capacity is zero");
+		return E_INVALIDARG;
+	}
+
+	D3D11_BUFFER_DESC desc = {};
+	desc.Usage = D3D11_USAGE_DYNAMIC;             // GPU lee, CPU reescribe con Map
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.ByteWidth = stride * elementCount;
+	desc.BindFlags = (D3D11_BIND_FLAG)bindFlag;
+	m_bindFlag = bindFlag;
+	m_stride = stride;
+	m_capacity = elementCount;
+	m_indexFormat = (stride == sizeof(uint16_t)) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	// Sin datos iniciales: el contenido se escribe con map()/unmap()
+	return createBuffer(device, desc, nullptr);
+}
+
+HRESULT
+Buffer::initInstanceBuffer(Device& device,
+	unsigned int capacity,
+	unsigned int stride) {
+	// Para D3D es un VB dinmico ms; el paso por instancia lo fija el input layout
+	HRESULT hr = initDynamic(device, capacity, stride, D3D11_BIND_VERTEX_BUFFER);
+	m_perInstance = SUCCEEDED(hr);
+	return hr;
+}
+
+HRESULT
+Buffer::initDynamicConstant(Device& device, unsigned int ByteWidth) {
+	if (!device.m_device) {
+		ERROR("Buffer", "initDynamicConstant", "Device is null.");
+		return E_POINTER;
+	}
+	if (ByteWidth == 0 || ByteWidth % 16 != 0) {
+		ERROR("Buffer", "initDynamicConstant", "ByteWidth must be a non-zero multiple of 16");
+		return E_INVALIDARG;
+	}
+
+	D3D11_BUFFER_DESC desc = {};
+	desc.Usage = D3D11_USAGE_DYNAMIC;             // GPU lee, CPU reescribe con Map
+	desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	desc.ByteWidth = ByteWidth;
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	m_bindFlag = desc.BindFlags;
+	m_stride = ByteWidth;
+	m_capacity = 1;
+
+	// Sin datos iniciales: el contenido se escribe con map()/unmap()
+	return createBuffer(device, desc, nullptr);
+}
+
+void*
+Buffer::map(DeviceContext& deviceContext, D3D11_MAP mapType) {
+	if (!m_buffer) {
+		ERROR("Buffer", "map", "m_buffer is null.");
+		return nullptr;
+	}
+	// WRITE_DISCARD entrega memoria nueva: la GPU puede seguir leyendo la anterior.
+	// NO_OVERWRITE devuelve la misma memoria sin esperar a la GPU
+	D3D11_MAPPED_SUBRESOURCE mapped = {};
+	HRESULT hr = deviceContext.Map(m_buffer, 0, mapType, 0, &mapped);
+	if (FAILED(hr)) {
+		ERROR("Buffer", "map", "Failed to map buffer");
+		return nullptr;
+	}
+	return mapped.pData;
+}
+
+void
+Buffer::unmap(DeviceContext& deviceContext) {
+	if (!m_buffer) {
+		ERROR("Buffer", "unmap", "m_buffer is null.");
+		return;
+	}
+	deviceContext.Unmap(m_buffer, 0);
 }
 
 HRESULT
@@ -91,7 +258,7 @@ Buffer::update(DeviceContext& deviceContext,
 		return;
 	}
 	// Sube datos al recurso (usa el propio m_buffer como destino)
-	deviceContext.m_deviceContext->UpdateSubresource(m_buffer,
+	deviceContext.UpdateSubresource(m_buffer,
 		DstSubresource,
 		pDstBox,
 		pSrcData,
@@ -120,19 +287,21 @@ Buffer::render(DeviceContext& deviceContext,
 	// Enlaza el buffer segn su tipo (VB/IB/CB)
 	switch (m_bindFlag) {
 	case D3D11_BIND_VERTEX_BUFFER:
-		// Asigna VB al IA (con stride y offset internos)
-		deviceContext.m_deviceContext->IASetVertexBuffers(StartSlot, NumBuffers, &m_buffer, &m_stride, &m_offset);
+		// Asigna VB al IA (con stride y offset internos); los streams por instancia van
+		// en su propio StartSlot, el que declara el input layout instanciado
+		deviceContext.IASetVertexBuffers(StartSlot, NumBuffers, &m_buffer, &m_stride, &m_offset);
 		break;
 	case D3D11_BIND_CONSTANT_BUFFER:
 		// Enlaza CB al VS y opcionalmente al PS
-		deviceContext.m_deviceContext->VSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
+		deviceContext.VSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
 		if (setPixelShader) {
-			deviceContext.m_deviceContext->PSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
+			deviceContext.PSSetConstantBuffers(StartSlot, NumBuffers, &m_buffer);
 		}
 		break;
 	case D3D11_BIND_INDEX_BUFFER:
 		// Asigna IB al IA con formato (R16/R32) y offset
-		deviceContext.m_deviceContext->IASetIndexBuffer(m_buffer, format, m_offset);
+		deviceContext.IASetIndexBuffer(m_buffer,
+			format == DXGI_FORMAT_UNKNOWN ? m_indexFormat : format, m_offset);
 		break;
 	default:
 		// Tipo de bind no soportado por este mtodo
@@ -141,10 +310,31 @@ Buffer::render(DeviceContext& deviceContext,
 	}
 }
 
+void
+Buffer::renderRange(DeviceContext& deviceContext,
+	unsigned int StartSlot,
+	unsigned int firstConstant,
+	unsigned int numConstants,
+	bool setPixelShader) {
+	if (!m_buffer) {
+		ERROR("Buffer", "renderRange", "m_buffer is null.");
+		return;
+	}
+	if (m_bindFlag != D3D11_BIND_CONSTANT_BUFFER) {
+		ERROR("Buffer", "renderRange", "Only constant buffers can be bound by range");
+		return;
+	}
+	deviceContext.VSSetConstantBuffers1(StartSlot, 1, &m_buffer, &firstConstant, &numConstants);
+	if (setPixelShader) {
+		deviceContext.PSSetConstantBuffers1(StartSlot, 1, &m_buffer, &firstConstant, &numConstants);
+	}
+}
+
 void
 Buffer::destroy() {
 	// Libera recurso GPU y pone a nullptr
 	SAFE_RELEASE(m_buffer);
+	m_perInstance = false;
 }
 
 HRESULT
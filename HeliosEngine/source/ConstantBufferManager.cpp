@@ -0,0 +1,189 @@
+#include "../include/ConstantBufferManager.h"
+#include "../include/Device.h"
+#include "../include/DeviceContext.h"
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    inline unsigned int alignUp(unsigned int value, unsigned int alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+HRESULT
+ConstantBufferManager::init(Device& device, DeviceContext& deviceContext, unsigned int ringBytes) {
+    if (!device.m_device) {
+        ERROR(L"ConstantBufferManager", L"init", L"Device is null.");
+        return E_POINTER;
+    }
+    destroy();
+
+    // El ring necesita enlazar rangos de un CB y mapearlo con NO_OVERWRITE (D3D11.1)
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    m_ringOffsets = deviceContext.supportsConstantBufferOffsets() &&
+        SUCCEEDED(device.m_device->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof(options))) &&
+        options.ConstantBufferOffsetting && options.MapNoOverwriteOnDynamicConstantBuffer;
+
+    if (m_ringOffsets) {
+        m_ringCapacity = alignUp(std::max(ringBytes, unsigned(kMaxAllocation)), kRingAlignment);
+        return m_ring.initDynamicConstant(device, m_ringCapacity);
+    }
+
+    // Sin D3D11.1: un CB dinámico donde cada draw copia su rango
+    m_ringCapacity = 0;
+    return m_ring.initDynamicConstant(device, kMaxAllocation);
+}
+
+unsigned int
+ConstantBufferManager::createBlock(Device& device, unsigned int byteWidth) {
+    if (byteWidth == 0 || byteWidth > kMaxAllocation) {
+        ERROR(L"ConstantBufferManager", L"createBlock", L"Tamaño de bloque inválido");
+        return kInvalid;
+    }
+    Block block;
+    block.data.assign(alignUp(byteWidth, 16), 0);
+    if (FAILED(block.buffer.init(device, unsigned(block.data.size())))) {
+        ERROR(L"ConstantBufferManager", L"createBlock", L"No se pudo crear el constant buffer");
+        return kInvalid;
+    }
+    m_blocks.push_back(block);
+    return unsigned(m_blocks.size() - 1);
+}
+
+void
+ConstantBufferManager::set(unsigned int block, const void* data, unsigned int size) {
+    if (block >= m_blocks.size() || !data || size > m_blocks[block].data.size()) {
+        ERROR(L"ConstantBufferManager", L"set", L"Bloque o tamaño inválido");
+        return;
+    }
+    Block& b = m_blocks[block];
+    if (std::memcmp(b.data.data(), data, size) == 0) {
+        ++m_stats.unchangedSets;
+        return;
+    }
+    std::memcpy(b.data.data(), data, size);
+    ++b.version;
+}
+
+void
+ConstantBufferManager::commit(DeviceContext& deviceContext) {
+    for (Block& b : m_blocks) {
+        if (b.version == b.uploadedVersion) continue;
+        b.buffer.update(deviceContext, nullptr, 0, nullptr, b.data.data(), 0, 0);
+        b.uploadedVersion = b.version;
+        ++m_stats.blockUploads;
+        m_stats.blockBytes += b.data.size();
+    }
+}
+
+void
+ConstantBufferManager::bind(DeviceContext& deviceContext, unsigned int block, unsigned int slot, bool setPixelShader) {
+    if (block >= m_blocks.size()) {
+        ERROR(L"ConstantBufferManager", L"bind", L"Bloque inválido");
+        return;
+    }
+    m_blocks[block].buffer.render(deviceContext, slot, 1, setPixelShader);
+}
+
+void
+ConstantBufferManager::beginFrame() {
+    m_stats = ConstantUploadStats();
+    m_cpuRing.clear();
+}
+
+ConstantAllocation
+ConstantBufferManager::allocate(DeviceContext& deviceContext, const void* data, unsigned int size) {
+    ConstantAllocation allocation;
+    if (!data || size == 0 || size > kMaxAllocation) {
+        ERROR(L"ConstantBufferManager", L"allocate", L"Tamaño de asignación inválido");
+        return allocation;
+    }
+    const unsigned int aligned = alignUp(size, kRingAlignment);
+
+    if (!m_ringOffsets) {
+        const size_t offset = m_cpuRing.size();
+        m_cpuRing.resize(offset + aligned, 0);
+        std::memcpy(m_cpuRing.data() + offset, data, size);
+        allocation.firstConstant = unsigned(offset / 16);
+        allocation.constantCount = aligned / 16;
+        ++m_stats.ringAllocations;
+        return allocation;
+    }
+
+    if (!m_mapped) {
+        // Un Map por tramo. Si no caben ni esta asignación ni otro tramo como el anterior, se
+        // vuelve al inicio con DISCARD (el driver da memoria nueva y la GPU sigue con la vieja);
+        // si no, NO_OVERWRITE a continuación de lo que la GPU aún puede estar leyendo
+        const bool wrap = !m_ringWritten ||
+            m_head + std::max(aligned, m_lastSegmentBytes) > m_ringCapacity;
+        if (wrap) m_head = 0;
+        m_mapped = static_cast<unsigned char*>(m_ring.map(deviceContext,
+            wrap ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE));
+        if (!m_mapped) return allocation;
+        ++(wrap ? m_stats.discardMaps : m_stats.noOverwriteMaps);
+        m_segmentStart = m_head;
+        m_ringWritten = true;
+    }
+
+    // Dentro de un tramo no se puede dar la vuelta: lo ya asignado se perdería con el DISCARD
+    if (m_head + aligned > m_ringCapacity) {
+        ++m_stats.ringOverflows;
+        ERROR(L"ConstantBufferManager", L"allocate", L"Ring lleno: aumentar ringBytes");
+        return allocation;
+    }
+    std::memcpy(m_mapped + m_head, data, size);
+    allocation.firstConstant = m_head / 16;
+    allocation.constantCount = aligned / 16;
+    m_head += aligned;
+    ++m_stats.ringAllocations;
+    m_stats.ringBytes += aligned;
+    return allocation;
+}
+
+void
+ConstantBufferManager::flush(DeviceContext& deviceContext) {
+    if (!m_mapped) return;
+    m_ring.unmap(deviceContext);
+    m_mapped = nullptr;
+    m_lastSegmentBytes = m_head - m_segmentStart;
+}
+
+void
+ConstantBufferManager::bindAllocation(DeviceContext& deviceContext, const ConstantAllocation& allocation,
+    unsigned int slot, bool setPixelShader) {
+    if (!allocation.valid()) return;
+    if (m_ringOffsets) {
+        m_ring.renderRange(deviceContext, slot, allocation.firstConstant, allocation.constantCount, setPixelShader);
+        return;
+    }
+
+    // Sin rangos: se copia el rango al inicio del CB con un Map DISCARD por draw
+    const size_t offset = size_t(allocation.firstConstant) * 16;
+    const size_t bytes = size_t(allocation.constantCount) * 16;
+    if (offset + bytes > m_cpuRing.size()) {
+        ERROR(L"ConstantBufferManager", L"bindAllocation", L"Asignación de otro frame");
+        return;
+    }
+    void* dst = m_ring.map(deviceContext);
+    if (!dst) return;
+    std::memcpy(dst, m_cpuRing.data() + offset, bytes);
+    m_ring.unmap(deviceContext);
+    ++m_stats.discardMaps;
+    m_stats.ringBytes += bytes;
+    m_ring.render(deviceContext, slot, 1, setPixelShader);
+}
+
+void
+ConstantBufferManager::destroy() {
+    for (Block& b : m_blocks) b.buffer.destroy();
+    m_blocks.clear();
+    m_ring.destroy();
+    m_ringOffsets = false;
+    m_ringCapacity = 0;
+    m_head = m_segmentStart = m_lastSegmentBytes = 0;
+    m_mapped = nullptr;
+    m_ringWritten = false;
+    m_cpuRing.clear();
+    m_stats = ConstantUploadStats();
+}
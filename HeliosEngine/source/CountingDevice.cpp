@@ -0,0 +1,172 @@
+#include "../include/CountingDevice.h"
+#include <algorithm>
+#include <cstring>
+
+CountingBuffer::CountingBuffer(const D3D11_BUFFER_DESC& desc)
+    : m_desc(desc), m_data(desc.ByteWidth, static_cast<unsigned char>(kFreshByte)), m_written(desc.ByteWidth, false) {
+}
+
+HRESULT STDMETHODCALLTYPE
+CountingBuffer::QueryInterface(REFIID riid, void** ppvObject) {
+    if (!ppvObject) return E_POINTER;
+    if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11Resource) || riid == __uuidof(ID3D11Buffer)) {
+        *ppvObject = static_cast<ID3D11Buffer*>(this);
+        AddRef();
+        return S_OK;
+    }
+    *ppvObject = nullptr;
+    return E_NOINTERFACE;
+}
+
+ULONG STDMETHODCALLTYPE
+CountingBuffer::Release() {
+    const ULONG count = --m_refCount;
+    if (count == 0) delete this;
+    return count;
+}
+
+HRESULT STDMETHODCALLTYPE
+CountingDevice::QueryInterface(REFIID riid, void** ppvObject) {
+    if (!ppvObject) return E_POINTER;
+    if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11Device)) {
+        *ppvObject = static_cast<ID3D11Device*>(this);
+        AddRef();
+        return S_OK;
+    }
+    *ppvObject = nullptr;
+    return E_NOINTERFACE;
+}
+
+HRESULT STDMETHODCALLTYPE
+CountingDevice::CreateBuffer(const D3D11_BUFFER_DESC* pDesc,
+    const D3D11_SUBRESOURCE_DATA* pInitialData, ID3D11Buffer** ppBuffer) {
+    if (!pDesc || !ppBuffer || pDesc->ByteWidth == 0) return E_INVALIDARG;
+    CountingBuffer* buffer = new CountingBuffer(*pDesc);
+    if (pInitialData && pInitialData->pSysMem) {
+        std::memcpy(buffer->m_data.data(), pInitialData->pSysMem, pDesc->ByteWidth);
+    }
+    *ppBuffer = buffer;
+    return S_OK;
+}
+
+HRESULT STDMETHODCALLTYPE
+CountingDevice::CheckFeatureSupport(D3D11_FEATURE Feature, void* pFeatureSupportData,
+    UINT FeatureSupportDataSize) {
+    if (Feature != D3D11_FEATURE_D3D11_OPTIONS || !pFeatureSupportData ||
+        FeatureSupportDataSize != sizeof(D3D11_FEATURE_DATA_D3D11_OPTIONS)) {
+        return E_INVALIDARG;
+    }
+    D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+    options.ConstantBufferOffsetting = m_constantBufferOffsets;
+    options.MapNoOverwriteOnDynamicConstantBuffer = m_constantBufferOffsets;
+    std::memcpy(pFeatureSupportData, &options, sizeof(options));
+    return S_OK;
+}
+
+const unsigned char*
+CountingDeviceContext::boundConstants(unsigned int slot, size_t& bytes) const {
+    bytes = 0;
+    if (slot >= kConstantSlots || !m_vsConstants[slot].buffer) return nullptr;
+    const ConstantBinding& binding = m_vsConstants[slot];
+    const size_t offset = size_t(binding.firstConstant) * 16;
+    if (offset >= binding.buffer->size()) return nullptr;
+    bytes = binding.numConstants ? size_t(binding.numConstants) * 16 : binding.buffer->size();
+    bytes = std::min(bytes, binding.buffer->size() - offset);
+    return binding.buffer->data() + offset;
+}
+
+HRESULT STDMETHODCALLTYPE
+CountingDeviceContext::QueryInterface(REFIID riid, void** ppvObject) {
+    if (!ppvObject) return E_POINTER;
+    if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3D11DeviceContext) ||
+        (m_constantBufferOffsets && riid == __uuidof(ID3D11DeviceContext1))) {
+        *ppvObject = static_cast<ID3D11DeviceContext1*>(this);
+        AddRef();
+        return S_OK;
+    }
+    *ppvObject = nullptr;
+    return E_NOINTERFACE;
+}
+
+HRESULT STDMETHODCALLTYPE
+CountingDeviceContext::Map(ID3D11Resource* pResource, UINT Subresource, D3D11_MAP MapType,
+    UINT, D3D11_MAPPED_SUBRESOURCE* pMappedResource) {
+    CountingBuffer* buffer = static_cast<CountingBuffer*>(pResource);
+    if (!buffer || !pMappedResource || Subresource != 0 || buffer->m_mapped) return E_INVALIDARG;
+    if (buffer->m_desc.Usage != D3D11_USAGE_DYNAMIC) return E_INVALIDARG;
+
+    if (MapType == D3D11_MAP_WRITE_DISCARD) {
+        // Memoria renombrada: lo anterior sigue siendo de la GPU y el tramo vigente empieza vacío
+        std::fill(buffer->m_data.begin(), buffer->m_data.end(), static_cast<unsigned char>(CountingBuffer::kFreshByte));
+        std::fill(buffer->m_written.begin(), buffer->m_written.end(), false);
+        ++m_stats.discardMaps;
+    }
+    else if (MapType == D3D11_MAP_WRITE_NO_OVERWRITE) {
+        ++m_stats.noOverwriteMaps;
+    }
+    else {
+        return E_INVALIDARG;
+    }
+    buffer->m_beforeMap = buffer->m_data;
+    buffer->m_mapType = MapType;
+    buffer->m_mapped = true;
+    pMappedResource->pData = buffer->m_data.data();
+    pMappedResource->RowPitch = buffer->m_desc.ByteWidth;
+    pMappedResource->DepthPitch = buffer->m_desc.ByteWidth;
+    return S_OK;
+}
+
+void STDMETHODCALLTYPE
+CountingDeviceContext::Unmap(ID3D11Resource* pResource, UINT) {
+    CountingBuffer* buffer = static_cast<CountingBuffer*>(pResource);
+    if (!buffer || !buffer->m_mapped) return;
+    buffer->m_mapped = false;
+
+    bool overwrote = false;
+    for (size_t i = 0; i < buffer->m_data.size(); ++i) {
+        if (buffer->m_data[i] == buffer->m_beforeMap[i]) continue;
+        ++m_stats.mappedBytes;
+        if (buffer->m_mapType == D3D11_MAP_WRITE_NO_OVERWRITE && buffer->m_written[i]) overwrote = true;
+        buffer->m_written[i] = true;
+    }
+    if (overwrote) ++m_stats.overwrites;
+}
+
+void STDMETHODCALLTYPE
+CountingDeviceContext::UpdateSubresource(ID3D11Resource* pDstResource, UINT DstSubresource,
+    const D3D11_BOX* pDstBox, const void* pSrcData, UINT, UINT) {
+    CountingBuffer* buffer = static_cast<CountingBuffer*>(pDstResource);
+    if (!buffer || !pSrcData || DstSubresource != 0) return;
+    size_t offset = 0;
+    size_t bytes = buffer->size();
+    if (pDstBox) {
+        offset = std::min<size_t>(pDstBox->left, buffer->size());
+        bytes = std::min<size_t>(pDstBox->right, buffer->size()) - offset;
+    }
+    std::memcpy(buffer->m_data.data() + offset, pSrcData, bytes);
+    ++m_stats.updates;
+    m_stats.updateBytes += bytes;
+}
+
+void STDMETHODCALLTYPE
+CountingDeviceContext::VSSetConstantBuffers(UINT StartSlot, UINT NumBuffers,
+    ID3D11Buffer* const* ppConstantBuffers) {
+    for (UINT i = 0; i < NumBuffers && StartSlot + i < kConstantSlots; ++i) {
+        ConstantBinding& binding = m_vsConstants[StartSlot + i];
+        binding.buffer = static_cast<CountingBuffer*>(ppConstantBuffers[i]);
+        binding.firstConstant = 0;
+        binding.numConstants = 0;
+    }
+}
+
+void STDMETHODCALLTYPE
+CountingDeviceContext::VSSetConstantBuffers1(UINT StartSlot, UINT NumBuffers,
+    ID3D11Buffer* const* ppConstantBuffers, const UINT* pFirstConstant, const UINT* pNumConstants) {
+    ++m_stats.rangeBinds;
+    for (UINT i = 0; i < NumBuffers && StartSlot + i < kConstantSlots; ++i) {
+        ConstantBinding& binding = m_vsConstants[StartSlot + i];
+        binding.buffer = static_cast<CountingBuffer*>(ppConstantBuffers[i]);
+        binding.firstConstant = pFirstConstant[i];
+        binding.numConstants = pNumConstants[i];
+    }
+}
@@ -1,4 +1,5 @@
 ﻿#include "../include/DeviceContext.h"
+#include <cstring>
 
 //
 // La funci�n `destroy` se encarga de liberar el objeto principal de Direct3D, el ID3D11DeviceContext.
@@ -6,7 +7,92 @@
 //
 void
 DeviceContext::destroy() {
+	SAFE_RELEASE(m_deviceContext1);
+	m_queriedContext1 = false;
 	SAFE_RELEASE(m_deviceContext);
+	resetShadow(false);
+}
+
+//
+// `resetShadow` deja el shadow state como el estado por defecto de D3D (todo nulo) o como
+// desconocido, en cuyo caso la siguiente llamada de cada tipo se emite sin comparar.
+//
+void
+DeviceContext::resetShadow(bool known) {
+	ShadowState& s = m_shadow;
+	s.vertexBuffers.reset(known);
+	std::memset(s.strides, 0, sizeof(s.strides));
+	std::memset(s.offsets, 0, sizeof(s.offsets));
+	s.vsConstantBuffers.reset(known);
+	s.psConstantBuffers.reset(known);
+	s.psShaderResources.reset(known);
+	s.psSamplers.reset(known);
+
+	s.knownInputLayout = s.knownTopology = s.knownIndexBuffer = known;
+	s.knownVertexShader = s.knownPixelShader = known;
+	s.knownViewports = s.knownRasterizer = s.knownBlend = s.knownRenderTargets = known;
+	s.inputLayout = nullptr;
+	s.topology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	s.indexBuffer = nullptr;
+	s.indexFormat = DXGI_FORMAT_UNKNOWN;
+	s.indexOffset = 0;
+	s.vertexShader = nullptr;
+	s.pixelShader = nullptr;
+	s.viewportCount = 0;
+	s.rasterizerState = nullptr;
+	s.blendState = nullptr;
+	for (float& f : s.blendFactor) f = 1.0f;
+	s.sampleMask = 0xffffffff;
+	s.renderTargetCount = 0;
+	for (ID3D11RenderTargetView*& rtv : s.renderTargets) rtv = nullptr;
+	s.depthStencilView = nullptr;
+}
+
+//
+// `ClearState` devuelve el pipeline a su estado por defecto; tras él, el shadow state
+// vuelve a ser exacto (todo desenlazado) y lo pendiente se descarta.
+//
+void
+DeviceContext::ClearState() {
+	if (!m_deviceContext) {
+		ERROR("DeviceContext", "ClearState", "m_deviceContext is nullptr");
+		return;
+	}
+	m_deviceContext->ClearState();
+	resetShadow(true);
+}
+
+//
+// `invalidateState` se usa cuando el estado se cambió por fuera del wrapper.
+//
+void
+DeviceContext::invalidateState() {
+	resetShadow(false);
+}
+
+//
+// `flushBindings` emite los enlaces por slot diferidos: por etapa, un rango contiguo desde el
+// primer slot que cambió hasta el último (los intermedios se reenvían con su valor actual).
+// Si en medio hay slots desconocidos el rango se parte en tramos y esos slots no se tocan.
+//
+void
+DeviceContext::flushBindings() {
+	ShadowState& s = m_shadow;
+	m_stats.issued += s.vertexBuffers.flush([&](unsigned int b, unsigned int n) {
+		m_deviceContext->IASetVertexBuffers(b, n, s.vertexBuffers.slots + b, s.strides + b, s.offsets + b);
+	});
+	m_stats.issued += s.vsConstantBuffers.flush([&](unsigned int b, unsigned int n) {
+		m_deviceContext->VSSetConstantBuffers(b, n, s.vsConstantBuffers.slots + b);
+	});
+	m_stats.issued += s.psConstantBuffers.flush([&](unsigned int b, unsigned int n) {
+		m_deviceContext->PSSetConstantBuffers(b, n, s.psConstantBuffers.slots + b);
+	});
+	m_stats.issued += s.psShaderResources.flush([&](unsigned int b, unsigned int n) {
+		m_deviceContext->PSSetShaderResources(b, n, s.psShaderResources.slots + b);
+	});
+	m_stats.issued += s.psSamplers.flush([&](unsigned int b, unsigned int n) {
+		m_deviceContext->PSSetSamplers(b, n, s.psSamplers.slots + b);
+	});
 }
 
 //
@@ -22,9 +108,26 @@ DeviceContext::RSSetViewports(unsigned int NumViewports,
 		return;
 	}
 
+	// Mismos viewports que los enlazados: nada que hacer.
+	++m_stats.requested;
+	ShadowState& s = m_shadow;
+	if (NumViewports <= kMaxViewports) {
+		if (s.knownViewports && s.viewportCount == NumViewports &&
+			std::memcmp(s.viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT)) == 0) {
+			return;
+		}
+		std::memcpy(s.viewports, pViewports, NumViewports * sizeof(D3D11_VIEWPORT));
+		s.viewportCount = NumViewports;
+		s.knownViewports = true;
+	}
+	else {
+		s.knownViewports = false;
+	}
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->RSSetViewports(NumViewports,
 		pViewports);
+	++m_stats.issued;
 }
 
 //
@@ -42,8 +145,20 @@ DeviceContext::PSSetShaderResources(unsigned int StartSlot,
 		return;
 	}
 
+	// Slots seguidos: se difieren al siguiente draw.
+	++m_stats.requested;
+	if (StartSlot + NumViews <= kShaderResourceSlots) {
+		m_shadow.psShaderResources.set(StartSlot, NumViews, ppShaderResourceViews);
+		return;
+	}
+
+	// Rango que se sale de lo seguido: va directo, tras lo diferido para respetar el orden.
+	flushBindings();
+	m_shadow.psShaderResources.forget(StartSlot, NumViews);
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->PSSetShaderResources(StartSlot, NumViews, ppShaderResourceViews);
+	++m_stats.issued;
 }
 
 //
@@ -58,8 +173,14 @@ DeviceContext::IASetInputLayout(ID3D11InputLayout* pInputLayout) {
 		return;
 	}
 
+	++m_stats.requested;
+	if (m_shadow.knownInputLayout && m_shadow.inputLayout == pInputLayout) return;
+	m_shadow.inputLayout = pInputLayout;
+	m_shadow.knownInputLayout = true;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->IASetInputLayout(pInputLayout);
+	++m_stats.issued;
 }
 
 //
@@ -75,10 +196,17 @@ DeviceContext::VSSetShader(ID3D11VertexShader* pVertexShader,
 		ERROR("DeviceContext", "VSSetShader", "pVertexShader is nullptr");
 		return;
 	}
+	// Las instancias de clase no se siguen: con ellas siempre se emite.
+	++m_stats.requested;
+	if (NumClassInstances == 0 && m_shadow.knownVertexShader && m_shadow.vertexShader == pVertexShader) return;
+	m_shadow.vertexShader = pVertexShader;
+	m_shadow.knownVertexShader = NumClassInstances == 0;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->VSSetShader(pVertexShader,
 		ppClassInstances,
 		NumClassInstances);
+	++m_stats.issued;
 }
 
 //
@@ -95,10 +223,16 @@ DeviceContext::PSSetShader(ID3D11PixelShader* pPixelShader,
 		return;
 	}
 
+	++m_stats.requested;
+	if (NumClassInstances == 0 && m_shadow.knownPixelShader && m_shadow.pixelShader == pPixelShader) return;
+	m_shadow.pixelShader = pPixelShader;
+	m_shadow.knownPixelShader = NumClassInstances == 0;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->PSSetShader(pPixelShader,
 		ppClassInstances,
 		NumClassInstances);
+	++m_stats.issued;
 }
 
 //
@@ -127,6 +261,40 @@ DeviceContext::UpdateSubresource(ID3D11Resource* pDstResource,
 		SrcDepthPitch);
 }
 
+//
+// `Map` da acceso de CPU a la memoria de un recurso (por ejemplo un búfer dinámico).
+// Con D3D11_MAP_WRITE_DISCARD el contenido anterior se descarta y la GPU no se detiene.
+//
+HRESULT
+DeviceContext::Map(ID3D11Resource* pResource,
+	unsigned int Subresource,
+	D3D11_MAP MapType,
+	unsigned int MapFlags,
+	D3D11_MAPPED_SUBRESOURCE* pMappedResource) {
+	// Verificación para evitar punteros nulos.
+	if (!pResource || !pMappedResource) {
+		ERROR("DeviceContext", "Map",
+			"Invalid arguments: pResource or pMappedResource is nullptr");
+		return E_INVALIDARG;
+	}
+	// Se llama a la función nativa de Direct3D.
+	return m_deviceContext->Map(pResource, Subresource, MapType, MapFlags, pMappedResource);
+}
+
+//
+// `Unmap` devuelve a la GPU un recurso mapeado con `Map`.
+//
+void
+DeviceContext::Unmap(ID3D11Resource* pResource, unsigned int Subresource) {
+	// Verificación para evitar un puntero nulo.
+	if (!pResource) {
+		ERROR("DeviceContext", "Unmap", "pResource is nullptr");
+		return;
+	}
+	// Se llama a la función nativa de Direct3D.
+	m_deviceContext->Unmap(pResource, Subresource);
+}
+
 //
 // `IASetVertexBuffers` asigna b�feres de v�rtices a la etapa de Ensamblador de Entrada.
 // Estos b�feres contienen los datos de los v�rtices (posiciones, normales, coordenadas de textura, etc.).
@@ -143,12 +311,34 @@ DeviceContext::IASetVertexBuffers(unsigned int StartSlot,
 			"Invalid arguments: ppVertexBuffers, pStrides, or pOffsets is nullptr");
 		return;
 	}
+	// Slots seguidos: se difieren al siguiente draw. Un cambio de stride u offset cuenta como
+	// cambio del slot aunque el buffer sea el mismo.
+	++m_stats.requested;
+	ShadowState& s = m_shadow;
+	if (StartSlot + NumBuffers <= kVertexBufferSlots) {
+		for (unsigned int i = 0; i < NumBuffers; ++i) {
+			const unsigned int slot = StartSlot + i;
+			if (s.strides[slot] != pStrides[i] || s.offsets[slot] != pOffsets[i]) {
+				s.vertexBuffers.known &= ~(1u << slot);
+				s.strides[slot] = pStrides[i];
+				s.offsets[slot] = pOffsets[i];
+			}
+		}
+		s.vertexBuffers.set(StartSlot, NumBuffers, ppVertexBuffers);
+		return;
+	}
+
+	// Rango que se sale de lo seguido: va directo, tras lo diferido para respetar el orden.
+	flushBindings();
+	m_shadow.vertexBuffers.forget(StartSlot, NumBuffers);
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->IASetVertexBuffers(StartSlot,
 		NumBuffers,
 		ppVertexBuffers,
 		pStrides,
 		pOffsets);
+	++m_stats.issued;
 }
 
 //
@@ -164,10 +354,21 @@ DeviceContext::IASetIndexBuffer(ID3D11Buffer* pIndexBuffer,
 		ERROR("DeviceContext", "IASetIndexBuffer", "pIndexBuffer is nullptr");
 		return;
 	}
+	++m_stats.requested;
+	ShadowState& s = m_shadow;
+	if (s.knownIndexBuffer && s.indexBuffer == pIndexBuffer && s.indexFormat == Format && s.indexOffset == Offset) {
+		return;
+	}
+	s.indexBuffer = pIndexBuffer;
+	s.indexFormat = Format;
+	s.indexOffset = Offset;
+	s.knownIndexBuffer = true;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->IASetIndexBuffer(pIndexBuffer,
 		Format,
 		Offset);
+	++m_stats.issued;
 }
 
 //
@@ -183,8 +384,20 @@ DeviceContext::PSSetSamplers(unsigned int StartSlot,
 		ERROR("DeviceContext", "PSSetSamplers", "ppSamplers is nullptr");
 		return;
 	}
+	// Slots seguidos: se difieren al siguiente draw.
+	++m_stats.requested;
+	if (StartSlot + NumSamplers <= kSamplerSlots) {
+		m_shadow.psSamplers.set(StartSlot, NumSamplers, ppSamplers);
+		return;
+	}
+
+	// Rango que se sale de lo seguido: va directo, tras lo diferido para respetar el orden.
+	flushBindings();
+	m_shadow.psSamplers.forget(StartSlot, NumSamplers);
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->PSSetSamplers(StartSlot, NumSamplers, ppSamplers);
+	++m_stats.issued;
 }
 
 //
@@ -198,8 +411,14 @@ DeviceContext::RSSetState(ID3D11RasterizerState* pRasterizerState) {
 		ERROR("DeviceContext", "RSSetState", "pRasterizerState is nullptr");
 		return;
 	}
+	++m_stats.requested;
+	if (m_shadow.knownRasterizer && m_shadow.rasterizerState == pRasterizerState) return;
+	m_shadow.rasterizerState = pRasterizerState;
+	m_shadow.knownRasterizer = true;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->RSSetState(pRasterizerState);
+	++m_stats.issued;
 }
 
 //
@@ -215,10 +434,25 @@ DeviceContext::OMSetBlendState(ID3D11BlendState* pBlendState,
 		ERROR("DeviceContext", "OMSetBlendState", "pBlendState is nullptr");
 		return;
 	}
+	// Sin BlendFactor D3D usa {1, 1, 1, 1}.
+	++m_stats.requested;
+	ShadowState& s = m_shadow;
+	const float defaultFactor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	const float* factor = BlendFactor ? BlendFactor : defaultFactor;
+	if (s.knownBlend && s.blendState == pBlendState && s.sampleMask == SampleMask &&
+		std::memcmp(s.blendFactor, factor, sizeof(s.blendFactor)) == 0) {
+		return;
+	}
+	s.blendState = pBlendState;
+	std::memcpy(s.blendFactor, factor, sizeof(s.blendFactor));
+	s.sampleMask = SampleMask;
+	s.knownBlend = true;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->OMSetBlendState(pBlendState,
 		BlendFactor,
 		SampleMask);
+	++m_stats.issued;
 }
 
 //
@@ -242,10 +476,35 @@ DeviceContext::OMSetRenderTargets(unsigned int NumViews,
 		return;
 	}
 
+	++m_stats.requested;
+	ShadowState& s = m_shadow;
+	if (NumViews <= kMaxRenderTargets) {
+		if (s.knownRenderTargets && s.renderTargetCount == NumViews && s.depthStencilView == pDepthStencilView &&
+			(NumViews == 0 || std::memcmp(s.renderTargets, ppRenderTargetViews, NumViews * sizeof(ID3D11RenderTargetView*)) == 0)) {
+			return;
+		}
+		for (unsigned int i = 0; i < NumViews; ++i) s.renderTargets[i] = ppRenderTargetViews[i];
+		s.renderTargetCount = NumViews;
+		s.depthStencilView = pDepthStencilView;
+		s.knownRenderTargets = true;
+	}
+	else {
+		s.knownRenderTargets = false;
+	}
+
+	// D3D desenlaza las SRV cuyo recurso pasa a ser salida (RTV o DSV). Averiguarlo costaría un
+	// GetResource por vista, así que toda SRV no nula deja de ser conocida y el siguiente enlace
+	// se reemite. Lo diferido sale antes para que D3D vea las llamadas en el orden pedido.
+	flushBindings();
+	for (unsigned int slot = 0; slot < kShaderResourceSlots; ++slot) {
+		if (s.psShaderResources.slots[slot]) s.psShaderResources.forget(slot, 1);
+	}
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->OMSetRenderTargets(NumViews,
 		ppRenderTargetViews,
 		pDepthStencilView);
+	++m_stats.issued;
 }
 
 //
@@ -260,8 +519,14 @@ DeviceContext::IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY Topology) {
 		return;
 	}
 
+	++m_stats.requested;
+	if (m_shadow.knownTopology && m_shadow.topology == Topology) return;
+	m_shadow.topology = Topology;
+	m_shadow.knownTopology = true;
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->IASetPrimitiveTopology(Topology);
+	++m_stats.issued;
 }
 
 //
@@ -328,10 +593,22 @@ DeviceContext::VSSetConstantBuffers(unsigned int StartSlot,
 		return;
 	}
 
+	// Slots seguidos: se difieren al siguiente draw.
+	++m_stats.requested;
+	if (StartSlot + NumBuffers <= kConstantBufferSlots) {
+		m_shadow.vsConstantBuffers.set(StartSlot, NumBuffers, ppConstantBuffers);
+		return;
+	}
+
+	// Rango que se sale de lo seguido: va directo, tras lo diferido para respetar el orden.
+	flushBindings();
+	m_shadow.vsConstantBuffers.forget(StartSlot, NumBuffers);
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->VSSetConstantBuffers(StartSlot,
 		NumBuffers,
 		ppConstantBuffers);
+	++m_stats.issued;
 }
 
 //
@@ -347,10 +624,22 @@ DeviceContext::PSSetConstantBuffers(unsigned int StartSlot,
 		ERROR("DeviceContext", "PSSetConstantBuffers", "ppConstantBuffers is nullptr");
 		return;
 	}
+	// Slots seguidos: se difieren al siguiente draw.
+	++m_stats.requested;
+	if (StartSlot + NumBuffers <= kConstantBufferSlots) {
+		m_shadow.psConstantBuffers.set(StartSlot, NumBuffers, ppConstantBuffers);
+		return;
+	}
+
+	// Rango que se sale de lo seguido: va directo, tras lo diferido para respetar el orden.
+	flushBindings();
+	m_shadow.psConstantBuffers.forget(StartSlot, NumBuffers);
+
 	// Se llama a la funci�n nativa de Direct3D.
 	m_deviceContext->PSSetConstantBuffers(StartSlot,
 		NumBuffers,
 		ppConstantBuffers);
+	++m_stats.issued;
 }
 
 //
@@ -367,8 +656,97 @@ DeviceContext::DrawIndexed(unsigned int IndexCount,
 		return;
 	}
 
-	// Se llama a la funci�n nativa de Direct3D.
+	// Enlaces por slot pendientes y draw.
+	flushBindings();
 	m_deviceContext->DrawIndexed(IndexCount,
 		StartIndexLocation,
 		BaseVertexLocation);
+}
+
+//
+// `DrawIndexedInstanced` dibuja InstanceCount copias del mismo rango de índices.
+// Los datos de cada copia (World, color) llegan por un VB con paso por instancia.
+//
+void
+DeviceContext::DrawIndexedInstanced(unsigned int IndexCountPerInstance,
+	unsigned int InstanceCount,
+	unsigned int StartIndexLocation,
+	int BaseVertexLocation,
+	unsigned int StartInstanceLocation) {
+	// Sin índices o sin instancias no hay nada que dibujar.
+	if (IndexCountPerInstance == 0 || InstanceCount == 0) {
+		ERROR("DeviceContext", "DrawIndexedInstanced", "IndexCountPerInstance or InstanceCount is zero");
+		return;
+	}
+
+	// Enlaces por slot pendientes y draw.
+	flushBindings();
+	m_deviceContext->DrawIndexedInstanced(IndexCountPerInstance,
+		InstanceCount,
+		StartIndexLocation,
+		BaseVertexLocation,
+		StartInstanceLocation);
+}
+
+//
+// `supportsConstantBufferOffsets` pide una sola vez la interfaz de D3D11.1, que es la que
+// permite enlazar un rango de un constant buffer en lugar del buffer entero.
+//
+bool
+DeviceContext::supportsConstantBufferOffsets() {
+	if (!m_queriedContext1 && m_deviceContext) {
+		m_queriedContext1 = true;
+		if (FAILED(m_deviceContext->QueryInterface(__uuidof(ID3D11DeviceContext1),
+			reinterpret_cast<void**>(&m_deviceContext1)))) {
+			m_deviceContext1 = nullptr;
+		}
+	}
+	return m_deviceContext1 != nullptr;
+}
+
+//
+// `VSSetConstantBuffers1` y `PSSetConstantBuffers1` enlazan rangos (p. ej. sub-asignaciones de un
+// ring buffer). Antes se emiten los enlaces diferidos para respetar el orden, y los slots quedan
+// como desconocidos para que el siguiente enlace del buffer completo no se filtre.
+//
+void
+DeviceContext::VSSetConstantBuffers1(unsigned int StartSlot,
+	unsigned int NumBuffers,
+	ID3D11Buffer* const* ppConstantBuffers,
+	const unsigned int* pFirstConstant,
+	const unsigned int* pNumConstants) {
+	if (!ppConstantBuffers || !pFirstConstant || !pNumConstants) {
+		ERROR("DeviceContext", "VSSetConstantBuffers1", "Invalid arguments: a pointer is nullptr");
+		return;
+	}
+	if (!supportsConstantBufferOffsets()) {
+		ERROR("DeviceContext", "VSSetConstantBuffers1", "ID3D11DeviceContext1 is not available");
+		return;
+	}
+	++m_stats.requested;
+	flushBindings();
+	m_shadow.vsConstantBuffers.forget(StartSlot, NumBuffers);
+	m_deviceContext1->VSSetConstantBuffers1(StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants);
+	++m_stats.issued;
+}
+
+void
+DeviceContext::PSSetConstantBuffers1(unsigned int StartSlot,
+	unsigned int NumBuffers,
+	ID3D11Buffer* const* ppConstantBuffers,
+	const unsigned int* pFirstConstant,
+	const unsigned int* pNumConstants) {
+	if (!ppConstantBuffers || !pFirstConstant || !pNumConstants) {
+		ERROR("DeviceContext", "PSSetConstantBuffers1", "Invalid arguments: a pointer is nullptr");
+		return;
+	}
+	if (!supportsConstantBufferOffsets()) {
+		ERROR("DeviceContext", "PSSetConstantBuffers1", "ID3D11DeviceContext1 is not available");
+		return;
+	}
+	++m_stats.requested;
+	flushBindings();
+	m_shadow.psConstantBuffers.forget(StartSlot, NumBuffers);
+	m_deviceContext1->PSSetConstantBuffers1(StartSlot, NumBuffers, ppConstantBuffers, pFirstConstant, pNumConstants);
+	++m_stats.issued;
 }
\ No newline at end of file
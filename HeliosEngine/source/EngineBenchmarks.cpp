@@ -0,0 +1,1313 @@
+#include "../include/EngineBenchmarks.h"
+#include "../include/ModelLoader.h"
+#include "../include/MappedFile.h"
+#include "../include/VertexIndexTable.h"
+#include "../include/MeshOptimizer.h"
+#include "../include/MeshBVH.h"
+#include "../include/Picker.h"
+#include "../include/BoundingVolumes.h"
+#include "../include/MeshNormals.h"
+#include "../include/StaticBatcher.h"
+#include "../include/InstanceList.h"
+#include "../include/FrustumCuller.h"
+#include "../include/SceneOctree.h"
+#include "../include/RenderQueue.h"
+#include "../include/ShaderProgram.h"
+#include "../include/Texture.h"
+#include "../include/Buffer.h"
+#include "../include/JobSystem.h"
+#include "../include/HandleTable.h"
+#include "../include/ConstantBufferManager.h"
+#include "../include/CountingDevice.h"
+#include "../include/Device.h"
+#include "../include/DeviceContext.h"
+#include <algorithm>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <map>
+#include <random>
+
+namespace
+{
+    // Cronómetro de alta resolución basado en QueryPerformanceCounter
+    class ScopedTimer {
+    public:
+        ScopedTimer() {
+            QueryPerformanceFrequency(&m_freq);
+            QueryPerformanceCounter(&m_start);
+        }
+
+        double seconds() const {
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            return double(now.QuadPart - m_start.QuadPart) / double(m_freq.QuadPart);
+        }
+
+    private:
+        LARGE_INTEGER m_freq;
+        LARGE_INTEGER m_start;
+    };
+
+    // Volcado con buffer propio para no pagar una llamada por línea
+    class BufferedWriter {
+    public:
+        explicit BufferedWriter(FILE* f) : m_file(f) { m_buffer.reserve(1 << 20); }
+        ~BufferedWriter() { flush(); }
+
+        template <typename... Args>
+        void print(const char* fmt, Args... args) {
+            char line[160];
+            int n = snprintf(line, sizeof(line), fmt, args...);
+            if (n <= 0) return;
+            m_buffer.insert(m_buffer.end(), line, line + std::min<int>(n, int(sizeof(line)) - 1));
+            if (m_buffer.size() >= (1 << 20)) flush();
+        }
+
+        bool flush() {
+            if (m_buffer.empty()) return m_ok;
+            m_ok = m_ok && fwrite(m_buffer.data(), 1, m_buffer.size(), m_file) == m_buffer.size();
+            m_buffer.clear();
+            return m_ok;
+        }
+
+    private:
+        FILE*             m_file;
+        std::vector<char> m_buffer;
+        bool              m_ok = true;
+    };
+
+    // Rejilla ondulada: triángulos pequeños y de tamaño parejo, como una malla escaneada
+    void makeWavyGrid(size_t triangleCount, MeshComponent& mesh) {
+        const size_t n = std::max<size_t>(1, size_t(std::ceil(std::sqrt(double(triangleCount) * 0.5))));
+        const size_t side = n + 1;
+        mesh.m_vertex.resize(side * side);
+        for (size_t z = 0; z < side; ++z) {
+            for (size_t x = 0; x < side; ++x) {
+                const float fx = float(x) / float(n), fz = float(z) / float(n);
+                SimpleVertex& v = mesh.m_vertex[z * side + x];
+                v.Pos = XMFLOAT3(fx * 10.0f - 5.0f, std::sin(fx * 37.0f) * std::cos(fz * 23.0f), fz * 10.0f - 5.0f);
+                v.Tex = XMFLOAT2(fx, fz);
+                v.Normal = XMFLOAT3(0, 1, 0);
+            }
+        }
+        mesh.m_index.reserve(2 * n * n * 3);
+        for (size_t z = 0; z < n; ++z) {
+            for (size_t x = 0; x < n; ++x) {
+                const unsigned int i0 = unsigned(z * side + x), i1 = i0 + 1;
+                const unsigned int i2 = i0 + unsigned(side), i3 = i2 + 1;
+                const unsigned int quad[6] = { i0, i2, i1, i1, i2, i3 };
+                mesh.m_index.insert(mesh.m_index.end(), quad, quad + 6);
+            }
+        }
+        mesh.computeBounds();
+    }
+
+    // Referencias escalares de BoundingVolumes (el bucle que había en MeshComponent::computeBounds
+    // y el Ritter clásico con extremos sobre los tres ejes)
+    void scalarAABB(const std::vector<SimpleVertex>& vertices, XMFLOAT3& mn, XMFLOAT3& mx) {
+        mn = mx = vertices[0].Pos;
+        for (const SimpleVertex& v : vertices) {
+            mn.x = std::min(mn.x, v.Pos.x); mn.y = std::min(mn.y, v.Pos.y); mn.z = std::min(mn.z, v.Pos.z);
+            mx.x = std::max(mx.x, v.Pos.x); mx.y = std::max(mx.y, v.Pos.y); mx.z = std::max(mx.z, v.Pos.z);
+        }
+    }
+
+    BoundingSphere scalarRitter(const std::vector<SimpleVertex>& vertices) {
+        size_t lo[3] = { 0, 0, 0 }, hi[3] = { 0, 0, 0 };
+        for (size_t i = 1; i < vertices.size(); ++i) {
+            const float* p = &vertices[i].Pos.x;
+            for (int a = 0; a < 3; ++a) {
+                if (p[a] < (&vertices[lo[a]].Pos.x)[a]) lo[a] = i;
+                if (p[a] > (&vertices[hi[a]].Pos.x)[a]) hi[a] = i;
+            }
+        }
+        int axis = 0;
+        float best = -1.0f;
+        for (int a = 0; a < 3; ++a) {
+            const XMFLOAT3& p = vertices[lo[a]].Pos;
+            const XMFLOAT3& q = vertices[hi[a]].Pos;
+            const float d2 = (q.x - p.x) * (q.x - p.x) + (q.y - p.y) * (q.y - p.y) + (q.z - p.z) * (q.z - p.z);
+            if (d2 > best) { best = d2; axis = a; }
+        }
+        const XMFLOAT3& p = vertices[lo[axis]].Pos;
+        const XMFLOAT3& q = vertices[hi[axis]].Pos;
+        BoundingSphere s;
+        s.center = XMFLOAT3(0.5f * (p.x + q.x), 0.5f * (p.y + q.y), 0.5f * (p.z + q.z));
+        s.radius = 0.5f * std::sqrt(best);
+        for (const SimpleVertex& v : vertices) {
+            const float dx = v.Pos.x - s.center.x, dy = v.Pos.y - s.center.y, dz = v.Pos.z - s.center.z;
+            const float d2 = dx * dx + dy * dy + dz * dz;
+            if (d2 <= s.radius * s.radius) continue;
+            const float d = std::sqrt(d2);
+            const float r = 0.5f * (s.radius + d);
+            const float k = (r - s.radius) / d;
+            s.center.x += dx * k; s.center.y += dy * k; s.center.z += dz * k;
+            s.radius = r;
+        }
+        return s;
+    }
+
+    // Referencia serial de normales: el scatter-add por triángulo que usaba OBJParser
+    void scalarScatterNormals(std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices) {
+        std::vector<XMFLOAT3> acc(vertices.size(), XMFLOAT3(0, 0, 0));
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const unsigned int ia = indices[i], ib = indices[i + 1], ic = indices[i + 2];
+            const XMFLOAT3& A = vertices[ia].Pos;
+            const XMFLOAT3& B = vertices[ib].Pos;
+            const XMFLOAT3& C = vertices[ic].Pos;
+            const XMFLOAT3 AB(B.x - A.x, B.y - A.y, B.z - A.z);
+            const XMFLOAT3 AC(C.x - A.x, C.y - A.y, C.z - A.z);
+            const XMFLOAT3 N(AB.y * AC.z - AB.z * AC.y, AB.z * AC.x - AB.x * AC.z, AB.x * AC.y - AB.y * AC.x);
+            for (unsigned int v : { ia, ib, ic }) {
+                acc[v].x += N.x; acc[v].y += N.y; acc[v].z += N.z;
+            }
+        }
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            const XMFLOAT3& a = acc[i];
+            const float len = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+            vertices[i].Normal = len > 1e-8f ? XMFLOAT3(a.x / len, a.y / len, a.z / len) : XMFLOAT3(0, 0, 0);
+        }
+    }
+}
+
+bool
+EngineBenchmarks::WriteSyntheticOBJ(const std::string& path, size_t faceCount) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        ERROR(L"EngineBenchmarks", L"WriteSyntheticOBJ", L"No se pudo crear el archivo");
+        return false;
+    }
+
+    // Rejilla de (n+1)x(n+1) vértices: 2*n*n triángulos
+    const size_t n = std::max<size_t>(1, size_t(std::ceil(std::sqrt(double(faceCount) * 0.5))));
+    const size_t side = n + 1;
+
+    bool ok = true;
+    {
+        BufferedWriter out(f);
+        out.print("# HeliosEngine synthetic OBJ (%zu x %zu)\n", side, side);
+        for (size_t z = 0; z < side; ++z) {
+            for (size_t x = 0; x < side; ++x) {
+                const float fx = float(x) / float(n);
+                const float fz = float(z) / float(n);
+                const float h = 0.05f * std::sin(fx * 37.0f) * std::cos(fz * 23.0f);
+                out.print("v %.6f %.6f %.6f\n", fx * 10.0f - 5.0f, h, fz * 10.0f - 5.0f);
+                out.print("vt %.6f %.6f\n", fx, fz);
+                out.print("vn %.6f %.6f %.6f\n", 0.0f, 1.0f, 0.0f);
+            }
+        }
+
+        size_t written = 0;
+        for (size_t z = 0; z < n && written < faceCount; ++z) {
+            for (size_t x = 0; x < n && written < faceCount; ++x) {
+                const size_t i0 = z * side + x + 1;
+                const size_t i1 = i0 + 1;
+                const size_t i2 = i0 + side;
+                const size_t i3 = i2 + 1;
+                out.print("f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", i0, i0, i0, i2, i2, i2, i1, i1, i1);
+                if (++written < faceCount) {
+                    out.print("f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", i1, i1, i1, i2, i2, i2, i3, i3, i3);
+                    ++written;
+                }
+            }
+        }
+        ok = out.flush();
+    }
+    ok = (fclose(f) == 0) && ok;
+    if (!ok) {
+        ERROR(L"EngineBenchmarks", L"WriteSyntheticOBJ", L"Escritura incompleta");
+    }
+    return ok;
+}
+
+BenchmarkResult
+EngineBenchmarks::OBJThroughput(const std::string& scratchPath, size_t faceCount,
+    unsigned int threadCount) {
+    BenchmarkResult result;
+    result.name = "OBJParser::LoadOBJ (" + std::to_string(faceCount) + " caras, " +
+        (threadCount ? std::to_string(threadCount) : std::string("auto")) + " hilos)";
+    result.unit = "MB/s";
+
+    if (!WriteSyntheticOBJ(scratchPath, faceCount)) {
+        return result;
+    }
+
+    MappedFile probe;
+    probe.open(scratchPath);
+    const double megabytes = double(probe.size()) / (1024.0 * 1024.0);
+    probe.close();
+
+    OBJParser parser;
+    parser.SetThreadCount(threadCount);
+    MeshComponent mesh;
+    ScopedTimer timer;
+    const bool ok = parser.LoadOBJ(scratchPath, mesh);
+    result.seconds = timer.seconds();
+    result.throughput = (ok && result.seconds > 0.0) ? megabytes / result.seconds : 0.0;
+
+    remove(scratchPath.c_str());
+    return result;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::VertexDedup(size_t cornerCount) {
+    // Flujo de esquinas como el de una rejilla triangulada: cada vértice
+    // aparece ~6 veces; 1 de cada 16 tiene una costura de UV (vt distinto)
+    struct Corner { int v, vt, vn; };
+    struct CornerLess {
+        bool operator()(const Corner& a, const Corner& b) const {
+            if (a.v != b.v)   return a.v < b.v;
+            if (a.vt != b.vt) return a.vt < b.vt;
+            return a.vn < b.vn;
+        }
+    };
+
+    const size_t n = std::max<size_t>(1, size_t(std::sqrt(double(cornerCount) / 6.0)));
+    const size_t side = n + 1;
+    std::vector<Corner> corners;
+    corners.reserve(cornerCount);
+    for (size_t q = 0; corners.size() < cornerCount; ++q) {
+        const size_t z = (q / n) % n, x = q % n;
+        const int i0 = int(z * side + x + 1), i1 = i0 + 1, i2 = i0 + int(side), i3 = i2 + 1;
+        const int quad[6] = { i0, i2, i1, i1, i2, i3 };
+        for (int k = 0; k < 6 && corners.size() < cornerCount; ++k) {
+            const int v = quad[k];
+            const int vt = (v % 16 == 0 && k >= 3) ? v + int(side * side) : v;
+            corners.push_back(Corner{ v, vt, v });
+        }
+    }
+
+    std::vector<BenchmarkResult> results;
+    std::vector<unsigned int> indices(corners.size());
+
+    {
+        BenchmarkResult r;
+        r.name = "Dedup std::map (" + std::to_string(cornerCount) + " esquinas)";
+        r.unit = "Mcorners/s";
+        std::map<Corner, unsigned int, CornerLess> cache;
+        unsigned int next = 0;
+        ScopedTimer timer;
+        for (size_t i = 0; i < corners.size(); ++i) {
+            auto it = cache.find(corners[i]);
+            if (it == cache.end()) it = cache.emplace(corners[i], next++).first;
+            indices[i] = it->second;
+        }
+        r.seconds = timer.seconds();
+        r.throughput = r.seconds > 0.0 ? double(corners.size()) / r.seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    {
+        BenchmarkResult r;
+        r.name = "Dedup VertexIndexTable (" + std::to_string(cornerCount) + " esquinas)";
+        r.unit = "Mcorners/s";
+        ScopedTimer timer;
+        VertexIndexTable cache;
+        cache.reserve(side * side + side * side / 4);
+        unsigned int next = 0;
+        for (size_t i = 0; i < corners.size(); ++i) {
+            bool inserted = false;
+            indices[i] = cache.findOrInsert(corners[i].v, corners[i].vt, corners[i].vn, 0, next, inserted);
+            if (inserted) ++next;
+        }
+        r.seconds = timer.seconds();
+        r.throughput = r.seconds > 0.0 ? double(corners.size()) / r.seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+BenchmarkResult
+EngineBenchmarks::VertexCacheOptimization(size_t triangleCount, unsigned int cacheSize) {
+    // Rejilla de (n+1)x(n+1) vértices con los triángulos en orden aleatorio: peor caso
+    // realista para la caché (exportadores que no optimizan)
+    const size_t n = std::max<size_t>(1, size_t(std::ceil(std::sqrt(double(triangleCount) * 0.5))));
+    const size_t side = n + 1;
+
+    MeshComponent mesh;
+    mesh.m_vertex.resize(side * side);
+    for (size_t z = 0; z < side; ++z) {
+        for (size_t x = 0; x < side; ++x) {
+            SimpleVertex& v = mesh.m_vertex[z * side + x];
+            v.Pos = XMFLOAT3(float(x), 0.0f, float(z));
+            v.Tex = XMFLOAT2(float(x) / float(n), float(z) / float(n));
+            v.Normal = XMFLOAT3(0, 1, 0);
+        }
+    }
+
+    std::vector<unsigned int> triangles;
+    triangles.reserve(2 * n * n * 3);
+    for (size_t z = 0; z < n; ++z) {
+        for (size_t x = 0; x < n; ++x) {
+            const unsigned int i0 = unsigned(z * side + x), i1 = i0 + 1;
+            const unsigned int i2 = i0 + unsigned(side), i3 = i2 + 1;
+            const unsigned int quad[6] = { i0, i2, i1, i1, i2, i3 };
+            triangles.insert(triangles.end(), quad, quad + 6);
+        }
+    }
+
+    std::vector<unsigned int> order(triangles.size() / 3);
+    for (size_t t = 0; t < order.size(); ++t) order[t] = unsigned(t);
+    std::mt19937 rng(1234);
+    std::shuffle(order.begin(), order.end(), rng);
+    mesh.m_index.reserve(triangles.size());
+    for (unsigned int t : order) {
+        mesh.m_index.insert(mesh.m_index.end(), &triangles[t * 3], &triangles[t * 3] + 3);
+    }
+
+    ScopedTimer timer;
+    const MeshOptimizeReport report = MeshOptimizer::Optimize(mesh, cacheSize);
+    const double seconds = timer.seconds();
+
+    char name[160];
+    snprintf(name, sizeof(name), "MeshOptimizer (%zu tris, FIFO %u) ACMR %.3f->%.3f ATVR %.3f->%.3f",
+        report.before.triangles, cacheSize, report.before.acmr(), report.after.acmr(),
+        report.before.atvr(), report.after.atvr());
+
+    BenchmarkResult result;
+    result.name = name;
+    result.unit = "Mtris/s";
+    result.seconds = seconds;
+    result.throughput = seconds > 0.0 ? double(report.before.triangles) / seconds / 1e6 : 0.0;
+    return result;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::BVHQueries(const std::string& objPath, size_t triangleCount, size_t rayCount) {
+    std::vector<BenchmarkResult> results;
+    MeshComponent mesh;
+    if (!objPath.empty()) {
+        OBJParser parser;
+        if (!parser.LoadOBJ(objPath, mesh)) {
+            return results;
+        }
+    }
+    else {
+        makeWavyGrid(triangleCount, mesh);
+    }
+    const size_t triangles = mesh.m_index.size() / 3;
+    const std::string label = " (" + std::to_string(triangles) + " tris)";
+
+    // Construcción serial y paralela
+    MeshBVH bvh;
+    const unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned int threadCount : { 1u, threads }) {
+        ScopedTimer timer;
+        bvh.build(mesh, threadCount);
+        const double seconds = timer.seconds();
+
+        char name[160];
+        snprintf(name, sizeof(name), "MeshBVH::build%s, %u hilos, %zu nodos, SAH %.1f",
+            label.c_str(), threadCount, bvh.getStats().nodes, bvh.getStats().sahCost);
+        BenchmarkResult r;
+        r.name = name;
+        r.unit = "Mtris/s";
+        r.seconds = seconds;
+        r.throughput = seconds > 0.0 ? double(triangles) / seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    // Rayos de la esfera envolvente hacia puntos del AABB
+    XMFLOAT3 mn, mx;
+    bvh.getBounds(mn, mx);
+    const XMFLOAT3 center(0.5f * (mn.x + mx.x), 0.5f * (mn.y + mx.y), 0.5f * (mn.z + mx.z));
+    const float radius = std::sqrt((mx.x - mn.x) * (mx.x - mn.x) + (mx.y - mn.y) * (mx.y - mn.y) +
+        (mx.z - mn.z) * (mx.z - mn.z));
+    std::mt19937 rng(99);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::normal_distribution<float> gauss;
+    std::vector<XMFLOAT3> origins(rayCount), directions(rayCount);
+    for (size_t i = 0; i < rayCount; ++i) {
+        XMFLOAT3 d(gauss(rng), gauss(rng), gauss(rng));
+        const float len = std::max(1e-6f, std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z));
+        origins[i] = XMFLOAT3(center.x + d.x / len * radius, center.y + d.y / len * radius,
+            center.z + d.z / len * radius);
+        const XMFLOAT3 target(mn.x + unit(rng) * (mx.x - mn.x), mn.y + unit(rng) * (mx.y - mn.y),
+            mn.z + unit(rng) * (mx.z - mn.z));
+        directions[i] = XMFLOAT3(target.x - origins[i].x, target.y - origins[i].y, target.z - origins[i].z);
+    }
+
+    auto castRange = [&](size_t begin, size_t end, size_t& hits) {
+        for (size_t i = begin; i < end; ++i) {
+            RayHit hit;
+            hits += bvh.raycast(origins[i], directions[i], hit) ? 1 : 0;
+        }
+    };
+
+    for (unsigned int threadCount : { 1u, threads }) {
+        std::vector<size_t> hits(threadCount, 0);
+        ScopedTimer timer;
+        std::vector<std::thread> workers;
+        for (unsigned int w = 1; w < threadCount; ++w) {
+            workers.emplace_back(castRange, rayCount * w / threadCount, rayCount * (w + 1) / threadCount,
+                std::ref(hits[w]));
+        }
+        castRange(0, rayCount / threadCount, hits[0]);
+        for (std::thread& t : workers) t.join();
+        const double seconds = timer.seconds();
+
+        size_t total = 0;
+        for (size_t h : hits) total += h;
+        BenchmarkResult r;
+        r.name = "MeshBVH::raycast" + label + ", " + std::to_string(threadCount) + " hilos, " +
+            std::to_string(total) + " impactos";
+        r.unit = "Mrays/s";
+        r.seconds = seconds;
+        r.throughput = seconds > 0.0 ? double(rayCount) / seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    {
+        size_t occluded = 0;
+        ScopedTimer timer;
+        for (size_t i = 0; i < rayCount; ++i) {
+            const XMFLOAT3 end(origins[i].x + directions[i].x, origins[i].y + directions[i].y,
+                origins[i].z + directions[i].z);
+            occluded += bvh.segmentOccluded(origins[i], end) ? 1 : 0;
+        }
+        BenchmarkResult r;
+        r.seconds = timer.seconds();
+        r.name = "MeshBVH::segmentOccluded" + label + ", " + std::to_string(occluded) + " ocluidos";
+        r.unit = "Mrays/s";
+        r.throughput = r.seconds > 0.0 ? double(rayCount) / r.seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    // Fuerza bruta sobre m_index (lo que había antes) con una muestra pequeña
+    {
+        const size_t sample = std::min<size_t>(rayCount, 64);
+        size_t mismatches = 0;
+        ScopedTimer timer;
+        for (size_t i = 0; i < sample; ++i) {
+            const XMFLOAT3& o = origins[i];
+            const XMFLOAT3& d = directions[i];
+            float best = FLT_MAX;
+            for (size_t t = 0; t < triangles; ++t) {
+                const XMFLOAT3& a = mesh.m_vertex[mesh.m_index[t * 3 + 0]].Pos;
+                const XMFLOAT3& b = mesh.m_vertex[mesh.m_index[t * 3 + 1]].Pos;
+                const XMFLOAT3& c = mesh.m_vertex[mesh.m_index[t * 3 + 2]].Pos;
+                const XMFLOAT3 e1(b.x - a.x, b.y - a.y, b.z - a.z), e2(c.x - a.x, c.y - a.y, c.z - a.z);
+                const XMFLOAT3 p(d.y * e2.z - d.z * e2.y, d.z * e2.x - d.x * e2.z, d.x * e2.y - d.y * e2.x);
+                const float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+                if (det == 0.0f) continue;
+                const float inv = 1.0f / det;
+                const XMFLOAT3 s(o.x - a.x, o.y - a.y, o.z - a.z);
+                const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inv;
+                if (u < 0.0f || u > 1.0f) continue;
+                const XMFLOAT3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+                const float v = (d.x * q.x + d.y * q.y + d.z * q.z) * inv;
+                if (v < 0.0f || u + v > 1.0f) continue;
+                const float t01 = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inv;
+                if (t01 >= 0.0f && t01 < best) best = t01;
+            }
+            RayHit hit;
+            const bool bvhHit = bvh.raycast(o, d, hit);
+            if (bvhHit != (best != FLT_MAX) || (bvhHit && std::fabs(hit.t - best) > 1e-5f * std::max(1.0f, best))) {
+                ++mismatches;
+            }
+        }
+        BenchmarkResult r;
+        r.seconds = timer.seconds();
+        r.name = "Raycast fuerza bruta" + label + ", " + std::to_string(sample) + " rayos, " +
+            std::to_string(mismatches) + " discrepancias con el BVH";
+        r.unit = "Mrays/s";
+        r.throughput = r.seconds > 0.0 ? double(sample) / r.seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    return results;
+}
+
+BenchmarkResult
+EngineBenchmarks::Picking(size_t triangleCount, unsigned int meshCount, size_t pickCount) {
+    BenchmarkResult result;
+    result.unit = "Kpicks/s";
+    meshCount = std::max(1u, meshCount);
+
+    // Rejillas de 10x10 unidades en una cuadrícula, cada una con su BVH
+    MeshComponent mesh;
+    makeWavyGrid(triangleCount / meshCount, mesh);
+    std::vector<MeshBVH> bvhs(meshCount);
+    Picker picker;
+    const unsigned int columns = unsigned(std::ceil(std::sqrt(double(meshCount))));
+    for (unsigned int i = 0; i < meshCount; ++i) {
+        bvhs[i].build(mesh);
+        const float x = (float(i % columns) - 0.5f * float(columns - 1)) * 11.0f;
+        const float z = (float(i / columns) - 0.5f * float(columns - 1)) * 11.0f;
+        picker.addMesh(&bvhs[i], XMMatrixRotationY(0.3f * float(i)) * XMMatrixTranslation(x, 0.0f, z));
+    }
+
+    // Cámara inclinada que encuadra toda la escena
+    const float extent = 11.0f * float(columns);
+    const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, extent * 0.6f, -extent * 0.9f, 1.0f),
+        XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 1280.0f / 720.0f, 0.01f, 10000.0f);
+
+    std::mt19937 rng(2024);
+    std::uniform_real_distribution<float> px(0.0f, 1280.0f), py(0.0f, 720.0f);
+    std::vector<XMFLOAT2> pixels(pickCount);
+    for (XMFLOAT2& p : pixels) p = XMFLOAT2(px(rng), py(rng));
+
+    size_t hits = 0;
+    ScopedTimer timer;
+    for (const XMFLOAT2& p : pixels) {
+        PickResult pick;
+        hits += picker.pick(p.x, p.y, 1280.0f, 720.0f, view, projection, pick) ? 1 : 0;
+    }
+    result.seconds = timer.seconds();
+    result.throughput = result.seconds > 0.0 ? double(pickCount) / result.seconds / 1e3 : 0.0;
+
+    char name[200];
+    snprintf(name, sizeof(name), "Picker::pick (%zu tris, %u mallas) %.2f us/pick, %zu impactos",
+        (mesh.m_index.size() / 3) * meshCount, meshCount,
+        pickCount ? result.seconds * 1e6 / double(pickCount) : 0.0, hits);
+    result.name = name;
+    return result;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::BoundsComputation(size_t vertexCount, unsigned int passes) {
+    std::vector<BenchmarkResult> results;
+    vertexCount = std::max<size_t>(vertexCount, 1);
+    passes = std::max(passes, 1u);
+
+    // Caja de 10x2x0.4 rotada: el AABB es flojo y la OBB debe recuperar la orientación
+    std::vector<SimpleVertex> vertices(vertexCount);
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    const XMMATRIX rotation = XMMatrixRotationX(0.7f) * XMMatrixRotationY(1.1f);
+    for (SimpleVertex& v : vertices) {
+        const XMVECTOR p = XMVectorSet(unit(rng) * 5.0f, unit(rng), unit(rng) * 0.2f, 1.0f);
+        XMStoreFloat3(&v.Pos, XMVector3TransformCoord(p, rotation));
+        v.Tex = XMFLOAT2(0.5f * unit(rng) + 0.5f, 0.5f * unit(rng) + 0.5f);
+        v.Normal = XMFLOAT3(0, 1, 0);
+    }
+    PointStream points;
+    points.positions = &vertices[0].Pos;
+    points.stride = sizeof(SimpleVertex);
+    points.count = vertices.size();
+
+    const double work = double(vertexCount) * passes / 1e6;
+    auto finish = [&](const std::string& name, double seconds) {
+        BenchmarkResult result;
+        result.name = name;
+        result.unit = "Mverts/s";
+        result.seconds = seconds;
+        result.throughput = seconds > 0.0 ? work / seconds : 0.0;
+        results.push_back(result);
+    };
+
+    XMFLOAT3 mn, mx;
+    {
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < passes; ++i) scalarAABB(vertices, mn, mx);
+        finish("AABB escalar", timer.seconds());
+    }
+    {
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < passes; ++i) BoundingVolumes::ComputeAABB(points, mn, mx);
+        finish("AABB SSE", timer.seconds());
+    }
+
+    char name[200];
+    BoundingSphere ritter, epos;
+    {
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < passes; ++i) ritter = scalarRitter(vertices);
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "Esfera Ritter escalar r=%.4f", ritter.radius);
+        finish(name, seconds);
+    }
+    {
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < passes; ++i) epos = BoundingVolumes::ComputeSphere(points);
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "Esfera EPOS-14 SSE r=%.4f", epos.radius);
+        finish(name, seconds);
+    }
+    {
+        OrientedBox box;
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < passes; ++i) box = BoundingVolumes::ComputeOBB(points);
+        const double seconds = timer.seconds();
+        const float aabbVolume = (mx.x - mn.x) * (mx.y - mn.y) * (mx.z - mn.z);
+        snprintf(name, sizeof(name), "OBB PCA SSE (volumen %.1f%% del AABB)",
+            aabbVolume > 0.0f ? 100.0f * box.volume() / aabbVolume : 100.0f);
+        finish(name, seconds);
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::NormalGeneration(size_t triangleCount, unsigned int threadCount) {
+    std::vector<BenchmarkResult> results;
+    MeshComponent mesh;
+    makeWavyGrid(std::max<size_t>(triangleCount, 2), mesh);
+    const size_t triangles = mesh.m_index.size() / 3;
+    const unsigned int threads = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+    auto finish = [&](const std::string& name, double seconds) {
+        BenchmarkResult result;
+        result.name = name;
+        result.unit = "Mtris/s";
+        result.seconds = seconds;
+        result.throughput = seconds > 0.0 ? double(triangles) / seconds / 1e6 : 0.0;
+        results.push_back(result);
+    };
+
+    char name[160];
+    {
+        ScopedTimer timer;
+        scalarScatterNormals(mesh.m_vertex, mesh.m_index);
+        finish("Normales scatter-add serial (área)", timer.seconds());
+    }
+    for (NormalWeighting weighting : { NormalWeighting::Area, NormalWeighting::Angle }) {
+        for (unsigned int t : { 1u, threads }) {
+            ScopedTimer timer;
+            MeshNormals::ComputeNormals(mesh.m_vertex, mesh.m_index, nullptr, weighting, t);
+            const double seconds = timer.seconds();
+            snprintf(name, sizeof(name), "Normales CSR (%s), %u hilos",
+                weighting == NormalWeighting::Area ? "área" : "ángulo", t);
+            finish(name, seconds);
+        }
+    }
+    for (unsigned int t : { 1u, threads }) {
+        // Cada pasada parte del mismo index buffer (las divisiones lo modifican)
+        MeshComponent copy = mesh;
+        ScopedTimer timer;
+        const size_t splits = MeshNormals::ComputeTangents(copy, t);
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "Tangentes, %u hilos, %zu vértices divididos", t, splits);
+        finish(name, seconds);
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::StaticBatching(unsigned int propCount, size_t trianglesPerProp, unsigned int materialCount) {
+    std::vector<BenchmarkResult> results;
+    propCount = std::max(1u, propCount);
+    materialCount = std::max(1u, materialCount);
+
+    // Una rejilla por material; las instancias los alternan en una cuadrícula con giros distintos
+    std::vector<MeshComponent> props(materialCount);
+    for (unsigned int m = 0; m < materialCount; ++m) {
+        makeWavyGrid(trianglesPerProp, props[m]);
+        MeshMaterial material;
+        material.name = "prop" + std::to_string(m);
+        props[m].m_materials.push_back(material);
+    }
+    std::vector<StaticMeshInstance> instances(propCount);
+    const unsigned int columns = unsigned(std::ceil(std::sqrt(double(propCount))));
+    for (unsigned int i = 0; i < propCount; ++i) {
+        const float x = (float(i % columns) - 0.5f * float(columns - 1)) * 12.0f;
+        const float z = (float(i / columns) - 0.5f * float(columns - 1)) * 12.0f;
+        instances[i].mesh = &props[i % materialCount];
+        XMStoreFloat4x4(&instances[i].world, XMMatrixRotationY(0.3f * float(i)) * XMMatrixTranslation(x, 0.0f, z));
+    }
+
+    StaticBatchData data;
+    char name[240];
+    {
+        ScopedTimer timer;
+        StaticBatcher::Build(instances, data);
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name),
+            "StaticBatcher::Build (%u mallas, %zu tris): draws %zu -> %zu, binds VB/IB %zu -> %zu, materiales %zu -> %zu",
+            propCount, data.mesh.m_index.size() / 3, data.before.drawCalls, data.after.drawCalls,
+            data.before.bufferBinds, data.after.bufferBinds, data.before.materialBinds, data.after.materialBinds);
+        BenchmarkResult r;
+        r.name = name;
+        r.unit = "Mtris/s";
+        r.seconds = seconds;
+        r.throughput = seconds > 0.0 ? double(data.mesh.m_index.size() / 3) / seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    // Cámara a ras del suelo: sólo una parte de la escena queda dentro del frustum
+    const float extent = 12.0f * float(columns);
+    const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(-0.5f * extent, 8.0f, -0.5f * extent, 1.0f),
+        XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 1280.0f / 720.0f, 0.1f, extent * 0.5f);
+    Frustum frustum;
+    frustum.init(view * projection);
+
+    const unsigned int passes = 100;
+    std::vector<MeshSubset> draws;
+    DrawStats before, after;
+    size_t visible = 0;
+    ScopedTimer timer;
+    for (unsigned int i = 0; i < passes; ++i) visible = StaticBatcher::Cull(data, frustum, draws, &before, &after);
+    const double seconds = timer.seconds();
+    snprintf(name, sizeof(name),
+        "StaticBatcher::Cull (%zu/%u visibles): draws %zu -> %zu, binds VB/IB %zu -> %zu, materiales %zu -> %zu",
+        visible, propCount, before.drawCalls, after.drawCalls, before.bufferBinds, after.bufferBinds,
+        before.materialBinds, after.materialBinds);
+    BenchmarkResult r;
+    r.name = name;
+    r.unit = "Mobjs/s";
+    r.seconds = seconds / passes;
+    r.throughput = seconds > 0.0 ? double(data.mesh.m_subsets.size()) * passes / seconds / 1e6 : 0.0;
+    results.push_back(r);
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::Instancing(unsigned int instanceCount, unsigned int subsetCount) {
+    std::vector<BenchmarkResult> results;
+    instanceCount = std::max(1u, instanceCount);
+    subsetCount = std::max(1u, subsetCount);
+
+    InstanceList instances;
+    BoundingSphere bounds;
+    bounds.center = XMFLOAT3(0.0f, 0.5f, 0.0f);
+    bounds.radius = 1.0f;
+    instances.setBounds(bounds);
+    const unsigned int columns = unsigned(std::ceil(std::sqrt(double(instanceCount))));
+    for (unsigned int i = 0; i < instanceCount; ++i) {
+        const float x = (float(i % columns) - 0.5f * float(columns - 1)) * 3.0f;
+        const float z = (float(i / columns) - 0.5f * float(columns - 1)) * 3.0f;
+        instances.add(XMMatrixRotationY(0.3f * float(i)) * XMMatrixTranslation(x, 0.0f, z));
+    }
+    std::vector<InstanceData> stream(instanceCount);
+
+    // Escena completa desde arriba y vista a ras del suelo
+    const float extent = 3.0f * float(columns);
+    const XMMATRIX projections[2] = {
+        XMMatrixPerspectiveFovLH(XM_PIDIV4, 1280.0f / 720.0f, 0.1f, extent * 4.0f),
+        XMMatrixPerspectiveFovLH(XM_PIDIV4, 1280.0f / 720.0f, 0.1f, extent * 0.5f) };
+    const XMMATRIX views[2] = {
+        XMMatrixLookAtLH(XMVectorSet(0.0f, extent * 1.5f, -0.01f, 1.0f),
+            XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)),
+        XMMatrixLookAtLH(XMVectorSet(-0.5f * extent, 4.0f, -0.5f * extent, 1.0f),
+            XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f)) };
+    const char* viewNames[2] = { "escena completa", "vista parcial" };
+
+    const unsigned int passes = 100;
+    char name[240];
+    for (int v = 0; v < 2; ++v) {
+        Frustum frustum;
+        frustum.init(views[v] * projections[v]);
+        size_t visible = 0;
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < passes; ++i) {
+            visible = instances.writeVisible(frustum, stream.data(), stream.size());
+        }
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name),
+            "InstanceList::writeVisible (%s, %zu/%u visibles): draws %zu -> %u, CB updates %zu -> 0, stream %zu KB",
+            viewNames[v], visible, instanceCount, visible * subsetCount, visible > 0 ? subsetCount : 0u,
+            visible, visible * sizeof(InstanceData) / 1024);
+        BenchmarkResult r;
+        r.name = name;
+        r.unit = "Minst/s";
+        r.seconds = seconds / passes;
+        r.throughput = seconds > 0.0 ? double(instanceCount) * passes / seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::FrustumCulling(size_t objectCount, unsigned int threadCount) {
+    std::vector<BenchmarkResult> results;
+
+    // Objetos en un cubo de 2000 de lado con la cámara en el centro
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    CullingBounds bounds;
+    bounds.reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        const XMFLOAT3 c(position(rng), position(rng), position(rng));
+        const XMFLOAT3 e(size(rng), size(rng), size(rng));
+        BoundingSphere sphere;
+        sphere.center = c;
+        sphere.radius = std::sqrt(e.x * e.x + e.y * e.y + e.z * e.z);
+        bounds.add(sphere, XMFLOAT3(c.x - e.x, c.y - e.y, c.z - e.z), XMFLOAT3(c.x + e.x, c.y + e.y, c.z + e.z));
+    }
+    const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+        XMVectorSet(1.0f, 0.2f, 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    Frustum frustum;
+    frustum.init(view * XMMatrixPerspectiveFovLH(XM_PIDIV4, 1280.0f / 720.0f, 0.1f, 1000.0f));
+
+    struct Pass { const char* label; CullTest test; unsigned int threads; bool scalar; };
+    const Pass passes[] = {
+        { "escalar, esfera", CullTest::Sphere, 1, true },
+        { "SSE, esfera, 1 hilo", CullTest::Sphere, 1, false },
+        { "SSE, esfera, multihilo", CullTest::Sphere, threadCount, false },
+        { "SSE, esfera + AABB, multihilo", CullTest::SphereAndAABB, threadCount, false } };
+
+    const unsigned int repeats = 10;
+    std::vector<unsigned int> visible;
+    visible.reserve(bounds.paddedSize());
+    char name[200];
+    for (const Pass& pass : passes) {
+        size_t count = 0;
+        double best = 0.0;
+        for (unsigned int i = 0; i < repeats; ++i) {
+            ScopedTimer timer;
+            count = pass.scalar ? FrustumCuller::CullScalar(frustum, bounds, pass.test, visible) :
+                FrustumCuller::Cull(frustum, bounds, pass.test, visible, pass.threads);
+            const double seconds = timer.seconds();
+            best = i == 0 ? seconds : std::min(best, seconds);
+        }
+        snprintf(name, sizeof(name), "FrustumCuller (%s): %zu/%zu visibles", pass.label, count, objectCount);
+        BenchmarkResult r;
+        r.name = name;
+        r.unit = "Mobjs/s";
+        r.seconds = best;
+        r.throughput = best > 0.0 ? double(objectCount) / best / 1e6 : 0.0;
+        results.push_back(r);
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::ScenePartition(unsigned int objectCount, unsigned int frames) {
+    std::vector<BenchmarkResult> results;
+    frames = std::max(1u, frames);
+    auto add = [&](const char* label, double seconds, double operations) {
+        BenchmarkResult r;
+        r.name = label;
+        r.unit = "Mops/s";
+        r.seconds = seconds;
+        r.throughput = seconds > 0.0 ? operations / seconds / 1e6 : 0.0;
+        results.push_back(r);
+    };
+
+    // Objetos en un cubo de 2000 de lado, con tamaños variados y velocidad constante
+    const float worldHalf = 1000.0f;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> position(-worldHalf, worldHalf);
+    std::uniform_real_distribution<float> speed(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::vector<XMFLOAT3> centers(objectCount), velocities(objectCount), extents(objectCount);
+    for (unsigned int i = 0; i < objectCount; ++i) {
+        centers[i] = XMFLOAT3(position(rng), position(rng), position(rng));
+        velocities[i] = XMFLOAT3(speed(rng), speed(rng), speed(rng));
+        const float size = 0.5f + 8.0f * unit(rng) * unit(rng) * unit(rng);  // Mayoría pequeños
+        extents[i] = XMFLOAT3(size, size * 0.5f + 0.25f, size);
+    }
+    auto boundsOf = [&](unsigned int i, XMFLOAT3& mn, XMFLOAT3& mx) {
+        const XMFLOAT3& c = centers[i];
+        const XMFLOAT3& e = extents[i];
+        mn = XMFLOAT3(c.x - e.x, c.y - e.y, c.z - e.z);
+        mx = XMFLOAT3(c.x + e.x, c.y + e.y, c.z + e.z);
+    };
+
+    SceneOctree octree;
+    octree.init(XMFLOAT3(0, 0, 0), worldHalf, 8);
+    std::vector<unsigned int> handles(objectCount);
+    char name[240];
+    {
+        ScopedTimer timer;
+        for (unsigned int i = 0; i < objectCount; ++i) {
+            XMFLOAT3 mn, mx;
+            boundsOf(i, mn, mx);
+            handles[i] = octree.insert(mn, mx, i);
+        }
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "SceneOctree::insert (%u objetos)", objectCount);
+        add(name, seconds, objectCount);
+    }
+
+    // Todos los objetos se mueven cada frame (rebotan en los límites del mundo)
+    {
+        ScopedTimer timer;
+        for (unsigned int f = 0; f < frames; ++f) {
+            for (unsigned int i = 0; i < objectCount; ++i) {
+                XMFLOAT3& c = centers[i];
+                XMFLOAT3& v = velocities[i];
+                c = XMFLOAT3(c.x + v.x, c.y + v.y, c.z + v.z);
+                if (std::fabs(c.x) > worldHalf) v.x = -v.x;
+                if (std::fabs(c.y) > worldHalf) v.y = -v.y;
+                if (std::fabs(c.z) > worldHalf) v.z = -v.z;
+                XMFLOAT3 mn, mx;
+                boundsOf(i, mn, mx);
+                octree.move(handles[i], mn, mx);
+            }
+        }
+        const double seconds = timer.seconds();
+        const OctreeStats stats = octree.getStats();
+        snprintf(name, sizeof(name), "SceneOctree::move (%u objetos x %u frames, %zu nodos, prof. %u, %zu en raíz)",
+            objectCount, frames, stats.nodes, stats.maxDepth, stats.rootObjects);
+        add(name, seconds / frames, objectCount);
+    }
+
+    // Culling jerárquico frente a culling plano (SSE) de los mismos AABBs
+    const XMMATRIX view = XMMatrixLookAtLH(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f),
+        XMVectorSet(1.0f, 0.2f, 0.5f, 1.0f), XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f));
+    Frustum frustum;
+    frustum.init(view * XMMatrixPerspectiveFovLH(XM_PIDIV4, 1280.0f / 720.0f, 0.1f, 600.0f));
+    std::vector<unsigned int> visible;
+    {
+        size_t count = 0;
+        ScopedTimer timer;
+        for (unsigned int f = 0; f < frames; ++f) count = octree.cullFrustum(frustum, visible);
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "SceneOctree::cullFrustum (%zu/%u visibles)", count, objectCount);
+        add(name, seconds / frames, objectCount);
+    }
+    {
+        CullingBounds flat;
+        flat.reserve(objectCount);
+        for (unsigned int i = 0; i < objectCount; ++i) {
+            XMFLOAT3 mn, mx;
+            boundsOf(i, mn, mx);
+            flat.add(BoundingSphere(), mn, mx);
+        }
+        size_t count = 0;
+        ScopedTimer timer;
+        for (unsigned int f = 0; f < frames; ++f) count = FrustumCuller::Cull(frustum, flat, CullTest::AABB, visible, 1);
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "FrustumCuller::Cull plano, AABB, 1 hilo (%zu/%u visibles)", count, objectCount);
+        add(name, seconds / frames, objectCount);
+    }
+
+    // Consultas locales: esferas de radio 20 y rayos cortos desde posiciones aleatorias
+    const unsigned int queries = 1000;
+    {
+        size_t found = 0;
+        ScopedTimer timer;
+        for (unsigned int q = 0; q < queries; ++q) {
+            found += octree.querySphere(XMFLOAT3(position(rng), position(rng), position(rng)), 20.0f, visible);
+        }
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "SceneOctree::querySphere (r = 20, %.1f objetos/consulta)", double(found) / queries);
+        add(name, seconds / queries, 1.0);
+    }
+    {
+        std::vector<RayCandidate> candidates;
+        size_t found = 0;
+        ScopedTimer timer;
+        for (unsigned int q = 0; q < queries; ++q) {
+            const XMFLOAT3 origin(position(rng), position(rng), position(rng));
+            const XMFLOAT3 direction(speed(rng), speed(rng), speed(rng));
+            found += octree.queryRay(origin, direction, 100.0f, candidates);
+        }
+        const double seconds = timer.seconds();
+        snprintf(name, sizeof(name), "SceneOctree::queryRay (%.1f candidatos/rayo)", double(found) / queries);
+        add(name, seconds / queries, 1.0);
+    }
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::RenderQueueSort(unsigned int packetCount, unsigned int shaderCount,
+    unsigned int materialCount, unsigned int meshCount) {
+    std::vector<BenchmarkResult> results;
+    shaderCount = std::max(1u, shaderCount);
+    materialCount = std::max(1u, materialCount);
+    meshCount = std::max(1u, meshCount);
+
+    // Recursos sin crear: la cola sólo compara punteros
+    std::vector<ShaderProgram> shaders(shaderCount);
+    std::vector<Texture> textures(materialCount);
+    std::vector<Buffer> vertexBuffers(meshCount), indexBuffers(meshCount);
+    Buffer constants;
+    CBChangesEveryFrame objectConstants;
+
+    // Cada malla tiene su material y su shader, como un objeto de la escena; los packets se
+    // crean una vez y cada frame sólo cambian las claves (la profundidad)
+    std::vector<DrawPacket> packets(packetCount);
+    std::vector<uint64_t> keys(packetCount);
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> depth(0.0f, 1.0f);
+    for (size_t i = 0; i < packets.size(); ++i) {
+        const unsigned int mesh = rng() % meshCount;
+        const unsigned int material = mesh % materialCount;
+        const unsigned int shader = material % shaderCount;
+        DrawPacket& packet = packets[i];
+        packet.shader = &shaders[shader];
+        packet.texture = &textures[material];
+        packet.vertexBuffer = &vertexBuffers[mesh];
+        packet.indexBuffer = &indexBuffers[mesh];
+        packet.constantBuffer = &constants;
+        packet.constants = &objectConstants;
+        packet.indexCount = 3 * (64 + mesh);
+        keys[i] = RenderQueue::MakeKey(0, shader, material, depth(rng));
+    }
+
+    RenderQueue queue;
+    queue.reserve(packetCount);
+    const unsigned int frames = 20;
+    double best = 0.0;
+    for (unsigned int f = 0; f < frames; ++f) {
+        ScopedTimer timer;
+        queue.clear();
+        for (size_t i = 0; i < packets.size(); ++i) queue.submit(keys[i], &packets[i]);
+        queue.sort();
+        const double seconds = timer.seconds();
+        best = f == 0 ? seconds : std::min(best, seconds);
+    }
+
+    queue.clear();
+    for (size_t i = 0; i < packets.size(); ++i) queue.submit(keys[i], &packets[i]);
+    const RenderQueueStats before = queue.countStateChanges();
+    queue.sort();
+    ScopedTimer walkTimer;
+    const RenderQueueStats after = queue.countStateChanges();
+    const double walkSeconds = walkTimer.seconds();
+
+    char name[240];
+    snprintf(name, sizeof(name),
+        "RenderQueue submit + sort (%u packets): shaders %zu -> %zu, materiales %zu -> %zu, buffers %zu -> %zu",
+        packetCount, before.shaderBinds, after.shaderBinds, before.materialBinds, after.materialBinds,
+        before.bufferBinds, after.bufferBinds);
+    BenchmarkResult r;
+    r.name = name;
+    r.unit = "Mpackets/s";
+    r.seconds = best;
+    r.throughput = best > 0.0 ? double(packetCount) / best / 1e6 : 0.0;
+    results.push_back(r);
+
+    snprintf(name, sizeof(name), "RenderQueue recorrido ordenado (%zu draws, %zu cambios de estado)",
+        after.drawCalls, after.stateChanges());
+    r.name = name;
+    r.seconds = walkSeconds;
+    r.throughput = walkSeconds > 0.0 ? double(packetCount) / walkSeconds / 1e6 : 0.0;
+    results.push_back(r);
+    return results;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::JobScaling(size_t itemCount, unsigned int maxThreads, unsigned int jobCount) {
+    std::vector<BenchmarkResult> results;
+    maxThreads = maxThreads ? maxThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<float> values(itemCount);
+    auto body = [&values](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            float x = float(i) * 1e-4f;
+            for (int k = 0; k < 16; ++k) x = std::sqrt(x * x + 1.0f) * 0.5f + std::sin(x);
+            values[i] = x;
+        }
+    };
+
+    const unsigned int repeats = 5;
+    char name[200];
+    double oneThread = 0.0;
+    for (unsigned int threads = 1; threads <= maxThreads; ++threads) {
+        JobSystem jobs;
+        jobs.init(threads);
+        double best = 0.0;
+        for (unsigned int i = 0; i < repeats; ++i) {
+            ScopedTimer timer;
+            jobs.parallelFor(0, itemCount, body);
+            const double seconds = timer.seconds();
+            best = i == 0 ? seconds : std::min(best, seconds);
+        }
+        jobs.shutdown();
+        if (threads == 1) oneThread = best;
+
+        snprintf(name, sizeof(name), "JobSystem parallelFor, %u hilos: %.2fx frente a 1 hilo",
+            threads, best > 0.0 ? oneThread / best : 0.0);
+        BenchmarkResult r;
+        r.name = name;
+        r.unit = "Mitems/s";
+        r.seconds = best;
+        r.throughput = best > 0.0 ? double(itemCount) / best / 1e6 : 0.0;
+        results.push_back(r);
+    }
+
+    // Coste fijo por tarea: lanzar y esperar tareas vacías
+    JobSystem jobs;
+    jobs.init(maxThreads);
+    double best = 0.0;
+    for (unsigned int i = 0; i < repeats; ++i) {
+        ScopedTimer timer;
+        JobCounter counter;
+        for (unsigned int j = 0; j < jobCount; ++j) jobs.run([]() {}, &counter);
+        jobs.wait(counter);
+        const double seconds = timer.seconds();
+        best = i == 0 ? seconds : std::min(best, seconds);
+    }
+    jobs.shutdown();
+
+    snprintf(name, sizeof(name), "JobSystem run + wait, %u tareas vacías, %u hilos", jobCount, maxThreads);
+    BenchmarkResult r;
+    r.name = name;
+    r.unit = "Mjobs/s";
+    r.seconds = best;
+    r.throughput = best > 0.0 ? double(jobCount) / best / 1e6 : 0.0;
+    results.push_back(r);
+    return results;
+}
+
+BenchmarkResult
+EngineBenchmarks::HandleTableStress(unsigned int threadCount, size_t handlesPerThread, unsigned int window) {
+    const unsigned int threads = threadCount ? threadCount : std::max(4u, std::thread::hardware_concurrency());
+    window = std::max(1u, window);
+    HandleTable table(threads * window + HandleTable::kChunkSize);
+    std::vector<size_t> errors(threads, 0);
+
+    auto stress = [&](unsigned int t) {
+        // Cada handle vivo apunta a su casilla de la ventana: el puntero identifica al dueño
+        std::vector<Handle> live(window);
+        size_t& bad = errors[t];
+        for (size_t i = 0; i < handlesPerThread; ++i) {
+            const size_t w = i % window;
+            const Handle old = live[w];
+            if (old.valid()) {
+                if (table.get(old) != &live[w]) ++bad;
+                if (!table.release(old)) ++bad;
+                if (table.isValid(old) || table.release(old)) ++bad;
+            }
+            const Handle handle = table.allocate(&live[w]);
+            if (!handle.valid() || table.get(handle) != &live[w] || (handle.generation & 1) == 0) ++bad;
+            live[w] = handle;
+        }
+        for (Handle& handle : live) {
+            if (handle.valid() && !table.release(handle)) ++bad;
+        }
+    };
+
+    ScopedTimer timer;
+    std::vector<std::thread> workers;
+    for (unsigned int t = 1; t < threads; ++t) workers.emplace_back(stress, t);
+    stress(0);
+    for (std::thread& w : workers) w.join();
+    const double seconds = timer.seconds();
+
+    size_t totalErrors = 0;
+    for (size_t e : errors) totalErrors += e;
+    if (table.size() != 0) ++totalErrors;  // Todo lo asignado se liberó
+
+    const double handles = double(handlesPerThread) * threads;
+    char name[200];
+    snprintf(name, sizeof(name), "HandleTable, %u hilos, %.0f handles, %u entradas usadas, errores: %zu",
+        threads, handles, table.highWater(), totalErrors);
+    BenchmarkResult r;
+    r.name = name;
+    r.unit = "Mhandles/s";
+    r.seconds = seconds;
+    r.throughput = seconds > 0.0 ? handles / seconds / 1e6 : 0.0;
+    return r;
+}
+
+std::vector<BenchmarkResult>
+EngineBenchmarks::ConstantUploads(unsigned int frames, unsigned int drawsPerFrame, unsigned int ringBytes) {
+    std::vector<BenchmarkResult> results;
+    const unsigned int payloadBytes = sizeof(CBChangesEveryFrame);
+    const unsigned int slot = 2;
+    auto align = [](size_t value, size_t alignment) { return (value + alignment - 1) / alignment * alignment; };
+
+    for (int pass = 0; pass < 2; ++pass) {
+        const bool offsets = pass == 0;
+        CountingDevice mockDevice(offsets);
+        CountingDeviceContext mockContext(offsets);
+        Device device;
+        DeviceContext deviceContext;
+        device.m_device = &mockDevice;
+        deviceContext.m_deviceContext = &mockContext;
+        size_t errors = 0;
+
+        ConstantBufferManager manager;
+        if (FAILED(manager.init(device, deviceContext, ringBytes)) || manager.hasRingOffsets() != offsets) ++errors;
+        const unsigned int viewBlock = manager.createBlock(device, sizeof(CBNeverChanges));
+        const unsigned int projectionBlock = manager.createBlock(device, sizeof(CBChangeOnResize));
+        const unsigned int objectBlock = manager.createBlock(device, sizeof(CBChangesEveryFrame));
+        const size_t allBlocksBytes = align(sizeof(CBNeverChanges), 16) + align(sizeof(CBChangeOnResize), 16) +
+            align(sizeof(CBChangesEveryFrame), 16);
+
+        CBNeverChanges view;
+        view.mView = XMMatrixTranslation(0.0f, 3.0f, -6.0f);
+        CBChangeOnResize projection;
+        projection.mProjection = XMMatrixScaling(1.5f, 2.0f, 1.0f);
+        CBChangesEveryFrame object;
+        object.mWorld = XMMatrixIdentity();
+
+        // Bytes de 1 a 100: nunca coinciden con CountingBuffer::kFreshByte
+        std::vector<unsigned char> payloads(size_t(drawsPerFrame) * payloadBytes);
+        std::vector<ConstantAllocation> allocations(drawsPerFrame);
+        size_t discards = 0, noOverwrites = 0, frameBytes = 0;
+
+        ScopedTimer timer;
+        for (unsigned int f = 0; f < frames; ++f) {
+            manager.beginFrame();
+            mockContext.resetStats();
+
+            object.vMeshColor = XMFLOAT4(float(f), 0.5f, 0.25f, 1.0f);
+            manager.set(viewBlock, &view, sizeof(view));
+            manager.set(projectionBlock, &projection, sizeof(projection));
+            manager.set(objectBlock, &object, sizeof(object));
+            manager.commit(deviceContext);
+
+            for (unsigned int d = 0; d < drawsPerFrame; ++d) {
+                unsigned char* payload = &payloads[size_t(d) * payloadBytes];
+                for (unsigned int i = 0; i < payloadBytes; ++i) payload[i] = (unsigned char)(1 + (f * 31 + d * 7 + i) % 100);
+                allocations[d] = manager.allocate(deviceContext, payload, payloadBytes);
+                if (!allocations[d].valid()) ++errors;
+            }
+            manager.flush(deviceContext);
+
+            for (unsigned int d = 0; d < drawsPerFrame; ++d) {
+                manager.bindAllocation(deviceContext, allocations[d], slot, false);
+                deviceContext.DrawIndexed(3, 0, 0);
+                size_t visible = 0;
+                const unsigned char* seen = mockContext.boundConstants(slot, visible);
+                if (!seen || visible < payloadBytes ||
+                    std::memcmp(seen, &payloads[size_t(d) * payloadBytes], payloadBytes) != 0) ++errors;
+            }
+
+            // Bloques: todo en el primer frame; luego sólo el del objeto, y los otros dos se filtran
+            const ConstantUploadStats& stats = manager.getStats();
+            const CountingDeviceStats& counted = mockContext.getStats();
+            const size_t blockBytes = f == 0 ? allBlocksBytes : align(sizeof(CBChangesEveryFrame), 16);
+            if (stats.blockBytes != blockBytes || counted.updateBytes != blockBytes) ++errors;
+            if (stats.unchangedSets != (f == 0 ? 0u : 2u)) ++errors;
+
+            // Ring: con D3D11.1 sólo se escriben las constantes y hay un Map por frame; sin él,
+            // un Map DISCARD por draw que copia el rango alineado entero
+            const size_t aligned = align(payloadBytes, ConstantBufferManager::kRingAlignment);
+            if (stats.ringAllocations != drawsPerFrame || stats.ringBytes != drawsPerFrame * aligned) ++errors;
+            if (counted.mappedBytes != drawsPerFrame * (offsets ? payloadBytes : aligned)) ++errors;
+            if (stats.discardMaps != counted.discardMaps || stats.noOverwriteMaps != counted.noOverwriteMaps) ++errors;
+            if (offsets ? counted.discardMaps + counted.noOverwriteMaps != 1 :
+                counted.discardMaps != drawsPerFrame || counted.noOverwriteMaps != 0) ++errors;
+            if (counted.overwrites != 0 || stats.ringOverflows != 0) ++errors;
+
+            discards += counted.discardMaps;
+            noOverwrites += counted.noOverwriteMaps;
+            frameBytes = counted.uploadBytes();
+        }
+        const double seconds = timer.seconds();
+
+        // Cada DISCARD abre un ring vacío que se llena con tantos frames como quepan
+        if (offsets) {
+            const size_t capacity = align(std::max(ringBytes, unsigned(ConstantBufferManager::kMaxAllocation)),
+                ConstantBufferManager::kRingAlignment);
+            const size_t segment = size_t(drawsPerFrame) * align(payloadBytes, ConstantBufferManager::kRingAlignment);
+            const size_t framesPerRing = std::max<size_t>(1, capacity / std::max<size_t>(1, segment));
+            if (discards != (frames + framesPerRing - 1) / framesPerRing) ++errors;
+        }
+
+        manager.destroy();
+        deviceContext.destroy();
+        device.destroy();
+
+        char name[240];
+        snprintf(name, sizeof(name),
+            "Constantes %s (%u frames x %u draws): %zu B/frame, %zu DISCARD + %zu NO_OVERWRITE, errores: %zu",
+            offsets ? "con ring D3D11.1" : "sin D3D11.1", frames, drawsPerFrame, frameBytes,
+            discards, noOverwrites, errors);
+        BenchmarkResult r;
+        r.name = name;
+        r.unit = "Mdraws/s";
+        r.seconds = seconds;
+        r.throughput = seconds > 0.0 ? double(frames) * drawsPerFrame / seconds / 1e6 : 0.0;
+        results.push_back(r);
+    }
+    return results;
+}
+
+void
+EngineBenchmarks::Report(const BenchmarkResult& result) {
+    char line[256];
+    snprintf(line, sizeof(line), "[Benchmark] %s : %.3f ms, %.2f %s\n",
+        result.name.c_str(), result.seconds * 1000.0, result.throughput, result.unit.c_str());
+    OutputDebugStringA(line);
+}
@@ -0,0 +1,63 @@
+#include "../include/Frustum.h"
+#include <cmath>
+
+void
+Frustum::init(const XMMATRIX& viewProjection) {
+    XMFLOAT4X4 m;
+    XMStoreFloat4x4(&m, viewProjection);
+
+    // clip = [p 1] * M: cada plano es una combinación de columnas de M (Gribb-Hartmann)
+    const float c0[4] = { m.m[0][0], m.m[1][0], m.m[2][0], m.m[3][0] };
+    const float c1[4] = { m.m[0][1], m.m[1][1], m.m[2][1], m.m[3][1] };
+    const float c2[4] = { m.m[0][2], m.m[1][2], m.m[2][2], m.m[3][2] };
+    const float c3[4] = { m.m[0][3], m.m[1][3], m.m[2][3], m.m[3][3] };
+
+    auto combine = [](const float* a, float s, const float* b) {
+        return XMFLOAT4(a[0] + s * b[0], a[1] + s * b[1], a[2] + s * b[2], a[3] + s * b[3]);
+    };
+    m_planes[0] = combine(c3, 1.0f, c0);    // izquierda
+    m_planes[1] = combine(c3, -1.0f, c0);   // derecha
+    m_planes[2] = combine(c3, 1.0f, c1);    // abajo
+    m_planes[3] = combine(c3, -1.0f, c1);   // arriba
+    m_planes[4] = combine(c2, 0.0f, c2);    // cerca (z >= 0)
+    m_planes[5] = combine(c3, -1.0f, c2);   // lejos
+
+    for (XMFLOAT4& p : m_planes) {
+        const float len = std::sqrt(p.x * p.x + p.y * p.y + p.z * p.z);
+        if (len > 0.0f) {
+            p.x /= len; p.y /= len; p.z /= len; p.w /= len;
+        }
+    }
+}
+
+bool
+Frustum::intersectsSphere(const XMFLOAT3& center, float radius) const {
+    for (const XMFLOAT4& p : m_planes) {
+        if (p.x * center.x + p.y * center.y + p.z * center.z + p.w < -radius) return false;
+    }
+    return true;
+}
+
+bool
+Frustum::intersectsAABB(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) const {
+    for (const XMFLOAT4& p : m_planes) {
+        const float x = p.x >= 0.0f ? aabbMax.x : aabbMin.x;
+        const float y = p.y >= 0.0f ? aabbMax.y : aabbMin.y;
+        const float z = p.z >= 0.0f ? aabbMax.z : aabbMin.z;
+        if (p.x * x + p.y * y + p.z * z + p.w < 0.0f) return false;
+    }
+    return true;
+}
+
+bool
+Frustum::intersectsOBB(const OrientedBox& box) const {
+    const float e[3] = { box.extents.x, box.extents.y, box.extents.z };
+    for (const XMFLOAT4& p : m_planes) {
+        float r = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            r += e[k] * std::fabs(p.x * box.axes[k].x + p.y * box.axes[k].y + p.z * box.axes[k].z);
+        }
+        if (p.x * box.center.x + p.y * box.center.y + p.z * box.center.z + p.w < -r) return false;
+    }
+    return true;
+}
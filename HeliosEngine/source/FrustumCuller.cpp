@@ -0,0 +1,254 @@
+#include "../include/FrustumCuller.h"
+#include "../include/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace
+{
+    // Por debajo de esta cantidad de objetos por tarea no compensa repartir
+    const size_t kMinObjectsPerThread = 1u << 16;
+
+    unsigned int resolveThreads(unsigned int threadCount, size_t objectCount) {
+        unsigned int n = threadCount ? threadCount : JobSystem::Default().getThreadCount();
+        const size_t byWork = std::max<size_t>(1, objectCount / kMinObjectsPerThread);
+        return unsigned(std::min<size_t>(n, byWork));
+    }
+
+    // Un plano difundido a los 4 carriles, con |n| para la semiextensión del AABB
+    struct PlaneSSE {
+        __m128 x, y, z, w;
+        __m128 ax, ay, az;
+    };
+
+    // Carriles visibles de cada máscara de 4 bits, en orden (el resto se escribe y se descarta)
+    struct CompactTable {
+        alignas(16) int lanes[16][4];
+        unsigned char count[16];
+
+        CompactTable() {
+            for (int m = 0; m < 16; ++m) {
+                int n = 0;
+                for (int lane = 0; lane < 4; ++lane) {
+                    if (m & (1 << lane)) lanes[m][n++] = lane;
+                }
+                count[m] = (unsigned char)n;
+                while (n < 4) lanes[m][n++] = 0;
+            }
+        }
+    };
+    const CompactTable kCompact;
+
+    inline __m128 dot(const PlaneSSE& p, __m128 x, __m128 y, __m128 z) {
+        return _mm_add_ps(_mm_add_ps(_mm_mul_ps(p.x, x), _mm_mul_ps(p.y, y)),
+            _mm_add_ps(_mm_mul_ps(p.z, z), p.w));
+    }
+
+    // Prueba los grupos de 4 en [begin, end) y escribe sus índices visibles desde out[0].
+    // Como cada grupo escribe 4 índices pero avanza sólo por los visibles, out nunca pasa
+    // de la posición del grupo actual: la salida puede compartir el rango de la entrada
+    template <bool kSphere, bool kBox>
+    size_t cullRange(const PlaneSSE* planes, const CullingBounds& b, size_t begin, size_t end,
+        unsigned int* out) {
+        const size_t count = b.size();
+        size_t written = 0;
+        __m128i base = _mm_set1_epi32(int(begin));
+        const __m128i four = _mm_set1_epi32(4);
+
+        for (size_t i = begin; i < end; i += 4) {
+            const __m128i groupBase = base;
+            base = _mm_add_epi32(base, four);
+            __m128 inside = _mm_set1_ps(1.0f);  // Mínimo sobre los planos de la distancia con signo
+            if (kSphere) {
+                const __m128 cx = _mm_loadu_ps(&b.m_centerX[i]);
+                const __m128 cy = _mm_loadu_ps(&b.m_centerY[i]);
+                const __m128 cz = _mm_loadu_ps(&b.m_centerZ[i]);
+                const __m128 r = _mm_loadu_ps(&b.m_radius[i]);
+                for (int p = 0; p < Frustum::kPlaneCount; ++p) {
+                    inside = _mm_min_ps(inside, _mm_add_ps(dot(planes[p], cx, cy, cz), r));
+                }
+                // Sin ningún carril dentro no hace falta leer los AABBs del grupo
+                if (kBox && _mm_movemask_ps(_mm_cmpge_ps(inside, _mm_setzero_ps())) == 0) continue;
+            }
+            if (kBox) {
+                const __m128 cx = _mm_loadu_ps(&b.m_boxX[i]);
+                const __m128 cy = _mm_loadu_ps(&b.m_boxY[i]);
+                const __m128 cz = _mm_loadu_ps(&b.m_boxZ[i]);
+                const __m128 ex = _mm_loadu_ps(&b.m_extentX[i]);
+                const __m128 ey = _mm_loadu_ps(&b.m_extentY[i]);
+                const __m128 ez = _mm_loadu_ps(&b.m_extentZ[i]);
+                for (int p = 0; p < Frustum::kPlaneCount; ++p) {
+                    const PlaneSSE& plane = planes[p];
+                    const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(plane.ax, ex), _mm_mul_ps(plane.ay, ey)),
+                        _mm_mul_ps(plane.az, ez));
+                    inside = _mm_min_ps(inside, _mm_add_ps(dot(plane, cx, cy, cz), radius));
+                }
+            }
+
+            int mask = _mm_movemask_ps(_mm_cmpge_ps(inside, _mm_setzero_ps()));
+            if (i + 4 > count) mask &= (1 << (count - i)) - 1;  // Relleno del último grupo
+
+            const __m128i lanes = _mm_load_si128(reinterpret_cast<const __m128i*>(kCompact.lanes[mask]));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + written), _mm_add_epi32(groupBase, lanes));
+            written += kCompact.count[mask];
+        }
+        return written;
+    }
+
+    typedef size_t(*CullKernel)(const PlaneSSE*, const CullingBounds&, size_t, size_t, unsigned int*);
+
+    CullKernel selectKernel(CullTest test) {
+        switch (test) {
+        case CullTest::AABB:          return &cullRange<false, true>;
+        case CullTest::SphereAndAABB: return &cullRange<true, true>;
+        default:                      return &cullRange<true, false>;
+        }
+    }
+
+    inline XMFLOAT3 boxMin(const CullingBounds& b, size_t i) {
+        return XMFLOAT3(b.m_boxX[i] - b.m_extentX[i], b.m_boxY[i] - b.m_extentY[i], b.m_boxZ[i] - b.m_extentZ[i]);
+    }
+
+    inline XMFLOAT3 boxMax(const CullingBounds& b, size_t i) {
+        return XMFLOAT3(b.m_boxX[i] + b.m_extentX[i], b.m_boxY[i] + b.m_extentY[i], b.m_boxZ[i] + b.m_extentZ[i]);
+    }
+}
+
+// ---- CullingBounds ----
+
+void
+CullingBounds::resizePadded(size_t count) {
+    const size_t padded = (count + 3) & ~size_t(3);
+    for (std::vector<float>* a : { &m_centerX, &m_centerY, &m_centerZ, &m_radius,
+        &m_boxX, &m_boxY, &m_boxZ, &m_extentX, &m_extentY, &m_extentZ }) {
+        a->resize(padded, 0.0f);
+    }
+    m_count = count;
+}
+
+unsigned int
+CullingBounds::add(const BoundingSphere& sphere, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    resizePadded(m_count + 1);
+    set(unsigned(m_count - 1), sphere, aabbMin, aabbMax);
+    return unsigned(m_count - 1);
+}
+
+unsigned int
+CullingBounds::add(const BoundingSphere& sphere) {
+    resizePadded(m_count + 1);
+    set(unsigned(m_count - 1), sphere);
+    return unsigned(m_count - 1);
+}
+
+void
+CullingBounds::set(unsigned int object, const BoundingSphere& sphere, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    if (object >= m_count) {
+        ERROR(L"CullingBounds", L"set", L"Índice de objeto fuera de rango");
+        return;
+    }
+    m_centerX[object] = sphere.center.x;
+    m_centerY[object] = sphere.center.y;
+    m_centerZ[object] = sphere.center.z;
+    m_radius[object] = sphere.radius;
+    m_boxX[object] = 0.5f * (aabbMin.x + aabbMax.x);
+    m_boxY[object] = 0.5f * (aabbMin.y + aabbMax.y);
+    m_boxZ[object] = 0.5f * (aabbMin.z + aabbMax.z);
+    m_extentX[object] = 0.5f * (aabbMax.x - aabbMin.x);
+    m_extentY[object] = 0.5f * (aabbMax.y - aabbMin.y);
+    m_extentZ[object] = 0.5f * (aabbMax.z - aabbMin.z);
+}
+
+void
+CullingBounds::set(unsigned int object, const BoundingSphere& sphere) {
+    const XMFLOAT3& c = sphere.center;
+    const float r = sphere.radius;
+    set(object, sphere, XMFLOAT3(c.x - r, c.y - r, c.z - r), XMFLOAT3(c.x + r, c.y + r, c.z + r));
+}
+
+void
+CullingBounds::reserve(size_t count) {
+    const size_t padded = (count + 3) & ~size_t(3);
+    for (std::vector<float>* a : { &m_centerX, &m_centerY, &m_centerZ, &m_radius,
+        &m_boxX, &m_boxY, &m_boxZ, &m_extentX, &m_extentY, &m_extentZ }) {
+        a->reserve(padded);
+    }
+}
+
+void
+CullingBounds::clear() {
+    resizePadded(0);
+}
+
+BoundingSphere
+CullingBounds::getSphere(unsigned int object) const {
+    BoundingSphere sphere;
+    sphere.center = XMFLOAT3(m_centerX[object], m_centerY[object], m_centerZ[object]);
+    sphere.radius = m_radius[object];
+    return sphere;
+}
+
+// ---- FrustumCuller ----
+
+size_t
+FrustumCuller::Cull(const Frustum& frustum, const CullingBounds& bounds, CullTest test,
+    std::vector<unsigned int>& outVisible, unsigned int threadCount) {
+    // La salida necesita el tamaño con relleno: cada grupo escribe sus 4 carriles
+    outVisible.resize(bounds.paddedSize());
+    if (bounds.size() == 0) return 0;
+
+    PlaneSSE planes[Frustum::kPlaneCount];
+    for (int p = 0; p < Frustum::kPlaneCount; ++p) {
+        const XMFLOAT4& src = frustum.m_planes[p];
+        planes[p].x = _mm_set1_ps(src.x);
+        planes[p].y = _mm_set1_ps(src.y);
+        planes[p].z = _mm_set1_ps(src.z);
+        planes[p].w = _mm_set1_ps(src.w);
+        planes[p].ax = _mm_set1_ps(std::fabs(src.x));
+        planes[p].ay = _mm_set1_ps(std::fabs(src.y));
+        planes[p].az = _mm_set1_ps(std::fabs(src.z));
+    }
+    const CullKernel kernel = selectKernel(test);
+
+    const size_t groups = bounds.paddedSize() / 4;
+    const unsigned int threads = resolveThreads(threadCount, bounds.size());
+    if (threads <= 1) {
+        const size_t visible = kernel(planes, bounds, 0, bounds.paddedSize(), outVisible.data());
+        outVisible.resize(visible);
+        return visible;
+    }
+
+    // Un rango de grupos por tarea, compactado sobre su propio tramo de la salida
+    std::vector<size_t> rangeVisible(threads, 0);
+    JobSystem::Default().parallelFor(0, threads, [&](size_t first, size_t last) {
+        for (size_t t = first; t < last; ++t) {
+            const size_t begin = groups * t / threads * 4;
+            const size_t end = groups * (t + 1) / threads * 4;
+            rangeVisible[t] = kernel(planes, bounds, begin, end, outVisible.data() + begin);
+        }
+    }, 1);
+
+    // Junta los tramos (el destino nunca adelanta al origen)
+    size_t visible = rangeVisible[0];
+    for (unsigned int t = 1; t < threads; ++t) {
+        const unsigned int* src = outVisible.data() + groups * t / threads * 4;
+        std::copy(src, src + rangeVisible[t], outVisible.data() + visible);
+        visible += rangeVisible[t];
+    }
+    outVisible.resize(visible);
+    return visible;
+}
+
+size_t
+FrustumCuller::CullScalar(const Frustum& frustum, const CullingBounds& bounds, CullTest test,
+    std::vector<unsigned int>& outVisible) {
+    outVisible.clear();
+    for (size_t i = 0; i < bounds.size(); ++i) {
+        if (test != CullTest::AABB) {
+            const XMFLOAT3 center(bounds.m_centerX[i], bounds.m_centerY[i], bounds.m_centerZ[i]);
+            if (!frustum.intersectsSphere(center, bounds.m_radius[i])) continue;
+        }
+        if (test != CullTest::Sphere && !frustum.intersectsAABB(boxMin(bounds, i), boxMax(bounds, i))) continue;
+        outVisible.push_back(unsigned(i));
+    }
+    return outVisible.size();
+}
@@ -0,0 +1,120 @@
+#include "../include/HandleTable.h"
+#include <algorithm>
+
+HandleTable::HandleTable(uint32_t maxHandles) {
+    m_chunkCount = std::max(1u, (maxHandles + kChunkSize - 1) / kChunkSize);
+    m_capacity = m_chunkCount * kChunkSize;
+    m_chunks.reset(new std::atomic<Entry*>[m_chunkCount]);
+    for (uint32_t i = 0; i < m_chunkCount; ++i) m_chunks[i].store(nullptr, std::memory_order_relaxed);
+}
+
+HandleTable::~HandleTable() {
+    for (uint32_t i = 0; i < m_chunkCount; ++i) delete[] m_chunks[i].load(std::memory_order_relaxed);
+}
+
+Handle
+HandleTable::allocate(void* value) {
+    uint32_t index = 0;
+    Entry* e = nullptr;
+
+    // Primero un índice liberado; la etiqueta cambia en cada pop/push para que un CAS con una
+    // cabeza vieja (mismo índice, otra historia) falle
+    uint64_t head = m_freeHead.load(std::memory_order_acquire);
+    for (;;) {
+        const uint32_t top = uint32_t(head);
+        if (top == 0) break;
+        e = entry(top - 1);
+        const uint64_t next = ((head >> 32) + 1) << 32 | e->nextFree.load(std::memory_order_relaxed);
+        if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire)) {
+            index = top - 1;
+            break;
+        }
+        e = nullptr;
+    }
+
+    if (!e) {
+        index = m_next.fetch_add(1, std::memory_order_relaxed);
+        if (index >= m_capacity) {
+            ERROR(L"HandleTable", L"allocate", L"Tabla de handles llena");
+            return Handle();
+        }
+        e = entryOrCreate(index);
+    }
+
+    e->value.store(value, std::memory_order_relaxed);
+    // Par -> impar: la entrada queda asignada con una generación que nadie tuvo antes
+    const uint32_t generation = e->generation.fetch_add(1, std::memory_order_release) + 1;
+    m_live.fetch_add(1, std::memory_order_relaxed);
+    return Handle{ index, generation };
+}
+
+bool
+HandleTable::release(Handle handle) {
+    Entry* e = handle.valid() ? entry(handle.index) : nullptr;
+    if (!e) return false;
+
+    // Impar -> par sólo si el handle es el vigente: dos release del mismo handle no pasan
+    uint32_t expected = handle.generation;
+    if (!e->generation.compare_exchange_strong(expected, expected + 1, std::memory_order_acq_rel)) {
+        return false;
+    }
+    e->value.store(nullptr, std::memory_order_relaxed);
+    m_live.fetch_sub(1, std::memory_order_relaxed);
+
+    uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+    for (;;) {
+        e->nextFree.store(uint32_t(head), std::memory_order_relaxed);
+        const uint64_t next = ((head >> 32) + 1) << 32 | (handle.index + 1);
+        if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_release, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+bool
+HandleTable::isValid(Handle handle) const {
+    const Entry* e = handle.valid() ? entry(handle.index) : nullptr;
+    return e && e->generation.load(std::memory_order_acquire) == handle.generation;
+}
+
+void*
+HandleTable::get(Handle handle) const {
+    const Entry* e = handle.valid() ? entry(handle.index) : nullptr;
+    if (!e || e->generation.load(std::memory_order_acquire) != handle.generation) return nullptr;
+    void* value = e->value.load(std::memory_order_acquire);
+    // Se vuelve a mirar la generación: si cambió, el valor puede ser de otra asignación
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return e->generation.load(std::memory_order_relaxed) == handle.generation ? value : nullptr;
+}
+
+bool
+HandleTable::set(Handle handle, void* value) {
+    Entry* e = handle.valid() ? entry(handle.index) : nullptr;
+    if (!e || e->generation.load(std::memory_order_acquire) != handle.generation) return false;
+    e->value.store(value, std::memory_order_release);
+    return true;
+}
+
+HandleTable::Entry*
+HandleTable::entry(uint32_t index) const {
+    if (index >= m_capacity) return nullptr;
+    Entry* chunk = m_chunks[index / kChunkSize].load(std::memory_order_acquire);
+    return chunk ? chunk + index % kChunkSize : nullptr;
+}
+
+HandleTable::Entry*
+HandleTable::entryOrCreate(uint32_t index) {
+    std::atomic<Entry*>& slot = m_chunks[index / kChunkSize];
+    Entry* chunk = slot.load(std::memory_order_acquire);
+    if (!chunk) {
+        // Dos hilos pueden llegar al mismo bloque nuevo: gana un CAS y el otro descarta el suyo
+        Entry* created = new Entry[kChunkSize];
+        if (slot.compare_exchange_strong(chunk, created, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            chunk = created;
+        }
+        else {
+            delete[] created;
+        }
+    }
+    return chunk + index % kChunkSize;
+}
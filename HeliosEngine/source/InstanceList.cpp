@@ -0,0 +1,100 @@
+#include "../include/InstanceList.h"
+#include <algorithm>
+#include <cmath>
+
+void
+InstanceList::setBounds(const BoundingSphere& sphere) {
+    m_localSphere = sphere;
+    for (unsigned int i = 0; i < m_worlds.size(); ++i) updateSphere(i);
+}
+
+void
+InstanceList::setVertexTransform(const XMMATRIX& transform) {
+    XMStoreFloat4x4(&m_vertexTransform, transform);
+}
+
+unsigned int
+InstanceList::add(const XMMATRIX& world, const XMFLOAT4& color) {
+    XMFLOAT4X4 stored;
+    XMStoreFloat4x4(&stored, world);
+    m_worlds.push_back(stored);
+    m_colors.push_back(color);
+    m_bounds.add(BoundingSphere());
+    updateSphere(unsigned(m_worlds.size() - 1));
+    return unsigned(m_worlds.size() - 1);
+}
+
+void
+InstanceList::setWorld(unsigned int instance, const XMMATRIX& world) {
+    if (instance >= m_worlds.size()) {
+        ERROR(L"InstanceList", L"setWorld", L"Índice de instancia fuera de rango");
+        return;
+    }
+    XMStoreFloat4x4(&m_worlds[instance], world);
+    updateSphere(instance);
+}
+
+void
+InstanceList::clear() {
+    m_worlds.clear();
+    m_colors.clear();
+    m_bounds.clear();
+}
+
+void
+InstanceList::updateSphere(unsigned int instance) {
+    // Centro transformado y radio por la mayor escala de los ejes (conservador con escala no uniforme)
+    const XMFLOAT4X4& w = m_worlds[instance];
+    const XMFLOAT3& c = m_localSphere.center;
+    BoundingSphere sphere;
+    sphere.center = XMFLOAT3(
+        c.x * w.m[0][0] + c.y * w.m[1][0] + c.z * w.m[2][0] + w.m[3][0],
+        c.x * w.m[0][1] + c.y * w.m[1][1] + c.z * w.m[2][1] + w.m[3][1],
+        c.x * w.m[0][2] + c.y * w.m[1][2] + c.z * w.m[2][2] + w.m[3][2]);
+    float scale2 = 0.0f;
+    for (int r = 0; r < 3; ++r) {
+        scale2 = std::max(scale2, w.m[r][0] * w.m[r][0] + w.m[r][1] * w.m[r][1] + w.m[r][2] * w.m[r][2]);
+    }
+    sphere.radius = m_localSphere.radius * std::sqrt(scale2);
+    m_bounds.set(instance, sphere);
+}
+
+size_t
+InstanceList::writeVisible(const Frustum& frustum, InstanceData* dst, size_t capacity) const {
+    if (!dst) return 0;
+    FrustumCuller::Cull(frustum, m_bounds, CullTest::Sphere, m_visible);
+
+    const XMMATRIX vertexTransform = XMLoadFloat4x4(&m_vertexTransform);
+    size_t written = 0;
+    for (size_t v = 0; v < m_visible.size() && written < capacity; ++v) {
+        const unsigned int i = m_visible[v];
+
+        // Filas de la transpuesta = columnas de la World completa
+        XMFLOAT4X4 full;
+        XMStoreFloat4x4(&full, XMMatrixMultiply(vertexTransform, XMLoadFloat4x4(&m_worlds[i])));
+        InstanceData& out = dst[written++];
+        for (int c = 0; c < 3; ++c) {
+            out.world[c] = XMFLOAT4(full.m[0][c], full.m[1][c], full.m[2][c], full.m[3][c]);
+        }
+        out.color = m_colors[i];
+    }
+    return written;
+}
+
+std::vector<D3D11_INPUT_ELEMENT_DESC>
+InstanceList::AppendInputLayout(std::vector<D3D11_INPUT_ELEMENT_DESC> vertexLayout, unsigned int slot) {
+    for (unsigned int row = 0; row < 3; ++row) {
+        D3D11_INPUT_ELEMENT_DESC w{};
+        w.SemanticName = "INSTANCE_WORLD"; w.SemanticIndex = row; w.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+        w.InputSlot = slot; w.AlignedByteOffset = row * sizeof(XMFLOAT4);
+        w.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA; w.InstanceDataStepRate = 1;
+        vertexLayout.push_back(w);
+    }
+
+    D3D11_INPUT_ELEMENT_DESC c{};
+    c.SemanticName = "INSTANCE_COLOR"; c.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+    c.InputSlot = slot; c.AlignedByteOffset = 3 * sizeof(XMFLOAT4);
+    c.InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA; c.InstanceDataStepRate = 1;
+    vertexLayout.push_back(c);
+    return vertexLayout;
+}
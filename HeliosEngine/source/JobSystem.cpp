@@ -0,0 +1,345 @@
+#include "../include/JobSystem.h"
+#include <algorithm>
+
+struct Job {
+    std::function<void()> task;
+    JobCounter*           counter = nullptr;
+};
+
+namespace
+{
+    const unsigned int kNoWorker = ~0u;
+
+    // Vueltas sin encontrar trabajo antes de dormir un trabajador
+    const int kIdleSpins = 64;
+
+    // Trabajador del hilo actual (sólo vale si t_system es el sistema que pregunta)
+    thread_local JobSystem*   t_system = nullptr;
+    thread_local unsigned int t_index = kNoWorker;
+    thread_local uint32_t     t_random = 0;
+
+    // xorshift32 para elegir víctima; la semilla sale de la dirección de la variable del hilo
+    uint32_t nextRandom() {
+        if (t_random == 0) t_random = uint32_t(reinterpret_cast<uintptr_t>(&t_random) >> 4) | 1u;
+        t_random ^= t_random << 13;
+        t_random ^= t_random >> 17;
+        t_random ^= t_random << 5;
+        return t_random;
+    }
+}
+
+JobDeque::JobDeque(size_t capacity) {
+    size_t pow2 = 16;
+    while (pow2 < capacity) pow2 <<= 1;
+    m_rings.emplace_back(new Ring(pow2));
+    m_ring.store(m_rings.back().get(), std::memory_order_relaxed);
+}
+
+void
+JobDeque::push(Job* job) {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_acquire);
+    Ring* ring = m_ring.load(std::memory_order_relaxed);
+    if (b - t > int64_t(ring->mask)) {
+        // Llena: se copia a un buffer del doble; el viejo queda vivo para los ladrones en curso
+        Ring* grown = new Ring((ring->mask + 1) * 2);
+        for (int64_t i = t; i < b; ++i) grown->put(i, ring->get(i));
+        m_rings.emplace_back(grown);
+        m_ring.store(grown, std::memory_order_release);
+        ring = grown;
+    }
+    ring->put(b, job);
+    m_bottom.store(b + 1, std::memory_order_release);
+}
+
+Job*
+JobDeque::pop() {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+    Ring* ring = m_ring.load(std::memory_order_relaxed);
+    m_bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = m_top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    Job* job = ring->get(b);
+    if (t == b) {
+        // Última tarea: se compite con los ladrones por ella
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job*
+JobDeque::steal() {
+    int64_t t = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = m_bottom.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+
+    Ring* ring = m_ring.load(std::memory_order_acquire);
+    Job* job = ring->get(t);
+    if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+size_t
+JobDeque::size() const {
+    const int64_t b = m_bottom.load(std::memory_order_relaxed);
+    const int64_t t = m_top.load(std::memory_order_relaxed);
+    return b > t ? size_t(b - t) : 0;
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+void
+JobSystem::init(unsigned int threadCount) {
+    shutdown();
+    const unsigned int n = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+    m_stop.store(false);
+    for (unsigned int i = 0; i < n; ++i) m_queues.emplace_back(new JobDeque());
+    m_previousSystem = t_system;
+    m_previousIndex = t_index;
+    t_system = this;
+    t_index = 0;
+    for (unsigned int i = 1; i < n; ++i) m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+}
+
+void
+JobSystem::shutdown() {
+    if (m_queues.empty()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stop.store(true);
+        ++m_wakeEpoch;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) t.join();
+    m_threads.clear();
+
+    // Sin trabajadores: lo que quedó en las colas corre en este hilo (puede lanzar más)
+    for (bool found = true; found; ) {
+        found = false;
+        for (auto& queue : m_queues) {
+            while (Job* job = queue->steal()) {
+                execute(job);
+                found = true;
+            }
+        }
+        std::deque<Job*> shared;
+        {
+            std::lock_guard<std::mutex> lock(m_sharedMutex);
+            shared.swap(m_shared);
+        }
+        for (Job* job : shared) {
+            execute(job);
+            found = true;
+        }
+    }
+
+    m_queues.clear();
+    if (t_system == this) {
+        t_system = m_previousSystem;
+        t_index = m_previousIndex;
+    }
+    m_previousSystem = nullptr;
+    m_previousIndex = kNoWorker;
+}
+
+void
+JobSystem::run(std::function<void()> task, JobCounter* counter) {
+    if (counter) counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    Job* job = new Job();
+    job->task = std::move(task);
+    job->counter = counter;
+    push(job);
+}
+
+void
+JobSystem::runAfter(JobCounter& dependency, std::function<void()> task, JobCounter* counter) {
+    if (counter) counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    Job* job = new Job();
+    job->task = std::move(task);
+    job->counter = counter;
+    {
+        std::lock_guard<std::mutex> lock(dependency.m_mutex);
+        if (dependency.m_pending.load(std::memory_order_acquire) != 0) {
+            dependency.m_continuations.push_back(job);
+            return;
+        }
+    }
+    push(job);
+}
+
+void
+JobSystem::wait(JobCounter& counter) {
+    const unsigned int self = t_system == this ? t_index : kNoWorker;
+    int spins = 0;
+    while (!counter.done()) {
+        Job* job = m_queues.empty() ? nullptr : findJob(self);
+        if (job) {
+            execute(job);
+            spins = 0;
+        }
+        else if (++spins > kIdleSpins) {
+            // Lo que falta lo están ejecutando otros hilos
+            std::this_thread::yield();
+        }
+    }
+    // El que llevó el contador a cero puede seguir dentro de su lock: se espera a que lo suelte
+    // para que el llamador pueda destruir el contador al volver
+    std::lock_guard<std::mutex> lock(counter.m_mutex);
+}
+
+void
+JobSystem::parallelFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body,
+    size_t grain) {
+    if (begin >= end) return;
+    if (m_queues.size() <= 1) {
+        body(begin, end);
+        return;
+    }
+    if (grain == 0) grain = std::max<size_t>(1, (end - begin) / (m_queues.size() * 8));
+
+    JobCounter counter;
+    split(begin, end, grain, body, counter);
+    wait(counter);
+}
+
+JobSystem&
+JobSystem::Default() {
+    static JobSystem system;
+    static std::once_flag once;
+    std::call_once(once, []() { system.init(); });
+    return system;
+}
+
+void
+JobSystem::workerLoop(unsigned int index) {
+    t_system = this;
+    t_index = index;
+    int spins = 0;
+    while (!m_stop.load(std::memory_order_acquire)) {
+        if (Job* job = findJob(index)) {
+            execute(job);
+            spins = 0;
+            continue;
+        }
+        if (++spins < kIdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+        spins = 0;
+
+        // Se anuncia el sueño antes de volver a mirar las colas: quien apile después verá
+        // m_sleeping > 0 y despertará (el wait_for cubre cualquier carrera que quede)
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        const uint64_t epoch = m_wakeEpoch;
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        if (!hasWork() && !m_stop.load(std::memory_order_acquire)) {
+            m_wake.wait_for(lock, std::chrono::milliseconds(10), [this, epoch]() {
+                return m_wakeEpoch != epoch || m_stop.load(std::memory_order_acquire);
+            });
+        }
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+    t_system = nullptr;
+    t_index = kNoWorker;
+}
+
+Job*
+JobSystem::findJob(unsigned int self) {
+    if (self != kNoWorker) {
+        if (Job* job = m_queues[self]->pop()) return job;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        if (!m_shared.empty()) {
+            Job* job = m_shared.front();
+            m_shared.pop_front();
+            return job;
+        }
+    }
+    // Se empieza a robar por una víctima al azar para no cargar siempre a la misma
+    const unsigned int count = unsigned(m_queues.size());
+    const unsigned int start = nextRandom() % count;
+    for (unsigned int i = 0; i < count; ++i) {
+        const unsigned int victim = (start + i) % count;
+        if (victim == self) continue;
+        if (Job* job = m_queues[victim]->steal()) return job;
+    }
+    return nullptr;
+}
+
+bool
+JobSystem::hasWork() {
+    for (const auto& queue : m_queues) {
+        if (queue->size() > 0) return true;
+    }
+    std::lock_guard<std::mutex> lock(m_sharedMutex);
+    return !m_shared.empty();
+}
+
+void
+JobSystem::execute(Job* job) {
+    if (job->task) job->task();
+    JobCounter* counter = job->counter;
+    delete job;
+    if (!counter) return;
+
+    std::vector<Job*> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter->m_mutex);
+        if (counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            continuations.swap(counter->m_continuations);
+        }
+    }
+    for (Job* next : continuations) push(next);
+}
+
+void
+JobSystem::push(Job* job) {
+    if (m_queues.empty()) {
+        execute(job);
+        return;
+    }
+    if (t_system == this && t_index != kNoWorker) {
+        m_queues[t_index]->push(job);
+    }
+    else {
+        std::lock_guard<std::mutex> lock(m_sharedMutex);
+        m_shared.push_back(job);
+    }
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed) > 0) {
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            ++m_wakeEpoch;
+        }
+        m_wake.notify_one();
+    }
+}
+
+void
+JobSystem::split(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body,
+    JobCounter& counter) {
+    // La mitad derecha queda en la cola (la roban otros) y la izquierda sigue aquí
+    while (end - begin > grain) {
+        const size_t mid = begin + (end - begin) / 2;
+        run([this, mid, end, grain, &body, &counter]() { split(mid, end, grain, body, counter); }, &counter);
+        end = mid;
+    }
+    body(begin, end);
+}
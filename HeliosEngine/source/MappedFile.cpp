@@ -0,0 +1,86 @@
+#include "../include/MappedFile.h"
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : m_file(other.m_file)
+    , m_mapping(other.m_mapping)
+    , m_data(other.m_data)
+    , m_size(other.m_size) {
+    other.m_file = INVALID_HANDLE_VALUE;
+    other.m_mapping = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+}
+
+MappedFile&
+MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        m_file = other.m_file;
+        m_mapping = other.m_mapping;
+        m_data = other.m_data;
+        m_size = other.m_size;
+        other.m_file = INVALID_HANDLE_VALUE;
+        other.m_mapping = nullptr;
+        other.m_data = nullptr;
+        other.m_size = 0;
+    }
+    return *this;
+}
+
+bool
+MappedFile::open(const std::string& path) {
+    close();
+
+    // Lectura secuencial: le indica al sistema que haga read-ahead agresivo
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        ERROR(L"MappedFile", L"open", L"No se pudo abrir el archivo");
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(m_file, &fileSize)) {
+        ERROR(L"MappedFile", L"open", L"No se pudo consultar el tamaño del archivo");
+        close();
+        return false;
+    }
+
+    // Un archivo vacío no se puede mapear, pero es un archivo válido
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    if (m_size == 0) {
+        return true;
+    }
+
+    m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        ERROR(L"MappedFile", L"open", L"CreateFileMapping falló");
+        close();
+        return false;
+    }
+
+    m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_data) {
+        ERROR(L"MappedFile", L"open", L"MapViewOfFile falló");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void
+MappedFile::close() {
+    if (m_data) {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_file != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
@@ -0,0 +1,575 @@
+#include "../include/MeshBVH.h"
+#include "../include/JobSystem.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <emmintrin.h>
+
+namespace
+{
+    // Caja envolvente de construcción; la cuarta componente sólo alinea a 16 bytes.
+    // Sin constructor: los bins se reinician sólo si se usan
+    struct Box {
+        float mn[4];
+        float mx[4];
+
+        void reset() {
+            _mm_storeu_ps(mn, _mm_set1_ps(FLT_MAX));
+            _mm_storeu_ps(mx, _mm_set1_ps(-FLT_MAX));
+        }
+
+        void grow(__m128 bmin, __m128 bmax) {
+            _mm_storeu_ps(mn, _mm_min_ps(_mm_loadu_ps(mn), bmin));
+            _mm_storeu_ps(mx, _mm_max_ps(_mm_loadu_ps(mx), bmax));
+        }
+
+        void grow(const Box& b) { grow(_mm_loadu_ps(b.mn), _mm_loadu_ps(b.mx)); }
+
+        bool empty() const { return mn[0] > mx[0]; }
+
+        float area() const {
+            if (empty()) return 0.0f;
+            const float dx = mx[0] - mn[0], dy = mx[1] - mn[1], dz = mx[2] - mn[2];
+            return 2.0f * (dx * dy + dy * dz + dz * dx);
+        }
+    };
+
+    // Caja de un triángulo y su índice; se particiona en el lugar para que cada subárbol
+    // recorra memoria contigua
+    struct PrimRef {
+        float        mn[3];
+        unsigned int id;
+        float        mx[3];
+        unsigned int pad;
+
+        float centroid(int axis) const { return (mn[axis] + mx[axis]) * 0.5f; }
+    };
+
+    // La cuarta componente de una carga de PrimRef es id/pad: se anula para no operar con
+    // sus bits como float (suelen ser denormales, muy lentos en SSE)
+    inline __m128 loadMin(const PrimRef& r) {
+        return _mm_and_ps(_mm_loadu_ps(r.mn), _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+    }
+
+    inline __m128 loadMax(const PrimRef& r) {
+        return _mm_and_ps(_mm_loadu_ps(r.mx), _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0)));
+    }
+
+    // Nodo del árbol binario intermedio; count > 0 indica hoja con refs[first, first + count)
+    struct BuildNode {
+        Box          box;
+        unsigned int left = 0;
+        unsigned int first = 0;
+        unsigned int count = 0;
+    };
+
+    // Profundidad a partir de la cual se divide por la mediana para acotar la pila de recorrido
+    const unsigned int kMedianSplitDepth = 48;
+
+    // Subárboles con menos triángulos se construyen en el hilo actual
+    const unsigned int kParallelMinTriangles = 16384;
+
+    // Entradas de la pila de recorrido: 3 por nivel más la raíz. El árbol binario tiene a lo
+    // más kMedianSplitDepth + 32 niveles y colapsar nunca lo hace más profundo; build lo comprueba
+    const int kStackSize = 3 * (kMedianSplitDepth + 32) + 4;
+
+    class Builder {
+    public:
+        Builder(std::vector<PrimRef>& refs, unsigned int parallelDepth)
+            : m_refs(refs), m_parallelDepth(parallelDepth) {
+            // Un árbol binario con hojas de al menos 1 triángulo tiene a lo más 2N - 1 nodos
+            m_nodes.resize(std::max<size_t>(1, refs.size() * 2 - 1));
+            m_nodeCount = 1;
+        }
+
+        void build(unsigned int nodeIndex, unsigned int first, unsigned int count, unsigned int depth) {
+            BuildNode& node = m_nodes[nodeIndex];
+            __m128 bmin = _mm_set1_ps(FLT_MAX), bmax = _mm_set1_ps(-FLT_MAX);
+            __m128 cmin = bmin, cmax = bmax;
+            const __m128 half = _mm_set1_ps(0.5f);
+            for (unsigned int i = first; i < first + count; ++i) {
+                const __m128 rmin = loadMin(m_refs[i]);
+                const __m128 rmax = loadMax(m_refs[i]);
+                const __m128 c = _mm_mul_ps(_mm_add_ps(rmin, rmax), half);
+                bmin = _mm_min_ps(bmin, rmin);
+                bmax = _mm_max_ps(bmax, rmax);
+                cmin = _mm_min_ps(cmin, c);
+                cmax = _mm_max_ps(cmax, c);
+            }
+            _mm_storeu_ps(node.box.mn, bmin);
+            _mm_storeu_ps(node.box.mx, bmax);
+            Box centroidBox;
+            _mm_storeu_ps(centroidBox.mn, cmin);
+            _mm_storeu_ps(centroidBox.mx, cmax);
+            node.first = first;
+            node.count = count;
+            if (count == 1) return;
+
+            unsigned int mid = first;
+            if (depth < kMedianSplitDepth) {
+                mid = splitSAH(node, centroidBox, first, count);
+            }
+            else {
+                mid = splitMedian(centroidBox, first, count);
+            }
+            if (mid == first) return;  // Hoja
+
+            const unsigned int left = m_nodeCount.fetch_add(2);
+            node.left = left;
+            node.count = 0;
+
+            const unsigned int leftCount = mid - first;
+            const unsigned int rightCount = count - leftCount;
+            if (depth < m_parallelDepth && count >= kParallelMinTriangles) {
+                // La izquierda queda en la cola del JobSystem (la roba otro hilo); wait ayuda
+                // con otras tareas mientras tanto, así que anidar no bloquea trabajadores
+                JobSystem& jobs = JobSystem::Default();
+                JobCounter counter;
+                jobs.run([this, left, first, leftCount, depth]() {
+                    build(left, first, leftCount, depth + 1);
+                }, &counter);
+                build(left + 1, mid, rightCount, depth + 1);
+                jobs.wait(counter);
+            }
+            else {
+                build(left, first, leftCount, depth + 1);
+                build(left + 1, mid, rightCount, depth + 1);
+            }
+        }
+
+        const std::vector<BuildNode>& nodes() const { return m_nodes; }
+
+    private:
+        // SAH con bins sobre los centroides; devuelve first si conviene dejar una hoja
+        unsigned int splitSAH(const BuildNode& node, const Box& centroidBox, unsigned int first,
+            unsigned int count) {
+            // Nodos pequeños usan menos bins: el barrido domina su costo. La copia local evita
+            // que std::min (por referencia) exija una definición fuera de clase de kBinCount.
+            const unsigned int maxBins = MeshBVH::kBinCount;
+            const unsigned int kBins = std::min(maxBins, count);
+            Box          binBox[3][MeshBVH::kBinCount];
+            unsigned int binCount[3][MeshBVH::kBinCount];
+            float        scale[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            for (int a = 0; a < 3; ++a) {
+                const float extent = centroidBox.mx[a] - centroidBox.mn[a];
+                scale[a] = extent > 0.0f ? float(kBins) * 0.99999f / extent : 0.0f;
+                for (unsigned int b = 0; b < kBins; ++b) {
+                    binBox[a][b].reset();
+                    binCount[a][b] = 0;
+                }
+            }
+
+            // Bin de los tres ejes a la vez; un eje sin extensión cae siempre en el bin 0
+            const __m128 origin = _mm_loadu_ps(centroidBox.mn);
+            const __m128 scales = _mm_loadu_ps(scale);
+            const __m128 half = _mm_set1_ps(0.5f);
+            alignas(16) int bin[4];
+            for (unsigned int i = first; i < first + count; ++i) {
+                const __m128 bmin = loadMin(m_refs[i]);
+                const __m128 bmax = loadMax(m_refs[i]);
+                const __m128 c = _mm_mul_ps(_mm_add_ps(bmin, bmax), half);
+                _mm_store_si128(reinterpret_cast<__m128i*>(bin),
+                    _mm_cvttps_epi32(_mm_mul_ps(_mm_sub_ps(c, origin), scales)));
+                for (int a = 0; a < 3; ++a) {
+                    const unsigned int b = std::min(kBins - 1, unsigned(bin[a]));
+                    binBox[a][b].grow(bmin, bmax);
+                    ++binCount[a][b];
+                }
+            }
+
+            // Barrido: costo de cortar después del bin b = A_izq * N_izq + A_der * N_der
+            float bestCost = FLT_MAX;
+            int bestAxis = -1;
+            unsigned int bestBin = 0;
+            for (int a = 0; a < 3; ++a) {
+                if (scale[a] == 0.0f) continue;
+                float rightArea[MeshBVH::kBinCount];
+                unsigned int rightCount[MeshBVH::kBinCount];
+                Box acc;
+                acc.reset();
+                unsigned int n = 0;
+                for (unsigned int b = kBins - 1; b > 0; --b) {
+                    acc.grow(binBox[a][b]);
+                    n += binCount[a][b];
+                    rightArea[b] = acc.area();
+                    rightCount[b] = n;
+                }
+                acc.reset();
+                n = 0;
+                for (unsigned int b = 0; b + 1 < kBins; ++b) {
+                    acc.grow(binBox[a][b]);
+                    n += binCount[a][b];
+                    if (n == 0 || rightCount[b + 1] == 0) continue;
+                    const float cost = acc.area() * float(n) + rightArea[b + 1] * float(rightCount[b + 1]);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestAxis = a;
+                        bestBin = b;
+                    }
+                }
+            }
+
+            // Todos los centroides coinciden: sólo se parte si la hoja quedaría demasiado grande
+            if (bestAxis < 0) {
+                return count > MeshBVH::kMaxLeafTriangles ? first + count / 2 : first;
+            }
+
+            // Costo de recorrer un nodo = 1, de probar un triángulo = 1
+            const float nodeArea = node.box.area();
+            const float splitCost = 1.0f + (nodeArea > 0.0f ? bestCost / nodeArea : float(count));
+            if (count <= MeshBVH::kMaxLeafTriangles && float(count) <= splitCost) {
+                return first;
+            }
+
+            const float mn = centroidBox.mn[bestAxis];
+            const float s = scale[bestAxis];
+            PrimRef* mid = std::partition(m_refs.data() + first, m_refs.data() + first + count,
+                [&](const PrimRef& r) {
+                    return std::min(kBins - 1, unsigned(int((r.centroid(bestAxis) - mn) * s))) <= bestBin;
+                });
+            const unsigned int split = unsigned(mid - m_refs.data());
+            return (split == first || split == first + count) ? first + count / 2 : split;
+        }
+
+        // Mediana de objetos sobre el eje más largo de los centroides
+        unsigned int splitMedian(const Box& centroidBox, unsigned int first, unsigned int count) {
+            if (count <= MeshBVH::kMaxLeafTriangles) return first;
+            int axis = 0;
+            for (int a = 1; a < 3; ++a) {
+                if (centroidBox.mx[a] - centroidBox.mn[a] > centroidBox.mx[axis] - centroidBox.mn[axis]) axis = a;
+            }
+            std::nth_element(m_refs.data() + first, m_refs.data() + first + count / 2,
+                m_refs.data() + first + count,
+                [&](const PrimRef& a, const PrimRef& b) {
+                    return a.centroid(axis) < b.centroid(axis);
+                });
+            return first + count / 2;
+        }
+
+        std::vector<PrimRef>&     m_refs;
+        std::vector<BuildNode>    m_nodes;
+        std::atomic<unsigned int> m_nodeCount;
+        unsigned int              m_parallelDepth;
+    };
+
+    // Colapsa el árbol binario a 4 hijos en preorden
+    class Collapser {
+    public:
+        Collapser(const std::vector<BuildNode>& binary, std::vector<BVHNode4>& out, BVHStats& stats)
+            : m_binary(binary), m_out(out), m_stats(stats) {
+        }
+
+        int collapse(unsigned int binaryIndex, unsigned int depth) {
+            const BuildNode& root = m_binary[binaryIndex];
+            unsigned int slots[4];
+            unsigned int slotCount = 0;
+            if (root.count > 0) {
+                slots[slotCount++] = binaryIndex;  // Raíz hoja: un solo hijo
+            }
+            else {
+                slots[slotCount++] = root.left;
+                slots[slotCount++] = root.left + 1;
+            }
+
+            // Abre el hijo interior de mayor área hasta tener 4
+            while (slotCount < 4) {
+                int widest = -1;
+                float widestArea = -1.0f;
+                for (unsigned int i = 0; i < slotCount; ++i) {
+                    const BuildNode& n = m_binary[slots[i]];
+                    if (n.count == 0 && n.box.area() > widestArea) {
+                        widestArea = n.box.area();
+                        widest = int(i);
+                    }
+                }
+                if (widest < 0) break;
+                const unsigned int left = m_binary[slots[widest]].left;
+                slots[widest] = left;
+                slots[slotCount++] = left + 1;
+            }
+
+            const int index = int(m_out.size());
+            m_out.push_back(BVHNode4());
+            ++m_stats.nodes;
+            m_stats.maxDepth = std::max(m_stats.maxDepth, depth);
+            m_stats.sahCost += root.box.area();
+
+            for (unsigned int i = 0; i < 4; ++i) {
+                float mn[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, mx[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+                int child = -1;
+                unsigned int count = 0;
+                if (i < slotCount) {
+                    const BuildNode& n = m_binary[slots[i]];
+                    std::copy(n.box.mn, n.box.mn + 3, mn);
+                    std::copy(n.box.mx, n.box.mx + 3, mx);
+                    if (n.count > 0) {
+                        child = int(n.first);
+                        count = n.count;
+                        ++m_stats.leaves;
+                        m_stats.sahCost += n.box.area() * float(n.count);
+                    }
+                    else {
+                        child = collapse(slots[i], depth + 1);
+                    }
+                }
+                // m_out pudo crecer en la recursión: se accede por índice
+                BVHNode4& node = m_out[index];
+                node.minX[i] = mn[0]; node.minY[i] = mn[1]; node.minZ[i] = mn[2];
+                node.maxX[i] = mx[0]; node.maxY[i] = mx[1]; node.maxZ[i] = mx[2];
+                node.child[i] = child;
+                node.count[i] = count;
+            }
+            return index;
+        }
+
+    private:
+        const std::vector<BuildNode>& m_binary;
+        std::vector<BVHNode4>&        m_out;
+        BVHStats&                     m_stats;
+    };
+
+    inline XMFLOAT3 sub(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    inline XMFLOAT3 cross(const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+    inline float dot(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+    // Inverso de una componente de dirección; 0 se sustituye por un valor diminuto con signo
+    inline float safeInverse(float d) {
+        return 1.0f / (std::fabs(d) > 1e-20f ? d : (d < 0.0f ? -1e-20f : 1e-20f));
+    }
+}
+
+bool
+MeshBVH::build(const SimpleVertex* vertices, size_t vertexCount,
+    const unsigned int* indices, size_t indexCount,
+    unsigned int threadCount) {
+    clear();
+    const size_t triangleCount = indexCount / 3;
+    if (!vertices || !indices || triangleCount == 0) {
+        ERROR(L"MeshBVH", L"build", L"Malla sin triángulos");
+        return false;
+    }
+    if (triangleCount >= size_t(INT_MAX) / 2) {
+        ERROR(L"MeshBVH", L"build", L"Demasiados triángulos");
+        return false;
+    }
+
+    // Caja de cada triángulo
+    std::vector<PrimRef> refs(triangleCount);
+    for (size_t t = 0; t < triangleCount; ++t) {
+        const unsigned int* tri = indices + t * 3;
+        if (tri[0] >= vertexCount || tri[1] >= vertexCount || tri[2] >= vertexCount) {
+            ERROR(L"MeshBVH", L"build", L"Índice fuera de rango");
+            return false;
+        }
+        const XMFLOAT3& a = vertices[tri[0]].Pos;
+        const XMFLOAT3& b = vertices[tri[1]].Pos;
+        const XMFLOAT3& c = vertices[tri[2]].Pos;
+        PrimRef& r = refs[t];
+        r.mn[0] = std::min(a.x, std::min(b.x, c.x)); r.mx[0] = std::max(a.x, std::max(b.x, c.x));
+        r.mn[1] = std::min(a.y, std::min(b.y, c.y)); r.mx[1] = std::max(a.y, std::max(b.y, c.y));
+        r.mn[2] = std::min(a.z, std::min(b.z, c.z)); r.mx[2] = std::max(a.z, std::max(b.z, c.z));
+        r.id = unsigned(t);
+        r.pad = 0;
+    }
+
+    // Subárboles en paralelo hasta tener ~2 tareas por hilo
+    const unsigned int threads = threadCount ? threadCount : JobSystem::Default().getThreadCount();
+    unsigned int parallelDepth = 0;
+    while ((1u << parallelDepth) < threads * 2 && threads > 1) ++parallelDepth;
+
+    Builder builder(refs, parallelDepth);
+    builder.build(0, 0, unsigned(triangleCount), 0);
+
+    const BuildNode& root = builder.nodes()[0];
+    m_rootMin = XMFLOAT3(root.box.mn[0], root.box.mn[1], root.box.mn[2]);
+    m_rootMax = XMFLOAT3(root.box.mx[0], root.box.mx[1], root.box.mx[2]);
+
+    Collapser collapser(builder.nodes(), m_nodes, m_stats);
+    collapser.collapse(0, 0);
+    // Cada nivel interior deja a lo más 3 hermanos en la pila de traverse
+    if (3 * int(m_stats.maxDepth) + 1 > kStackSize) {
+        ERROR(L"MeshBVH", L"build", L"Árbol más profundo que la pila de recorrido");
+        clear();
+        return false;
+    }
+    const float rootArea = root.box.area();
+    m_stats.sahCost = rootArea > 0.0f ? m_stats.sahCost / rootArea : 0.0;
+    m_stats.triangles = triangleCount;
+
+    // Triángulos en el orden de las hojas, listos para Möller-Trumbore
+    m_triangles.resize(triangleCount * 3);
+    m_triangleIds.resize(triangleCount);
+    for (size_t i = 0; i < triangleCount; ++i) {
+        m_triangleIds[i] = refs[i].id;
+        const unsigned int* tri = indices + size_t(refs[i].id) * 3;
+        const XMFLOAT3& p0 = vertices[tri[0]].Pos;
+        m_triangles[i * 3 + 0] = p0;
+        m_triangles[i * 3 + 1] = sub(vertices[tri[1]].Pos, p0);
+        m_triangles[i * 3 + 2] = sub(vertices[tri[2]].Pos, p0);
+    }
+    return true;
+}
+
+bool
+MeshBVH::build(const MeshComponent& mesh, unsigned int threadCount) {
+    return build(mesh.m_vertex.data(), mesh.m_vertex.size(), mesh.m_index.data(), mesh.m_index.size(),
+        threadCount);
+}
+
+void
+MeshBVH::clear() {
+    m_nodes.clear();
+    m_nodes.shrink_to_fit();
+    m_triangles.clear();
+    m_triangles.shrink_to_fit();
+    m_triangleIds.clear();
+    m_triangleIds.shrink_to_fit();
+    m_rootMin = m_rootMax = XMFLOAT3(0, 0, 0);
+    m_stats = BVHStats();
+}
+
+bool
+MeshBVH::raycast(const XMFLOAT3& origin, const XMFLOAT3& direction, RayHit& hit, float tMax) const {
+    return traverse(origin, direction, tMax, false, hit);
+}
+
+bool
+MeshBVH::segmentHit(const XMFLOAT3& a, const XMFLOAT3& b, RayHit& hit) const {
+    return traverse(a, sub(b, a), 1.0f, false, hit);
+}
+
+bool
+MeshBVH::segmentOccluded(const XMFLOAT3& a, const XMFLOAT3& b) const {
+    RayHit hit;
+    return traverse(a, sub(b, a), 1.0f, true, hit);
+}
+
+void
+MeshBVH::getBounds(XMFLOAT3& outMin, XMFLOAT3& outMax) const {
+    outMin = m_rootMin;
+    outMax = m_rootMax;
+}
+
+size_t
+MeshBVH::getSizeInBytes() const {
+    return m_nodes.capacity() * sizeof(BVHNode4) +
+        m_triangles.capacity() * sizeof(XMFLOAT3) +
+        m_triangleIds.capacity() * sizeof(unsigned int);
+}
+
+bool
+MeshBVH::traverse(const XMFLOAT3& origin, const XMFLOAT3& direction, float tMax, bool anyHit,
+    RayHit& hit) const {
+    if (m_nodes.empty() || !(tMax >= 0.0f)) return false;
+
+    // Slabs: t = caja * inv - origen * inv, con el plano cercano elegido por el signo del rayo
+    const float ix = safeInverse(direction.x), iy = safeInverse(direction.y), iz = safeInverse(direction.z);
+    const __m128 invX = _mm_set1_ps(ix), invY = _mm_set1_ps(iy), invZ = _mm_set1_ps(iz);
+    const __m128 oX = _mm_set1_ps(origin.x * ix), oY = _mm_set1_ps(origin.y * iy), oZ = _mm_set1_ps(origin.z * iz);
+    const size_t nearX = ix >= 0.0f ? offsetof(BVHNode4, minX) : offsetof(BVHNode4, maxX);
+    const size_t nearY = iy >= 0.0f ? offsetof(BVHNode4, minY) : offsetof(BVHNode4, maxY);
+    const size_t nearZ = iz >= 0.0f ? offsetof(BVHNode4, minZ) : offsetof(BVHNode4, maxZ);
+    const size_t farX = ix >= 0.0f ? offsetof(BVHNode4, maxX) : offsetof(BVHNode4, minX);
+    const size_t farY = iy >= 0.0f ? offsetof(BVHNode4, maxY) : offsetof(BVHNode4, minY);
+    const size_t farZ = iz >= 0.0f ? offsetof(BVHNode4, maxZ) : offsetof(BVHNode4, minZ);
+    const __m128 zero = _mm_setzero_ps();
+
+    float best = tMax;
+    unsigned int bestTriangle = ~0u;
+    float bestU = 0.0f, bestV = 0.0f;
+
+    struct Entry { int node; float t; };
+    Entry stack[kStackSize];
+    int sp = 0;
+    stack[sp++] = Entry{ 0, 0.0f };
+
+    while (sp > 0) {
+        const Entry entry = stack[--sp];
+        if (entry.t > best) continue;
+
+        const BVHNode4& node = m_nodes[entry.node];
+        const char* base = reinterpret_cast<const char*>(&node);
+        const __m128 t0x = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float*>(base + nearX)), invX), oX);
+        const __m128 t0y = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float*>(base + nearY)), invY), oY);
+        const __m128 t0z = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float*>(base + nearZ)), invZ), oZ);
+        const __m128 t1x = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float*>(base + farX)), invX), oX);
+        const __m128 t1y = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float*>(base + farY)), invY), oY);
+        const __m128 t1z = _mm_sub_ps(_mm_mul_ps(_mm_loadu_ps(reinterpret_cast<const float*>(base + farZ)), invZ), oZ);
+        const __m128 tEnter = _mm_max_ps(_mm_max_ps(t0x, t0y), _mm_max_ps(t0z, zero));
+        const __m128 tExit = _mm_min_ps(_mm_min_ps(t1x, t1y), _mm_min_ps(t1z, _mm_set1_ps(best)));
+        int mask = _mm_movemask_ps(_mm_cmple_ps(tEnter, tExit));
+        if (!mask) continue;
+
+        alignas(16) float enter[4];
+        _mm_store_ps(enter, tEnter);
+
+        // Hijos impactados ordenados de cerca a lejos
+        int order[4];
+        int hits = 0;
+        for (int i = 0; i < 4; ++i) {
+            if (!(mask & (1 << i)) || (node.child[i] < 0 && node.count[i] == 0)) continue;
+            int j = hits++;
+            while (j > 0 && enter[order[j - 1]] > enter[i]) {
+                order[j] = order[j - 1];
+                --j;
+            }
+            order[j] = i;
+        }
+
+        // Hojas: se prueban ya, para acortar best antes de abrir los nodos lejanos
+        for (int h = 0; h < hits; ++h) {
+            const int i = order[h];
+            if (node.count[i] == 0 || enter[i] > best) continue;
+            const unsigned int first = unsigned(node.child[i]);
+            for (unsigned int t = first; t < first + node.count[i]; ++t) {
+                const XMFLOAT3& v0 = m_triangles[t * 3 + 0];
+                const XMFLOAT3& e1 = m_triangles[t * 3 + 1];
+                const XMFLOAT3& e2 = m_triangles[t * 3 + 2];
+                const XMFLOAT3 p = cross(direction, e2);
+                const float det = dot(e1, p);
+                if (det == 0.0f) continue;
+                const float invDet = 1.0f / det;
+                const XMFLOAT3 s = sub(origin, v0);
+                const float u = dot(s, p) * invDet;
+                if (u < 0.0f || u > 1.0f) continue;
+                const XMFLOAT3 q = cross(s, e1);
+                const float v = dot(direction, q) * invDet;
+                if (v < 0.0f || u + v > 1.0f) continue;
+                const float t01 = dot(e2, q) * invDet;
+                if (t01 < 0.0f || t01 > best) continue;
+
+                best = t01;
+                bestTriangle = t;
+                bestU = u;
+                bestV = v;
+                if (anyHit) {
+                    hit.t = best;
+                    hit.triangle = m_triangleIds[t];
+                    hit.u = u;
+                    hit.v = v;
+                    return true;
+                }
+            }
+        }
+
+        // Nodos: se apilan del más lejano al más cercano
+        for (int h = hits - 1; h >= 0; --h) {
+            const int i = order[h];
+            if (node.count[i] != 0) continue;
+            assert(sp < kStackSize);  // build rechaza árboles más profundos
+            stack[sp++] = Entry{ node.child[i], enter[i] };
+        }
+    }
+
+    if (bestTriangle == ~0u) return false;
+    hit.t = best;
+    hit.triangle = m_triangleIds[bestTriangle];
+    hit.u = bestU;
+    hit.v = bestV;
+    return true;
+}
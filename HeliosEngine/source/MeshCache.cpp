@@ -0,0 +1,722 @@
+#include "../include/MeshCache.h"
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+    // Constantes y rondas de XXH64
+    const uint64_t kPrime1 = 11400714785074694791ull;
+    const uint64_t kPrime2 = 14029467366897019727ull;
+    const uint64_t kPrime3 = 1609587929392839161ull;
+    const uint64_t kPrime4 = 9650029242287828579ull;
+    const uint64_t kPrime5 = 2870177450012600261ull;
+
+    inline uint64_t rotl64(uint64_t x, int r) {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    inline uint64_t read64(const unsigned char* p) {
+        uint64_t v; memcpy(&v, p, sizeof(v)); return v;
+    }
+
+    inline uint32_t read32(const unsigned char* p) {
+        uint32_t v; memcpy(&v, p, sizeof(v)); return v;
+    }
+
+    inline uint64_t hashRound(uint64_t acc, uint64_t input) {
+        acc += input * kPrime2;
+        acc = rotl64(acc, 31);
+        return acc * kPrime1;
+    }
+
+    inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+        acc ^= hashRound(0, val);
+        return acc * kPrime1 + kPrime4;
+    }
+
+    inline uint64_t alignUp(uint64_t v, uint64_t a) {
+        return (v + a - 1) & ~(a - 1);
+    }
+
+    bool writePadding(std::ofstream& out, uint64_t from, uint64_t to) {
+        static const char zeros[16] = {};
+        if (to > from) out.write(zeros, std::streamsize(to - from));
+        return bool(out);
+    }
+
+    void storeBounds(const BoundingSphere& sphere, const OrientedBox& box, HMeshBounds& out) {
+        out.sphere[0] = sphere.center.x; out.sphere[1] = sphere.center.y;
+        out.sphere[2] = sphere.center.z; out.sphere[3] = sphere.radius;
+        out.obbCenter[0] = box.center.x; out.obbCenter[1] = box.center.y; out.obbCenter[2] = box.center.z;
+        out.obbExtents[0] = box.extents.x; out.obbExtents[1] = box.extents.y; out.obbExtents[2] = box.extents.z;
+        for (int k = 0; k < 3; ++k) {
+            out.obbAxes[3 * k] = box.axes[k].x;
+            out.obbAxes[3 * k + 1] = box.axes[k].y;
+            out.obbAxes[3 * k + 2] = box.axes[k].z;
+        }
+        out.reserved = 0;
+    }
+
+    void loadBounds(const HMeshBounds& in, BoundingSphere& sphere, OrientedBox& box) {
+        sphere.center = XMFLOAT3(in.sphere[0], in.sphere[1], in.sphere[2]);
+        sphere.radius = in.sphere[3];
+        box.center = XMFLOAT3(in.obbCenter[0], in.obbCenter[1], in.obbCenter[2]);
+        box.extents = XMFLOAT3(in.obbExtents[0], in.obbExtents[1], in.obbExtents[2]);
+        for (int k = 0; k < 3; ++k) {
+            box.axes[k] = XMFLOAT3(in.obbAxes[3 * k], in.obbAxes[3 * k + 1], in.obbAxes[3 * k + 2]);
+        }
+    }
+
+    void storeSubset(const MeshSubset& src, HMeshSubset& dst) {
+        memset(&dst, 0, sizeof(dst));
+        dst.startIndex = src.startIndex;
+        dst.indexCount = src.indexCount;
+        dst.materialId = src.materialId;
+        dst.baseVertex = src.baseVertex;
+        dst.aabbMin[0] = src.aabbMin.x; dst.aabbMin[1] = src.aabbMin.y; dst.aabbMin[2] = src.aabbMin.z;
+        dst.aabbMax[0] = src.aabbMax.x; dst.aabbMax[1] = src.aabbMax.y; dst.aabbMax[2] = src.aabbMax.z;
+        storeBounds(src.sphere, src.obb, dst.bounds);
+    }
+
+    void loadSubset(const HMeshSubset& src, MeshSubset& dst) {
+        dst.startIndex = src.startIndex;
+        dst.indexCount = src.indexCount;
+        dst.materialId = src.materialId;
+        dst.baseVertex = src.baseVertex;
+        dst.aabbMin = XMFLOAT3(src.aabbMin[0], src.aabbMin[1], src.aabbMin[2]);
+        dst.aabbMax = XMFLOAT3(src.aabbMax[0], src.aabbMax[1], src.aabbMax[2]);
+        loadBounds(src.bounds, dst.sphere, dst.obb);
+    }
+
+    // Mayor índice de una lista (0 si está vacía); un solo recorrido secuencial
+    unsigned int maxIndex(const unsigned int* indices, size_t count) {
+        unsigned int result = 0;
+        for (size_t i = 0; i < count; ++i) {
+            result = std::max(result, indices[i]);
+        }
+        return result;
+    }
+
+    // Cotas de MeshletData en el orden en que se guardan
+    std::vector<float> MeshletData::* const kMeshletBounds[8] = {
+        &MeshletData::centerX, &MeshletData::centerY, &MeshletData::centerZ, &MeshletData::radius,
+        &MeshletData::coneAxisX, &MeshletData::coneAxisY, &MeshletData::coneAxisZ, &MeshletData::coneCutoff,
+    };
+
+    // Posición de cada arreglo de un HMeshMeshletSet
+    struct MeshletLayout {
+        uint64_t meshlets, vertices, triangles, subsets, bounds, end;
+    };
+
+    MeshletLayout meshletLayout(const HMeshMeshletSet& set) {
+        MeshletLayout layout;
+        layout.meshlets = set.offset;
+        layout.vertices = alignUp(layout.meshlets + uint64_t(set.meshletCount) * sizeof(Meshlet), 16);
+        layout.triangles = alignUp(layout.vertices + uint64_t(set.vertexCount) * sizeof(uint32_t), 16);
+        layout.subsets = alignUp(layout.triangles + set.triangleBytes, 16);
+        layout.bounds = alignUp(layout.subsets + uint64_t(set.subsetCount) * sizeof(HMeshSubset), 16);
+        layout.end = layout.bounds + 8 * uint64_t(set.boundsCount) * sizeof(float);
+        return layout;
+    }
+
+    template <typename T>
+    void writeArray(std::ofstream& out, const std::vector<T>& values) {
+        if (!values.empty()) {
+            out.write(reinterpret_cast<const char*>(values.data()), std::streamsize(values.size() * sizeof(T)));
+        }
+    }
+
+    // Tamaño y fecha de última escritura de un archivo, sin leerlo
+    bool fileStamp(const std::string& path, uint64_t& outSize, uint64_t& outWriteTime) {
+        WIN32_FILE_ATTRIBUTE_DATA data;
+        if (!GetFileAttributesExA(path.c_str(), GetFileExInfoStandard, &data)) {
+            return false;
+        }
+        outSize = (uint64_t(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+        outWriteTime = (uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+        return true;
+    }
+
+    // Tamaño en disco de un material: cabecera + cadenas, alineado a 4
+    inline uint64_t materialRecordSize(uint64_t nameLength, uint64_t diffuseMapLength) {
+        return alignUp(sizeof(HMeshMaterial) + nameLength + diffuseMapLength, 4);
+    }
+}
+
+uint64_t
+MeshCache::HashBytes(const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    const unsigned char* end = p + size;
+    const uint64_t seed = 0;
+    uint64_t h;
+
+    if (size >= 32) {
+        // Cuatro acumuladores independientes: el bucle no queda limitado por la latencia
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const unsigned char* limit = end - 32;
+        do {
+            v1 = hashRound(v1, read64(p));
+            v2 = hashRound(v2, read64(p + 8));
+            v3 = hashRound(v3, read64(p + 16));
+            v4 = hashRound(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    }
+    else {
+        h = seed + kPrime5;
+    }
+
+    h += uint64_t(size);
+
+    while (p + 8 <= end) {
+        h ^= hashRound(0, read64(p));
+        h = rotl64(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+    }
+    if (p + 4 <= end) {
+        h ^= uint64_t(read32(p)) * kPrime1;
+        h = rotl64(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    while (p < end) {
+        h ^= uint64_t(*p) * kPrime5;
+        h = rotl64(h, 11) * kPrime1;
+        ++p;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+bool
+MeshCache::HashFile(const std::string& path, uint64_t& outHash, uint64_t& outSize) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    outSize = file.size();
+    outHash = HashBytes(file.data(), file.size());
+    return true;
+}
+
+bool
+MeshCache::write(const std::string& cachePath, const MeshComponent& mesh, const std::string& sourcePath,
+    const MeshLODChain* lods, const std::vector<MeshletData>* meshlets) {
+    if (mesh.m_vertex.empty() || mesh.m_index.empty()) {
+        ERROR(L"MeshCache", L"write", L"La malla está vacía");
+        return false;
+    }
+
+    HMeshHeader header;
+    memset(&header, 0, sizeof(header));
+    uint64_t stampSize = 0;
+    if (!fileStamp(sourcePath, stampSize, header.sourceWriteTime) ||
+        !HashFile(sourcePath, header.sourceHash, header.sourceSize)) {
+        return false;
+    }
+
+    memcpy(header.magic, "HMSH", 4);
+    header.formatVersion = kFormatVersion;
+    header.loaderVersion = kLoaderVersion;
+    header.vertexStride = sizeof(SimpleVertex);
+    header.vertexCount = static_cast<uint32_t>(mesh.m_vertex.size());
+    header.indexCount = static_cast<uint32_t>(mesh.m_index.size());
+    header.subsetCount = static_cast<uint32_t>(mesh.m_subsets.size());
+    header.materialCount = static_cast<uint32_t>(mesh.m_materials.size());
+    header.aabbMin[0] = mesh.m_aabbMin.x; header.aabbMin[1] = mesh.m_aabbMin.y; header.aabbMin[2] = mesh.m_aabbMin.z;
+    header.aabbMax[0] = mesh.m_aabbMax.x; header.aabbMax[1] = mesh.m_aabbMax.y; header.aabbMax[2] = mesh.m_aabbMax.z;
+    storeBounds(mesh.m_sphere, mesh.m_obb, header.bounds);
+
+    const uint64_t vertexBytes = uint64_t(header.vertexCount) * sizeof(SimpleVertex);
+    const uint64_t indexBytes = uint64_t(header.indexCount) * sizeof(uint32_t);
+    const bool hasTangents = mesh.m_tangents.size() == mesh.m_vertex.size();
+    const uint64_t tangentBytes = hasTangents ? uint64_t(header.vertexCount) * sizeof(XMFLOAT4) : 0;
+    header.vertexOffset = alignUp(sizeof(HMeshHeader), 16);
+    const uint64_t vertexEnd = header.vertexOffset + vertexBytes;
+    header.tangentOffset = hasTangents ? alignUp(vertexEnd, 16) : 0;
+    header.indexOffset = alignUp(hasTangents ? header.tangentOffset + tangentBytes : vertexEnd, 16);
+    header.subsetOffset = alignUp(header.indexOffset + indexBytes, 16);
+    header.materialOffset = alignUp(header.subsetOffset + uint64_t(header.subsetCount) * sizeof(HMeshSubset), 16);
+
+    std::vector<HMeshSubset> subsets(mesh.m_subsets.size());
+    for (size_t i = 0; i < subsets.size(); ++i) {
+        storeSubset(mesh.m_subsets[i], subsets[i]);
+    }
+    uint64_t materialEnd = header.materialOffset;
+    for (const MeshMaterial& material : mesh.m_materials) {
+        materialEnd += materialRecordSize(material.name.size(), material.diffuseMap.size());
+    }
+
+    // Cadena de LODs: los rangos de todos los niveles van seguidos, cada nivel apunta a los suyos
+    std::vector<HMeshLOD>    records;
+    std::vector<HMeshSubset> lodSubsets;
+    const bool hasLODs = lods != nullptr && !lods->levels.empty() && !lods->indices.empty();
+    if (hasLODs) {
+        for (const MeshLOD& level : lods->levels) {
+            HMeshLOD record;
+            memset(&record, 0, sizeof(record));
+            record.firstSubset = static_cast<uint32_t>(lodSubsets.size());
+            record.subsetCount = static_cast<uint32_t>(level.subsets.size());
+            record.triangleCount = level.triangleCount;
+            record.targetRatio = level.targetRatio;
+            record.error = level.error;
+            records.push_back(record);
+            for (const MeshSubset& subset : level.subsets) {
+                lodSubsets.push_back(HMeshSubset());
+                storeSubset(subset, lodSubsets.back());
+            }
+        }
+        header.lodRatioCount = static_cast<uint32_t>(lods->ratios.size());
+        header.lodCount = static_cast<uint32_t>(records.size());
+        header.lodSubsetCount = static_cast<uint32_t>(lodSubsets.size());
+        header.lodIndexCount = static_cast<uint32_t>(lods->indices.size());
+        header.lodRatioOffset = alignUp(materialEnd, 16);
+        header.lodOffset = alignUp(header.lodRatioOffset + uint64_t(header.lodRatioCount) * sizeof(float), 16);
+        header.lodSubsetOffset = alignUp(header.lodOffset + uint64_t(header.lodCount) * sizeof(HMeshLOD), 16);
+        header.lodIndexOffset = alignUp(header.lodSubsetOffset + uint64_t(header.lodSubsetCount) * sizeof(HMeshSubset), 16);
+    }
+
+    // Meshlets: sólo con un conjunto por LOD y las cotas completas
+    std::vector<HMeshMeshletSet> sets;
+    bool hasMeshlets = hasLODs && meshlets != nullptr && meshlets->size() == lods->levels.size();
+    for (size_t i = 0; hasMeshlets && i < meshlets->size(); ++i) {
+        const MeshletData& data = (*meshlets)[i];
+        for (std::vector<float> MeshletData::* bounds : kMeshletBounds) {
+            hasMeshlets &= (data.*bounds).size() == data.radius.size();
+        }
+        hasMeshlets &= data.radius.size() % 4 == 0 && data.radius.size() >= data.meshlets.size();
+    }
+    if (hasMeshlets) {
+        header.meshletSetCount = static_cast<uint32_t>(meshlets->size());
+        header.meshletMaxVertices = MeshletBuilder::kMaxVertices;
+        header.meshletMaxTriangles = MeshletBuilder::kMaxTriangles;
+        header.meshletOffset = alignUp(header.lodIndexOffset + uint64_t(header.lodIndexCount) * sizeof(uint32_t), 16);
+        uint64_t cursor = alignUp(header.meshletOffset + uint64_t(header.meshletSetCount) * sizeof(HMeshMeshletSet), 16);
+        for (const MeshletData& data : *meshlets) {
+            HMeshMeshletSet set;
+            memset(&set, 0, sizeof(set));
+            set.meshletCount = static_cast<uint32_t>(data.meshlets.size());
+            set.vertexCount = static_cast<uint32_t>(data.vertices.size());
+            set.triangleBytes = static_cast<uint32_t>(data.triangles.size());
+            set.subsetCount = static_cast<uint32_t>(data.subsets.size());
+            set.boundsCount = static_cast<uint32_t>(data.radius.size());
+            set.fitsIndex16 = data.fitsIndex16 ? 1 : 0;
+            set.triangleCount = data.triangleCount;
+            set.offset = cursor;
+            sets.push_back(set);
+            cursor = alignUp(meshletLayout(set).end, 16);
+        }
+    }
+
+    // Se escribe a un temporal y se renombra: un lector nunca ve un .hmesh a medias
+    const std::string tmpPath = cachePath + ".tmp";
+    {
+        std::ofstream out(tmpPath.c_str(), std::ios::binary | std::ios::trunc);
+        if (!out) {
+            ERROR(L"MeshCache", L"write", L"No se pudo crear el archivo de caché");
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writePadding(out, sizeof(header), header.vertexOffset);
+        out.write(reinterpret_cast<const char*>(mesh.m_vertex.data()), std::streamsize(vertexBytes));
+        if (hasTangents) {
+            writePadding(out, vertexEnd, header.tangentOffset);
+            out.write(reinterpret_cast<const char*>(mesh.m_tangents.data()), std::streamsize(tangentBytes));
+            writePadding(out, header.tangentOffset + tangentBytes, header.indexOffset);
+        }
+        else {
+            writePadding(out, vertexEnd, header.indexOffset);
+        }
+        out.write(reinterpret_cast<const char*>(mesh.m_index.data()), std::streamsize(indexBytes));
+        writePadding(out, header.indexOffset + indexBytes, header.subsetOffset);
+        if (!subsets.empty()) {
+            out.write(reinterpret_cast<const char*>(subsets.data()),
+                std::streamsize(subsets.size() * sizeof(HMeshSubset)));
+        }
+        writePadding(out, header.subsetOffset + subsets.size() * sizeof(HMeshSubset), header.materialOffset);
+        for (const MeshMaterial& material : mesh.m_materials) {
+            HMeshMaterial record;
+            memset(&record, 0, sizeof(record));
+            record.nameLength = static_cast<uint32_t>(material.name.size());
+            record.diffuseMapLength = static_cast<uint32_t>(material.diffuseMap.size());
+            record.diffuse[0] = material.diffuse.x;
+            record.diffuse[1] = material.diffuse.y;
+            record.diffuse[2] = material.diffuse.z;
+
+            const uint64_t used = sizeof(record) + material.name.size() + material.diffuseMap.size();
+            out.write(reinterpret_cast<const char*>(&record), sizeof(record));
+            out.write(material.name.data(), std::streamsize(material.name.size()));
+            out.write(material.diffuseMap.data(), std::streamsize(material.diffuseMap.size()));
+            writePadding(out, used, materialRecordSize(record.nameLength, record.diffuseMapLength));
+        }
+        if (hasLODs) {
+            writePadding(out, materialEnd, header.lodRatioOffset);
+            writeArray(out, lods->ratios);
+            writePadding(out, header.lodRatioOffset + uint64_t(header.lodRatioCount) * sizeof(float), header.lodOffset);
+            writeArray(out, records);
+            writePadding(out, header.lodOffset + uint64_t(header.lodCount) * sizeof(HMeshLOD), header.lodSubsetOffset);
+            writeArray(out, lodSubsets);
+            writePadding(out, header.lodSubsetOffset + uint64_t(header.lodSubsetCount) * sizeof(HMeshSubset),
+                header.lodIndexOffset);
+            writeArray(out, lods->indices);
+        }
+        if (hasMeshlets) {
+            uint64_t pos = header.lodIndexOffset + uint64_t(header.lodIndexCount) * sizeof(uint32_t);
+            writePadding(out, pos, header.meshletOffset);
+            writeArray(out, sets);
+            pos = header.meshletOffset + sets.size() * sizeof(HMeshMeshletSet);
+            for (size_t i = 0; i < sets.size(); ++i) {
+                const MeshletData& data = (*meshlets)[i];
+                const MeshletLayout layout = meshletLayout(sets[i]);
+                std::vector<HMeshSubset> setSubsets(data.subsets.size());
+                for (size_t s = 0; s < setSubsets.size(); ++s) {
+                    storeSubset(data.subsets[s], setSubsets[s]);
+                }
+
+                writePadding(out, pos, layout.meshlets);
+                writeArray(out, data.meshlets);
+                writePadding(out, layout.meshlets + data.meshlets.size() * sizeof(Meshlet), layout.vertices);
+                writeArray(out, data.vertices);
+                writePadding(out, layout.vertices + data.vertices.size() * sizeof(uint32_t), layout.triangles);
+                writeArray(out, data.triangles);
+                writePadding(out, layout.triangles + data.triangles.size(), layout.subsets);
+                writeArray(out, setSubsets);
+                writePadding(out, layout.subsets + setSubsets.size() * sizeof(HMeshSubset), layout.bounds);
+                for (std::vector<float> MeshletData::* bounds : kMeshletBounds) {
+                    writeArray(out, data.*bounds);
+                }
+                pos = layout.end;
+            }
+        }
+        if (!out) {
+            ERROR(L"MeshCache", L"write", L"Escritura incompleta del archivo de caché");
+            out.close();
+            remove(tmpPath.c_str());
+            return false;
+        }
+    }
+
+    if (!MoveFileExA(tmpPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING)) {
+        ERROR(L"MeshCache", L"write", L"No se pudo reemplazar el archivo de caché");
+        remove(tmpPath.c_str());
+        return false;
+    }
+
+    MESSAGE(L"MeshCache", L"write", L"OK");
+    return true;
+}
+
+bool
+MeshCache::open(const std::string& cachePath, const std::string& sourcePath) {
+    close();
+
+    // Caché inexistente: caso normal en la primera ejecución, no es un error
+    if (GetFileAttributesA(cachePath.c_str()) == INVALID_FILE_ATTRIBUTES) {
+        return false;
+    }
+    if (!m_file.open(cachePath) || m_file.size() < sizeof(HMeshHeader)) {
+        close();
+        return false;
+    }
+
+    const HMeshHeader* header = reinterpret_cast<const HMeshHeader*>(m_file.data());
+    const uint64_t fileSize = m_file.size();
+    const uint64_t vertexBytes = uint64_t(header->vertexCount) * sizeof(SimpleVertex);
+    const uint64_t indexBytes = uint64_t(header->indexCount) * sizeof(uint32_t);
+    const uint64_t subsetBytes = uint64_t(header->subsetCount) * sizeof(HMeshSubset);
+
+    const bool layoutOk =
+        memcmp(header->magic, "HMSH", 4) == 0 &&
+        header->formatVersion == kFormatVersion &&
+        header->vertexStride == sizeof(SimpleVertex) &&
+        header->vertexOffset % 16 == 0 && header->indexOffset % 4 == 0 && header->subsetOffset % 4 == 0 &&
+        header->vertexOffset + vertexBytes <= fileSize &&
+        header->indexOffset + indexBytes <= fileSize &&
+        header->subsetOffset + subsetBytes <= fileSize &&
+        (header->tangentOffset == 0 || (header->tangentOffset % 16 == 0 &&
+            header->tangentOffset + uint64_t(header->vertexCount) * sizeof(XMFLOAT4) <= fileSize));
+    if (!layoutOk || header->loaderVersion != kLoaderVersion) {
+        MESSAGE(L"MeshCache", L"open", L"Caché obsoleta (formato/versión del loader)");
+        close();
+        return false;
+    }
+
+    // Los materiales son de tamaño variable: se recorren una vez para validar sus límites
+    uint64_t materialCursor = header->materialOffset;
+    for (uint32_t i = 0; i < header->materialCount; ++i) {
+        HMeshMaterial record;
+        if (materialCursor % 4 != 0 || materialCursor + sizeof(record) > fileSize) {
+            materialCursor = fileSize + 1;
+            break;
+        }
+        memcpy(&record, m_file.data() + materialCursor, sizeof(record));
+        materialCursor += materialRecordSize(record.nameLength, record.diffuseMapLength);
+    }
+    if (materialCursor > fileSize) {
+        MESSAGE(L"MeshCache", L"open", L"Caché corrupta (materiales)");
+        close();
+        return false;
+    }
+
+    // Sección de LODs: sólo límites; el contenido se valida en readLODs, que es quien lo usa
+    const bool lodsOk = header->lodCount == 0 || (
+        header->lodRatioOffset % 4 == 0 && header->lodOffset % 8 == 0 &&
+        header->lodSubsetOffset % 4 == 0 && header->lodIndexOffset % 4 == 0 &&
+        header->lodRatioOffset + uint64_t(header->lodRatioCount) * sizeof(float) <= fileSize &&
+        header->lodOffset + uint64_t(header->lodCount) * sizeof(HMeshLOD) <= fileSize &&
+        header->lodSubsetOffset + uint64_t(header->lodSubsetCount) * sizeof(HMeshSubset) <= fileSize &&
+        header->lodIndexOffset + uint64_t(header->lodIndexCount) * sizeof(uint32_t) <= fileSize);
+    if (!lodsOk) {
+        MESSAGE(L"MeshCache", L"open", L"Caché corrupta (LODs)");
+        close();
+        return false;
+    }
+
+    // Meshlets: la tabla y los datos de cada conjunto dentro del archivo (contenido en readMeshlets)
+    bool meshletsOk = header->meshletSetCount == 0 || (header->meshletSetCount == header->lodCount &&
+        header->meshletOffset % 8 == 0 &&
+        header->meshletOffset + uint64_t(header->meshletSetCount) * sizeof(HMeshMeshletSet) <= fileSize);
+    const HMeshMeshletSet* sets = reinterpret_cast<const HMeshMeshletSet*>(m_file.data() + header->meshletOffset);
+    for (uint32_t i = 0; meshletsOk && i < header->meshletSetCount; ++i) {
+        meshletsOk = sets[i].offset % 16 == 0 && meshletLayout(sets[i]).end <= fileSize;
+    }
+    if (!meshletsOk) {
+        MESSAGE(L"MeshCache", L"open", L"Caché corrupta (meshlets)");
+        close();
+        return false;
+    }
+
+    // Cada subset debe caer dentro de los índices y vértices de la caché: un rango malo se
+    // leería fuera del buffer al dibujar o al partir la malla
+    const HMeshSubset* subsets = reinterpret_cast<const HMeshSubset*>(m_file.data() + header->subsetOffset);
+    for (uint32_t i = 0; i < header->subsetCount; ++i) {
+        const HMeshSubset& subset = subsets[i];
+        if (uint64_t(subset.startIndex) + subset.indexCount > header->indexCount ||
+            (subset.baseVertex != 0 && subset.baseVertex >= header->vertexCount)) {
+            MESSAGE(L"MeshCache", L"open", L"Caché obsoleta (rango de subset inválido)");
+            close();
+            return false;
+        }
+    }
+
+    // Los índices van directo a consumidores en CPU (BVH, LODs, meshlets): uno que no apunte a
+    // un vértice se leería fuera de la vista mapeada
+    const unsigned int* indices = reinterpret_cast<const unsigned int*>(m_file.data() + header->indexOffset);
+    if (header->indexCount > 0 && maxIndex(indices, header->indexCount) >= header->vertexCount) {
+        MESSAGE(L"MeshCache", L"open", L"Caché corrupta (índice fuera de los vértices)");
+        close();
+        return false;
+    }
+
+    // Validación del fuente. Si no existe (solo se distribuye la caché) se acepta tal cual; si
+    // conserva tamaño y fecha no se relee: el hash sólo se calcula cuando algo cambió
+    uint64_t sourceSize = 0, sourceWriteTime = 0;
+    if (fileStamp(sourcePath, sourceSize, sourceWriteTime)) {
+        bool changed = sourceSize != header->sourceSize;
+        if (!changed && sourceWriteTime != header->sourceWriteTime) {
+            // Mismo tamaño y otra fecha (p. ej. se volvió a copiar): decide el contenido
+            uint64_t sourceHash = 0;
+            changed = HashFile(sourcePath, sourceHash, sourceSize) && sourceHash != header->sourceHash;
+        }
+        if (changed) {
+            MESSAGE(L"MeshCache", L"open", L"Caché obsoleta (el archivo fuente cambió)");
+            close();
+            return false;
+        }
+    }
+
+    m_header = header;
+    return true;
+}
+
+void
+MeshCache::close() {
+    m_header = nullptr;
+    m_file.close();
+}
+
+const SimpleVertex*
+MeshCache::vertices() const {
+    return m_header ? reinterpret_cast<const SimpleVertex*>(m_file.data() + m_header->vertexOffset) : nullptr;
+}
+
+const XMFLOAT4*
+MeshCache::tangents() const {
+    return (m_header && m_header->tangentOffset) ?
+        reinterpret_cast<const XMFLOAT4*>(m_file.data() + m_header->tangentOffset) : nullptr;
+}
+
+const unsigned int*
+MeshCache::indices() const {
+    return m_header ? reinterpret_cast<const unsigned int*>(m_file.data() + m_header->indexOffset) : nullptr;
+}
+
+const unsigned int*
+MeshCache::lodIndices() const {
+    return (m_header && m_header->lodCount) ?
+        reinterpret_cast<const unsigned int*>(m_file.data() + m_header->lodIndexOffset) : nullptr;
+}
+
+void
+MeshCache::fillMetadata(MeshComponent& mesh) const {
+    if (!m_header) return;
+
+    mesh.m_numVertex = static_cast<int>(m_header->vertexCount);
+    mesh.m_numIndex = static_cast<int>(m_header->indexCount);
+    mesh.m_aabbMin = XMFLOAT3(m_header->aabbMin[0], m_header->aabbMin[1], m_header->aabbMin[2]);
+    mesh.m_aabbMax = XMFLOAT3(m_header->aabbMax[0], m_header->aabbMax[1], m_header->aabbMax[2]);
+    loadBounds(m_header->bounds, mesh.m_sphere, mesh.m_obb);
+
+    const HMeshSubset* subsets = reinterpret_cast<const HMeshSubset*>(m_file.data() + m_header->subsetOffset);
+    mesh.m_subsets.resize(m_header->subsetCount);
+    for (uint32_t i = 0; i < m_header->subsetCount; ++i) {
+        loadSubset(subsets[i], mesh.m_subsets[i]);
+    }
+
+    // Límites ya validados en open()
+    const char* cursor = m_file.data() + m_header->materialOffset;
+    mesh.m_materials.resize(m_header->materialCount);
+    for (uint32_t i = 0; i < m_header->materialCount; ++i) {
+        HMeshMaterial record;
+        memcpy(&record, cursor, sizeof(record));
+        const char* strings = cursor + sizeof(record);
+
+        MeshMaterial& dst = mesh.m_materials[i];
+        dst.name.assign(strings, record.nameLength);
+        dst.diffuseMap.assign(strings + record.nameLength, record.diffuseMapLength);
+        dst.diffuse = XMFLOAT3(record.diffuse[0], record.diffuse[1], record.diffuse[2]);
+        cursor += materialRecordSize(record.nameLength, record.diffuseMapLength);
+    }
+}
+
+void
+MeshCache::copyTo(MeshComponent& mesh) const {
+    if (!m_header) return;
+
+    fillMetadata(mesh);
+    mesh.m_vertex.assign(vertices(), vertices() + m_header->vertexCount);
+    mesh.m_index.assign(indices(), indices() + m_header->indexCount);
+    if (tangents()) mesh.m_tangents.assign(tangents(), tangents() + m_header->vertexCount);
+    else            mesh.m_tangents.clear();
+}
+
+bool
+MeshCache::readLODs(const std::vector<float>& ratios, MeshLODChain& chain) const {
+    chain.indices.clear();
+    chain.levels.clear();
+    chain.ratios.clear();
+    if (!m_header || m_header->lodCount == 0 || m_header->lodRatioCount != ratios.size()) return false;
+
+    const float* storedRatios = reinterpret_cast<const float*>(m_file.data() + m_header->lodRatioOffset);
+    if (!ratios.empty() && memcmp(storedRatios, ratios.data(), ratios.size() * sizeof(float)) != 0) {
+        MESSAGE(L"MeshCache", L"readLODs", L"LODs guardados con otros ratios; hay que reconstruirlos");
+        return false;
+    }
+
+    // Los índices se dibujan y se leen en CPU sin copiarlos: todo rango debe caer dentro de la caché
+    const unsigned int* indices = lodIndices();
+    if (maxIndex(indices, m_header->lodIndexCount) >= m_header->vertexCount) return false;
+
+    const HMeshLOD* records = reinterpret_cast<const HMeshLOD*>(m_file.data() + m_header->lodOffset);
+    const HMeshSubset* subsets = reinterpret_cast<const HMeshSubset*>(m_file.data() + m_header->lodSubsetOffset);
+    chain.levels.resize(m_header->lodCount);
+    for (uint32_t i = 0; i < m_header->lodCount; ++i) {
+        const HMeshLOD& record = records[i];
+        if (uint64_t(record.firstSubset) + record.subsetCount > m_header->lodSubsetCount) {
+            chain.levels.clear();
+            return false;
+        }
+        MeshLOD& level = chain.levels[i];
+        level.triangleCount = size_t(record.triangleCount);
+        level.targetRatio = record.targetRatio;
+        level.error = record.error;
+        level.subsets.resize(record.subsetCount);
+        for (uint32_t s = 0; s < record.subsetCount; ++s) {
+            const HMeshSubset& subset = subsets[record.firstSubset + s];
+            if (uint64_t(subset.startIndex) + subset.indexCount > m_header->lodIndexCount ||
+                (subset.baseVertex != 0 && subset.baseVertex >= m_header->vertexCount)) {
+                chain.levels.clear();
+                return false;
+            }
+            loadSubset(subset, level.subsets[s]);
+        }
+    }
+    chain.ratios = ratios;
+    return true;
+}
+
+bool
+MeshCache::readMeshlets(std::vector<MeshletData>& out) const {
+    out.clear();
+    if (!m_header || m_header->meshletSetCount == 0 ||
+        m_header->meshletMaxVertices != MeshletBuilder::kMaxVertices ||
+        m_header->meshletMaxTriangles != MeshletBuilder::kMaxTriangles) {
+        return false;
+    }
+
+    const HMeshMeshletSet* sets = reinterpret_cast<const HMeshMeshletSet*>(m_file.data() + m_header->meshletOffset);
+    out.resize(m_header->meshletSetCount);
+    for (uint32_t i = 0; i < m_header->meshletSetCount; ++i) {
+        const HMeshMeshletSet& set = sets[i];
+        const MeshletLayout layout = meshletLayout(set);
+        MeshletData& data = out[i];
+        if (set.boundsCount % 4 != 0 || set.boundsCount < set.meshletCount) {
+            out.clear();
+            return false;
+        }
+
+        const Meshlet* meshlets = reinterpret_cast<const Meshlet*>(m_file.data() + layout.meshlets);
+        const unsigned int* vertices = reinterpret_cast<const unsigned int*>(m_file.data() + layout.vertices);
+        const unsigned char* triangles = reinterpret_cast<const unsigned char*>(m_file.data() + layout.triangles);
+        const HMeshSubset* subsets = reinterpret_cast<const HMeshSubset*>(m_file.data() + layout.subsets);
+        const float* bounds = reinterpret_cast<const float*>(m_file.data() + layout.bounds);
+
+        // WriteVisibleIndices sigue meshlet -> vértice local -> vértice sin comprobar nada:
+        // cualquier rango fuera de sus arreglos descarta los meshlets guardados
+        bool valid = maxIndex(vertices, set.vertexCount) < m_header->vertexCount;
+        for (uint32_t m = 0; valid && m < set.meshletCount; ++m) {
+            const Meshlet& meshlet = meshlets[m];
+            valid = uint64_t(meshlet.vertexOffset) + meshlet.vertexCount <= set.vertexCount &&
+                uint64_t(meshlet.triangleOffset) + 3 * uint64_t(meshlet.triangleCount) <= set.triangleBytes &&
+                meshlet.subset < set.subsetCount;
+            for (uint32_t t = 0; valid && t < 3 * meshlet.triangleCount; ++t) {
+                valid = triangles[meshlet.triangleOffset + t] < meshlet.vertexCount;
+            }
+        }
+        if (!valid) {
+            MESSAGE(L"MeshCache", L"readMeshlets", L"Meshlets corruptos; hay que reconstruirlos");
+            out.clear();
+            return false;
+        }
+
+        data.meshlets.assign(meshlets, meshlets + set.meshletCount);
+        data.vertices.assign(vertices, vertices + set.vertexCount);
+        data.triangles.assign(triangles, triangles + set.triangleBytes);
+        data.subsets.resize(set.subsetCount);
+        for (uint32_t s = 0; s < set.subsetCount; ++s) {
+            loadSubset(subsets[s], data.subsets[s]);
+        }
+        for (std::vector<float> MeshletData::* member : kMeshletBounds) {
+            (data.*member).assign(bounds, bounds + set.boundsCount);
+            bounds += set.boundsCount;
+        }
+        data.triangleCount = size_t(set.triangleCount);
+        data.fitsIndex16 = set.fitsIndex16 != 0;
+    }
+    return true;
+}
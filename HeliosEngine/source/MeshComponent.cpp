@@ -0,0 +1,100 @@
+#include "../include/MeshComponent.h"
+#include <algorithm>
+
+void
+MeshComponent::computeBounds() {
+    if (m_subsets.empty() && !m_index.empty()) {
+        MeshSubset whole;
+        whole.indexCount = static_cast<unsigned int>(m_index.size());
+        m_subsets.push_back(whole);
+    }
+
+    if (m_vertex.empty()) {
+        m_aabbMin = m_aabbMax = XMFLOAT3(0, 0, 0);
+        m_sphere = BoundingSphere();
+        m_obb = OrientedBox();
+        return;
+    }
+
+    // Volúmenes globales sobre todos los vértices
+    PointStream points;
+    points.positions = &m_vertex[0].Pos;
+    points.stride = sizeof(SimpleVertex);
+    points.count = m_vertex.size();
+    BoundingVolumes::ComputeAll(points, m_aabbMin, m_aabbMax, m_sphere, m_obb);
+
+    // Por subset, sobre los vértices que referencian sus índices
+    for (MeshSubset& subset : m_subsets) {
+        points.indices = m_index.data() + subset.startIndex;
+        points.count = subset.indexCount;
+        BoundingVolumes::ComputeAll(points, subset.aabbMin, subset.aabbMax, subset.sphere, subset.obb);
+    }
+}
+
+void
+MeshComponent::splitForIndex16() {
+    for (MeshSubset& subset : m_subsets) subset.baseVertex = 0;
+    if (m_vertex.size() <= kMaxVertices16 || m_index.empty()) return;
+    if (m_subsets.empty()) computeBounds();
+
+    // Los vértices se copian en orden de primer uso dentro de una ventana de kMaxVertices16
+    // a partir de windowBase. La ventana se comparte entre subsets consecutivos; sólo al
+    // llenarse se abre otra y los vértices que se vuelvan a usar se duplican en ella
+    const unsigned int kNone = ~0u;
+    const bool hasTangents = m_tangents.size() == m_vertex.size();
+    std::vector<SimpleVertex> vertices;
+    std::vector<XMFLOAT4>     tangents;
+    vertices.reserve(m_vertex.size() + m_vertex.size() / 16);
+    if (hasTangents) tangents.reserve(vertices.capacity());
+    std::vector<unsigned int> copyOf(m_vertex.size(), kNone);
+    std::vector<unsigned int> indices(m_index);
+    std::vector<MeshSubset>   ranges;
+    unsigned int windowBase = 0;
+
+    for (const MeshSubset& subset : m_subsets) {
+        MeshSubset range = subset;
+        range.indexCount = 0;
+        range.baseVertex = windowBase;
+
+        unsigned int* idx = indices.data() + subset.startIndex;
+        for (unsigned int i = 0; i + 2 < subset.indexCount; i += 3) {
+            const unsigned int a = idx[i], b = idx[i + 1], c = idx[i + 2];
+            auto missing = [&](unsigned int v) { return copyOf[v] == kNone || copyOf[v] < windowBase; };
+            const size_t added = missing(a) + (missing(b) && b != a) + (missing(c) && c != a && c != b);
+
+            if (vertices.size() - windowBase + added > kMaxVertices16) {
+                windowBase = static_cast<unsigned int>(vertices.size());
+                if (range.indexCount > 0) ranges.push_back(range);
+                range.startIndex = subset.startIndex + i;
+                range.indexCount = 0;
+                range.baseVertex = windowBase;
+            }
+
+            for (int k = 0; k < 3; ++k) {
+                const unsigned int v = idx[i + k];
+                if (missing(v)) {
+                    copyOf[v] = static_cast<unsigned int>(vertices.size());
+                    vertices.push_back(m_vertex[v]);
+                    if (hasTangents) tangents.push_back(m_tangents[v]);
+                }
+                idx[i + k] = copyOf[v];
+            }
+            range.indexCount += 3;
+        }
+        ranges.push_back(range);
+    }
+
+    // Si los materiales comparten muchos vértices la duplicación puede costar más que lo
+    // que ahorran los índices de 16 bits: en ese caso la malla se queda con 32 bits
+    const size_t extraBytes = (vertices.size() - m_vertex.size()) *
+        (sizeof(SimpleVertex) + (hasTangents ? sizeof(XMFLOAT4) : 0));
+    const size_t savedBytes = m_index.size() * (sizeof(unsigned int) - sizeof(uint16_t));
+    if (extraBytes > savedBytes) return;
+
+    m_vertex.swap(vertices);
+    if (hasTangents) m_tangents.swap(tangents);
+    m_index.swap(indices);
+    m_subsets.swap(ranges);
+    m_numVertex = static_cast<int>(m_vertex.size());
+    computeBounds();
+}
@@ -0,0 +1,308 @@
+#include "../include/MeshNormals.h"
+#include "../include/JobSystem.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Por debajo de esta cantidad de índices por tarea no compensa repartir
+    const size_t kMinIndicesPerThread = 1u << 16;
+
+    unsigned int resolveThreads(unsigned int threadCount, size_t indexCount) {
+        unsigned int n = threadCount ? threadCount : JobSystem::Default().getThreadCount();
+        const size_t byWork = std::max<size_t>(1, indexCount / kMinIndicesPerThread);
+        return unsigned(std::min<size_t>(n, byWork));
+    }
+
+    // Reparte [0, count) en un rango contiguo por tarea del JobSystem; t indexa el rango
+    template <class Fn>
+    void parallelRanges(size_t count, unsigned int threads, Fn&& fn) {
+        if (threads <= 1) {
+            fn(size_t(0), count, 0u);
+            return;
+        }
+        JobSystem::Default().parallelFor(0, threads, [&fn, count, threads](size_t first, size_t last) {
+            for (size_t t = first; t < last; ++t) {
+                fn(count * t / threads, count * (t + 1) / threads, unsigned(t));
+            }
+        }, 1);
+    }
+
+    inline XMFLOAT3 sub(const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z);
+    }
+
+    inline XMFLOAT3 cross(const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+
+    inline float dot(const XMFLOAT3& a, const XMFLOAT3& b) {
+        return a.x * b.x + a.y * b.y + a.z * b.z;
+    }
+
+    inline void addScaled(XMFLOAT3& acc, const XMFLOAT3& v, float s) {
+        acc.x += v.x * s; acc.y += v.y * s; acc.z += v.z * s;
+    }
+
+    inline XMFLOAT3 normalize(const XMFLOAT3& v) {
+        const float len = std::sqrt(dot(v, v));
+        if (len <= 1e-20f) return XMFLOAT3(0, 0, 0);
+        return XMFLOAT3(v.x / len, v.y / len, v.z / len);
+    }
+
+    // Normal de un triángulo: producto cruz (proporcional al área) y, si se piden, los
+    // ángulos de sus esquinas. |e1 x e2| es el mismo en las tres esquinas
+    XMFLOAT3 faceNormal(const std::vector<SimpleVertex>& vertices, const unsigned int* tri, float* outAngles) {
+        const XMFLOAT3& p0 = vertices[tri[0]].Pos;
+        const XMFLOAT3& p1 = vertices[tri[1]].Pos;
+        const XMFLOAT3& p2 = vertices[tri[2]].Pos;
+        const XMFLOAT3 e01 = sub(p1, p0), e02 = sub(p2, p0), e12 = sub(p2, p1);
+        const XMFLOAT3 n = cross(e01, e02);
+        if (outAngles) {
+            const float len = std::sqrt(dot(n, n));
+            outAngles[0] = std::atan2(len, dot(e01, e02));
+            outAngles[1] = std::atan2(len, -dot(e01, e12));
+            outAngles[2] = std::atan2(len, dot(e02, e12));
+        }
+        return n;
+    }
+
+    // Tangente de un triángulo según sus UV, ya orientada (orientation = signo del área UV,
+    // el bOrient de MikkTSpace; 0 si las UV son degeneradas)
+    struct FaceTangent {
+        XMFLOAT3 tangent;
+        float    orientation;
+    };
+
+    void computeFaceTangent(const std::vector<SimpleVertex>& vertices, const unsigned int* tri,
+        FaceTangent& out) {
+        const SimpleVertex& v0 = vertices[tri[0]];
+        const SimpleVertex& v1 = vertices[tri[1]];
+        const SimpleVertex& v2 = vertices[tri[2]];
+        const XMFLOAT3 dp1 = sub(v1.Pos, v0.Pos), dp2 = sub(v2.Pos, v0.Pos);
+        const float du1 = v1.Tex.x - v0.Tex.x, dv1 = v1.Tex.y - v0.Tex.y;
+        const float du2 = v2.Tex.x - v0.Tex.x, dv2 = v2.Tex.y - v0.Tex.y;
+
+        const float area = du1 * dv2 - du2 * dv1;
+        const XMFLOAT3 t(dp1.x * dv2 - dp2.x * dv1, dp1.y * dv2 - dp2.y * dv1, dp1.z * dv2 - dp2.z * dv1);
+        const XMFLOAT3 unit = normalize(t);
+        out.orientation = !(std::fabs(area) > 0.0f) ? 0.0f : (area > 0.0f ? 1.0f : -1.0f);
+        out.tangent = XMFLOAT3(unit.x * out.orientation, unit.y * out.orientation, unit.z * out.orientation);
+    }
+
+    // Cualquier tangente perpendicular a n (vértices sin UV utilizables)
+    XMFLOAT3 anyTangent(const XMFLOAT3& n) {
+        const XMFLOAT3 axis = std::fabs(n.x) < 0.9f ? XMFLOAT3(1, 0, 0) : XMFLOAT3(0, 1, 0);
+        XMFLOAT3 t = axis;
+        addScaled(t, n, -dot(n, axis));
+        t = normalize(t);
+        return (t.x == 0.0f && t.y == 0.0f && t.z == 0.0f) ? XMFLOAT3(1, 0, 0) : t;
+    }
+}
+
+void
+MeshNormals::BuildAdjacency(const unsigned int* indices, size_t indexCount, const unsigned int* groupOf,
+    size_t groupCount, VertexAdjacency& out, unsigned int threadCount) {
+    out.offsets.assign(groupCount + 1, 0);
+    out.corners.clear();
+    if (indexCount == 0 || groupCount == 0) return;
+
+    // Un histograma de groupCount contadores por tarea: se limitan las tareas para que los
+    // histogramas no ocupen más que dos index buffers
+    const unsigned int threads = std::min(resolveThreads(threadCount, indexCount),
+        unsigned(std::max<size_t>(1, indexCount * 2 / groupCount)));
+    auto groupAt = [&](size_t corner) -> size_t {
+        return groupOf ? groupOf[indices[corner]] : indices[corner];
+    };
+
+    // 1) Conteo: cada tarea recorre sólo su rango de esquinas y cuenta en su histograma
+    std::vector<std::vector<unsigned int>> histograms(threads);
+    parallelRanges(indexCount, threads, [&](size_t begin, size_t end, unsigned int t) {
+        std::vector<unsigned int>& histogram = histograms[t];
+        histogram.assign(groupCount, 0);
+        for (size_t c = begin; c < end; ++c) {
+            const size_t g = groupAt(c);
+            if (g < groupCount) ++histogram[g];
+        }
+    });
+
+    // 2) Suma prefija por rangos de grupos: total de cada rango, base de cada rango y, dentro
+    //    de cada grupo, las esquinas de las tareas anteriores. Los histogramas pasan a ser el
+    //    cursor de escritura de cada tarea en cada grupo
+    std::vector<size_t> rangeTotals(threads, 0);
+    parallelRanges(groupCount, threads, [&](size_t begin, size_t end, unsigned int t) {
+        size_t total = 0;
+        for (const std::vector<unsigned int>& histogram : histograms) {
+            for (size_t g = begin; g < end; ++g) total += histogram[g];
+        }
+        rangeTotals[t] = total;
+    });
+    std::vector<size_t> rangeBase(threads, 0);
+    for (unsigned int t = 1; t < threads; ++t) rangeBase[t] = rangeBase[t - 1] + rangeTotals[t - 1];
+    out.corners.resize(rangeBase[threads - 1] + rangeTotals[threads - 1]);
+
+    parallelRanges(groupCount, threads, [&](size_t begin, size_t end, unsigned int t) {
+        size_t running = rangeBase[t];
+        for (size_t g = begin; g < end; ++g) {
+            out.offsets[g] = unsigned(running);
+            for (std::vector<unsigned int>& histogram : histograms) {
+                const unsigned int count = histogram[g];
+                histogram[g] = unsigned(running);
+                running += count;
+            }
+        }
+    });
+
+    // 3) Relleno con el mismo reparto de esquinas que el conteo: cada tarea escribe en sus
+    //    propias posiciones y, como las tareas van en orden de esquina, las listas quedan
+    //    ordenadas y el resultado no depende de la cantidad de hilos
+    parallelRanges(indexCount, threads, [&](size_t begin, size_t end, unsigned int t) {
+        std::vector<unsigned int>& cursor = histograms[t];
+        for (size_t c = begin; c < end; ++c) {
+            const size_t g = groupAt(c);
+            if (g < groupCount) out.corners[cursor[g]++] = unsigned(c);
+        }
+    });
+    out.offsets[groupCount] = unsigned(out.corners.size());
+}
+
+void
+MeshNormals::ComputeNormals(std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices,
+    const unsigned int* weldGroup, NormalWeighting weighting, unsigned int threadCount) {
+    const size_t vertexCount = vertices.size();
+    const size_t indexCount = indices.size() - indices.size() % 3;
+    if (vertexCount == 0 || indexCount == 0) return;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            ERROR(L"MeshNormals", L"ComputeNormals", L"Índice fuera de rango");
+            return;
+        }
+    }
+
+    VertexAdjacency adjacency;
+    BuildAdjacency(indices.data(), indexCount, weldGroup, vertexCount, adjacency, threadCount);
+
+    // 1) Normal de cada triángulo y, con pesos por ángulo, el de cada esquina
+    //    (paralelo por triángulos, escrituras disjuntas)
+    const unsigned int threads = resolveThreads(threadCount, indexCount);
+    const size_t triangleCount = indexCount / 3;
+    const bool byAngle = weighting == NormalWeighting::Angle;
+    std::vector<XMFLOAT3> faceNormals(triangleCount);
+    std::vector<float> cornerAngles(byAngle ? indexCount : 0);
+    parallelRanges(triangleCount, threads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t t = begin; t < end; ++t) {
+            XMFLOAT3 n = faceNormal(vertices, indices.data() + t * 3, byAngle ? &cornerAngles[t * 3] : nullptr);
+            if (byAngle) n = normalize(n);
+            faceNormals[t] = n;
+        }
+    });
+
+    // 2) Normal de cada grupo: suma de las esquinas incidentes (recolección, sin atómicos)
+    std::vector<XMFLOAT3> groupNormals(vertexCount);
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t g = begin; g < end; ++g) {
+            XMFLOAT3 acc(0, 0, 0);
+            for (unsigned int i = adjacency.offsets[g]; i < adjacency.offsets[g + 1]; ++i) {
+                const unsigned int corner = adjacency.corners[i];
+                addScaled(acc, faceNormals[corner / 3], byAngle ? cornerAngles[corner] : 1.0f);
+            }
+            groupNormals[g] = normalize(acc);
+        }
+    });
+
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t v = begin; v < end; ++v) {
+            const unsigned int g = weldGroup ? weldGroup[v] : unsigned(v);
+            if (g != kKeepNormal && g < vertexCount) vertices[v].Normal = groupNormals[g];
+        }
+    });
+}
+
+size_t
+MeshNormals::ComputeTangents(MeshComponent& mesh, unsigned int threadCount) {
+    std::vector<SimpleVertex>& vertices = mesh.m_vertex;
+    std::vector<unsigned int>& indices = mesh.m_index;
+    const size_t vertexCount = vertices.size();
+    const size_t indexCount = indices.size() - indices.size() % 3;
+    mesh.m_tangents.clear();
+    if (vertexCount == 0) return 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        if (indices[i] >= vertexCount) {
+            ERROR(L"MeshNormals", L"ComputeTangents", L"Índice fuera de rango");
+            return 0;
+        }
+    }
+
+    VertexAdjacency adjacency;
+    BuildAdjacency(indices.data(), indexCount, nullptr, vertexCount, adjacency, threadCount);
+
+    // Tangente, orientación y ángulos de cada triángulo, una sola vez
+    const unsigned int threads = resolveThreads(threadCount, indexCount);
+    const size_t triangleCount = indexCount / 3;
+    std::vector<FaceTangent> faceTangents(triangleCount);
+    std::vector<float> cornerAngles(indexCount);
+    parallelRanges(triangleCount, threads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t t = begin; t < end; ++t) {
+            computeFaceTangent(vertices, indices.data() + t * 3, faceTangents[t]);
+            faceNormal(vertices, indices.data() + t * 3, &cornerAngles[t * 3]);
+        }
+    });
+
+    // Por vértice se acumulan por separado las esquinas de cada orientación: la tangente del
+    // triángulo proyectada al plano de la normal del vértice, pesada por el ángulo de la
+    // esquina. Gana la orientación con más esquinas; si aparecen ambas, la otra se guarda
+    // para la división posterior
+    std::vector<XMFLOAT4> tangents(vertexCount);
+    std::vector<XMFLOAT4> mirrored(vertexCount);
+    std::vector<unsigned char> needsSplit(vertexCount, 0);
+    parallelRanges(vertexCount, threads, [&](size_t begin, size_t end, unsigned int) {
+        for (size_t v = begin; v < end; ++v) {
+            const XMFLOAT3 n = vertices[v].Normal;
+            XMFLOAT3 acc[2] = { XMFLOAT3(0, 0, 0), XMFLOAT3(0, 0, 0) };
+            unsigned int count[2] = { 0, 0 };
+            for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i) {
+                const unsigned int corner = adjacency.corners[i];
+                const FaceTangent& face = faceTangents[corner / 3];
+                if (face.orientation == 0.0f) continue;
+                XMFLOAT3 t = face.tangent;
+                addScaled(t, n, -dot(n, t));
+                t = normalize(t);
+                if (t.x == 0.0f && t.y == 0.0f && t.z == 0.0f) continue;
+                const int side = face.orientation > 0.0f ? 0 : 1;
+                addScaled(acc[side], t, cornerAngles[corner]);
+                ++count[side];
+            }
+
+            const int main = count[1] > count[0] ? 1 : 0;
+            XMFLOAT3 t = normalize(acc[main]);
+            if (count[main] == 0 || (t.x == 0.0f && t.y == 0.0f && t.z == 0.0f)) t = anyTangent(n);
+            tangents[v] = XMFLOAT4(t.x, t.y, t.z, main == 0 ? 1.0f : -1.0f);
+
+            if (count[0] > 0 && count[1] > 0) {
+                const XMFLOAT3 other = normalize(acc[1 - main]);
+                mirrored[v] = XMFLOAT4(other.x, other.y, other.z, main == 0 ? -1.0f : 1.0f);
+                needsSplit[v] = 1;
+            }
+        }
+    });
+
+    // División serial de los vértices con UV espejadas (pocos): las esquinas de la
+    // orientación minoritaria pasan a una copia con su propia tangente
+    size_t added = 0;
+    for (size_t v = 0; v < vertexCount; ++v) {
+        if (!needsSplit[v]) continue;
+        const unsigned int copy = unsigned(vertices.size());
+        vertices.push_back(vertices[v]);
+        tangents.push_back(mirrored[v]);
+        ++added;
+
+        for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i) {
+            const unsigned int corner = adjacency.corners[i];
+            if (faceTangents[corner / 3].orientation == mirrored[v].w) indices[corner] = copy;
+        }
+    }
+
+    mesh.m_tangents.swap(tangents);
+    mesh.m_numVertex = static_cast<int>(vertices.size());
+    return added;
+}
@@ -0,0 +1,215 @@
+#include "../include/MeshOptimizer.h"
+#include <algorithm>
+
+namespace
+{
+    const unsigned int kNone = ~0u;
+
+    // Tipsify (Sander, Nehab, Barczak 2007) sobre los triángulos de [indices, indices + indexCount).
+    // Emite abanicos alrededor de un vértice "fanning" y elige el siguiente entre los vértices
+    // recién emitidos que seguirán en caché; en un callejón sin salida usa la pila de vértices
+    // recientes y, en último caso, el siguiente triángulo pendiente en orden de entrada.
+    //
+    // Los vértices del rango se renumeran a [0, vertexCount local) para que el costo dependa del
+    // subset y no de la malla entera. @p localOf (uno por vértice de la malla, todo kNone) es
+    // memoria compartida entre subsets: sólo se tocan y se restauran las entradas del rango.
+    void tipsifyRange(unsigned int* indices, size_t indexCount, std::vector<unsigned int>& localOf,
+        unsigned int cacheSize) {
+        const size_t triangleCount = indexCount / 3;
+        if (triangleCount == 0) return;
+
+        std::vector<unsigned int> globalOf;
+        for (size_t i = 0; i < triangleCount * 3; ++i) {
+            unsigned int& local = localOf[indices[i]];
+            if (local == kNone) {
+                local = unsigned(globalOf.size());
+                globalOf.push_back(indices[i]);
+            }
+            indices[i] = local;
+        }
+        for (unsigned int v : globalOf) localOf[v] = kNone;
+        const size_t vertexCount = globalOf.size();
+
+        // Adyacencia vértice -> triángulos en formato CSR
+        std::vector<unsigned int> offsets(vertexCount + 1, 0);
+        for (size_t i = 0; i < triangleCount * 3; ++i) ++offsets[indices[i] + 1];
+        for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+
+        std::vector<unsigned int> adjacency(triangleCount * 3);
+        {
+            std::vector<unsigned int> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t t = 0; t < triangleCount; ++t) {
+                for (int c = 0; c < 3; ++c) adjacency[fill[indices[t * 3 + c]]++] = unsigned(t);
+            }
+        }
+
+        // Triángulos aún no emitidos por vértice
+        std::vector<unsigned int> live(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v) live[v] = offsets[v + 1] - offsets[v];
+
+        std::vector<unsigned int> cacheTime(vertexCount, 0);
+        std::vector<char>         emitted(triangleCount, 0);
+        std::vector<unsigned int> deadEnd;
+        std::vector<unsigned int> candidates;
+        std::vector<unsigned int> output;
+        deadEnd.reserve(triangleCount * 3);
+        output.reserve(triangleCount * 3);
+
+        unsigned int time = cacheSize + 1;
+        size_t inputCursor = 0;
+        unsigned int fanning = indices[0];
+
+        while (fanning != kNone) {
+            candidates.clear();
+            for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; ++a) {
+                const unsigned int t = adjacency[a];
+                if (emitted[t]) continue;
+                emitted[t] = 1;
+
+                for (int c = 0; c < 3; ++c) {
+                    const unsigned int v = indices[t * 3 + c];
+                    output.push_back(v);
+                    deadEnd.push_back(v);
+                    candidates.push_back(v);
+                    --live[v];
+                    if (time - cacheTime[v] > cacheSize) {
+                        cacheTime[v] = time++;
+                    }
+                }
+            }
+
+            // Candidato más antiguo que siga en caché después de emitir su abanico
+            unsigned int next = kNone;
+            int bestPriority = -1;
+            for (unsigned int v : candidates) {
+                if (live[v] == 0) continue;
+                int priority = 0;
+                if (time - cacheTime[v] + 2 * live[v] <= cacheSize) {
+                    priority = int(time - cacheTime[v]);
+                }
+                if (priority > bestPriority) {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+
+            if (next == kNone) {
+                while (!deadEnd.empty()) {
+                    const unsigned int d = deadEnd.back();
+                    deadEnd.pop_back();
+                    if (live[d] > 0) { next = d; break; }
+                }
+            }
+            while (next == kNone && inputCursor < triangleCount) {
+                if (!emitted[inputCursor]) next = indices[inputCursor * 3];
+                else ++inputCursor;
+            }
+            fanning = next;
+        }
+
+        for (size_t i = 0; i < output.size(); ++i) indices[i] = globalOf[output[i]];
+    }
+
+    bool indicesInRange(const MeshComponent& mesh) {
+        const unsigned int vertexCount = unsigned(mesh.m_vertex.size());
+        for (unsigned int i : mesh.m_index) {
+            if (i >= vertexCount) return false;
+        }
+        return true;
+    }
+}
+
+void
+MeshOptimizer::OptimizeVertexCache(MeshComponent& mesh, unsigned int cacheSize) {
+    if (mesh.m_index.empty()) return;
+    if (!indicesInRange(mesh)) {
+        ERROR(L"MeshOptimizer", L"OptimizeVertexCache", L"Índice fuera de rango");
+        return;
+    }
+
+    // Cada subset por separado: el orden por material se conserva
+    std::vector<unsigned int> localOf(mesh.m_vertex.size(), kNone);
+    if (mesh.m_subsets.empty()) {
+        tipsifyRange(mesh.m_index.data(), mesh.m_index.size(), localOf, cacheSize);
+        return;
+    }
+    for (const MeshSubset& subset : mesh.m_subsets) {
+        tipsifyRange(mesh.m_index.data() + subset.startIndex, subset.indexCount, localOf, cacheSize);
+    }
+}
+
+void
+MeshOptimizer::OptimizeVertexFetch(MeshComponent& mesh) {
+    if (mesh.m_index.empty()) return;
+    if (!indicesInRange(mesh)) {
+        ERROR(L"MeshOptimizer", L"OptimizeVertexFetch", L"Índice fuera de rango");
+        return;
+    }
+
+    // Nuevo índice de cada vértice = orden en que aparece por primera vez
+    std::vector<unsigned int> remap(mesh.m_vertex.size(), kNone);
+    unsigned int next = 0;
+    for (unsigned int& index : mesh.m_index) {
+        if (remap[index] == kNone) remap[index] = next++;
+        index = remap[index];
+    }
+    for (unsigned int& r : remap) {
+        if (r == kNone) r = next++;
+    }
+
+    std::vector<SimpleVertex> reordered(mesh.m_vertex.size());
+    for (size_t v = 0; v < mesh.m_vertex.size(); ++v) {
+        reordered[remap[v]] = mesh.m_vertex[v];
+    }
+    mesh.m_vertex.swap(reordered);
+
+    if (mesh.m_tangents.size() == remap.size()) {
+        std::vector<XMFLOAT4> tangents(remap.size());
+        for (size_t v = 0; v < remap.size(); ++v) tangents[remap[v]] = mesh.m_tangents[v];
+        mesh.m_tangents.swap(tangents);
+    }
+
+    // El remapeo es global: la división en rangos de 16 bits deja de ser válida
+    for (MeshSubset& subset : mesh.m_subsets) subset.baseVertex = 0;
+}
+
+VertexCacheStats
+MeshOptimizer::AnalyzeVertexCache(const unsigned int* indices, size_t indexCount, size_t vertexCount,
+    unsigned int cacheSize) {
+    VertexCacheStats stats;
+    stats.triangles = indexCount / 3;
+
+    // FIFO por marcas de tiempo: un vértice sigue en caché si desde su inserción
+    // hubo menos de cacheSize inserciones (0 = nunca insertado)
+    std::vector<size_t> insertedAt(vertexCount, 0);
+    std::vector<char>   seen(vertexCount, 0);
+    size_t time = 0;
+
+    for (size_t i = 0; i < stats.triangles * 3; ++i) {
+        const unsigned int v = indices[i];
+        if (v >= vertexCount) continue;
+
+        if (!seen[v]) {
+            seen[v] = 1;
+            ++stats.uniqueVertices;
+        }
+        if (insertedAt[v] == 0 || time - insertedAt[v] >= cacheSize) {
+            insertedAt[v] = ++time;
+            ++stats.transformed;
+        }
+    }
+    return stats;
+}
+
+MeshOptimizeReport
+MeshOptimizer::Optimize(MeshComponent& mesh, unsigned int cacheSize) {
+    MeshOptimizeReport report;
+    report.cacheSize = cacheSize;
+    report.before = AnalyzeVertexCache(mesh.m_index.data(), mesh.m_index.size(), mesh.m_vertex.size(), cacheSize);
+
+    OptimizeVertexCache(mesh, cacheSize);
+    OptimizeVertexFetch(mesh);
+
+    report.after = AnalyzeVertexCache(mesh.m_index.data(), mesh.m_index.size(), mesh.m_vertex.size(), cacheSize);
+    return report;
+}
@@ -0,0 +1,527 @@
+#include "../include/MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <tuple>
+
+namespace
+{
+    const unsigned int kNone = ~0u;
+
+    // Peso de los planos que fijan los bordes abiertos (relativo al área de los triángulos)
+    const float kBorderWeight = 10.0f;
+
+    enum VertexKind : unsigned char {
+        KindManifold,   // Interior: puede colapsar a cualquier vecino
+        KindBorder,     // Borde abierto: sólo a lo largo del borde
+        KindSeam,       // Costura UV/normal de dos vértices: sólo a lo largo de la costura
+        KindLocked      // Topología compleja, varios subsets o costura con borde
+    };
+
+    // Cuádrica simétrica: pᵀAp + 2bᵀp + c, con w = área acumulada para normalizar el error
+    struct Quadric {
+        float a00, a11, a22, a10, a20, a21;
+        float b0, b1, b2;
+        float c;
+        float w;
+    };
+
+    void quadricAdd(Quadric& q, const Quadric& r) {
+        q.a00 += r.a00; q.a11 += r.a11; q.a22 += r.a22;
+        q.a10 += r.a10; q.a20 += r.a20; q.a21 += r.a21;
+        q.b0 += r.b0; q.b1 += r.b1; q.b2 += r.b2;
+        q.c += r.c;
+        q.w += r.w;
+    }
+
+    // Plano n·p + d = 0 (n unitaria) con peso @p weight
+    Quadric planeQuadric(const XMFLOAT3& n, float d, float weight) {
+        Quadric q;
+        q.a00 = weight * n.x * n.x; q.a11 = weight * n.y * n.y; q.a22 = weight * n.z * n.z;
+        q.a10 = weight * n.y * n.x; q.a20 = weight * n.z * n.x; q.a21 = weight * n.z * n.y;
+        q.b0 = weight * n.x * d; q.b1 = weight * n.y * d; q.b2 = weight * n.z * d;
+        q.c = weight * d * d;
+        q.w = weight;
+        return q;
+    }
+
+    // Distancia cuadrática media (ponderada por área) de p a los planos acumulados
+    float quadricError(const Quadric& q, const XMFLOAT3& p) {
+        const float rx = q.a00 * p.x + q.a10 * p.y + q.a20 * p.z + q.b0;
+        const float ry = q.a10 * p.x + q.a11 * p.y + q.a21 * p.z + q.b1;
+        const float rz = q.a20 * p.x + q.a21 * p.y + q.a22 * p.z + q.b2;
+        const float r = rx * p.x + ry * p.y + rz * p.z + q.b0 * p.x + q.b1 * p.y + q.b2 * p.z + q.c;
+        return std::fabs(r) / std::max(q.w, FLT_MIN);
+    }
+
+    XMFLOAT3 sub3(const XMFLOAT3& a, const XMFLOAT3& b) { return XMFLOAT3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    float    dot3(const XMFLOAT3& a, const XMFLOAT3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    XMFLOAT3 cross3(const XMFLOAT3& a, const XMFLOAT3& b) {
+        return XMFLOAT3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+    float    length3(const XMFLOAT3& a) { return std::sqrt(dot3(a, a)); }
+
+    struct Collapse {
+        unsigned int v0;
+        unsigned int v1;
+        float        cost;
+    };
+
+    /**
+     * Estado del simplificador para una malla. Las posiciones se normalizan a [0,1]^3 para que
+     * las cuádricas en float no pierdan precisión; los errores se devuelven en esa escala.
+     * Las cuádricas se acumulan entre llamadas a run(), así los LODs sucesivos parten del
+     * anterior y el error reportado ya incluye el de los niveles previos.
+     */
+    class Simplifier {
+    public:
+        Simplifier(const SimpleVertex* vertices, size_t vertexCount,
+            const std::vector<unsigned int>& tri)
+            : m_vertexCount(vertexCount), m_positions(vertexCount), m_posId(vertexCount),
+            m_wedge(vertexCount) {
+            normalizePositions(vertices);
+            buildPositionGroups();
+            buildQuadrics(tri);
+        }
+
+        float scale() const { return m_scale; }
+
+        // Simplifica tri/triSubset in situ hasta targetTriangles. Devuelve el error máximo aplicado.
+        float run(std::vector<unsigned int>& tri, std::vector<unsigned int>& triSubset, size_t targetTriangles) {
+            float maxError = 0.0f;
+            for (int pass = 0; pass < 100 && tri.size() / 3 > targetTriangles; ++pass) {
+                buildAdjacency(tri);
+                classify(tri, triSubset);
+
+                std::vector<Collapse> collapses;
+                gatherCollapses(tri, collapses);
+                if (collapses.empty()) break;
+                std::sort(collapses.begin(), collapses.end(),
+                    [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+                const size_t removed = applyCollapses(tri, collapses, tri.size() / 3 - targetTriangles, maxError);
+                if (removed == 0) break;
+                compact(tri, triSubset);
+            }
+            return std::sqrt(maxError);
+        }
+
+    private:
+        void normalizePositions(const SimpleVertex* vertices) {
+            XMFLOAT3 mn(FLT_MAX, FLT_MAX, FLT_MAX), mx(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (size_t v = 0; v < m_vertexCount; ++v) {
+                const XMFLOAT3& p = vertices[v].Pos;
+                mn.x = std::min(mn.x, p.x); mn.y = std::min(mn.y, p.y); mn.z = std::min(mn.z, p.z);
+                mx.x = std::max(mx.x, p.x); mx.y = std::max(mx.y, p.y); mx.z = std::max(mx.z, p.z);
+            }
+            m_scale = std::max(mx.x - mn.x, std::max(mx.y - mn.y, mx.z - mn.z));
+            const float inv = m_scale > 0.0f ? 1.0f / m_scale : 0.0f;
+            for (size_t v = 0; v < m_vertexCount; ++v) {
+                const XMFLOAT3& p = vertices[v].Pos;
+                m_positions[v] = XMFLOAT3((p.x - mn.x) * inv, (p.y - mn.y) * inv, (p.z - mn.z) * inv);
+            }
+        }
+
+        // Vértices con la misma posición exacta forman un anillo (m_wedge) con un id común
+        void buildPositionGroups() {
+            std::vector<unsigned int> order(m_vertexCount);
+            for (size_t v = 0; v < m_vertexCount; ++v) order[v] = unsigned(v);
+            auto key = [this](unsigned int v) {
+                uint32_t k[3];
+                memcpy(k, &m_positions[v], sizeof(k));
+                return std::make_tuple(k[0], k[1], k[2]);
+            };
+            std::sort(order.begin(), order.end(),
+                [&](unsigned int a, unsigned int b) { return key(a) < key(b); });
+
+            size_t first = 0;
+            for (size_t i = 1; i <= m_vertexCount; ++i) {
+                if (i < m_vertexCount && key(order[i]) == key(order[first])) continue;
+                for (size_t j = first; j < i; ++j) {
+                    m_posId[order[j]] = order[first];
+                    m_wedge[order[j]] = order[j + 1 < i ? j + 1 : first];
+                }
+                first = i;
+            }
+        }
+
+        void buildQuadrics(const std::vector<unsigned int>& tri) {
+            Quadric zero;
+            memset(&zero, 0, sizeof(zero));
+            m_quadrics.assign(m_vertexCount, zero);
+
+            for (size_t t = 0; t < tri.size(); t += 3) {
+                const XMFLOAT3& p0 = m_positions[tri[t]];
+                const XMFLOAT3 n = cross3(sub3(m_positions[tri[t + 1]], p0), sub3(m_positions[tri[t + 2]], p0));
+                const float len = length3(n);
+                if (len == 0.0f) continue;
+                const XMFLOAT3 un(n.x / len, n.y / len, n.z / len);
+                const float area = 0.5f * len;
+                const Quadric q = planeQuadric(un, -dot3(un, p0), area);
+                for (int k = 0; k < 3; ++k) quadricAdd(m_quadrics[m_posId[tri[t + k]]], q);
+            }
+
+            // Bordes abiertos (sin arista opuesta ni siquiera por posición): plano perpendicular
+            // a la cara que pasa por la arista, para que el borde no se desplace al colapsar
+            buildAdjacency(tri);
+            for (size_t t = 0; t < tri.size(); t += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const unsigned int a = tri[t + k], b = tri[t + (k + 1) % 3];
+                    if (hasPositionEdge(b, a)) continue;
+
+                    const XMFLOAT3& pa = m_positions[a];
+                    const XMFLOAT3& pc = m_positions[tri[t + (k + 2) % 3]];
+                    const XMFLOAT3 edge = sub3(m_positions[b], pa);
+                    const XMFLOAT3 n = cross3(edge, sub3(pc, pa));
+                    XMFLOAT3 m = cross3(edge, n);
+                    const float len = length3(m);
+                    if (len == 0.0f) continue;
+                    m = XMFLOAT3(m.x / len, m.y / len, m.z / len);
+                    const float weight = kBorderWeight * dot3(edge, edge);
+                    const Quadric q = planeQuadric(m, -dot3(m, pa), weight);
+                    quadricAdd(m_quadrics[m_posId[a]], q);
+                    quadricAdd(m_quadrics[m_posId[b]], q);
+                }
+            }
+        }
+
+        // Aristas salientes por vértice (CSR); m_edgeTri guarda el triángulo de cada arista
+        void buildAdjacency(const std::vector<unsigned int>& tri) {
+            m_edgeOffsets.assign(m_vertexCount + 1, 0);
+            for (unsigned int v : tri) ++m_edgeOffsets[v + 1];
+            for (size_t v = 0; v < m_vertexCount; ++v) m_edgeOffsets[v + 1] += m_edgeOffsets[v];
+
+            m_edgeTarget.resize(tri.size());
+            m_edgeTri.resize(tri.size());
+            std::vector<unsigned int> fill(m_edgeOffsets.begin(), m_edgeOffsets.end() - 1);
+            for (size_t t = 0; t < tri.size(); t += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const unsigned int slot = fill[tri[t + k]]++;
+                    m_edgeTarget[slot] = tri[t + (k + 1) % 3];
+                    m_edgeTri[slot] = unsigned(t / 3);
+                }
+            }
+        }
+
+        bool hasEdge(unsigned int a, unsigned int b) const {
+            for (unsigned int e = m_edgeOffsets[a]; e < m_edgeOffsets[a + 1]; ++e) {
+                if (m_edgeTarget[e] == b) return true;
+            }
+            return false;
+        }
+
+        // Arista a->b entre cualquier par de vértices con las posiciones de a y b
+        bool hasPositionEdge(unsigned int a, unsigned int b) const {
+            unsigned int w = a;
+            do {
+                for (unsigned int e = m_edgeOffsets[w]; e < m_edgeOffsets[w + 1]; ++e) {
+                    if (m_posId[m_edgeTarget[e]] == m_posId[b]) return true;
+                }
+                w = m_wedge[w];
+            } while (w != a);
+            return false;
+        }
+
+        void classify(const std::vector<unsigned int>& tri, const std::vector<unsigned int>& triSubset) {
+            m_kind.assign(m_vertexCount, KindManifold);
+            std::vector<unsigned int> subsetOf(m_vertexCount, kNone);
+            std::vector<unsigned int> openOut(m_vertexCount, 0), openIn(m_vertexCount, 0);
+            std::vector<unsigned int> openOutTarget(m_vertexCount, kNone), openInSource(m_vertexCount, kNone);
+
+            for (size_t t = 0; t < tri.size(); t += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const unsigned int a = tri[t + k], b = tri[t + (k + 1) % 3];
+                    const unsigned int s = triSubset[t / 3];
+                    if (subsetOf[a] == kNone) subsetOf[a] = s;
+                    else if (subsetOf[a] != s) m_kind[a] = KindLocked;
+
+                    if (!hasEdge(b, a)) {
+                        ++openOut[a]; openOutTarget[a] = b;
+                        ++openIn[b];  openInSource[b] = a;
+                    }
+                }
+            }
+
+            for (size_t v = 0; v < m_vertexCount; ++v) {
+                if (m_kind[v] == KindLocked || subsetOf[v] == kNone) continue;
+
+                const unsigned int w = m_wedge[v];
+                if (w == v) {
+                    // Un único vértice en esta posición
+                    if (openOut[v] == 0 && openIn[v] == 0) m_kind[v] = KindManifold;
+                    else if (openOut[v] == 1 && openIn[v] == 1) m_kind[v] = KindBorder;
+                    else m_kind[v] = KindLocked;
+                }
+                else if (m_wedge[w] == v && openOut[v] == 1 && openIn[v] == 1 &&
+                    openOut[w] == 1 && openIn[w] == 1 &&
+                    m_posId[openOutTarget[v]] == m_posId[openInSource[w]] &&
+                    m_posId[openInSource[v]] == m_posId[openOutTarget[w]]) {
+                    // Dos vértices cuyas aristas abiertas se emparejan por posición: costura
+                    m_kind[v] = KindSeam;
+                }
+                else {
+                    m_kind[v] = KindLocked;
+                }
+            }
+        }
+
+        bool canCollapse(unsigned int v0, unsigned int v1, bool openEdge) const {
+            switch (m_kind[v0]) {
+            case KindManifold:
+                return true;
+            case KindBorder:
+                return openEdge && m_kind[v1] == KindBorder;
+            case KindSeam: {
+                if (!openEdge || m_kind[v1] != KindSeam) return false;
+                // El otro lado de la costura debe tener la arista gemela
+                const unsigned int s0 = m_wedge[v0], s1 = m_wedge[v1];
+                return hasEdge(s0, s1) || hasEdge(s1, s0);
+            }
+            default:
+                return false;
+            }
+        }
+
+        void gatherCollapses(const std::vector<unsigned int>& tri, std::vector<Collapse>& out) const {
+            out.reserve(tri.size());
+            for (size_t t = 0; t < tri.size(); t += 3) {
+                for (int k = 0; k < 3; ++k) {
+                    const unsigned int a = tri[t + k], b = tri[t + (k + 1) % 3];
+                    const bool open = !hasEdge(b, a);
+                    // Las aristas interiores aparecen dos veces: se evalúan una sola
+                    if (!open && a > b) continue;
+
+                    Collapse best = { kNone, kNone, FLT_MAX };
+                    if (canCollapse(a, b, open)) {
+                        best = { a, b, quadricError(m_quadrics[m_posId[a]], m_positions[b]) };
+                    }
+                    if (canCollapse(b, a, open)) {
+                        const float cost = quadricError(m_quadrics[m_posId[b]], m_positions[a]);
+                        if (cost < best.cost) best = { b, a, cost };
+                    }
+                    if (best.v0 != kNone) out.push_back(best);
+                }
+            }
+        }
+
+        unsigned int resolve(unsigned int v) const { return m_remap[v]; }
+
+        // true si mover v0 a la posición de v1 invierte algún triángulo que sobrevive
+        bool flips(unsigned int v0, unsigned int v1) const {
+            const XMFLOAT3& p0 = m_positions[v0];
+            const XMFLOAT3& p1 = m_positions[v1];
+            for (unsigned int e = m_edgeOffsets[v0]; e < m_edgeOffsets[v0 + 1]; ++e) {
+                const unsigned int t = m_edgeTri[e];
+                const unsigned int b = resolve(m_tri[t * 3 + 0]) == v0 ? 1 : (resolve(m_tri[t * 3 + 1]) == v0 ? 2 : 0);
+                const unsigned int vb = resolve(m_tri[t * 3 + b]);
+                const unsigned int vc = resolve(m_tri[t * 3 + (b + 1) % 3]);
+                if (vb == v1 || vc == v1 || vb == vc) continue;
+
+                const XMFLOAT3& pb = m_positions[vb];
+                const XMFLOAT3& pc = m_positions[vc];
+                const XMFLOAT3 nOld = cross3(sub3(pb, p0), sub3(pc, p0));
+                const XMFLOAT3 nNew = cross3(sub3(pb, p1), sub3(pc, p1));
+                if (dot3(nOld, nNew) <= 0.25f * length3(nOld) * length3(nNew)) return true;
+            }
+            return false;
+        }
+
+        unsigned int trianglesRemoved(unsigned int v0, unsigned int v1) const {
+            unsigned int count = 0;
+            for (unsigned int e = m_edgeOffsets[v0]; e < m_edgeOffsets[v0 + 1]; ++e) {
+                const unsigned int t = m_edgeTri[e];
+                for (int k = 0; k < 3; ++k) {
+                    if (resolve(m_tri[t * 3 + k]) == v1) { ++count; break; }
+                }
+            }
+            return count;
+        }
+
+        // Aplica colapsos en orden de coste; cada posición participa como mucho en uno por pasada
+        size_t applyCollapses(std::vector<unsigned int>& tri, const std::vector<Collapse>& collapses,
+            size_t needed, float& maxError) {
+            m_tri = tri.data();
+            m_remap.resize(m_vertexCount);
+            for (size_t v = 0; v < m_vertexCount; ++v) m_remap[v] = unsigned(v);
+            std::vector<char> locked(m_vertexCount, 0);
+
+            size_t removed = 0;
+            for (const Collapse& c : collapses) {
+                if (removed >= needed) break;
+                const unsigned int v0 = c.v0, v1 = c.v1;
+                if (locked[m_posId[v0]] || locked[m_posId[v1]]) continue;
+
+                const bool seam = m_kind[v0] == KindSeam;
+                const unsigned int s0 = m_wedge[v0], s1 = m_wedge[v1];
+                if (flips(v0, v1) || (seam && flips(s0, s1))) continue;
+
+                removed += trianglesRemoved(v0, v1) + (seam ? trianglesRemoved(s0, s1) : 0);
+                m_remap[v0] = v1;
+                if (seam) m_remap[s0] = s1;
+
+                locked[m_posId[v0]] = locked[m_posId[v1]] = 1;
+                quadricAdd(m_quadrics[m_posId[v1]], m_quadrics[m_posId[v0]]);
+                maxError = std::max(maxError, c.cost);
+            }
+
+            for (unsigned int& v : tri) v = m_remap[v];
+            m_tri = nullptr;
+            return removed;
+        }
+
+        // Elimina triángulos degenerados conservando el orden (y por tanto los rangos por subset)
+        static void compact(std::vector<unsigned int>& tri, std::vector<unsigned int>& triSubset) {
+            size_t out = 0;
+            for (size_t t = 0; t < triSubset.size(); ++t) {
+                const unsigned int a = tri[t * 3], b = tri[t * 3 + 1], c = tri[t * 3 + 2];
+                if (a == b || b == c || a == c) continue;
+                tri[out * 3] = a; tri[out * 3 + 1] = b; tri[out * 3 + 2] = c;
+                triSubset[out++] = triSubset[t];
+            }
+            tri.resize(out * 3);
+            triSubset.resize(out);
+        }
+
+    private:
+        size_t                    m_vertexCount;
+        float                     m_scale = 1.0f;
+        std::vector<XMFLOAT3>     m_positions;
+        std::vector<unsigned int> m_posId;
+        std::vector<unsigned int> m_wedge;
+        std::vector<Quadric>      m_quadrics;
+        std::vector<unsigned char> m_kind;
+
+        std::vector<unsigned int> m_edgeOffsets;
+        std::vector<unsigned int> m_edgeTarget;
+        std::vector<unsigned int> m_edgeTri;
+
+        std::vector<unsigned int> m_remap;
+        const unsigned int*       m_tri = nullptr;
+    };
+
+    // Copia los triángulos como rangos de la cadena, uno por subset de origen
+    void appendLevel(const std::vector<unsigned int>& tri, const std::vector<unsigned int>& triSubset,
+        const std::vector<MeshSubset>& sourceSubsets, float ratio, float error, MeshLODChain& chain) {
+        MeshLOD level;
+        level.targetRatio = ratio;
+        level.error = error;
+        level.triangleCount = triSubset.size();
+        level.subsets = sourceSubsets;
+
+        const unsigned int base = unsigned(chain.indices.size());
+        for (MeshSubset& subset : level.subsets) {
+            subset.startIndex = base;
+            subset.indexCount = 0;
+        }
+        // triSubset no decrece: los triángulos de cada subset siguen contiguos
+        for (size_t t = 0; t < triSubset.size(); ++t) level.subsets[triSubset[t]].indexCount += 3;
+        unsigned int start = base;
+        for (MeshSubset& subset : level.subsets) {
+            subset.startIndex = start;
+            start += subset.indexCount;
+        }
+
+        chain.indices.insert(chain.indices.end(), tri.begin(), tri.end());
+        chain.levels.push_back(level);
+    }
+}
+
+float
+MeshSimplifier::Simplify(const SimpleVertex* vertices, size_t vertexCount,
+    std::vector<unsigned int>& indices, size_t targetTriangles) {
+    indices.resize(indices.size() / 3 * 3);
+    for (unsigned int i : indices) {
+        if (i >= vertexCount) {
+            ERROR(L"MeshSimplifier", L"Simplify", L"Índice fuera de rango");
+            return 0.0f;
+        }
+    }
+
+    std::vector<unsigned int> triSubset(indices.size() / 3, 0);
+    Simplifier simplifier(vertices, vertexCount, indices);
+    const float error = simplifier.run(indices, triSubset, targetTriangles);
+    return error * simplifier.scale();
+}
+
+void
+MeshSimplifier::BuildLODChain(const SimpleVertex* vertices, size_t vertexCount,
+    const unsigned int* indices, size_t indexCount,
+    const std::vector<MeshSubset>& subsets,
+    const std::vector<float>& ratios,
+    MeshLODChain& outChain) {
+    outChain.indices.clear();
+    outChain.levels.clear();
+    outChain.ratios = ratios;
+    if (!vertices || !indices || indexCount < 3) return;
+
+    std::vector<MeshSubset> ranges = subsets;
+    if (ranges.empty()) {
+        MeshSubset whole;
+        whole.indexCount = unsigned(indexCount);
+        ranges.push_back(whole);
+    }
+
+    // Lista de triángulos en orden de subset, con el subset de cada uno
+    std::vector<unsigned int> tri;
+    std::vector<unsigned int> triSubset;
+    tri.reserve(indexCount);
+    triSubset.reserve(indexCount / 3);
+    for (size_t s = 0; s < ranges.size(); ++s) {
+        const MeshSubset& r = ranges[s];
+        if (size_t(r.startIndex) + r.indexCount > indexCount) {
+            ERROR(L"MeshSimplifier", L"BuildLODChain", L"Subset fuera de rango");
+            return;
+        }
+        for (unsigned int i = 0; i + 2 < r.indexCount; i += 3) {
+            const unsigned int* t = indices + r.startIndex + i;
+            if (t[0] >= vertexCount || t[1] >= vertexCount || t[2] >= vertexCount) {
+                ERROR(L"MeshSimplifier", L"BuildLODChain", L"Índice fuera de rango");
+                return;
+            }
+            tri.insert(tri.end(), t, t + 3);
+            triSubset.push_back(unsigned(s));
+        }
+    }
+
+    const size_t sourceTriangles = triSubset.size();
+    outChain.indices.reserve(tri.size() * 2);
+    appendLevel(tri, triSubset, ranges, 1.0f, 0.0f, outChain);
+
+    Simplifier simplifier(vertices, vertexCount, tri);
+    float error = 0.0f;
+    for (float ratio : ratios) {
+        const size_t target = size_t(double(sourceTriangles) * ratio);
+        if (target >= triSubset.size()) continue;
+
+        error = std::max(error, simplifier.run(tri, triSubset, target) * simplifier.scale());
+        // Un nivel que no logra reducir nada no aporta
+        if (triSubset.size() == outChain.levels.back().triangleCount) break;
+        appendLevel(tri, triSubset, ranges, ratio, error, outChain);
+    }
+}
+
+void
+MeshSimplifier::BuildLODChain(const MeshComponent& mesh, MeshLODChain& outChain) {
+    static const std::vector<float> kDefaultRatios = { 0.5f, 0.25f, 0.125f, 0.0625f };
+    BuildLODChain(mesh.m_vertex.data(), mesh.m_vertex.size(), mesh.m_index.data(), mesh.m_index.size(),
+        mesh.m_subsets, kDefaultRatios, outChain);
+}
+
+float
+MeshSimplifier::ProjectedError(float error, float distance, float fovY, float viewportHeight) {
+    if (distance <= 0.0f) return FLT_MAX;
+    return error * viewportHeight / (2.0f * distance * std::tan(0.5f * fovY));
+}
+
+unsigned int
+MeshSimplifier::SelectLOD(const MeshLODChain& chain, float distance, float fovY, float viewportHeight,
+    float maxPixelError) {
+    // El error es acumulado (no decrece con el nivel): basta el último que cumpla
+    unsigned int lod = 0;
+    for (size_t i = 1; i < chain.levels.size(); ++i) {
+        if (ProjectedError(chain.levels[i].error, distance, fovY, viewportHeight) > maxPixelError) break;
+        lod = unsigned(i);
+    }
+    return lod;
+}
@@ -0,0 +1,255 @@
+#include "../include/MeshletBuilder.h"
+#include <algorithm>
+#include <cmath>
+#include <emmintrin.h>
+
+namespace
+{
+    // Esfera (centro del AABB + distancia máxima) y cono de normales de un meshlet
+    void computeBounds(const SimpleVertex* vertices, const Meshlet& m, MeshletData& out) {
+        const unsigned int* verts = out.vertices.data() + m.vertexOffset;
+        const unsigned char* tris = out.triangles.data() + m.triangleOffset;
+
+        XMFLOAT3 mn = vertices[verts[0]].Pos, mx = mn;
+        for (unsigned int i = 1; i < m.vertexCount; ++i) {
+            const XMFLOAT3& p = vertices[verts[i]].Pos;
+            mn.x = std::min(mn.x, p.x); mn.y = std::min(mn.y, p.y); mn.z = std::min(mn.z, p.z);
+            mx.x = std::max(mx.x, p.x); mx.y = std::max(mx.y, p.y); mx.z = std::max(mx.z, p.z);
+        }
+        const XMFLOAT3 c(0.5f * (mn.x + mx.x), 0.5f * (mn.y + mx.y), 0.5f * (mn.z + mx.z));
+        float r2 = 0.0f;
+        for (unsigned int i = 0; i < m.vertexCount; ++i) {
+            const XMFLOAT3& p = vertices[verts[i]].Pos;
+            const float dx = p.x - c.x, dy = p.y - c.y, dz = p.z - c.z;
+            r2 = std::max(r2, dx * dx + dy * dy + dz * dz);
+        }
+
+        // Eje = promedio de las normales de cara unitarias; el cono cubre la más alejada
+        std::vector<XMFLOAT3> normals;
+        normals.reserve(m.triangleCount);
+        XMFLOAT3 axis(0, 0, 0);
+        for (unsigned int t = 0; t < m.triangleCount; ++t) {
+            const XMFLOAT3& a = vertices[verts[tris[t * 3 + 0]]].Pos;
+            const XMFLOAT3& b = vertices[verts[tris[t * 3 + 1]]].Pos;
+            const XMFLOAT3& d = vertices[verts[tris[t * 3 + 2]]].Pos;
+            const float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+            const float vx = d.x - a.x, vy = d.y - a.y, vz = d.z - a.z;
+            XMFLOAT3 n(uy * vz - uz * vy, uz * vx - ux * vz, ux * vy - uy * vx);
+            const float len = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+            if (len == 0.0f) continue;
+            n = XMFLOAT3(n.x / len, n.y / len, n.z / len);
+            normals.push_back(n);
+            axis.x += n.x; axis.y += n.y; axis.z += n.z;
+        }
+
+        float cutoff = 2.0f;   // Nunca se descarta por el cono
+        const float axisLen = std::sqrt(axis.x * axis.x + axis.y * axis.y + axis.z * axis.z);
+        if (axisLen > 0.0f) {
+            axis = XMFLOAT3(axis.x / axisLen, axis.y / axisLen, axis.z / axisLen);
+            float minDot = 1.0f;
+            for (const XMFLOAT3& n : normals) {
+                minDot = std::min(minDot, n.x * axis.x + n.y * axis.y + n.z * axis.z);
+            }
+            // Con normales casi opuestas el cono no descartaría nada útil
+            if (minDot > 0.1f) cutoff = std::sqrt(1.0f - minDot * minDot);
+        }
+
+        out.centerX.push_back(c.x); out.centerY.push_back(c.y); out.centerZ.push_back(c.z);
+        out.radius.push_back(std::sqrt(r2));
+        out.coneAxisX.push_back(axis.x); out.coneAxisY.push_back(axis.y); out.coneAxisZ.push_back(axis.z);
+        out.coneCutoff.push_back(cutoff);
+    }
+}
+
+void
+MeshletBuilder::Build(const SimpleVertex* vertices, size_t vertexCount,
+    const unsigned int* indices, size_t indexCount,
+    const std::vector<MeshSubset>& subsets,
+    MeshletData& out,
+    unsigned int maxVertices,
+    unsigned int maxTriangles) {
+    out = MeshletData();
+    if (!vertices || !indices || indexCount < 3) return;
+
+    // Los índices locales se guardan en un byte
+    maxVertices = std::min(std::max(maxVertices, 3u), 256u);
+    maxTriangles = std::max(maxTriangles, 1u);
+
+    out.subsets = subsets;
+    if (out.subsets.empty()) {
+        MeshSubset whole;
+        whole.indexCount = static_cast<unsigned int>(indexCount);
+        out.subsets.push_back(whole);
+    }
+    out.meshlets.reserve(indexCount / 3 / maxTriangles + out.subsets.size());
+    out.vertices.reserve(indexCount / 2);
+    out.triangles.reserve(indexCount);
+
+    std::vector<unsigned int>  stamp(vertexCount, 0);
+    std::vector<unsigned char> local(vertexCount, 0);
+    unsigned int meshletId = 0;
+    Meshlet current;
+
+    auto finish = [&]() {
+        if (current.triangleCount > 0) {
+            computeBounds(vertices, current, out);
+            out.meshlets.push_back(current);
+            out.triangleCount += current.triangleCount;
+        }
+        current = Meshlet();
+        current.vertexOffset = static_cast<unsigned int>(out.vertices.size());
+        current.triangleOffset = static_cast<unsigned int>(out.triangles.size());
+        ++meshletId;
+    };
+
+    for (size_t s = 0; s < out.subsets.size(); ++s) {
+        const MeshSubset& subset = out.subsets[s];
+        if (size_t(subset.startIndex) + subset.indexCount > indexCount) {
+            ERROR(L"MeshletBuilder", L"Build", L"Subset fuera de rango");
+            out = MeshletData();
+            return;
+        }
+
+        finish();
+        current.subset = static_cast<unsigned int>(s);
+        const unsigned int* idx = indices + subset.startIndex;
+        for (unsigned int i = 0; i + 2 < subset.indexCount; i += 3) {
+            const unsigned int a = idx[i], b = idx[i + 1], c = idx[i + 2];
+            if (a >= vertexCount || b >= vertexCount || c >= vertexCount) {
+                ERROR(L"MeshletBuilder", L"Build", L"Índice fuera de rango");
+                out = MeshletData();
+                return;
+            }
+            const unsigned int added = (stamp[a] != meshletId) +
+                (stamp[b] != meshletId && b != a) +
+                (stamp[c] != meshletId && c != a && c != b);
+            if (current.vertexCount + added > maxVertices || current.triangleCount + 1 > maxTriangles) {
+                finish();
+                current.subset = static_cast<unsigned int>(s);
+            }
+
+            for (int k = 0; k < 3; ++k) {
+                const unsigned int v = idx[i + k];
+                if (stamp[v] != meshletId) {
+                    stamp[v] = meshletId;
+                    local[v] = static_cast<unsigned char>(current.vertexCount++);
+                    out.vertices.push_back(v);
+                    if (v < subset.baseVertex || v - subset.baseVertex >= MeshComponent::kMaxVertices16) {
+                        out.fitsIndex16 = false;
+                    }
+                }
+                out.triangles.push_back(local[v]);
+            }
+            ++current.triangleCount;
+        }
+    }
+    finish();
+
+    // Relleno SoA hasta múltiplo de 4 (radio 0, cono desactivado)
+    while (out.radius.size() % 4 != 0) {
+        out.centerX.push_back(0.0f); out.centerY.push_back(0.0f); out.centerZ.push_back(0.0f);
+        out.radius.push_back(0.0f);
+        out.coneAxisX.push_back(0.0f); out.coneAxisY.push_back(0.0f); out.coneAxisZ.push_back(0.0f);
+        out.coneCutoff.push_back(2.0f);
+    }
+}
+
+void
+MeshletBuilder::Build(const MeshComponent& mesh, MeshletData& out) {
+    Build(mesh.m_vertex.data(), mesh.m_vertex.size(), mesh.m_index.data(), mesh.m_index.size(),
+        mesh.m_subsets, out);
+}
+
+size_t
+MeshletBuilder::Cull(const MeshletData& data, const Frustum& frustum, const XMFLOAT3& cameraPosition,
+    bool coneCulling, std::vector<unsigned char>& outVisible) {
+    const size_t count = data.meshlets.size();
+    outVisible.resize(count);
+
+    const __m128 camX = _mm_set1_ps(cameraPosition.x);
+    const __m128 camY = _mm_set1_ps(cameraPosition.y);
+    const __m128 camZ = _mm_set1_ps(cameraPosition.z);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t visibleCount = 0;
+    for (size_t i = 0; i < count; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&data.centerX[i]);
+        const __m128 cy = _mm_loadu_ps(&data.centerY[i]);
+        const __m128 cz = _mm_loadu_ps(&data.centerZ[i]);
+        const __m128 r = _mm_loadu_ps(&data.radius[i]);
+        const __m128 negR = _mm_sub_ps(zero, r);
+
+        // Fuera si la esfera queda entera detrás de algún plano
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (const XMFLOAT4& p : frustum.m_planes) {
+            const __m128 d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(p.x)), _mm_mul_ps(cy, _mm_set1_ps(p.y))),
+                _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(p.z)), _mm_set1_ps(p.w)));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(d, negR));
+        }
+
+        if (coneCulling) {
+            const __m128 dx = _mm_sub_ps(cx, camX);
+            const __m128 dy = _mm_sub_ps(cy, camY);
+            const __m128 dz = _mm_sub_ps(cz, camZ);
+            const __m128 len = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                _mm_mul_ps(dz, dz)));
+            const __m128 dp = _mm_add_ps(_mm_add_ps(
+                _mm_mul_ps(dx, _mm_loadu_ps(&data.coneAxisX[i])),
+                _mm_mul_ps(dy, _mm_loadu_ps(&data.coneAxisY[i]))),
+                _mm_mul_ps(dz, _mm_loadu_ps(&data.coneAxisZ[i])));
+            const __m128 limit = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&data.coneCutoff[i]), len), r);
+            visible = _mm_andnot_ps(_mm_cmpge_ps(dp, limit), visible);
+        }
+
+        const int mask = _mm_movemask_ps(visible);
+        const size_t lanes = std::min<size_t>(4, count - i);
+        for (size_t k = 0; k < lanes; ++k) {
+            const unsigned char v = static_cast<unsigned char>((mask >> k) & 1);
+            outVisible[i + k] = v;
+            visibleCount += v;
+        }
+    }
+    return visibleCount;
+}
+
+size_t
+MeshletBuilder::WriteVisibleIndices(const MeshletData& data, const std::vector<unsigned char>& visible,
+    bool use16Bit, void* dst, size_t capacity, std::vector<MeshSubset>& outRanges) {
+    outRanges.clear();
+    if (!dst || visible.size() != data.meshlets.size()) return 0;
+
+    uint16_t* dst16 = static_cast<uint16_t*>(dst);
+    uint32_t* dst32 = static_cast<uint32_t*>(dst);
+    size_t written = 0;
+
+    for (size_t i = 0; i < data.meshlets.size(); ++i) {
+        if (!visible[i]) continue;
+        const Meshlet& m = data.meshlets[i];
+        if (written + m.triangleCount * 3 > capacity) break;
+
+        const MeshSubset& subset = data.subsets[m.subset];
+        // Los meshlets de un subset son consecutivos: un rango nuevo sólo al cambiar de subset
+        if (outRanges.empty() || outRanges.back().materialId != subset.materialId ||
+            outRanges.back().baseVertex != subset.baseVertex) {
+            MeshSubset range = subset;
+            range.startIndex = static_cast<unsigned int>(written);
+            range.indexCount = 0;
+            outRanges.push_back(range);
+        }
+
+        const unsigned int* verts = data.vertices.data() + m.vertexOffset;
+        const unsigned char* tris = data.triangles.data() + m.triangleOffset;
+        const unsigned int base = subset.baseVertex;
+        const unsigned int count = m.triangleCount * 3;
+        if (use16Bit) {
+            for (unsigned int k = 0; k < count; ++k) dst16[written + k] = static_cast<uint16_t>(verts[tris[k]] - base);
+        }
+        else {
+            for (unsigned int k = 0; k < count; ++k) dst32[written + k] = verts[tris[k]] - base;
+        }
+        written += count;
+        outRanges.back().indexCount += count;
+    }
+    return written;
+}
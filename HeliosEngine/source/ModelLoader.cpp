@@ -1,41 +1,175 @@
 ﻿#include "../include/ModelLoader.h" 
-#include <iostream>
-#include <fstream>
-#include <sstream>
+#include "../include/MappedFile.h"
+#include "../include/VertexIndexTable.h"
+#include "../include/MeshCache.h"
+#include "../include/MeshOptimizer.h"
+#include "../include/MeshNormals.h"
+#include "../include/JobSystem.h"
 #include <string>
 #include <vector>
-#include <map>
-#include <tuple>
 #include <cmath>
+#include <algorithm>
+#include <functional>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
 
 // -----------------------------
 // Helpers (namespace anónimo)
 // -----------------------------
 namespace
 {
-    inline void trim(std::string& s) {
-        size_t b = s.find_first_not_of(" \t\r\n");
-        size_t e = s.find_last_not_of(" \t\r\n");
-        if (b == std::string::npos) { s.clear(); return; }
-        s = s.substr(b, e - b + 1);
+    // Separadores dentro de una línea (mismo criterio que isspace, sin '\n')
+    inline bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    inline const char* skipBlanks(const char* p, const char* end) {
+        while (p < end && isBlank(*p)) ++p;
+        return p;
+    }
+
+    inline const char* tokenEnd(const char* p, const char* end) {
+        while (p < end && !isBlank(*p)) ++p;
+        return p;
+    }
+
+    // Fin del texto útil de [p, end) sin separadores finales
+    inline const char* trimEnd(const char* p, const char* end) {
+        while (end > p && isBlank(end[-1])) --end;
+        return end;
+    }
+
+    // Compara la palabra clave [key, keyEnd) con un literal
+    inline bool keyEquals(const char* key, const char* keyEnd, const char* word) {
+        const size_t len = strlen(word);
+        return size_t(keyEnd - key) == len && memcmp(key, word, len) == 0;
     }
 
-    
-    inline std::tuple<int, int, int> parseFaceIndex(const std::string& token) {
-        int v = 0, vt = 0, vn = 0;
-        std::stringstream ss(token);
-        std::string a, b, c;
+    // Directorio (con separador final) de una ruta; vacío si no tiene
+    inline std::string directoryOf(const std::string& path) {
+        const size_t pos = path.find_last_of("\\/");
+        return (pos == std::string::npos) ? std::string() : path.substr(0, pos + 1);
+    }
 
-        if (!std::getline(ss, a, '/')) return std::make_tuple(0, 0, 0);
-        if (!a.empty()) v = std::stoi(a);
+    inline bool isAbsolutePath(const std::string& path) {
+        return !path.empty() &&
+            (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+    }
 
-        if (std::getline(ss, b, '/')) {
-            if (!b.empty()) vt = std::stoi(b);
-            if (std::getline(ss, c, '/')) {
-                if (!c.empty()) vn = std::stoi(c);
+    // Potencias de 10 representables sin error en float (5^10 < 2^24)
+    const float kPow10f[] = {
+        1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+    };
+
+    // Parser de float estilo from_chars sobre [p, end).
+    // Camino rápido: mantisa <= 2^24 y |exp| <= 10 -> una sola operación IEEE,
+    // que da el mismo resultado correctamente redondeado que strtof/operator>>.
+    // El resto de casos (mantisas largas, inf/nan...) se delega a strtof
+    // sobre un buffer en la pila, sin tocar el heap.
+    inline const char* parseFloat(const char* p, const char* end, float& out) {
+        p = skipBlanks(p, end);
+        const char* tokBegin = p;
+        const char* tokLast = tokenEnd(p, end);
+
+        const char* q = p;
+        bool negative = false;
+        if (q < tokLast && (*q == '-' || *q == '+')) { negative = (*q == '-'); ++q; }
+
+        uint64_t mantissa = 0;
+        int      digits = 0;
+        int      exp10 = 0;
+        bool     any = false;
+
+        while (q < tokLast && isDigit(*q)) {
+            if (digits < 19) {
+                mantissa = mantissa * 10 + uint64_t(*q - '0');
+                if (mantissa) ++digits;
             }
+            else {
+                ++exp10;
+            }
+            any = true; ++q;
         }
-        return std::make_tuple(v, vt, vn);
+        if (q < tokLast && *q == '.') {
+            ++q;
+            while (q < tokLast && isDigit(*q)) {
+                if (digits < 19) {
+                    mantissa = mantissa * 10 + uint64_t(*q - '0');
+                    if (mantissa) ++digits;
+                    --exp10;
+                }
+                any = true; ++q;
+            }
+        }
+        if (any && q < tokLast && (*q == 'e' || *q == 'E')) {
+            const char* e = q + 1;
+            bool expNeg = false;
+            if (e < tokLast && (*e == '-' || *e == '+')) { expNeg = (*e == '-'); ++e; }
+            if (e < tokLast && isDigit(*e)) {
+                int ev = 0;
+                while (e < tokLast && isDigit(*e)) {
+                    if (ev < 10000) ev = ev * 10 + (*e - '0');
+                    ++e;
+                }
+                exp10 += expNeg ? -ev : ev;
+                q = e;
+            }
+        }
+
+        if (any && q == tokLast && mantissa <= (1u << 24) && exp10 >= -10 && exp10 <= 10) {
+            float f = float(mantissa);
+            f = (exp10 < 0) ? f / kPow10f[-exp10] : f * kPow10f[exp10];
+            out = negative ? -f : f;
+            return tokLast;
+        }
+
+        // Camino lento: copia acotada del token y strtof
+        char buf[64];
+        size_t n = size_t(tokLast - tokBegin);
+        if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+        memcpy(buf, tokBegin, n);
+        buf[n] = '\0';
+        char* parsedEnd = nullptr;
+        out = strtof(buf, &parsedEnd);
+        if (parsedEnd == buf) out = 0.0f;
+        return tokLast;
+    }
+
+    // Entero con signo estilo stoi; se detiene en el primer carácter no numérico
+    inline const char* parseInt(const char* p, const char* end, int& out) {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) { negative = (*p == '-'); ++p; }
+        // Satura en INT_MAX: un índice que no cabe en int queda fuera de rango y se rechaza
+        int value = 0;
+        while (p < end && isDigit(*p)) {
+            const int digit = *p - '0';
+            value = (value > (INT_MAX - digit) / 10) ? INT_MAX : value * 10 + digit;
+            ++p;
+        }
+        out = negative ? -value : value;
+        return p;
+    }
+
+    // Token de cara "v", "v/vt", "v//vn" o "v/vt/vn" sobre [p, end)
+    inline void parseFaceIndex(const char* p, const char* end, int& v, int& vt, int& vn) {
+        v = 0; vt = 0; vn = 0;
+        p = parseInt(p, end, v);
+        while (p < end && *p != '/') ++p;
+        if (p == end) return;
+
+        p = parseInt(p + 1, end, vt);
+        while (p < end && *p != '/') ++p;
+        if (p == end) return;
+
+        parseInt(p + 1, end, vn);
     }
 
     // Convierte índice OBJ
@@ -46,11 +180,213 @@ namespace
         else               return 0;    
     }
 
-    inline XMFLOAT3 normalize(const XMFLOAT3& v) {
-        float len = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
-        if (len <= 1e-8f) return XMFLOAT3(0, 0, 0);
-        return XMFLOAT3(v.x / len, v.y / len, v.z / len);
+    // Recorre las líneas con contenido de [begin, end) e invoca
+    // fn(keyBegin, keyEnd, lineEnd) con la palabra clave de cada registro.
+    template <typename Fn>
+    inline void forEachRecord(const char* begin, const char* end, Fn&& fn) {
+        const char* cursor = begin;
+        while (cursor < end) {
+            const char* lineEnd = static_cast<const char*>(memchr(cursor, '\n', size_t(end - cursor)));
+            if (!lineEnd) lineEnd = end;
+
+            const char* p = skipBlanks(cursor, lineEnd);
+            cursor = (lineEnd < end) ? lineEnd + 1 : end;
+            if (p == lineEnd || *p == '#') continue;
+
+            fn(p, tokenEnd(p, lineEnd), lineEnd);
+        }
+    }
+
+    // Tipo de registro según su palabra clave
+    enum class RecordKind { Position, TexCoord, Normal, Face, Smoothing, UseMaterial, MaterialLib, Other };
+
+    inline RecordKind classify(const char* key, const char* keyEnd) {
+        const size_t len = size_t(keyEnd - key);
+        if (len == 1 && key[0] == 'v') return RecordKind::Position;
+        if (len == 1 && key[0] == 'f') return RecordKind::Face;
+        if (len == 1 && key[0] == 's') return RecordKind::Smoothing;
+        if (len == 2 && key[0] == 'v' && key[1] == 't') return RecordKind::TexCoord;
+        if (len == 2 && key[0] == 'v' && key[1] == 'n') return RecordKind::Normal;
+        if (keyEquals(key, keyEnd, "usemtl")) return RecordKind::UseMaterial;
+        if (keyEquals(key, keyEnd, "mtllib")) return RecordKind::MaterialLib;
+        return RecordKind::Other;
+    }
+
+    // Por debajo de este tamaño por hilo no compensa paralelizar
+    const size_t kMinBytesPerChunk = 4u << 20;
+}
+
+// ----------------------------------------------------------
+// Resultado del parseo de un rango de líneas del OBJ
+// ----------------------------------------------------------
+struct OBJParser::ParseChunk {
+    std::vector<XMFLOAT3>                 positions;
+    std::vector<XMFLOAT2>                 texCoords;
+    std::vector<XMFLOAT3>                 normals;
+
+    // Esquinas ya resueltas/validadas de todas las caras, y su tamaño por cara (>= 3)
+    std::vector<OBJParser::VertexIndices> corners;
+    std::vector<unsigned int>             faceSizes;
+
+    // usemtl: (cara local a partir de la cual aplica, nombre del material)
+    std::vector<std::pair<unsigned int, std::string>> materialSwitches;
+
+    // s: (cara local a partir de la cual aplica, grupo de suavizado; 0 = caras planas)
+    std::vector<std::pair<unsigned int, int>> smoothingSwitches;
+
+    // mtllib: archivos .mtl en orden de aparición
+    std::vector<std::string>              materialLibs;
+};
+
+void
+OBJParser::CountRecords(const char* begin, const char* end, ChunkBase& outCounts) {
+    outCounts = ChunkBase();
+    forEachRecord(begin, end, [&](const char* key, const char* keyEnd, const char*) {
+        switch (classify(key, keyEnd)) {
+        case RecordKind::Position: ++outCounts.positions; break;
+        case RecordKind::TexCoord: ++outCounts.texCoords; break;
+        case RecordKind::Normal:   ++outCounts.normals;   break;
+        default: break;
+        }
+    });
+}
+
+void
+OBJParser::ParseRange(const char* begin, const char* end, const ChunkBase& base,
+    bool flipV, ParseChunk& out) {
+    forEachRecord(begin, end, [&](const char* key, const char* keyEnd, const char* lineEnd) {
+        switch (classify(key, keyEnd)) {
+        case RecordKind::Position: {
+            XMFLOAT3 pos(0, 0, 0);
+            const char* q = parseFloat(keyEnd, lineEnd, pos.x);
+            q = parseFloat(q, lineEnd, pos.y);
+            parseFloat(q, lineEnd, pos.z);
+            out.positions.push_back(pos);
+            break;
+        }
+        case RecordKind::TexCoord: {
+            XMFLOAT2 t(0, 0);
+            const char* q = parseFloat(keyEnd, lineEnd, t.x);
+            parseFloat(q, lineEnd, t.y);
+            if (flipV) t.y = 1.0f - t.y;
+            out.texCoords.push_back(t);
+            break;
+        }
+        case RecordKind::Normal: {
+            XMFLOAT3 n(0, 0, 0);
+            const char* q = parseFloat(keyEnd, lineEnd, n.x);
+            q = parseFloat(q, lineEnd, n.y);
+            parseFloat(q, lineEnd, n.z);
+            out.normals.push_back(n);
+            break;
+        }
+        case RecordKind::Face: {
+            // Tamaños globales (con slot 0) vistos hasta esta línea: así los
+            // índices relativos resuelven igual sin importar dónde empieza el chunk
+            const size_t numPositions = 1 + base.positions + out.positions.size();
+            const size_t numTexCoords = 1 + base.texCoords + out.texCoords.size();
+            const size_t numNormals = 1 + base.normals + out.normals.size();
+
+            const size_t firstCorner = out.corners.size();
+            const char* q = skipBlanks(keyEnd, lineEnd);
+            while (q < lineEnd) {
+                const char* vEnd = tokenEnd(q, lineEnd);
+                int iv = 0, ivt = 0, ivn = 0;
+                parseFaceIndex(q, vEnd, iv, ivt, ivn);
+                q = skipBlanks(vEnd, lineEnd);
+
+                iv = resolveIndex(iv, numPositions);
+                ivt = resolveIndex(ivt, numTexCoords);
+                ivn = resolveIndex(ivn, numNormals);
+
+                if (iv <= 0 || iv >= (int)numPositions) {
+                    ERROR(L"OBJParser", L"LoadOBJ", L"Índice de posición fuera de rango");
+                    continue;
+                }
+                if (ivt < 0 || ivt >= (int)numTexCoords) ivt = 0;
+                if (ivn < 0 || ivn >= (int)numNormals)   ivn = 0;
+
+                out.corners.push_back(OBJParser::VertexIndices{ iv, ivt, ivn });
+            }
+
+            const size_t polygonSize = out.corners.size() - firstCorner;
+            if (polygonSize < 3) {
+                out.corners.resize(firstCorner);
+            }
+            else {
+                out.faceSizes.push_back(unsigned(polygonSize));
+            }
+            break;
+        }
+        case RecordKind::UseMaterial: {
+            // El nombre es el resto de la línea (puede contener espacios)
+            const char* name = skipBlanks(keyEnd, lineEnd);
+            out.materialSwitches.emplace_back(unsigned(out.faceSizes.size()),
+                std::string(name, trimEnd(name, lineEnd)));
+            break;
+        }
+        case RecordKind::Smoothing: {
+            // "s off" y "s 0" desactivan el suavizado; cualquier otro número es un grupo
+            const char* q = skipBlanks(keyEnd, lineEnd);
+            int group = 0;
+            if (!keyEquals(q, tokenEnd(q, lineEnd), "off")) parseInt(q, lineEnd, group);
+            out.smoothingSwitches.emplace_back(unsigned(out.faceSizes.size()), std::max(group, 0));
+            break;
+        }
+        case RecordKind::MaterialLib: {
+            const char* q = skipBlanks(keyEnd, lineEnd);
+            while (q < lineEnd) {
+                const char* libEnd = tokenEnd(q, lineEnd);
+                out.materialLibs.emplace_back(q, libEnd);
+                q = skipBlanks(libEnd, lineEnd);
+            }
+            break;
+        }
+        default:
+            // Ignorar otras líneas: o, g, etc.
+            break;
+        }
+    });
+}
+
+void
+OBJParser::LoadMTL(const std::string& objDir, const std::string& libPath,
+    std::vector<MeshMaterial>& outMaterials) {
+    MappedFile file;
+    if (!file.open(isAbsolutePath(libPath) ? libPath : objDir + libPath)) {
+        ERROR(L"OBJParser", L"LoadMTL", L"No se pudo abrir el archivo .mtl");
+        return;
     }
+
+    // Las texturas del .mtl son relativas a su propio directorio
+    const std::string libDir = isAbsolutePath(libPath) ? std::string() : directoryOf(libPath);
+    MeshMaterial* current = nullptr;
+
+    forEachRecord(file.data(), file.data() + file.size(),
+        [&](const char* key, const char* keyEnd, const char* lineEnd) {
+        if (keyEquals(key, keyEnd, "newmtl")) {
+            const char* name = skipBlanks(keyEnd, lineEnd);
+            outMaterials.push_back(MeshMaterial());
+            current = &outMaterials.back();
+            current->name.assign(name, trimEnd(name, lineEnd));
+        }
+        else if (!current) {
+            return;
+        }
+        else if (keyEquals(key, keyEnd, "Kd")) {
+            const char* q = parseFloat(keyEnd, lineEnd, current->diffuse.x);
+            q = parseFloat(q, lineEnd, current->diffuse.y);
+            parseFloat(q, lineEnd, current->diffuse.z);
+        }
+        else if (keyEquals(key, keyEnd, "map_Kd")) {
+            // Las opciones (-bm, -o, ...) van antes del nombre: se toma el último token
+            const char* last = trimEnd(keyEnd, lineEnd);
+            const char* first = last;
+            while (first > keyEnd && !isBlank(first[-1])) --first;
+            const std::string texture(first, last);
+            current->diffuseMap = isAbsolutePath(texture) ? texture : libDir + texture;
+        }
+    });
 }
 
 // ----------------------------------------------------------
@@ -61,73 +397,196 @@ bool OBJParser::LoadOBJ(const std::string& objPath, MeshComponent& outMesh, bool
     outMesh.m_name = objPath;
     outMesh.m_vertex.clear();
     outMesh.m_index.clear();
+    outMesh.m_subsets.clear();
+    outMesh.m_materials.clear();
 
-    // Slot 0 reservado como “vacío”
-    std::vector<XMFLOAT3> temp_positions(1, XMFLOAT3(0, 0, 0));
-    std::vector<XMFLOAT2> temp_texCoords(1, XMFLOAT2(0, 0));
-    std::vector<XMFLOAT3> temp_normals(1, XMFLOAT3(0, 0, 0));
-
-    // Usa el tipo anidado OBJParser::VertexIndices
-    std::map<OBJParser::VertexIndices, unsigned int> vertex_cache;
-    unsigned int next_index = 0;
-
-    std::ifstream file(objPath.c_str());
-    if (!file.is_open()) {
+    // El archivo se mapea completo y se tokeniza sobre los bytes, sin copias por línea
+    MappedFile file;
+    if (!file.open(objPath)) {
         ERROR(L"OBJParser", L"LoadOBJ", L"No se pudo abrir el archivo .obj");
         return false;
     }
     MESSAGE(L"OBJParser", L"LoadOBJ", L"Iniciando parsing manual...");
 
-    std::string line;
-    while (std::getline(file, line))
-    {
-        trim(line);
-        if (line.empty() || line[0] == '#') continue;
+    const char* fileBegin = file.data();
+    const char* fileEnd = fileBegin + file.size();
+
+    // Número de chunks: 1 = ruta serial
+    JobSystem& jobs = JobSystem::Default();
+    size_t numChunks = m_threadCount ? m_threadCount : jobs.getThreadCount();
+    numChunks = std::min(numChunks, std::max<size_t>(1, file.size() / kMinBytesPerChunk));
+
+    // Cortes en fronteras de línea: cada chunk empieza justo después de un '\n'
+    std::vector<const char*> cuts(numChunks + 1, fileEnd);
+    cuts[0] = fileBegin;
+    for (size_t c = 1; c < numChunks; ++c) {
+        const char* p = fileBegin + (file.size() / numChunks) * c;
+        p = std::max(p, cuts[c - 1]);
+        const char* nl = static_cast<const char*>(memchr(p, '\n', size_t(fileEnd - p)));
+        cuts[c] = nl ? nl + 1 : fileEnd;
+    }
 
-        std::stringstream ls(line);
-        std::string tok;
-        ls >> tok;
+    std::vector<ParseChunk> chunks(numChunks);
+    std::vector<ChunkBase>  bases(numChunks);
 
-        if (tok == "v") {
-            XMFLOAT3 p; ls >> p.x >> p.y >> p.z;
-            temp_positions.push_back(p);
-        }
-        else if (tok == "vt") {
-            XMFLOAT2 t; ls >> t.x >> t.y;
-            if (flipV) t.y = 1.0f - t.y;
-            temp_texCoords.push_back(t);
-        }
-        else if (tok == "vn") {
-            XMFLOAT3 n; ls >> n.x >> n.y >> n.z;
-            temp_normals.push_back(n);
+    if (numChunks == 1) {
+        ParseRange(fileBegin, fileEnd, bases[0], flipV, chunks[0]);
+    }
+    else {
+        // Pasada 1: conteo de v/vt/vn por chunk para conocer los offsets globales
+        std::vector<ChunkBase> counts(numChunks);
+        jobs.parallelFor(0, numChunks, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) CountRecords(cuts[c], cuts[c + 1], counts[c]);
+        }, 1);
+        for (size_t c = 1; c < numChunks; ++c) {
+            bases[c].positions = bases[c - 1].positions + counts[c - 1].positions;
+            bases[c].texCoords = bases[c - 1].texCoords + counts[c - 1].texCoords;
+            bases[c].normals = bases[c - 1].normals + counts[c - 1].normals;
         }
-        else if (tok == "f") {
-            // Polígono de caras
-            std::vector<OBJParser::VertexIndices> polygon;
-            std::string vtok;
 
-            while (ls >> vtok) {
-                int iv = 0, ivt = 0, ivn = 0;
-                std::tie(iv, ivt, ivn) = parseFaceIndex(vtok);
+        // Pasada 2: parseo con índices ya resueltos a posiciones globales
+        jobs.parallelFor(0, numChunks, [&](size_t first, size_t last) {
+            for (size_t c = first; c < last; ++c) {
+                chunks[c].positions.reserve(counts[c].positions);
+                chunks[c].texCoords.reserve(counts[c].texCoords);
+                chunks[c].normals.reserve(counts[c].normals);
+                ParseRange(cuts[c], cuts[c + 1], bases[c], flipV, chunks[c]);
+            }
+        }, 1);
+    }
+    file.close();
 
-                iv = resolveIndex(iv, temp_positions.size());
-                ivt = resolveIndex(ivt, temp_texCoords.size());
-                ivn = resolveIndex(ivn, temp_normals.size());
+    // Merge determinista en orden de archivo. Slot 0 reservado como “vacío”
+    std::vector<XMFLOAT3> temp_positions(1, XMFLOAT3(0, 0, 0));
+    std::vector<XMFLOAT2> temp_texCoords(1, XMFLOAT2(0, 0));
+    std::vector<XMFLOAT3> temp_normals(1, XMFLOAT3(0, 0, 0));
+    for (const ParseChunk& chunk : chunks) {
+        temp_positions.insert(temp_positions.end(), chunk.positions.begin(), chunk.positions.end());
+        temp_texCoords.insert(temp_texCoords.end(), chunk.texCoords.begin(), chunk.texCoords.end());
+        temp_normals.insert(temp_normals.end(), chunk.normals.begin(), chunk.normals.end());
+    }
 
-                if (iv <= 0 || iv >= (int)temp_positions.size()) {
-                    ERROR(L"OBJParser", L"LoadOBJ", L"Índice de posición fuera de rango");
-                    continue;
+    // Deduplicación (v, vt, vn) -> índice. Los vértices distintos son al menos
+    // tantos como el mayor de los atributos y, como mucho, tantos como esquinas;
+    // con el margen de 1/4 para costuras la tabla casi nunca crece durante la carga
+    size_t totalCorners = 0;
+    size_t totalTriangles = 0;
+    for (const ParseChunk& chunk : chunks) {
+        totalCorners += chunk.corners.size();
+        totalTriangles += chunk.corners.size() - 2 * chunk.faceSizes.size();
+    }
+    const size_t maxAttributes = std::max(temp_positions.size(),
+        std::max(temp_texCoords.size(), temp_normals.size()));
+    VertexIndexTable vertex_cache;
+    vertex_cache.reserve(std::min(totalCorners, maxAttributes + maxAttributes / 4));
+    outMesh.m_index.resize(totalTriangles * 3);
+    unsigned int next_index = 0;
+
+    // Material de cada cara en orden de archivo. Los ids se asignan por orden de primer
+    // uso; las caras previas a cualquier usemtl usan el material por defecto ("")
+    std::vector<std::string>            materialNames;
+    std::map<std::string, unsigned int> materialIds;
+    std::vector<unsigned int>           faceMaterial;
+    {
+        size_t totalFaces = 0;
+        for (const ParseChunk& chunk : chunks) totalFaces += chunk.faceSizes.size();
+        faceMaterial.reserve(totalFaces);
+
+        const std::string defaultName;
+        const std::string* pendingName = &defaultName;
+        int currentId = -1;
+        for (const ParseChunk& chunk : chunks) {
+            size_t s = 0;
+            for (size_t f = 0; f < chunk.faceSizes.size(); ++f) {
+                while (s < chunk.materialSwitches.size() && chunk.materialSwitches[s].first == f) {
+                    pendingName = &chunk.materialSwitches[s].second;
+                    currentId = -1;
+                    ++s;
+                }
+                // Un usemtl sin caras detrás no consume id
+                if (currentId < 0) {
+                    auto it = materialIds.find(*pendingName);
+                    if (it == materialIds.end()) {
+                        it = materialIds.emplace(*pendingName, unsigned(materialNames.size())).first;
+                        materialNames.push_back(*pendingName);
+                    }
+                    currentId = int(it->second);
                 }
-                if (ivt < 0 || ivt >= (int)temp_texCoords.size()) ivt = 0;
-                if (ivn < 0 || ivn >= (int)temp_normals.size())   ivn = 0;
+                faceMaterial.push_back(unsigned(currentId));
+            }
+            // Un usemtl tras la última cara del chunk (o en un chunk sin caras) aplica a las
+            // caras del siguiente; si hay varios seguidos gana el último
+            if (s < chunk.materialSwitches.size()) {
+                pendingName = &chunk.materialSwitches.back().second;
+                currentId = -1;
+            }
+        }
+    }
 
-                polygon.push_back(OBJParser::VertexIndices{ iv, ivt, ivn });
+    // Grupo de suavizado de cada cara en orden de archivo. Sin ninguna "s" todo el
+    // modelo es un único grupo suave (1); "s off" deja las caras siguientes planas (0)
+    std::vector<int> faceSmoothing;
+    {
+        faceSmoothing.reserve(faceMaterial.size());
+        int current = 1;
+        for (const ParseChunk& chunk : chunks) {
+            size_t s = 0;
+            for (size_t f = 0; f < chunk.faceSizes.size(); ++f) {
+                while (s < chunk.smoothingSwitches.size() && chunk.smoothingSwitches[s].first == f) {
+                    current = chunk.smoothingSwitches[s++].second;
+                }
+                faceSmoothing.push_back(current);
+            }
+            // Un "s" tras la última cara del chunk aplica a las caras del siguiente
+            if (!chunk.smoothingSwitches.empty() &&
+                chunk.smoothingSwitches.back().first == chunk.faceSizes.size()) {
+                current = chunk.smoothingSwitches.back().second;
             }
+        }
+    }
 
-            if (polygon.size() < 3) continue;
+    // Vértices sin normal en el archivo: la clave de deduplicación incluye el grupo de
+    // suavizado (cada cara plana es su propio grupo), así una arista entre grupos parte
+    // los vértices y queda dura. weld[i] une los vértices de igual posición y grupo
+    // (aunque difieran en UV) para que compartan normal; los que traen vn la conservan
+    std::vector<unsigned int> weld;
+    VertexIndexTable weld_cache;
+    if (temp_normals.size() == 1) {
+        weld_cache.reserve(temp_positions.size() + temp_positions.size() / 4);
+    }
+    bool anyMissingNormal = false;
+
+    // Counting sort de triángulos por material: cada material ocupa un rango contiguo
+    // de m_index (un subset) y dentro del rango se conserva el orden del archivo
+    std::vector<size_t> materialCursor(materialNames.size() + 1, 0);
+    {
+        size_t face = 0;
+        for (const ParseChunk& chunk : chunks) {
+            for (unsigned int polygonSize : chunk.faceSizes) {
+                materialCursor[faceMaterial[face++] + 1] += size_t(polygonSize - 2) * 3;
+            }
+        }
+        for (size_t m = 0; m < materialNames.size(); ++m) {
+            materialCursor[m + 1] += materialCursor[m];
+
+            MeshSubset subset;
+            subset.startIndex = unsigned(materialCursor[m]);
+            subset.indexCount = unsigned(materialCursor[m + 1] - materialCursor[m]);
+            subset.materialId = unsigned(m);
+            outMesh.m_subsets.push_back(subset);
+        }
+    }
+
+    size_t face = 0;
+    for (const ParseChunk& chunk : chunks) {
+        const OBJParser::VertexIndices* polygon = chunk.corners.data();
+        for (unsigned int polygonSize : chunk.faceSizes) {
+            size_t& cursor = materialCursor[faceMaterial[face]];
+            const int smoothing = faceSmoothing[face] ? faceSmoothing[face] : -int(face + 1);
+            ++face;
 
             // Triangulación tipo fan: (0, i+1, i+2)
-            for (size_t i = 0; i + 2 < polygon.size(); ++i) {
+            for (size_t i = 0; i + 2 < polygonSize; ++i) {
                 OBJParser::VertexIndices tri[3] = {
                     polygon[0], polygon[i + 1], polygon[i + 2]
                 };
@@ -135,12 +594,11 @@ bool OBJParser::LoadOBJ(const std::string& objPath, MeshComponent& outMesh, bool
                 for (int k = 0; k < 3; ++k) {
                     const OBJParser::VertexIndices& key = tri[k];
 
-                    auto it = vertex_cache.find(key);
-                    if (it != vertex_cache.end()) {
-                        // Reutiliza índice
-                        outMesh.m_index.push_back(it->second);
-                    }
-                    else {
+                    const int group = (key.vn != 0) ? 0 : smoothing;
+                    bool isNew = false;
+                    const unsigned int index = vertex_cache.findOrInsert(key.v, key.vt, key.vn, group,
+                        next_index, isNew);
+                    if (isNew) {
                         // Crea vértice nuevo
                         SimpleVertex v{};
                         v.Pos = temp_positions[key.v];
@@ -148,64 +606,183 @@ bool OBJParser::LoadOBJ(const std::string& objPath, MeshComponent& outMesh, bool
                         v.Normal = (key.vn != 0) ? temp_normals[key.vn] : XMFLOAT3(0, 0, 0);
 
                         outMesh.m_vertex.push_back(v);
-                        vertex_cache[key] = next_index;
-                        outMesh.m_index.push_back(next_index);
+                        if (key.vn != 0) {
+                            weld.push_back(unsigned(MeshNormals::kKeepNormal));
+                        }
+                        else {
+                            bool isNewWeld = false;
+                            weld.push_back(weld_cache.findOrInsert(key.v, 0, 0, group, next_index, isNewWeld));
+                            anyMissingNormal = true;
+                        }
                         ++next_index;
                     }
+                    outMesh.m_index[cursor++] = index;
                 }
             }
-        }
-        else {
-            // Ignorar otras líneas: o, g, s, usemtl, mtllib, etc.
+            polygon += polygonSize;
         }
     }
-    file.close();
 
-    // Si no hay normales, calcúlalas
-    bool needNormals = true;
-    for (size_t i = 0; i < outMesh.m_vertex.size(); ++i) {
-        const XMFLOAT3& n = outMesh.m_vertex[i].Normal;
-        if (n.x != 0 || n.y != 0 || n.z != 0) { needNormals = false; break; }
+    // Normales faltantes (ponderadas por ángulo, en paralelo) y tangentes si hay UV
+    if (anyMissingNormal) {
+        MeshNormals::ComputeNormals(outMesh.m_vertex, outMesh.m_index, weld.data(),
+            NormalWeighting::Angle, m_threadCount);
+    }
+    bool hasTexCoords = false;
+    for (const ParseChunk& chunk : chunks) hasTexCoords = hasTexCoords || !chunk.texCoords.empty();
+    if (m_generateTangents && hasTexCoords) {
+        MeshNormals::ComputeTangents(outMesh, m_threadCount);
     }
 
-    if (needNormals && outMesh.m_index.size() >= 3) {
-        std::vector<XMFLOAT3> acc(outMesh.m_vertex.size(), XMFLOAT3(0, 0, 0));
-
-        for (size_t i = 0; i + 2 < outMesh.m_index.size(); i += 3) {
-            unsigned ia = outMesh.m_index[i + 0];
-            unsigned ib = outMesh.m_index[i + 1];
-            unsigned ic = outMesh.m_index[i + 2];
+    outMesh.m_numVertex = (int)outMesh.m_vertex.size();
+    outMesh.m_numIndex = (int)outMesh.m_index.size();
 
-            const XMFLOAT3& A = outMesh.m_vertex[ia].Pos;
-            const XMFLOAT3& B = outMesh.m_vertex[ib].Pos;
-            const XMFLOAT3& C = outMesh.m_vertex[ic].Pos;
+    if (outMesh.m_numVertex == 0 || outMesh.m_numIndex == 0) {
+        ERROR(L"OBJParser", L"LoadOBJ", L"El OBJ no generó vértices/índices.");
+        return false;
+    }
 
-            XMFLOAT3 AB{ B.x - A.x, B.y - A.y, B.z - A.z };
-            XMFLOAT3 AC{ C.x - A.x, C.y - A.y, C.z - A.z };
-            XMFLOAT3 N{
-                AB.y * AC.z - AB.z * AC.y,
-                AB.z * AC.x - AB.x * AC.z,
-                AB.x * AC.y - AB.y * AC.x
-            };
+    // Materiales: cada .mtl se lee una vez, relativo al directorio del OBJ
+    {
+        const std::string objDir = directoryOf(objPath);
+        std::vector<MeshMaterial> library;
+        std::vector<std::string>  loadedLibs;
+        for (const ParseChunk& chunk : chunks) {
+            for (const std::string& lib : chunk.materialLibs) {
+                if (std::find(loadedLibs.begin(), loadedLibs.end(), lib) != loadedLibs.end()) continue;
+                loadedLibs.push_back(lib);
+                LoadMTL(objDir, lib, library);
+            }
+        }
 
-            acc[ia].x += N.x; acc[ia].y += N.y; acc[ia].z += N.z;
-            acc[ib].x += N.x; acc[ib].y += N.y; acc[ib].z += N.z;
-            acc[ic].x += N.x; acc[ic].y += N.y; acc[ic].z += N.z;
+        outMesh.m_materials.resize(materialNames.size());
+        for (size_t m = 0; m < materialNames.size(); ++m) {
+            MeshMaterial& material = outMesh.m_materials[m];
+            material.name = materialNames[m];
+            if (material.name.empty()) continue;
+
+            auto it = std::find_if(library.begin(), library.end(),
+                [&](const MeshMaterial& def) { return def.name == material.name; });
+            if (it == library.end()) {
+                ERROR(L"OBJParser", L"LoadOBJ", L"usemtl sin definición en los .mtl; se usa el material por defecto");
+                continue;
+            }
+            material = *it;
         }
+    }
+
+    // AABB global y por subset (se guardan en la caché .hmesh)
+    outMesh.computeBounds();
+
+    MESSAGE(L"OBJParser", L"LoadOBJ", L"Parsing OBJ finalizado.");
+    return true;
+}
+
+// -----------------------------
+// Model3D
+// -----------------------------
+bool Model3D::load(const std::string& path)
+{
+    SetPath(path);
+    SetState(ResourceState::Loading);
+    m_meshes.clear();
+
+    bool ok = false;
+    if (m_modelType == ModelType::OBJ) {
+        ok = loadOBJ_Internal(path);
+    }
+    else {
+#ifdef USE_FBX_SDK
+        ok = loadFBX_Internal(path);
+#else
+        ERROR(L"Model3D", L"load", L"Soporte FBX no compilado (USE_FBX_SDK).");
+#endif
+    }
 
-        for (size_t i = 0; i < outMesh.m_vertex.size(); ++i) {
-            outMesh.m_vertex[i].Normal = normalize(acc[i]);
+    // Una textura difusa por material (índice = MeshSubset::materialId); vacía si no tiene
+    m_textureFileNames.clear();
+    if (ok && !m_meshes.empty()) {
+        const std::string modelDir = directoryOf(path);
+        for (const MeshMaterial& material : m_meshes.front().m_materials) {
+            if (material.diffuseMap.empty() || isAbsolutePath(material.diffuseMap)) {
+                m_textureFileNames.push_back(material.diffuseMap);
+            }
+            else {
+                m_textureFileNames.push_back(modelDir + material.diffuseMap);
+            }
         }
     }
 
-    outMesh.m_numVertex = (int)outMesh.m_vertex.size();
-    outMesh.m_numIndex = (int)outMesh.m_index.size();
+    SetState(ok ? ResourceState::Loaded : ResourceState::Failed);
+    return ok;
+}
 
-    if (outMesh.m_numVertex == 0 || outMesh.m_numIndex == 0) {
-        ERROR(L"OBJParser", L"LoadOBJ", L"El OBJ no generó vértices/índices.");
+bool Model3D::loadOBJ_Internal(const std::string& path)
+{
+    MeshComponent mesh;
+    const std::string cachePath = MeshCache::GetCachePath(path);
+
+    // Caché vigente: la malla se copia directo desde la vista mapeada, sin parsear texto
+    MeshCache cache;
+    if (cache.open(cachePath, path)) {
+        cache.copyTo(mesh);
+        mesh.m_name = path;
+        m_meshes.push_back(std::move(mesh));
+        return true;
+    }
+
+    OBJParser parser;
+    if (!parser.LoadOBJ(path, mesh, true)) {
         return false;
     }
+    MeshOptimizer::Optimize(mesh);
+    mesh.splitForIndex16();
+    // Si no se puede escribir la caché la carga sigue siendo válida
+    MeshCache::write(cachePath, mesh, path);
 
-    MESSAGE(L"OBJParser", L"LoadOBJ", L"Parsing OBJ finalizado.");
+    m_meshes.push_back(std::move(mesh));
     return true;
 }
+
+bool Model3D::init()
+{
+    // Los buffers de GPU los crea quien consume GetMeshes(); aquí sólo se valida el estado
+    return m_state == ResourceState::Loaded && !m_meshes.empty();
+}
+
+bool Model3D::BuildBVHs(unsigned int threadCount)
+{
+    m_bvhs.clear();
+    m_bvhs.resize(m_meshes.size());
+    bool ok = !m_meshes.empty();
+    for (size_t i = 0; i < m_meshes.size(); ++i) {
+        ok = m_bvhs[i].build(m_meshes[i], threadCount) && ok;
+    }
+    return ok;
+}
+
+void Model3D::unload()
+{
+    m_meshes.clear();
+    m_meshes.shrink_to_fit();
+    m_bvhs.clear();
+    m_bvhs.shrink_to_fit();
+    m_textureFileNames.clear();
+    SetState(ResourceState::Unloaded);
+}
+
+size_t Model3D::getSizeInBytes() const
+{
+    size_t bytes = 0;
+    for (const MeshComponent& mesh : m_meshes) {
+        bytes += mesh.m_vertex.capacity() * sizeof(SimpleVertex);
+        bytes += mesh.m_tangents.capacity() * sizeof(XMFLOAT4);
+        bytes += mesh.m_index.capacity() * sizeof(unsigned int);
+        bytes += mesh.m_subsets.capacity() * sizeof(MeshSubset);
+        bytes += mesh.m_materials.capacity() * sizeof(MeshMaterial);
+    }
+    for (const MeshBVH& bvh : m_bvhs) {
+        bytes += bvh.getSizeInBytes();
+    }
+    return bytes;
+}
@@ -0,0 +1,115 @@
+#include "../include/Picker.h"
+#include <algorithm>
+#include <cmath>
+
+void
+Picker::clear() {
+    m_entries.clear();
+    m_partition.clear();
+}
+
+unsigned int
+Picker::addMesh(const MeshBVH* bvh, const XMMATRIX& world) {
+    Entry entry;
+    entry.bvh = bvh;
+    updateEntry(entry, world);
+    m_entries.push_back(entry);
+    const unsigned int mesh = unsigned(m_entries.size() - 1);
+    m_entries[mesh].object = m_partition.insert(entry.worldMin, entry.worldMax, mesh);
+    return mesh;
+}
+
+void
+Picker::setWorld(unsigned int mesh, const XMMATRIX& world) {
+    if (mesh >= m_entries.size()) {
+        ERROR(L"Picker", L"setWorld", L"Índice de malla fuera de rango");
+        return;
+    }
+    updateEntry(m_entries[mesh], world);
+    m_partition.move(m_entries[mesh].object, m_entries[mesh].worldMin, m_entries[mesh].worldMax);
+}
+
+void
+Picker::updateEntry(Entry& entry, const XMMATRIX& world) {
+    XMStoreFloat4x4(&entry.world, world);
+    XMVECTOR det;
+    XMStoreFloat4x4(&entry.invWorld, XMMatrixInverse(&det, world));
+
+    // AABB en mundo de las 8 esquinas de la caja raíz
+    XMFLOAT3 mn(0, 0, 0), mx(0, 0, 0);
+    if (entry.bvh && entry.bvh->isBuilt()) {
+        entry.bvh->getBounds(mn, mx);
+    }
+    XMVECTOR wMin = XMVectorReplicate(FLT_MAX), wMax = XMVectorReplicate(-FLT_MAX);
+    for (int i = 0; i < 8; ++i) {
+        const XMVECTOR corner = XMVectorSet((i & 1) ? mx.x : mn.x, (i & 2) ? mx.y : mn.y,
+            (i & 4) ? mx.z : mn.z, 1.0f);
+        const XMVECTOR p = XMVector3TransformCoord(corner, world);
+        wMin = XMVectorMin(wMin, p);
+        wMax = XMVectorMax(wMax, p);
+    }
+    XMStoreFloat3(&entry.worldMin, wMin);
+    XMStoreFloat3(&entry.worldMax, wMax);
+}
+
+void
+Picker::ScreenRay(float x, float y, float viewportWidth, float viewportHeight,
+    const XMMATRIX& view, const XMMATRIX& projection,
+    XMFLOAT3& outOrigin, XMFLOAT3& outDirection) {
+    // Centro del píxel a NDC (y hacia arriba) y de vuelta por la inversa de View * Projection
+    const float ndcX = (x + 0.5f) / std::max(viewportWidth, 1.0f) * 2.0f - 1.0f;
+    const float ndcY = 1.0f - (y + 0.5f) / std::max(viewportHeight, 1.0f) * 2.0f;
+    XMVECTOR det;
+    const XMMATRIX invViewProj = XMMatrixInverse(&det, XMMatrixMultiply(view, projection));
+    const XMVECTOR nearPoint = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 0.0f, 1.0f), invViewProj);
+    const XMVECTOR farPoint = XMVector3TransformCoord(XMVectorSet(ndcX, ndcY, 1.0f, 1.0f), invViewProj);
+    XMStoreFloat3(&outOrigin, nearPoint);
+    XMStoreFloat3(&outDirection, XMVector3Normalize(XMVectorSubtract(farPoint, nearPoint)));
+}
+
+bool
+Picker::pick(const XMFLOAT3& origin, const XMFLOAT3& direction, PickResult& out) const {
+    const XMVECTOR o = XMLoadFloat3(&origin);
+    const XMVECTOR d = XMVector3Normalize(XMLoadFloat3(&direction));
+    XMFLOAT3 worldDir;
+    XMStoreFloat3(&worldDir, d);
+
+    std::vector<RayCandidate> candidates;
+    m_partition.queryRay(origin, worldDir, FLT_MAX, candidates);
+
+    PickResult best;
+    for (const RayCandidate& candidate : candidates) {
+        if (candidate.tEnter > best.distance) break;
+        const unsigned int i = m_partition.getUserData(candidate.object);
+        const Entry& entry = m_entries[i];
+        if (!entry.bvh || !entry.bvh->isBuilt()) continue;
+
+        // Rayo en espacio objeto: el parámetro t sigue midiendo distancia en mundo
+        const XMMATRIX invWorld = XMLoadFloat4x4(&entry.invWorld);
+        XMFLOAT3 localOrigin, localDir;
+        XMStoreFloat3(&localOrigin, XMVector3TransformCoord(o, invWorld));
+        XMStoreFloat3(&localDir, XMVector3TransformNormal(d, invWorld));
+
+        RayHit hit;
+        if (entry.bvh->raycast(localOrigin, localDir, hit, best.distance)) {
+            best.mesh = unsigned(i);
+            best.triangle = hit.triangle;
+            best.u = hit.u;
+            best.v = hit.v;
+            best.distance = hit.t;
+        }
+    }
+
+    if (!best.hit()) return false;
+    XMStoreFloat3(&best.position, XMVectorAdd(o, XMVectorScale(d, best.distance)));
+    out = best;
+    return true;
+}
+
+bool
+Picker::pick(float x, float y, float viewportWidth, float viewportHeight,
+    const XMMATRIX& view, const XMMATRIX& projection, PickResult& out) const {
+    XMFLOAT3 origin, direction;
+    ScreenRay(x, y, viewportWidth, viewportHeight, view, projection, origin, direction);
+    return pick(origin, direction, out);
+}
@@ -0,0 +1,158 @@
+#include "../include/RenderQueue.h"
+#include "../include/DeviceContext.h"
+#include "../include/ShaderProgram.h"
+#include "../include/Texture.h"
+#include "../include/Buffer.h"
+#include <algorithm>
+
+namespace
+{
+    inline uint64_t field(unsigned int value, unsigned int bits) {
+        return uint64_t(value) & ((uint64_t(1) << bits) - 1);
+    }
+}
+
+uint64_t
+RenderQueue::MakeKey(unsigned int layer, unsigned int shader, unsigned int material, float depth,
+    bool backToFront) {
+    const float maxDepth = float((1u << kDepthBits) - 1);
+    unsigned int d = unsigned(std::min(std::max(depth, 0.0f), 1.0f) * maxDepth);
+    if (backToFront) d = unsigned(maxDepth) - d;
+    return (field(layer, kLayerBits) << (kShaderBits + kMaterialBits + kDepthBits)) |
+        (field(shader, kShaderBits) << (kMaterialBits + kDepthBits)) |
+        (field(material, kMaterialBits) << kDepthBits) |
+        field(d, kDepthBits);
+}
+
+void
+RenderQueue::clear() {
+    m_entries.clear();
+    m_sorted = true;
+}
+
+void
+RenderQueue::reserve(size_t count) {
+    m_entries.reserve(count);
+    m_scratch.reserve(count);
+}
+
+void
+RenderQueue::sort() {
+    if (m_sorted) return;
+    const size_t count = m_entries.size();
+
+    // Los ocho histogramas en un solo recorrido
+    size_t histogram[8][256] = {};
+    for (const SortEntry& entry : m_entries) {
+        uint64_t key = entry.key;
+        for (int pass = 0; pass < 8; ++pass, key >>= 8) ++histogram[pass][key & 0xFF];
+    }
+
+    m_scratch.resize(count);
+    SortEntry* src = m_entries.data();
+    SortEntry* dst = m_scratch.data();
+    for (int pass = 0; pass < 8; ++pass) {
+        size_t* h = histogram[pass];
+        // Dígito igual en todas las claves: la pasada no cambia nada
+        if (h[(src[0].key >> (pass * 8)) & 0xFF] == count) continue;
+
+        size_t offset = 0;
+        for (int b = 0; b < 256; ++b) {
+            const size_t n = h[b];
+            h[b] = offset;
+            offset += n;
+        }
+        const int shift = pass * 8;
+        for (size_t i = 0; i < count; ++i) {
+            dst[h[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+    if (src != m_entries.data()) m_entries.swap(m_scratch);
+    m_sorted = true;
+}
+
+template <bool kIssue>
+RenderQueueStats
+RenderQueue::walk(DeviceContext* deviceContext) const {
+    RenderQueueStats stats;
+    stats.packets = m_entries.size();
+
+    const ShaderProgram* shader = nullptr;
+    const Texture* texture = nullptr;
+    const Buffer* vertexBuffer = nullptr;
+    const Buffer* instanceBuffer = nullptr;
+    const Buffer* indexBuffer = nullptr;
+    const Buffer* constantBuffer = nullptr;
+
+    for (const SortEntry& entry : m_entries) {
+        const DrawPacket& p = *entry.packet;
+        if (p.indexCount == 0) continue;
+
+        if (p.shader && p.shader != shader) {
+            if (kIssue) p.shader->render(*deviceContext);
+            shader = p.shader;
+            ++stats.shaderBinds;
+        }
+        if (p.texture && p.texture != texture) {
+            if (kIssue) p.texture->render(*deviceContext, 0, 1);
+            texture = p.texture;
+            ++stats.materialBinds;
+        }
+        if (p.vertexBuffer && p.vertexBuffer != vertexBuffer) {
+            if (kIssue) p.vertexBuffer->render(*deviceContext, 0, 1);
+            vertexBuffer = p.vertexBuffer;
+            ++stats.bufferBinds;
+        }
+        if (p.instanceBuffer && p.instanceBuffer != instanceBuffer) {
+            if (kIssue) p.instanceBuffer->render(*deviceContext, 1, 1);
+            instanceBuffer = p.instanceBuffer;
+            ++stats.bufferBinds;
+        }
+        if (p.indexBuffer && p.indexBuffer != indexBuffer) {
+            if (kIssue) p.indexBuffer->render(*deviceContext, 0, 1);
+            indexBuffer = p.indexBuffer;
+            ++stats.bufferBinds;
+        }
+        if (p.constantBuffer && p.constantBuffer != constantBuffer) {
+            if (kIssue) {
+                p.constantBuffer->render(*deviceContext, 2, 1);
+                p.constantBuffer->render(*deviceContext, 2, 1, true);
+            }
+            constantBuffer = p.constantBuffer;
+            ++stats.bufferBinds;
+        }
+        if (p.constantBuffer && p.constants) {
+            if (kIssue) p.constantBuffer->update(*deviceContext, nullptr, 0, nullptr, p.constants, 0, 0);
+            ++stats.constantUpdates;
+        }
+        // Rango propio en el ring: ya está en la GPU, sólo cambia el enlace
+        if (p.constantRing && p.constantRange.valid()) {
+            if (kIssue) p.constantRing->bindAllocation(*deviceContext, p.constantRange, 2, true);
+            constantBuffer = nullptr;
+            ++stats.constantUpdates;
+        }
+
+        if (kIssue) {
+            if (p.instanceCount > 0) {
+                deviceContext->DrawIndexedInstanced(p.indexCount, p.instanceCount, p.startIndex, p.baseVertex, 0);
+            }
+            else {
+                deviceContext->DrawIndexed(p.indexCount, p.startIndex, p.baseVertex);
+            }
+        }
+        ++stats.drawCalls;
+    }
+    return stats;
+}
+
+RenderQueueStats
+RenderQueue::execute(DeviceContext& deviceContext) {
+    sort();
+    return walk<true>(&deviceContext);
+}
+
+RenderQueueStats
+RenderQueue::countStateChanges() const {
+    return walk<false>(nullptr);
+}
@@ -65,14 +65,14 @@ void RenderTargetView::render(DeviceContext& deviceContext, DepthStencilView& de
     if (!m_renderTargetView) { ERROR("RenderTargetView", "render", "RenderTargetView is nullptr."); return; }
 
     deviceContext.m_deviceContext->ClearRenderTargetView(m_renderTargetView, clearColor);
-    deviceContext.m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, depthStencilView.m_depthStencilView);
+    deviceContext.OMSetRenderTargets(1, &m_renderTargetView, depthStencilView.m_depthStencilView);
 }
 
 void RenderTargetView::render(DeviceContext& deviceContext, unsigned int /*numViews*/) {
     if (!deviceContext.m_deviceContext) { ERROR("RenderTargetView", "render", "DeviceContext is nullptr."); return; }
     if (!m_renderTargetView) { ERROR("RenderTargetView", "render", "RenderTargetView is nullptr."); return; }
 
-    deviceContext.m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, nullptr);
+    deviceContext.OMSetRenderTargets(1, &m_renderTargetView, nullptr);
 }
 
 void RenderTargetView::destroy() {
@@ -0,0 +1,419 @@
+#include "../include/ResourceManager.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+
+ResourceManager::~ResourceManager() {
+    shutdown();
+}
+
+void
+ResourceManager::init(unsigned int loaderThreads) {
+    shutdown();
+    m_stop = false;
+    m_stats = ResourceManagerStats();
+    // Los presupuestos se conservan: se pueden fijar antes de init
+    for (ResourceTypeMemory& type : m_memory.types) {
+        ResourceTypeMemory reset;
+        reset.cpuBudget = type.cpuBudget;
+        reset.gpuBudget = type.gpuBudget;
+        type = reset;
+    }
+    for (unsigned int i = 0; i < std::max(1u, loaderThreads); ++i) {
+        m_loaders.emplace_back(&ResourceManager::loaderLoop, this);
+    }
+}
+
+ResourceHandle
+ResourceManager::load(const std::string& path, const Factory& factory, Callback onReady) {
+    const std::string key = NormalizePath(path);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_stats.requests;
+
+    auto it = m_byPath.find(key);
+    if (it != m_byPath.end()) {
+        const ResourceHandle handle = it->second;
+        Slot& slot = *m_slots[handle.index];
+        ++m_stats.deduplicated;
+        if (slot.evicted) requeue(handle.index);
+        if (onReady) {
+            const bool finished = slot.state == ResourceState::Loaded || slot.state == ResourceState::Failed;
+            if (finished) m_lateCallbacks.emplace_back(handle, std::move(onReady));
+            else slot.callbacks.push_back(std::move(onReady));
+        }
+        return handle;
+    }
+
+    std::unique_ptr<IResource> resource = factory ? factory(path) : nullptr;
+    if (!resource) {
+        ERROR(L"ResourceManager", L"load", L"La fábrica no creó el recurso");
+        return ResourceHandle();
+    }
+
+    const ResourceHandle handle = m_handles.allocate(nullptr);
+    if (!handle.valid()) return ResourceHandle();
+    const uint32_t index = handle.index;
+    // Los slots se conservan con sus índices (también tras shutdown), así que un índice nuevo
+    // es el siguiente a los usados; crecer hasta él cubre cualquier orden de la tabla
+    while (m_slots.size() <= index) m_slots.emplace_back(new Slot());
+    Slot& slot = *m_slots[index];
+    m_handles.set(handle, &slot);
+    slot.handle = handle;
+    slot.resource = std::move(resource);
+    slot.path = key;
+    slot.sourcePath = path;
+    slot.used = true;
+    slot.released = false;
+    slot.loadDone = false;
+    slot.loadOk = false;
+    slot.evicted = false;
+    slot.type = slot.resource->GetType();
+    slot.state = ResourceState::Loading;
+    slot.lastUsedFrame = m_frame;
+    slot.pinCount = 0;
+    slot.promise = std::promise<ResourceState>();
+    slot.future = slot.promise.get_future().share();
+    if (onReady) slot.callbacks.push_back(std::move(onReady));
+    m_byPath[key] = handle;
+
+    m_loadQueue.push_back(index);
+    lock.unlock();
+    m_loadWake.notify_one();
+    return handle;
+}
+
+ResourceHandle
+ResourceManager::find(const std::string& path) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_byPath.find(NormalizePath(path));
+    return it == m_byPath.end() ? ResourceHandle() : it->second;
+}
+
+ResourceState
+ResourceManager::getState(ResourceHandle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Slot* slot = resolve(handle);
+    return slot ? slot->state : ResourceState::Unloaded;
+}
+
+std::shared_future<ResourceState>
+ResourceManager::getFuture(ResourceHandle handle) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (const Slot* slot = resolve(handle)) return slot->future;
+    std::promise<ResourceState> none;
+    none.set_value(ResourceState::Unloaded);
+    return none.get_future().share();
+}
+
+IResource*
+ResourceManager::get(ResourceHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Slot* slot = resolve(handle);
+    if (!slot) return nullptr;
+    slot->lastUsedFrame = m_frame;
+    if (slot->evicted) requeue(handle.index);
+    return slot->state == ResourceState::Loaded ? slot->resource.get() : nullptr;
+}
+
+void
+ResourceManager::touch(ResourceHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (Slot* slot = resolve(handle)) slot->lastUsedFrame = m_frame;
+}
+
+void
+ResourceManager::pin(ResourceHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (Slot* slot = resolve(handle)) ++slot->pinCount;
+}
+
+void
+ResourceManager::unpin(ResourceHandle handle) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Slot* slot = resolve(handle);
+    if (slot && slot->pinCount > 0) --slot->pinCount;
+}
+
+void
+ResourceManager::setBudget(ResourceType type, size_t cpuBytes, size_t gpuBytes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_memory.types[size_t(type)].cpuBudget = cpuBytes;
+    m_memory.types[size_t(type)].gpuBudget = gpuBytes;
+}
+
+unsigned int
+ResourceManager::update(double budgetMs) {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point start = Clock::now();
+    unsigned int finished = 0;
+
+    std::vector<std::pair<ResourceHandle, Callback>> late;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_frame;
+        late.swap(m_lateCallbacks);
+    }
+    for (auto& entry : late) entry.second(entry.first, getState(entry.first));
+
+    // init crea recursos de GPU: uno por vez hasta agotar el presupuesto
+    for (;;) {
+        uint32_t index;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_initQueue.empty()) break;
+            index = m_initQueue.front();
+            m_initQueue.pop_front();
+        }
+        finish(index);
+        ++finished;
+        const double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        if (elapsedMs >= budgetMs) break;
+    }
+    enforceBudgets();
+    return finished;
+}
+
+ResourceState
+ResourceManager::wait(ResourceHandle handle) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Slot* slot = resolve(handle);
+    if (!slot) return ResourceState::Unloaded;
+    slot->lastUsedFrame = m_frame;
+    if (slot->evicted) requeue(handle.index);
+    if (slot->state != ResourceState::Loading) return slot->state;
+
+    m_loadDone.wait(lock, [slot]() { return slot->loadDone; });
+    // Se saca de la cola de init para no esperar al presupuesto de update
+    auto it = std::find(m_initQueue.begin(), m_initQueue.end(), handle.index);
+    if (it == m_initQueue.end()) return slot->state;  // Otro wait/update ya lo está terminando
+    m_initQueue.erase(it);
+    lock.unlock();
+
+    finish(handle.index);
+    return getState(handle);
+}
+
+void
+ResourceManager::release(ResourceHandle handle) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Slot* slot = resolve(handle);
+    if (!slot) return;
+    m_byPath.erase(slot->path);
+    auto queued = std::find(m_loadQueue.begin(), m_loadQueue.end(), handle.index);
+    if (queued != m_loadQueue.end()) {
+        // Aún no empezó a cargar: se cancela
+        m_loadQueue.erase(queued);
+        slot->promise.set_value(ResourceState::Unloaded);
+        slot->state = ResourceState::Unloaded;
+    }
+    else if (slot->state == ResourceState::Loading) {
+        // El hilo de carga aún usa el recurso: el slot (y su handle) se libera al terminar
+        slot->released = true;
+        return;
+    }
+    const bool loaded = !slot->evicted;
+    std::unique_ptr<IResource> resource = std::move(slot->resource);
+    freeSlot(handle.index);
+    lock.unlock();
+    if (resource && loaded) resource->unload();
+}
+
+ResourceManagerStats
+ResourceManager::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ResourceManagerStats stats = m_stats;
+    stats.awaitingInit = unsigned(m_initQueue.size());
+    stats.pending = 0;
+    for (const auto& slot : m_slots) {
+        if (slot->used && slot->state == ResourceState::Loading && !slot->loadDone) ++stats.pending;
+    }
+    return stats;
+}
+
+void
+ResourceManager::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+        m_loadQueue.clear();
+    }
+    m_loadWake.notify_all();
+    for (std::thread& t : m_loaders) t.join();
+    m_loaders.clear();
+
+    // Sin hilos de carga nadie toca los slots: se descargan y se cumplen los futures pendientes.
+    // Los slots se vacían pero no se borran: m_handles conserva su lista libre y un init
+    // posterior volverá a dar esos índices
+    for (uint32_t index = 0; index < m_slots.size(); ++index) {
+        Slot& slot = *m_slots[index];
+        if (!slot.used) continue;
+        if (slot.resource && !slot.evicted) slot.resource->unload();
+        if (slot.state == ResourceState::Loading) slot.promise.set_value(ResourceState::Unloaded);
+        freeSlot(index);
+    }
+    m_byPath.clear();
+    m_initQueue.clear();
+    m_lateCallbacks.clear();
+}
+
+std::string
+ResourceManager::NormalizePath(const std::string& path) {
+    std::string key = path;
+    for (char& c : key) {
+        c = c == '/' ? '\\' : char(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return key;
+}
+
+ResourceManager::Slot*
+ResourceManager::resolve(ResourceHandle handle) const {
+    Slot* slot = m_handles.get<Slot>(handle);
+    return slot && !slot->released ? slot : nullptr;
+}
+
+void
+ResourceManager::loaderLoop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_loadWake.wait(lock, [this]() { return m_stop || !m_loadQueue.empty(); });
+        if (m_stop) return;
+        const uint32_t index = m_loadQueue.front();
+        m_loadQueue.pop_front();
+        Slot& slot = *m_slots[index];
+        IResource* resource = slot.resource.get();
+        const std::string path = slot.sourcePath;
+        lock.unlock();
+
+        const bool ok = resource->load(path);
+
+        lock.lock();
+        slot.loadDone = true;
+        slot.loadOk = ok;
+        m_initQueue.push_back(index);
+        m_loadDone.notify_all();
+    }
+}
+
+void
+ResourceManager::finish(uint32_t index) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    Slot& slot = *m_slots[index];
+    if (slot.released) {
+        // release llegó durante la carga
+        std::unique_ptr<IResource> resource = std::move(slot.resource);
+        slot.promise.set_value(ResourceState::Unloaded);
+        freeSlot(index);
+        lock.unlock();
+        if (resource) resource->unload();
+        return;
+    }
+    IResource* resource = slot.resource.get();
+    const bool loadOk = slot.loadOk;
+    lock.unlock();
+
+    const ResourceState state = loadOk && resource->init() ? ResourceState::Loaded : ResourceState::Failed;
+
+    lock.lock();
+    slot.state = state;
+    slot.lastUsedFrame = m_frame;
+    ++(state == ResourceState::Loaded ? m_stats.loaded : m_stats.failed);
+    std::vector<Callback> callbacks;
+    callbacks.swap(slot.callbacks);
+    const ResourceHandle handle = slot.handle;
+    slot.promise.set_value(state);
+    lock.unlock();
+
+    for (Callback& callback : callbacks) callback(handle, state);
+}
+
+void
+ResourceManager::freeSlot(uint32_t index) {
+    Slot& slot = *m_slots[index];
+    slot.resource.reset();
+    slot.path.clear();
+    slot.sourcePath.clear();
+    slot.callbacks.clear();
+    slot.used = false;
+    slot.released = false;
+    slot.loadDone = false;
+    slot.loadOk = false;
+    slot.evicted = false;
+    slot.type = ResourceType::Unknown;
+    slot.state = ResourceState::Unloaded;
+    slot.lastUsedFrame = 0;
+    slot.pinCount = 0;
+    slot.cpuBytes = slot.gpuBytes = 0;
+    m_handles.release(slot.handle);
+    slot.handle = ResourceHandle();
+}
+
+void
+ResourceManager::requeue(uint32_t index) {
+    // Vuelve a cargar un recurso desalojado por el mismo camino que la primera vez
+    Slot& slot = *m_slots[index];
+    slot.evicted = false;
+    slot.loadDone = false;
+    slot.loadOk = false;
+    slot.state = ResourceState::Loading;
+    slot.promise = std::promise<ResourceState>();
+    slot.future = slot.promise.get_future().share();
+    m_loadQueue.push_back(index);
+    m_loadWake.notify_one();
+}
+
+void
+ResourceManager::enforceBudgets() {
+    std::vector<IResource*> victims;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (ResourceTypeMemory& type : m_memory.types) {
+            type.cpuBytes = type.gpuBytes = 0;
+            type.resident = 0;
+            type.overBudget = false;
+        }
+        for (const auto& slot : m_slots) {
+            if (!slot->used || slot->state != ResourceState::Loaded) continue;
+            slot->cpuBytes = slot->resource->getSizeInBytes();
+            slot->gpuBytes = slot->resource->getGpuSizeInBytes();
+            ResourceTypeMemory& type = m_memory.types[size_t(slot->type)];
+            type.cpuBytes += slot->cpuBytes;
+            type.gpuBytes += slot->gpuBytes;
+            ++type.resident;
+        }
+
+        std::vector<Slot*> candidates;
+        for (size_t t = 0; t < kResourceTypeCount; ++t) {
+            ResourceTypeMemory& type = m_memory.types[t];
+            auto over = [&type]() {
+                return (type.cpuBudget && type.cpuBytes > type.cpuBudget) ||
+                    (type.gpuBudget && type.gpuBytes > type.gpuBudget);
+            };
+            if (!over()) continue;
+
+            // Menos usados primero; lo fijado y lo usado en este frame o el anterior no cuenta
+            candidates.clear();
+            for (const auto& slot : m_slots) {
+                if (slot->used && slot->state == ResourceState::Loaded && size_t(slot->type) == t &&
+                    slot->pinCount == 0 && slot->lastUsedFrame + 1 < m_frame) {
+                    candidates.push_back(slot.get());
+                }
+            }
+            std::stable_sort(candidates.begin(), candidates.end(), [](const Slot* a, const Slot* b) {
+                return a->lastUsedFrame < b->lastUsedFrame;
+            });
+            for (Slot* slot : candidates) {
+                if (!over()) break;
+                type.cpuBytes -= slot->cpuBytes;
+                type.gpuBytes -= slot->gpuBytes;
+                --type.resident;
+                ++type.evictions;
+                slot->cpuBytes = slot->gpuBytes = 0;
+                slot->state = ResourceState::Unloaded;
+                slot->evicted = true;
+                victims.push_back(slot->resource.get());
+            }
+            type.overBudget = over();
+        }
+    }
+    for (IResource* resource : victims) resource->unload();
+}
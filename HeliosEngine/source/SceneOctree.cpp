@@ -0,0 +1,388 @@
+#include "../include/SceneOctree.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const unsigned int kAllPlanes = (1u << Frustum::kPlaneCount) - 1;
+
+    // Objetos que acepta una hoja antes de crear sus hijos
+    const size_t kSplitThreshold = 16;
+
+    // Prueba una caja (centro, semiextensión) contra los planos de mask. Devuelve false si queda
+    // fuera de alguno y quita de mask los planos que la contienen por completo
+    bool classifyBox(const Frustum& frustum, const XMFLOAT3& c, const XMFLOAT3& e, unsigned int& mask) {
+        for (int p = 0; p < Frustum::kPlaneCount; ++p) {
+            if (!(mask & (1u << p))) continue;
+            const XMFLOAT4& plane = frustum.m_planes[p];
+            const float d = plane.x * c.x + plane.y * c.y + plane.z * c.z + plane.w;
+            const float r = std::fabs(plane.x) * e.x + std::fabs(plane.y) * e.y + std::fabs(plane.z) * e.z;
+            if (d + r < 0.0f) return false;
+            if (d - r >= 0.0f) mask &= ~(1u << p);
+        }
+        return true;
+    }
+
+    inline void centerExtent(const XMFLOAT3& mn, const XMFLOAT3& mx, XMFLOAT3& c, XMFLOAT3& e) {
+        c = XMFLOAT3(0.5f * (mn.x + mx.x), 0.5f * (mn.y + mx.y), 0.5f * (mn.z + mx.z));
+        e = XMFLOAT3(0.5f * (mx.x - mn.x), 0.5f * (mx.y - mn.y), 0.5f * (mx.z - mn.z));
+    }
+
+    inline bool boxesOverlap(const XMFLOAT3& aMin, const XMFLOAT3& aMax, const XMFLOAT3& bMin, const XMFLOAT3& bMax) {
+        return aMin.x <= bMax.x && aMax.x >= bMin.x &&
+            aMin.y <= bMax.y && aMax.y >= bMin.y &&
+            aMin.z <= bMax.z && aMax.z >= bMin.z;
+    }
+
+    inline bool sphereOverlapsBox(const XMFLOAT3& c, float r2, const XMFLOAT3& mn, const XMFLOAT3& mx) {
+        const float dx = std::max(std::max(mn.x - c.x, 0.0f), c.x - mx.x);
+        const float dy = std::max(std::max(mn.y - c.y, 0.0f), c.y - mx.y);
+        const float dz = std::max(std::max(mn.z - c.z, 0.0f), c.z - mx.z);
+        return dx * dx + dy * dy + dz * dz <= r2;
+    }
+
+    // Entrada de un rayo en un AABB (slabs); false si no lo cruza en [0, tMax]
+    bool rayBox(const float origin[3], const float invDir[3], const bool parallel[3],
+        const XMFLOAT3& mn, const XMFLOAT3& mx, float tMax, float& tEnter) {
+        const float lo[3] = { mn.x, mn.y, mn.z };
+        const float hi[3] = { mx.x, mx.y, mx.z };
+        float t0 = 0.0f, t1 = tMax;
+        for (int a = 0; a < 3; ++a) {
+            if (parallel[a]) {
+                if (origin[a] < lo[a] || origin[a] > hi[a]) return false;
+                continue;
+            }
+            float tn = (lo[a] - origin[a]) * invDir[a];
+            float tf = (hi[a] - origin[a]) * invDir[a];
+            if (tn > tf) std::swap(tn, tf);
+            t0 = std::max(t0, tn);
+            t1 = std::min(t1, tf);
+            if (t0 > t1) return false;
+        }
+        tEnter = t0;
+        return true;
+    }
+}
+
+SceneOctree::SceneOctree() {
+    init(XMFLOAT3(0, 0, 0), 1024.0f);
+}
+
+void
+SceneOctree::init(const XMFLOAT3& center, float halfSize, unsigned int maxDepth) {
+    m_nodes.assign(1, Node());
+    m_nodes[0].center = center;
+    m_nodes[0].halfSize = std::max(halfSize, 1e-3f);
+    m_maxDepth = maxDepth;
+    m_objects.clear();
+    m_freeObjects.clear();
+    m_liveObjects = 0;
+}
+
+void
+SceneOctree::clear() {
+    const Node root = m_nodes[0];
+    init(root.center, root.halfSize, m_maxDepth);
+}
+
+bool
+SceneOctree::fitsChild(unsigned int node, float extent) const {
+    return m_nodes[node].depth < m_maxDepth && extent <= 0.5f * m_nodes[node].halfSize;
+}
+
+unsigned int
+SceneOctree::childFor(unsigned int node, const XMFLOAT3& center) const {
+    const Node& n = m_nodes[node];
+    return n.firstChild + ((center.x >= n.center.x ? 1u : 0u) | (center.y >= n.center.y ? 2u : 0u) |
+        (center.z >= n.center.z ? 4u : 0u));
+}
+
+void
+SceneOctree::split(unsigned int node) {
+    const unsigned int first = unsigned(m_nodes.size());
+    const XMFLOAT3 parentCenter = m_nodes[node].center;
+    const float half = 0.5f * m_nodes[node].halfSize;
+    const unsigned int depth = m_nodes[node].depth + 1;
+    m_nodes.resize(m_nodes.size() + 8);
+    m_nodes[node].firstChild = first;
+    for (unsigned int k = 0; k < 8; ++k) {
+        Node& child = m_nodes[first + k];
+        child.center = XMFLOAT3(parentCenter.x + ((k & 1) ? half : -half),
+            parentCenter.y + ((k & 2) ? half : -half), parentCenter.z + ((k & 4) ? half : -half));
+        child.halfSize = half;
+        child.parent = node;
+        child.depth = depth;
+    }
+
+    // Baja un nivel los objetos que caben en un hijo
+    const std::vector<unsigned int> objects = m_nodes[node].objects;
+    for (unsigned int object : objects) {
+        XMFLOAT3 c, e;
+        centerExtent(m_objects[object].aabbMin, m_objects[object].aabbMax, c, e);
+        if (!fitsChild(node, std::max(e.x, std::max(e.y, e.z)))) continue;
+        detach(object);
+        attach(object, childFor(node, c));
+    }
+}
+
+unsigned int
+SceneOctree::findNode(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    XMFLOAT3 c, e;
+    centerExtent(aabbMin, aabbMax, c, e);
+    const float extent = std::max(e.x, std::max(e.y, e.z));
+
+    const Node& root = m_nodes[0];
+    if (std::fabs(c.x - root.center.x) > root.halfSize || std::fabs(c.y - root.center.y) > root.halfSize ||
+        std::fabs(c.z - root.center.z) > root.halfSize) {
+        return 0;
+    }
+
+    // Baja por el centro mientras el objeto quepa en la caja holgada del hijo. Los hijos se
+    // crean sólo cuando una hoja llega a kSplitThreshold objetos: así las zonas poco pobladas
+    // no generan cadenas de nodos hasta la profundidad máxima
+    unsigned int node = 0;
+    while (fitsChild(node, extent)) {
+        if (m_nodes[node].firstChild == kInvalid) {
+            if (m_nodes[node].objects.size() < kSplitThreshold) break;
+            split(node);
+        }
+        node = childFor(node, c);
+    }
+    return node;
+}
+
+bool
+SceneOctree::staysInNode(unsigned int object) const {
+    const Object& o = m_objects[object];
+    if (o.node == 0) return false;  // La raíz puede tener objetos fuera: se decide desde arriba
+    XMFLOAT3 c, e;
+    centerExtent(o.aabbMin, o.aabbMax, c, e);
+    const float extent = std::max(e.x, std::max(e.y, e.z));
+    const Node& n = m_nodes[o.node];
+    if (std::fabs(c.x - n.center.x) > n.halfSize || std::fabs(c.y - n.center.y) > n.halfSize ||
+        std::fabs(c.z - n.center.z) > n.halfSize || extent > n.halfSize) {
+        return false;
+    }
+    // Sigue en la celda y en la caja holgada; sólo debe bajar si ya hay hijos que lo acepten
+    return n.firstChild == kInvalid || !fitsChild(o.node, extent);
+}
+
+void
+SceneOctree::attach(unsigned int object, unsigned int node) {
+    Object& o = m_objects[object];
+    o.node = node;
+    o.slot = unsigned(m_nodes[node].objects.size());
+    m_nodes[node].objects.push_back(object);
+    for (unsigned int n = node; n != kInvalid; n = m_nodes[n].parent) ++m_nodes[n].subtreeObjects;
+}
+
+void
+SceneOctree::detach(unsigned int object) {
+    Object& o = m_objects[object];
+    std::vector<unsigned int>& list = m_nodes[o.node].objects;
+    const unsigned int last = list.back();
+    list[o.slot] = last;
+    m_objects[last].slot = o.slot;
+    list.pop_back();
+    for (unsigned int n = o.node; n != kInvalid; n = m_nodes[n].parent) --m_nodes[n].subtreeObjects;
+    o.node = kInvalid;
+}
+
+unsigned int
+SceneOctree::insert(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax, unsigned int userData) {
+    unsigned int object;
+    if (!m_freeObjects.empty()) {
+        object = m_freeObjects.back();
+        m_freeObjects.pop_back();
+    }
+    else {
+        object = unsigned(m_objects.size());
+        m_objects.push_back(Object());
+    }
+    Object& o = m_objects[object];
+    o.aabbMin = aabbMin;
+    o.aabbMax = aabbMax;
+    o.userData = userData;
+    attach(object, findNode(aabbMin, aabbMax));
+    ++m_liveObjects;
+    return object;
+}
+
+void
+SceneOctree::move(unsigned int object, const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    if (object >= m_objects.size() || m_objects[object].node == kInvalid) {
+        ERROR(L"SceneOctree", L"move", L"Handle de objeto inválido");
+        return;
+    }
+    m_objects[object].aabbMin = aabbMin;
+    m_objects[object].aabbMax = aabbMax;
+    if (staysInNode(object)) return;
+    const unsigned int node = findNode(aabbMin, aabbMax);
+    if (node == m_objects[object].node) return;
+    detach(object);
+    attach(object, node);
+}
+
+void
+SceneOctree::remove(unsigned int object) {
+    if (object >= m_objects.size() || m_objects[object].node == kInvalid) {
+        ERROR(L"SceneOctree", L"remove", L"Handle de objeto inválido");
+        return;
+    }
+    detach(object);
+    m_freeObjects.push_back(object);
+    --m_liveObjects;
+}
+
+void
+SceneOctree::getBounds(unsigned int object, XMFLOAT3& outMin, XMFLOAT3& outMax) const {
+    outMin = m_objects[object].aabbMin;
+    outMax = m_objects[object].aabbMax;
+}
+
+void
+SceneOctree::collectSubtree(unsigned int node, std::vector<unsigned int>& out) const {
+    const Node& n = m_nodes[node];
+    out.insert(out.end(), n.objects.begin(), n.objects.end());
+    if (n.firstChild == kInvalid) return;
+    for (unsigned int k = 0; k < 8; ++k) {
+        if (m_nodes[n.firstChild + k].subtreeObjects > 0) collectSubtree(n.firstChild + k, out);
+    }
+}
+
+size_t
+SceneOctree::cullFrustum(const Frustum& frustum, std::vector<unsigned int>& out) const {
+    out.clear();
+    struct Entry { unsigned int node; unsigned int mask; };
+    std::vector<Entry> stack;
+    stack.push_back(Entry{ 0, kAllPlanes });  // La raíz puede tener objetos fuera de su caja
+
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const Node& n = m_nodes[entry.node];
+        if (entry.mask == 0) {
+            collectSubtree(entry.node, out);
+            continue;
+        }
+
+        for (unsigned int object : n.objects) {
+            const Object& o = m_objects[object];
+            XMFLOAT3 c, e;
+            centerExtent(o.aabbMin, o.aabbMax, c, e);
+            unsigned int mask = entry.mask;
+            if (classifyBox(frustum, c, e, mask)) out.push_back(object);
+        }
+        if (n.firstChild == kInvalid) continue;
+        for (unsigned int k = 0; k < 8; ++k) {
+            const Node& child = m_nodes[n.firstChild + k];
+            if (child.subtreeObjects == 0) continue;
+            const float loose = 2.0f * child.halfSize;
+            unsigned int mask = entry.mask;
+            if (classifyBox(frustum, child.center, XMFLOAT3(loose, loose, loose), mask)) {
+                stack.push_back(Entry{ n.firstChild + k, mask });
+            }
+        }
+    }
+    return out.size();
+}
+
+size_t
+SceneOctree::querySphere(const XMFLOAT3& center, float radius, std::vector<unsigned int>& out) const {
+    out.clear();
+    const float r2 = radius * radius;
+    std::vector<unsigned int> stack(1, 0u);
+    while (!stack.empty()) {
+        const Node& n = m_nodes[stack.back()];
+        stack.pop_back();
+        for (unsigned int object : n.objects) {
+            if (sphereOverlapsBox(center, r2, m_objects[object].aabbMin, m_objects[object].aabbMax)) out.push_back(object);
+        }
+        if (n.firstChild == kInvalid) continue;
+        for (unsigned int k = 0; k < 8; ++k) {
+            const Node& child = m_nodes[n.firstChild + k];
+            if (child.subtreeObjects == 0) continue;
+            const float loose = 2.0f * child.halfSize;
+            const XMFLOAT3 mn(child.center.x - loose, child.center.y - loose, child.center.z - loose);
+            const XMFLOAT3 mx(child.center.x + loose, child.center.y + loose, child.center.z + loose);
+            if (sphereOverlapsBox(center, r2, mn, mx)) stack.push_back(n.firstChild + k);
+        }
+    }
+    return out.size();
+}
+
+size_t
+SceneOctree::queryBox(const XMFLOAT3& boxMin, const XMFLOAT3& boxMax, std::vector<unsigned int>& out) const {
+    out.clear();
+    std::vector<unsigned int> stack(1, 0u);
+    while (!stack.empty()) {
+        const Node& n = m_nodes[stack.back()];
+        stack.pop_back();
+        for (unsigned int object : n.objects) {
+            if (boxesOverlap(boxMin, boxMax, m_objects[object].aabbMin, m_objects[object].aabbMax)) out.push_back(object);
+        }
+        if (n.firstChild == kInvalid) continue;
+        for (unsigned int k = 0; k < 8; ++k) {
+            const Node& child = m_nodes[n.firstChild + k];
+            if (child.subtreeObjects == 0) continue;
+            const float loose = 2.0f * child.halfSize;
+            const XMFLOAT3 mn(child.center.x - loose, child.center.y - loose, child.center.z - loose);
+            const XMFLOAT3 mx(child.center.x + loose, child.center.y + loose, child.center.z + loose);
+            if (boxesOverlap(boxMin, boxMax, mn, mx)) stack.push_back(n.firstChild + k);
+        }
+    }
+    return out.size();
+}
+
+size_t
+SceneOctree::queryRay(const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance,
+    std::vector<RayCandidate>& out) const {
+    out.clear();
+    const float o[3] = { origin.x, origin.y, origin.z };
+    const float d[3] = { direction.x, direction.y, direction.z };
+    float invDir[3];
+    bool parallel[3];
+    for (int a = 0; a < 3; ++a) {
+        parallel[a] = std::fabs(d[a]) < 1e-20f;
+        invDir[a] = parallel[a] ? 0.0f : 1.0f / d[a];
+    }
+
+    std::vector<unsigned int> stack(1, 0u);
+    while (!stack.empty()) {
+        const Node& n = m_nodes[stack.back()];
+        stack.pop_back();
+        for (unsigned int object : n.objects) {
+            RayCandidate candidate;
+            if (rayBox(o, invDir, parallel, m_objects[object].aabbMin, m_objects[object].aabbMax,
+                maxDistance, candidate.tEnter)) {
+                candidate.object = object;
+                out.push_back(candidate);
+            }
+        }
+        if (n.firstChild == kInvalid) continue;
+        for (unsigned int k = 0; k < 8; ++k) {
+            const Node& child = m_nodes[n.firstChild + k];
+            if (child.subtreeObjects == 0) continue;
+            const float loose = 2.0f * child.halfSize;
+            const XMFLOAT3 mn(child.center.x - loose, child.center.y - loose, child.center.z - loose);
+            const XMFLOAT3 mx(child.center.x + loose, child.center.y + loose, child.center.z + loose);
+            float tEnter;
+            if (rayBox(o, invDir, parallel, mn, mx, maxDistance, tEnter)) stack.push_back(n.firstChild + k);
+        }
+    }
+    std::sort(out.begin(), out.end(),
+        [](const RayCandidate& a, const RayCandidate& b) { return a.tEnter < b.tEnter; });
+    return out.size();
+}
+
+OctreeStats
+SceneOctree::getStats() const {
+    OctreeStats stats;
+    stats.nodes = m_nodes.size();
+    stats.objects = m_liveObjects;
+    stats.rootObjects = m_nodes[0].objects.size();
+    for (const Node& n : m_nodes) {
+        if (!n.objects.empty()) stats.maxDepth = std::max(stats.maxDepth, n.depth);
+    }
+    return stats;
+}
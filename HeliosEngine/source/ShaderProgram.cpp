@@ -251,16 +251,16 @@ void ShaderProgram::render(DeviceContext& deviceContext)
 {
     if (!m_VertexShader || !m_PixelShader || !m_inputLayout.m_inputLayout) return;
     m_inputLayout.render(deviceContext);
-    deviceContext.m_deviceContext->VSSetShader(m_VertexShader, nullptr, 0);
-    deviceContext.m_deviceContext->PSSetShader(m_PixelShader, nullptr, 0);
+    deviceContext.VSSetShader(m_VertexShader, nullptr, 0);
+    deviceContext.PSSetShader(m_PixelShader, nullptr, 0);
 }
 
 void ShaderProgram::render(DeviceContext& deviceContext, ShaderType type)
 {
     if (!deviceContext.m_deviceContext) return;
     switch (type) {
-    case VERTEX_SHADER: deviceContext.m_deviceContext->VSSetShader(m_VertexShader, nullptr, 0); break;
-    case PIXEL_SHADER:  deviceContext.m_deviceContext->PSSetShader(m_PixelShader, nullptr, 0);  break;
+    case VERTEX_SHADER: deviceContext.VSSetShader(m_VertexShader, nullptr, 0); break;
+    case PIXEL_SHADER:  deviceContext.PSSetShader(m_PixelShader, nullptr, 0);  break;
     default: break;
     }
 }
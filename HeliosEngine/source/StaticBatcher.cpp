@@ -0,0 +1,250 @@
+#include "../include/StaticBatcher.h"
+#include <algorithm>
+
+namespace
+{
+    // Un subset de una instancia, antes de ordenarlo por material
+    struct ObjectRef {
+        unsigned int instance;
+        unsigned int startIndex;
+        unsigned int indexCount;
+        unsigned int materialId;
+    };
+
+    bool sameMaterial(const MeshMaterial& a, const MeshMaterial& b) {
+        return a.name == b.name && a.diffuseMap == b.diffuseMap &&
+            a.diffuse.x == b.diffuse.x && a.diffuse.y == b.diffuse.y && a.diffuse.z == b.diffuse.z;
+    }
+
+    unsigned int findOrAddMaterial(std::vector<MeshMaterial>& materials, const MeshMaterial& material) {
+        for (size_t m = 0; m < materials.size(); ++m) {
+            if (sameMaterial(materials[m], material)) return unsigned(m);
+        }
+        materials.push_back(material);
+        return unsigned(materials.size() - 1);
+    }
+
+    XMFLOAT3 transformNormal(const XMFLOAT3& n, const XMMATRIX& m) {
+        XMFLOAT3 out;
+        XMStoreFloat3(&out, XMVector3Normalize(XMVector3TransformNormal(XMLoadFloat3(&n), m)));
+        return out;
+    }
+
+    // Coste sin batching: cada malla enlaza su VB/IB y cada subset su material y un DrawIndexed
+    DrawStats unbatchedCost(size_t objects, size_t instances) {
+        DrawStats stats;
+        stats.drawCalls = objects;
+        stats.bufferBinds = instances * 2;
+        stats.materialBinds = objects;
+        return stats;
+    }
+}
+
+bool
+StaticBatcher::Build(const std::vector<StaticMeshInstance>& instances, StaticBatchData& out) {
+    out = StaticBatchData();
+    MeshComponent& batched = out.mesh;
+    batched.m_name = "StaticBatch";
+
+    // 1) Objetos (instancia, subset) con su material deduplicado entre mallas
+    std::vector<ObjectRef> objects;
+    size_t maxVertices = 0;
+    size_t usedInstances = 0;
+    bool hasTangents = true;
+    for (size_t i = 0; i < instances.size(); ++i) {
+        const MeshComponent* mesh = instances[i].mesh;
+        if (!mesh || mesh->m_vertex.empty() || mesh->m_index.size() < 3) continue;
+        maxVertices = std::max(maxVertices, mesh->m_vertex.size());
+        hasTangents = hasTangents && mesh->m_tangents.size() == mesh->m_vertex.size();
+
+        const size_t before = objects.size();
+        auto addObject = [&](unsigned int startIndex, unsigned int indexCount, unsigned int materialId) {
+            indexCount -= indexCount % 3;
+            if (indexCount == 0 || size_t(startIndex) + indexCount > mesh->m_index.size()) return;
+            const MeshMaterial material = materialId < mesh->m_materials.size() ?
+                mesh->m_materials[materialId] : MeshMaterial();
+            objects.push_back(ObjectRef{ unsigned(i), startIndex, indexCount,
+                findOrAddMaterial(batched.m_materials, material) });
+        };
+        if (mesh->m_subsets.empty()) {
+            addObject(0, unsigned(mesh->m_index.size()), 0);
+        }
+        for (const MeshSubset& subset : mesh->m_subsets) {
+            addObject(subset.startIndex, subset.indexCount, subset.materialId);
+        }
+        if (objects.size() > before) ++usedInstances;
+    }
+    if (objects.empty()) {
+        ERROR(L"StaticBatcher", L"Build", L"No hay triángulos que agrupar");
+        return false;
+    }
+
+    // 2) Objetos contiguos por material; dentro de un material se conserva el orden de entrada
+    std::stable_sort(objects.begin(), objects.end(),
+        [](const ObjectRef& a, const ObjectRef& b) { return a.materialId < b.materialId; });
+
+    // 3) Copia y transformación de los vértices que usa cada objeto. copyOf se reutiliza entre
+    //    objetos: una entrada vale sólo si su sello coincide con el del objeto actual
+    const unsigned int kNone = ~0u;
+    std::vector<unsigned int> copyOf(maxVertices, kNone);
+    std::vector<unsigned int> stamp(maxVertices, kNone);
+    std::vector<unsigned int> used;
+    unsigned int windowBase = 0;
+    size_t windows = 0;
+
+    for (size_t o = 0; o < objects.size(); ++o) {
+        const ObjectRef& object = objects[o];
+        const MeshComponent& mesh = *instances[object.instance].mesh;
+
+        if (out.batches.empty() || out.batches.back().materialId != object.materialId) {
+            StaticBatch batch;
+            batch.materialId = object.materialId;
+            batch.firstObject = unsigned(o);
+            out.batches.push_back(batch);
+            windowBase = unsigned(batched.m_vertex.size());
+            ++windows;
+        }
+
+        // Vértices del objeto en orden de primer uso
+        used.clear();
+        const unsigned int* src = mesh.m_index.data() + object.startIndex;
+        for (unsigned int k = 0; k < object.indexCount; ++k) {
+            const unsigned int v = src[k];
+            if (stamp[v] == unsigned(o)) continue;
+            stamp[v] = unsigned(o);
+            copyOf[v] = unsigned(used.size());
+            used.push_back(v);
+        }
+
+        // Ventana nueva si el objeto no cabe en la actual con índices de 16 bits
+        const size_t firstVertex = batched.m_vertex.size();
+        if (firstVertex > windowBase && firstVertex - windowBase + used.size() > MeshComponent::kMaxVertices16) {
+            windowBase = unsigned(firstVertex);
+            ++windows;
+        }
+
+        const XMMATRIX world = XMLoadFloat4x4(&instances[object.instance].world);
+        XMVECTOR det = XMMatrixDeterminant(world);
+        const bool mirrored = XMVectorGetX(det) < 0.0f;
+        const XMMATRIX normalMatrix = XMMatrixTranspose(XMMatrixInverse(&det, world));
+        for (unsigned int v : used) {
+            SimpleVertex vertex = mesh.m_vertex[v];
+            XMStoreFloat3(&vertex.Pos, XMVector3TransformCoord(XMLoadFloat3(&vertex.Pos), world));
+            vertex.Normal = transformNormal(vertex.Normal, normalMatrix);
+            batched.m_vertex.push_back(vertex);
+            if (hasTangents) {
+                const XMFLOAT4& t = mesh.m_tangents[v];
+                const XMFLOAT3 tangent = transformNormal(XMFLOAT3(t.x, t.y, t.z), world);
+                batched.m_tangents.push_back(XMFLOAT4(tangent.x, tangent.y, tangent.z, mirrored ? -t.w : t.w));
+            }
+        }
+
+        // Índices absolutos; un World que refleja invierte el orden de los triángulos
+        MeshSubset subset;
+        subset.startIndex = unsigned(batched.m_index.size());
+        subset.indexCount = object.indexCount;
+        subset.materialId = object.materialId;
+        subset.baseVertex = windowBase;
+        for (unsigned int k = 0; k < object.indexCount; k += 3) {
+            const unsigned int a = unsigned(firstVertex) + copyOf[src[k]];
+            const unsigned int b = unsigned(firstVertex) + copyOf[src[k + 1]];
+            const unsigned int c = unsigned(firstVertex) + copyOf[src[k + 2]];
+            batched.m_index.push_back(a);
+            batched.m_index.push_back(mirrored ? c : b);
+            batched.m_index.push_back(mirrored ? b : c);
+        }
+
+        // Cotas en mundo sobre los vértices propios (contiguos)
+        PointStream points;
+        points.positions = &batched.m_vertex[firstVertex].Pos;
+        points.stride = sizeof(SimpleVertex);
+        points.count = used.size();
+        BoundingVolumes::ComputeAll(points, subset.aabbMin, subset.aabbMax, subset.sphere, subset.obb);
+
+        StaticBatch& batch = out.batches.back();
+        if (batch.objectCount == 0) {
+            batch.aabbMin = subset.aabbMin;
+            batch.aabbMax = subset.aabbMax;
+        }
+        else {
+            XMStoreFloat3(&batch.aabbMin, XMVectorMin(XMLoadFloat3(&batch.aabbMin), XMLoadFloat3(&subset.aabbMin)));
+            XMStoreFloat3(&batch.aabbMax, XMVectorMax(XMLoadFloat3(&batch.aabbMax), XMLoadFloat3(&subset.aabbMax)));
+        }
+        ++batch.objectCount;
+
+        batched.m_subsets.push_back(subset);
+        out.objectInstance.push_back(object.instance);
+    }
+
+    batched.m_numVertex = static_cast<int>(batched.m_vertex.size());
+    batched.m_numIndex = static_cast<int>(batched.m_index.size());
+    PointStream all;
+    all.positions = &batched.m_vertex[0].Pos;
+    all.stride = sizeof(SimpleVertex);
+    all.count = batched.m_vertex.size();
+    BoundingVolumes::ComputeAll(all, batched.m_aabbMin, batched.m_aabbMax, batched.m_sphere, batched.m_obb);
+
+    out.before = unbatchedCost(objects.size(), usedInstances);
+    out.after.drawCalls = windows;
+    out.after.bufferBinds = 2;
+    out.after.materialBinds = out.batches.size();
+    return true;
+}
+
+size_t
+StaticBatcher::Cull(const StaticBatchData& data, const Frustum& frustum, std::vector<MeshSubset>& outDraws,
+    DrawStats* outBefore, DrawStats* outAfter) {
+    outDraws.clear();
+    const std::vector<MeshSubset>& objects = data.mesh.m_subsets;
+    size_t visible = 0;
+    size_t visibleBatches = 0;
+
+    // Instancias con algún objeto visible (para el coste sin batching)
+    std::vector<unsigned char> instanceVisible;
+    if (outBefore) {
+        unsigned int maxInstance = 0;
+        for (unsigned int instance : data.objectInstance) maxInstance = std::max(maxInstance, instance);
+        instanceVisible.assign(data.objectInstance.empty() ? 0 : maxInstance + 1, 0);
+    }
+
+    for (const StaticBatch& batch : data.batches) {
+        if (!frustum.intersectsAABB(batch.aabbMin, batch.aabbMax)) continue;
+
+        const size_t drawsBefore = outDraws.size();
+        bool extend = false;  // El último rango termina justo antes de este objeto
+        for (unsigned int o = batch.firstObject; o < batch.firstObject + batch.objectCount; ++o) {
+            const MeshSubset& object = objects[o];
+            if (!frustum.intersectsSphere(object.sphere.center, object.sphere.radius) ||
+                !frustum.intersectsAABB(object.aabbMin, object.aabbMax)) {
+                extend = false;
+                continue;
+            }
+            ++visible;
+            if (outBefore) instanceVisible[data.objectInstance[o]] = 1;
+
+            if (extend && outDraws.back().baseVertex == object.baseVertex) {
+                outDraws.back().indexCount += object.indexCount;
+                continue;
+            }
+            MeshSubset draw;
+            draw.startIndex = object.startIndex;
+            draw.indexCount = object.indexCount;
+            draw.materialId = batch.materialId;
+            draw.baseVertex = object.baseVertex;
+            outDraws.push_back(draw);
+            extend = true;
+        }
+        if (outDraws.size() > drawsBefore) ++visibleBatches;
+    }
+
+    if (outBefore) {
+        const size_t instances = size_t(std::count(instanceVisible.begin(), instanceVisible.end(), 1));
+        *outBefore = unbatchedCost(visible, instances);
+    }
+    if (outAfter) {
+        outAfter->drawCalls = outDraws.size();
+        outAfter->bufferBinds = outDraws.empty() ? 0 : 2;
+        outAfter->materialBinds = visibleBatches;
+    }
+    return visible;
+}
@@ -0,0 +1,65 @@
+#include "../include/VertexIndexTable.h"
+
+namespace
+{
+    inline size_t nextPowerOfTwo(size_t n) {
+        size_t p = 16;
+        while (p < n) p <<= 1;
+        return p;
+    }
+}
+
+void
+VertexIndexTable::reserve(size_t maxKeys) {
+    const size_t wanted = nextPowerOfTwo(maxKeys * 2);
+    if (wanted > m_slots.size()) {
+        rehash(wanted);
+    }
+}
+
+unsigned int
+VertexIndexTable::findOrInsert(int v, int vt, int vn, int group, unsigned int newValue, bool& inserted) {
+    // Mantiene el factor de carga <= 0.5 aunque no se haya llamado a reserve()
+    if ((m_count + 1) * 2 > m_slots.size()) {
+        rehash(nextPowerOfTwo((m_count + 1) * 2));
+    }
+
+    size_t i = hash(v, vt, vn, group) & m_mask;
+    for (;;) {
+        Slot& s = m_slots[i];
+        if (s.v == 0) {
+            s.v = v; s.vt = vt; s.vn = vn; s.group = group; s.value = newValue;
+            ++m_count;
+            inserted = true;
+            return newValue;
+        }
+        if (s.v == v && s.vt == vt && s.vn == vn && s.group == group) {
+            inserted = false;
+            return s.value;
+        }
+        i = (i + 1) & m_mask;
+    }
+}
+
+void
+VertexIndexTable::clear() {
+    for (Slot& s : m_slots) s.v = 0;
+    m_count = 0;
+}
+
+void
+VertexIndexTable::rehash(size_t newCapacity) {
+    std::vector<Slot> old;
+    old.swap(m_slots);
+
+    Slot empty = { 0, 0, 0, 0, 0 };
+    m_slots.assign(newCapacity, empty);
+    m_mask = newCapacity - 1;
+
+    for (const Slot& s : old) {
+        if (s.v == 0) continue;
+        size_t i = hash(s.v, s.vt, s.vn, s.group) & m_mask;
+        while (m_slots[i].v != 0) i = (i + 1) & m_mask;
+        m_slots[i] = s;
+    }
+}
@@ -0,0 +1,300 @@
+#include "../include/VertexQuantizer.h"
+#include <emmintrin.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static_assert(sizeof(SimpleVertex) == 8 * sizeof(float), "SimpleVertex debe ser Pos(3) Tex(2) Normal(3) contiguos");
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex debe ocupar 16 bytes");
+
+namespace
+{
+    inline __m128i select(__m128i mask, __m128i a, __m128i b) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    inline __m128 absolute(__m128 v) {
+        return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+    }
+
+    // float -> half con redondeo al par más cercano (denormales, Inf y NaN incluidos).
+    // Devuelve los 16 bits en la parte baja de cada carril de 32
+    inline __m128i floatToHalf(__m128 f) {
+        __m128i u = _mm_castps_si128(f);
+        const __m128i sign = _mm_and_si128(u, _mm_set1_epi32(int(0x80000000u)));
+        u = _mm_xor_si128(u, sign);
+
+        const __m128i isNaN = _mm_cmpgt_epi32(u, _mm_set1_epi32(255 << 23));
+        const __m128i isOverflow = _mm_cmpgt_epi32(u, _mm_set1_epi32(((127 + 16) << 23) - 1));
+        const __m128i isDenormal = _mm_cmplt_epi32(u, _mm_set1_epi32(113 << 23));
+
+        // Denormal: la suma con el "número mágico" deja la mantisa ya redondeada
+        const __m128i denormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+        const __m128i denormal = _mm_sub_epi32(
+            _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u), _mm_castsi128_ps(denormMagic))), denormMagic);
+
+        // Normal: rebias del exponente (-112 << 23) y redondeo RNE con el bit impar de la mantisa
+        const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+        __m128i normal = _mm_add_epi32(u, _mm_set1_epi32(int(0xC8000FFFu)));
+        normal = _mm_srli_epi32(_mm_add_epi32(normal, mantissaOdd), 13);
+
+        __m128i h = select(isDenormal, denormal, normal);
+        h = select(isOverflow, _mm_set1_epi32(0x7c00), h);
+        h = select(isNaN, _mm_set1_epi32(0x7e00), h);
+        return _mm_or_si128(h, _mm_srli_epi32(sign, 16));
+    }
+
+    // half (16 bits bajos de cada carril) -> float
+    inline __m128 halfToFloat(__m128i h) {
+        const __m128i shiftedExp = _mm_set1_epi32(0x7c00 << 13);
+        __m128i o = _mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x7fff)), 13);
+        const __m128i exponent = _mm_and_si128(o, shiftedExp);
+        o = _mm_add_epi32(o, _mm_set1_epi32((127 - 15) << 23));
+
+        // Inf/NaN: exponente extra; denormal: renormaliza restando 2^-14
+        const __m128i isInfNaN = _mm_cmpeq_epi32(exponent, shiftedExp);
+        o = _mm_add_epi32(o, _mm_and_si128(isInfNaN, _mm_set1_epi32((128 - 16) << 23)));
+        const __m128i isDenormal = _mm_cmpeq_epi32(exponent, _mm_setzero_si128());
+        const __m128 denormal = _mm_sub_ps(
+            _mm_castsi128_ps(_mm_add_epi32(o, _mm_set1_epi32(1 << 23))),
+            _mm_castsi128_ps(_mm_set1_epi32(113 << 23)));
+
+        const __m128 f = select(_mm_castsi128_ps(isDenormal), denormal, _mm_castsi128_ps(o));
+        return _mm_or_ps(f, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(0x8000)), 16)));
+    }
+
+    // Codifica exactamente 4 vértices
+    inline void encode4(const SimpleVertex* src, const QuantizationParams& params, PackedVertex* dst) {
+        const float* f = reinterpret_cast<const float*>(src);
+        // Fila a: px py pz tu | fila b: tv nx ny nz
+        __m128 a0 = _mm_loadu_ps(f + 0), b0 = _mm_loadu_ps(f + 4);
+        __m128 a1 = _mm_loadu_ps(f + 8), b1 = _mm_loadu_ps(f + 12);
+        __m128 a2 = _mm_loadu_ps(f + 16), b2 = _mm_loadu_ps(f + 20);
+        __m128 a3 = _mm_loadu_ps(f + 24), b3 = _mm_loadu_ps(f + 28);
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);   // PX PY PZ TU
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);   // TV NX NY NZ
+
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        // Posición -> UNORM16
+        const __m128 k65535 = _mm_set1_ps(65535.0f);
+        const __m128 px = _mm_mul_ps(_mm_sub_ps(a0, _mm_set1_ps(params.offset.x)), _mm_set1_ps(1.0f / params.scale.x));
+        const __m128 py = _mm_mul_ps(_mm_sub_ps(a1, _mm_set1_ps(params.offset.y)), _mm_set1_ps(1.0f / params.scale.y));
+        const __m128 pz = _mm_mul_ps(_mm_sub_ps(a2, _mm_set1_ps(params.offset.z)), _mm_set1_ps(1.0f / params.scale.z));
+        const __m128i qx = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(px, zero), one), k65535));
+        const __m128i qy = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(py, zero), one), k65535));
+        const __m128i qz = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(pz, zero), one), k65535));
+
+        // Normal -> octaedro: proyección L1 y pliegue del hemisferio z < 0
+        const __m128 l1 = _mm_add_ps(_mm_add_ps(absolute(b1), absolute(b2)), absolute(b3));
+        const __m128 invL1 = _mm_and_ps(_mm_cmpgt_ps(l1, zero), _mm_div_ps(one, l1));
+        const __m128 ox = _mm_mul_ps(b1, invL1);
+        const __m128 oy = _mm_mul_ps(b2, invL1);
+        const __m128 oz = _mm_mul_ps(b3, invL1);
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000u)));
+        const __m128 foldX = _mm_or_ps(_mm_sub_ps(one, absolute(oy)), _mm_and_ps(ox, signMask));
+        const __m128 foldY = _mm_or_ps(_mm_sub_ps(one, absolute(ox)), _mm_and_ps(oy, signMask));
+        const __m128 lower = _mm_cmplt_ps(oz, zero);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        const __m128 k32767 = _mm_set1_ps(32767.0f);
+        const __m128i nx = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(select(lower, foldX, ox), minusOne), one), k32767));
+        const __m128i ny = _mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(select(lower, foldY, oy), minusOne), one), k32767));
+
+        // UV -> half
+        const __m128i tu = floatToHalf(a3);
+        const __m128i tv = floatToHalf(b0);
+
+        // Cuatro palabras de 32 bits por vértice y transposición a AoS
+        const __m128i low16 = _mm_set1_epi32(0xffff);
+        __m128 w0 = _mm_castsi128_ps(_mm_or_si128(qx, _mm_slli_epi32(qy, 16)));
+        __m128 w1 = _mm_castsi128_ps(qz);
+        __m128 w2 = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(nx, low16), _mm_slli_epi32(ny, 16)));
+        __m128 w3 = _mm_castsi128_ps(_mm_or_si128(tu, _mm_slli_epi32(tv, 16)));
+        _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_castps_si128(w0));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 1), _mm_castps_si128(w1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2), _mm_castps_si128(w2));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3), _mm_castps_si128(w3));
+    }
+
+    // Decodifica exactamente 4 vértices
+    inline void decode4(const PackedVertex* src, const QuantizationParams& params, SimpleVertex* dst) {
+        __m128 w0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0)));
+        __m128 w1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 1)));
+        __m128 w2 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2)));
+        __m128 w3 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3)));
+        _MM_TRANSPOSE4_PS(w0, w1, w2, w3);
+
+        const __m128i low16 = _mm_set1_epi32(0xffff);
+        const __m128i i0 = _mm_castps_si128(w0), i1 = _mm_castps_si128(w1);
+        const __m128i i2 = _mm_castps_si128(w2), i3 = _mm_castps_si128(w3);
+
+        // Posición
+        const float inv = 1.0f / 65535.0f;
+        __m128 a0 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(i0, low16)), _mm_set1_ps(params.scale.x * inv)), _mm_set1_ps(params.offset.x));
+        __m128 a1 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(i0, 16)), _mm_set1_ps(params.scale.y * inv)), _mm_set1_ps(params.offset.y));
+        __m128 a2 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(i1, low16)), _mm_set1_ps(params.scale.z * inv)), _mm_set1_ps(params.offset.z));
+
+        // Normal: desplegado del octaedro y renormalización
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 minusOne = _mm_set1_ps(-1.0f);
+        const __m128 k = _mm_set1_ps(1.0f / 32767.0f);
+        __m128 nx = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_slli_epi32(i2, 16), 16)), k), minusOne);
+        __m128 ny = _mm_max_ps(_mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(i2, 16)), k), minusOne);
+        __m128 nz = _mm_sub_ps(_mm_sub_ps(one, absolute(nx)), absolute(ny));
+        const __m128 t = _mm_max_ps(_mm_sub_ps(_mm_setzero_ps(), nz), _mm_setzero_ps());
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(int(0x80000000u)));
+        nx = _mm_sub_ps(nx, _mm_or_ps(t, _mm_and_ps(nx, signMask)));
+        ny = _mm_sub_ps(ny, _mm_or_ps(t, _mm_and_ps(ny, signMask)));
+        const __m128 invLen = _mm_div_ps(one,
+            _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz))));
+        __m128 b1 = _mm_mul_ps(nx, invLen);
+        __m128 b2 = _mm_mul_ps(ny, invLen);
+        __m128 b3 = _mm_mul_ps(nz, invLen);
+
+        // UV
+        __m128 a3 = halfToFloat(_mm_and_si128(i3, low16));
+        __m128 b0 = halfToFloat(_mm_srli_epi32(i3, 16));
+
+        _MM_TRANSPOSE4_PS(a0, a1, a2, a3);
+        _MM_TRANSPOSE4_PS(b0, b1, b2, b3);
+        float* f = reinterpret_cast<float*>(dst);
+        _mm_storeu_ps(f + 0, a0);  _mm_storeu_ps(f + 4, b0);
+        _mm_storeu_ps(f + 8, a1);  _mm_storeu_ps(f + 12, b1);
+        _mm_storeu_ps(f + 16, a2); _mm_storeu_ps(f + 20, b2);
+        _mm_storeu_ps(f + 24, a3); _mm_storeu_ps(f + 28, b3);
+    }
+
+    inline float distance(const XMFLOAT3& a, const XMFLOAT3& b) {
+        const float dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+        return std::sqrt(dx * dx + dy * dy + dz * dz);
+    }
+}
+
+QuantizationParams
+VertexQuantizer::ComputeParams(const XMFLOAT3& aabbMin, const XMFLOAT3& aabbMax) {
+    QuantizationParams params;
+    params.offset = aabbMin;
+    params.scale.x = (aabbMax.x > aabbMin.x) ? aabbMax.x - aabbMin.x : 1.0f;
+    params.scale.y = (aabbMax.y > aabbMin.y) ? aabbMax.y - aabbMin.y : 1.0f;
+    params.scale.z = (aabbMax.z > aabbMin.z) ? aabbMax.z - aabbMin.z : 1.0f;
+    return params;
+}
+
+void
+VertexQuantizer::Encode(const SimpleVertex* src, size_t count, const QuantizationParams& params, PackedVertex* dst) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        encode4(src + i, params, dst + i);
+    }
+    // Cola: se completa un bloque de 4 en la pila
+    if (i < count) {
+        SimpleVertex in[4];
+        PackedVertex out[4];
+        memset(static_cast<void*>(in), 0, sizeof(in));
+        std::copy(src + i, src + count, in);
+        encode4(in, params, out);
+        std::copy(out, out + (count - i), dst + i);
+    }
+}
+
+void
+VertexQuantizer::Decode(const PackedVertex* src, size_t count, const QuantizationParams& params, SimpleVertex* dst) {
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        decode4(src + i, params, dst + i);
+    }
+    if (i < count) {
+        PackedVertex in[4];
+        SimpleVertex out[4];
+        memset(in, 0, sizeof(in));
+        std::copy(src + i, src + count, in);
+        decode4(in, params, out);
+        std::copy(out, out + (count - i), dst + i);
+    }
+}
+
+QuantizationError
+VertexQuantizer::MeasureError(const SimpleVertex* original, const PackedVertex* packed, size_t count,
+    const QuantizationParams& params) {
+    QuantizationError error;
+    error.vertexCount = count;
+    error.bytesBefore = count * sizeof(SimpleVertex);
+    error.bytesAfter = count * sizeof(PackedVertex);
+
+    // Por bloques para no duplicar la malla completa en memoria
+    const size_t kBlock = 1024;
+    SimpleVertex decoded[kBlock];
+    double sumSquared = 0.0;
+    float minCos = 1.0f;
+
+    for (size_t base = 0; base < count; base += kBlock) {
+        const size_t n = std::min(kBlock, count - base);
+        Decode(packed + base, n, params, decoded);
+
+        for (size_t i = 0; i < n; ++i) {
+            const SimpleVertex& a = original[base + i];
+            const SimpleVertex& b = decoded[i];
+
+            const float d = distance(a.Pos, b.Pos);
+            error.maxPositionError = std::max(error.maxPositionError, d);
+            sumSquared += double(d) * double(d);
+
+            error.maxTexCoordError = std::max(error.maxTexCoordError,
+                std::max(std::fabs(a.Tex.x - b.Tex.x), std::fabs(a.Tex.y - b.Tex.y)));
+
+            const float len = std::sqrt(a.Normal.x * a.Normal.x + a.Normal.y * a.Normal.y + a.Normal.z * a.Normal.z);
+            if (len > 1e-6f) {
+                const float c = (a.Normal.x * b.Normal.x + a.Normal.y * b.Normal.y + a.Normal.z * b.Normal.z) / len;
+                minCos = std::min(minCos, c);
+            }
+        }
+    }
+
+    error.rmsPositionError = count ? float(std::sqrt(sumSquared / double(count))) : 0.0f;
+    error.maxNormalErrorDeg = std::acos(std::max(-1.0f, std::min(1.0f, minCos))) * (180.0f / XM_PI);
+    return error;
+}
+
+QuantizationError
+VertexQuantizer::PackMesh(const MeshComponent& mesh, std::vector<PackedVertex>& outPacked,
+    QuantizationParams& outParams) {
+    outParams = ComputeParams(mesh.m_aabbMin, mesh.m_aabbMax);
+    outPacked.resize(mesh.m_vertex.size());
+    Encode(mesh.m_vertex.data(), mesh.m_vertex.size(), outParams, outPacked.data());
+    return MeasureError(mesh.m_vertex.data(), outPacked.data(), mesh.m_vertex.size(), outParams);
+}
+
+XMMATRIX
+VertexQuantizer::GetDequantizeMatrix(const QuantizationParams& params) {
+    return XMMatrixScaling(params.scale.x, params.scale.y, params.scale.z) *
+        XMMatrixTranslation(params.offset.x, params.offset.y, params.offset.z);
+}
+
+std::vector<D3D11_INPUT_ELEMENT_DESC>
+VertexQuantizer::GetInputLayout() {
+    std::vector<D3D11_INPUT_ELEMENT_DESC> layout;
+
+    D3D11_INPUT_ELEMENT_DESC p{};
+    p.SemanticName = "POSITION"; p.Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+    p.InputSlot = 0; p.AlignedByteOffset = 0; p.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+    layout.push_back(p);
+
+    D3D11_INPUT_ELEMENT_DESC n{};
+    n.SemanticName = "NORMAL"; n.Format = DXGI_FORMAT_R16G16_SNORM;
+    n.InputSlot = 0; n.AlignedByteOffset = 8; n.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+    layout.push_back(n);
+
+    D3D11_INPUT_ELEMENT_DESC t{};
+    t.SemanticName = "TEXCOORD"; t.Format = DXGI_FORMAT_R16G16_FLOAT;
+    t.InputSlot = 0; t.AlignedByteOffset = 12; t.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+    layout.push_back(t);
+
+    return layout;
+}
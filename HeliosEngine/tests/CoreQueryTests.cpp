@@ -0,0 +1,268 @@
+/**
+ * @file CoreQueryTests.cpp
+ * @brief Pruebas y tiempos de las consultas de escena (BVH, octree, frustum, picking) sin D3D.
+ *
+ * Compara cada consulta acelerada con su versión de fuerza bruta sobre datos aleatorios con
+ * semilla fija. Devuelve 0 si todo coincide; imprime los tiempos de construcción y consulta.
+ */
+#include "../include/MeshBVH.h"
+#include "../include/SceneOctree.h"
+#include "../include/Picker.h"
+#include "../include/JobSystem.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+    unsigned int g_failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (condition) return;
+        ++g_failures;
+        std::printf("  FALLO: %s\n", what);
+    }
+
+    class ScopedTimer {
+    public:
+        ScopedTimer() : m_start(std::chrono::steady_clock::now()) {}
+        double seconds() const {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+        }
+    private:
+        std::chrono::steady_clock::time_point m_start;
+    };
+
+    // Triángulos pequeños repartidos en un cubo de lado 2 * extent
+    void randomSoup(std::mt19937& rng, size_t triangles, float extent,
+        std::vector<SimpleVertex>& vertices, std::vector<unsigned int>& indices) {
+        std::uniform_real_distribution<float> pos(-extent, extent);
+        std::uniform_real_distribution<float> jitter(-0.5f, 0.5f);
+        vertices.clear();
+        indices.clear();
+        for (size_t t = 0; t < triangles; ++t) {
+            const XMFLOAT3 c(pos(rng), pos(rng), pos(rng));
+            for (int k = 0; k < 3; ++k) {
+                SimpleVertex v = {};
+                v.Pos = XMFLOAT3(c.x + jitter(rng), c.y + jitter(rng), c.z + jitter(rng));
+                indices.push_back(unsigned(vertices.size()));
+                vertices.push_back(v);
+            }
+        }
+    }
+
+    // Möller-Trumbore sin aceleración; t en unidades de dir
+    bool bruteRaycast(const std::vector<SimpleVertex>& vertices, const std::vector<unsigned int>& indices,
+        const XMFLOAT3& o, const XMFLOAT3& d, float tMax, float& outT) {
+        bool hit = false;
+        outT = tMax;
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            const XMFLOAT3& a = vertices[indices[i]].Pos;
+            const XMFLOAT3& b = vertices[indices[i + 1]].Pos;
+            const XMFLOAT3& c = vertices[indices[i + 2]].Pos;
+            const XMFLOAT3 e1(b.x - a.x, b.y - a.y, b.z - a.z), e2(c.x - a.x, c.y - a.y, c.z - a.z);
+            const XMFLOAT3 p(d.y * e2.z - d.z * e2.y, d.z * e2.x - d.x * e2.z, d.x * e2.y - d.y * e2.x);
+            const float det = e1.x * p.x + e1.y * p.y + e1.z * p.z;
+            if (det == 0.0f) continue;
+            const float inv = 1.0f / det;
+            const XMFLOAT3 s(o.x - a.x, o.y - a.y, o.z - a.z);
+            const float u = (s.x * p.x + s.y * p.y + s.z * p.z) * inv;
+            if (u < 0.0f || u > 1.0f) continue;
+            const XMFLOAT3 q(s.y * e1.z - s.z * e1.y, s.z * e1.x - s.x * e1.z, s.x * e1.y - s.y * e1.x);
+            const float v = (d.x * q.x + d.y * q.y + d.z * q.z) * inv;
+            if (v < 0.0f || u + v > 1.0f) continue;
+            const float t = (e2.x * q.x + e2.y * q.y + e2.z * q.z) * inv;
+            if (t < 0.0f || t > outT) continue;
+            outT = t;
+            hit = true;
+        }
+        return hit;
+    }
+
+    bool overlaps(const XMFLOAT3& aMin, const XMFLOAT3& aMax, const XMFLOAT3& bMin, const XMFLOAT3& bMax) {
+        return aMin.x <= bMax.x && aMax.x >= bMin.x && aMin.y <= bMax.y && aMax.y >= bMin.y &&
+            aMin.z <= bMax.z && aMax.z >= bMin.z;
+    }
+
+    void testBVH() {
+        std::printf("MeshBVH\n");
+        std::mt19937 rng(7);
+        std::vector<SimpleVertex> vertices;
+        std::vector<unsigned int> indices;
+        randomSoup(rng, 50000, 40.0f, vertices, indices);
+
+        MeshBVH serial, parallel;
+        ScopedTimer buildTimer;
+        check(serial.build(vertices.data(), vertices.size(), indices.data(), indices.size(), 1), "build serial");
+        const double serialSeconds = buildTimer.seconds();
+        check(parallel.build(vertices.data(), vertices.size(), indices.data(), indices.size(), 0), "build paralelo");
+        check(serial.getStats().nodes == parallel.getStats().nodes, "mismo árbol en serie y en paralelo");
+
+        std::uniform_real_distribution<float> pos(-50.0f, 50.0f);
+        const int kRays = 500;
+        unsigned int mismatches = 0, hits = 0;
+        double bvhSeconds = 0.0;
+        for (int r = 0; r < kRays; ++r) {
+            const XMFLOAT3 o(pos(rng), pos(rng), pos(rng));
+            const XMFLOAT3 d(-o.x + pos(rng) * 0.2f, -o.y + pos(rng) * 0.2f, -o.z + pos(rng) * 0.2f);
+            float bruteT = 0.0f;
+            const bool bruteHit = bruteRaycast(vertices, indices, o, d, FLT_MAX, bruteT);
+            RayHit hit;
+            ScopedTimer rayTimer;
+            const bool bvhHit = parallel.raycast(o, d, hit);
+            bvhSeconds += rayTimer.seconds();
+            if (bvhHit != bruteHit || (bvhHit && std::fabs(hit.t - bruteT) > 1e-5f * std::max(1.0f, bruteT))) {
+                ++mismatches;
+            }
+            if (bvhHit) {
+                ++hits;
+                // Un segmento que llega un poco más allá del impacto queda ocluido
+                const XMFLOAT3 end(o.x + d.x * hit.t, o.y + d.y * hit.t, o.z + d.z * hit.t);
+                check(parallel.segmentOccluded(o, XMFLOAT3(o.x + (end.x - o.x) * 1.001f,
+                    o.y + (end.y - o.y) * 1.001f, o.z + (end.z - o.z) * 1.001f)), "segmento ocluido");
+            }
+        }
+        check(mismatches == 0, "raycast igual a fuerza bruta");
+        check(hits > 0, "algún rayo impacta");
+        std::printf("  %zu triángulos, %zu nodos, profundidad %u: build %.1f ms, %d rayos %.2f us/rayo (%u impactos)\n",
+            serial.getStats().triangles, serial.getStats().nodes, serial.getStats().maxDepth,
+            serialSeconds * 1e3, kRays, bvhSeconds * 1e6 / kRays, hits);
+    }
+
+    void testOctree() {
+        std::printf("SceneOctree\n");
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> pos(-900.0f, 900.0f);
+        std::uniform_real_distribution<float> size(0.5f, 30.0f);
+
+        SceneOctree octree;
+        std::vector<XMFLOAT3> mins, maxs;
+        for (int i = 0; i < 20000; ++i) {
+            const XMFLOAT3 c(pos(rng), pos(rng), pos(rng));
+            const float h = size(rng);
+            mins.push_back(XMFLOAT3(c.x - h, c.y - h, c.z - h));
+            maxs.push_back(XMFLOAT3(c.x + h, c.y + h, c.z + h));
+            octree.insert(mins.back(), maxs.back(), unsigned(i));
+        }
+        // Mover la mitad: los que cambian de nodo deben seguir encontrándose
+        for (size_t i = 0; i < mins.size(); i += 2) {
+            const float dx = pos(rng) * 0.05f;
+            mins[i].x += dx;
+            maxs[i].x += dx;
+            octree.move(unsigned(i), mins[i], maxs[i]);
+        }
+
+        unsigned int mismatches = 0;
+        std::vector<unsigned int> found;
+        ScopedTimer timer;
+        for (int q = 0; q < 200; ++q) {
+            const XMFLOAT3 c(pos(rng), pos(rng), pos(rng));
+            const float h = size(rng) * 4.0f;
+            const XMFLOAT3 qMin(c.x - h, c.y - h, c.z - h), qMax(c.x + h, c.y + h, c.z + h);
+            octree.queryBox(qMin, qMax, found);
+            std::vector<unsigned int> expected;
+            for (size_t i = 0; i < mins.size(); ++i) {
+                if (overlaps(mins[i], maxs[i], qMin, qMax)) expected.push_back(unsigned(i));
+            }
+            std::vector<unsigned int> got;
+            for (unsigned int object : found) got.push_back(octree.getUserData(object));
+            std::sort(got.begin(), got.end());
+            if (got != expected) ++mismatches;
+        }
+        check(mismatches == 0, "queryBox igual a fuerza bruta");
+        const double boxSeconds = timer.seconds();
+
+        // Frustum desde el origen hacia +z: el octree no puede perder ni inventar objetos
+        Frustum frustum;
+        frustum.init(XMMatrixPerspectiveFovLH(XM_PIDIV4, 16.0f / 9.0f, 1.0f, 800.0f));
+        ScopedTimer cullTimer;
+        octree.cullFrustum(frustum, found);
+        const double cullSeconds = cullTimer.seconds();
+        std::vector<unsigned int> visible, expectedVisible;
+        for (unsigned int object : found) visible.push_back(octree.getUserData(object));
+        std::sort(visible.begin(), visible.end());
+        for (size_t i = 0; i < mins.size(); ++i) {
+            if (frustum.intersectsAABB(mins[i], maxs[i])) expectedVisible.push_back(unsigned(i));
+        }
+        check(visible == expectedVisible, "cullFrustum igual a fuerza bruta");
+
+        std::printf("  %zu objetos, %zu nodos: 200 consultas de caja en %.2f ms, frustum %.3f ms (%zu visibles)\n",
+            octree.size(), octree.getStats().nodes, boxSeconds * 1e3, cullSeconds * 1e3, visible.size());
+    }
+
+    void testPicker() {
+        std::printf("Picker\n");
+        std::mt19937 rng(3);
+        std::vector<SimpleVertex> vertices;
+        std::vector<unsigned int> indices;
+        randomSoup(rng, 4000, 5.0f, vertices, indices);
+        MeshBVH bvh;
+        check(bvh.build(vertices.data(), vertices.size(), indices.data(), indices.size(), 1), "build");
+
+        // Rejilla de instancias trasladadas de la misma malla
+        Picker picker;
+        std::vector<XMFLOAT3> offsets;
+        for (int x = -3; x <= 3; ++x) {
+            for (int y = -3; y <= 3; ++y) {
+                offsets.push_back(XMFLOAT3(x * 12.0f, y * 12.0f, 40.0f + (x + y) * 2.0f));
+                picker.addMesh(&bvh, XMMatrixTranslation(offsets.back().x, offsets.back().y, offsets.back().z));
+            }
+        }
+
+        // Cámara en el origen mirando a +z: el rayo del centro de la pantalla va hacia +z
+        // (ScreenRay toma el centro del píxel, así que el centro exacto es 399.5)
+        const XMMATRIX view = XMMatrixIdentity();
+        const XMMATRIX projection = XMMatrixPerspectiveFovLH(XM_PIDIV4, 1.0f, 0.1f, 1000.0f);
+        XMFLOAT3 origin, direction;
+        Picker::ScreenRay(399.5f, 399.5f, 800.0f, 800.0f, view, projection, origin, direction);
+        check(std::fabs(direction.x) < 1e-4f && std::fabs(direction.y) < 1e-4f && direction.z > 0.999f,
+            "rayo del centro de pantalla hacia +z");
+
+        // Pick por píxel = pick del rayo en mundo que devuelve ScreenRay
+        PickResult screenResult, rayResult;
+        const bool screenPicked = picker.pick(399.5f, 399.5f, 800.0f, 800.0f, view, projection, screenResult);
+        const bool rayPicked = picker.pick(origin, direction, rayResult);
+        check(screenPicked == rayPicked && screenResult.mesh == rayResult.mesh &&
+            screenResult.triangle == rayResult.triangle, "pick por píxel igual al del rayo");
+
+        // Rayos en mundo contra la fuerza bruta por instancia (sólo traslación: t no cambia)
+        unsigned int mismatches = 0, hits = 0;
+        std::uniform_real_distribution<float> spread(-0.6f, 0.6f);
+        for (int r = 0; r < 300; ++r) {
+            const XMFLOAT3 o(0.0f, 0.0f, 0.0f);
+            const float dx = spread(rng), dy = spread(rng);
+            const float len = std::sqrt(dx * dx + dy * dy + 1.0f);
+            const XMFLOAT3 d(dx / len, dy / len, 1.0f / len);
+            PickResult result;
+            const bool picked = picker.pick(o, d, result);
+
+            float bestT = FLT_MAX;
+            bool bruteHit = false;
+            for (const XMFLOAT3& off : offsets) {
+                float t = 0.0f;
+                if (bruteRaycast(vertices, indices, XMFLOAT3(o.x - off.x, o.y - off.y, o.z - off.z), d, bestT, t)) {
+                    bestT = t;
+                    bruteHit = true;
+                }
+            }
+            if (picked != bruteHit || (picked && std::fabs(result.distance - bestT) > 1e-3f)) ++mismatches;
+            if (picked) ++hits;
+        }
+        check(mismatches == 0, "pick igual a fuerza bruta");
+        check(hits > 0, "algún pick impacta");
+        std::printf("  %zu instancias, %u de 300 rayos impactan\n", picker.getMeshCount(), hits);
+    }
+}
+
+int main() {
+    JobSystem::Default();
+    testBVH();
+    testOctree();
+    testPicker();
+    JobSystem::Default().shutdown();
+
+    std::printf(g_failures ? "%u fallos\n" : "OK\n", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,250 @@
+/**
+ * @file ResourceManagerTests.cpp
+ * @brief Pruebas del @c ResourceManager con recursos falsos (sin disco ni D3D).
+ *
+ * Los recursos cuentan sus llamadas a load, init y unload; una ruta que contiene "bad" falla
+ * al cargar. Devuelve 0 si todo se comporta como documenta ResourceManager.h.
+ */
+#include "../include/ResourceManager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace
+{
+    unsigned int g_failures = 0;
+
+    void check(bool condition, const char* what) {
+        if (condition) return;
+        ++g_failures;
+        std::printf("  FALLO: %s\n", what);
+    }
+
+    struct FakeCounters {
+        std::atomic<int> created{ 0 };
+        std::atomic<int> loads{ 0 };
+        std::atomic<int> inits{ 0 };
+        std::atomic<int> unloads{ 0 };
+    };
+
+    class FakeResource : public IResource {
+    public:
+        FakeResource(const std::string& path, FakeCounters& counters, size_t bytes)
+            : IResource(path, ResourceType::Texture), m_counters(counters), m_bytes(bytes) {
+            ++m_counters.created;
+        }
+
+        bool load(const std::string& filename) override {
+            ++m_counters.loads;
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            m_loaded = filename.find("bad") == std::string::npos;
+            return m_loaded;
+        }
+
+        bool init() override {
+            ++m_counters.inits;
+            return m_loaded;
+        }
+
+        void unload() override {
+            ++m_counters.unloads;
+            m_loaded = false;
+        }
+
+        size_t getSizeInBytes() const override { return m_loaded ? m_bytes : 0; }
+
+    private:
+        FakeCounters& m_counters;
+        size_t        m_bytes;
+        bool          m_loaded = false;
+    };
+
+    ResourceManager::Factory fakeFactory(FakeCounters& counters, size_t bytes = 100) {
+        return [&counters, bytes](const std::string& path) {
+            return std::unique_ptr<IResource>(new FakeResource(path, counters, bytes));
+        };
+    }
+
+    // Termina todo lo pendiente como lo haría el bucle de frames
+    void drain(ResourceManager& manager) {
+        for (;;) {
+            const ResourceManagerStats stats = manager.getStats();
+            if (stats.pending == 0 && stats.awaitingInit == 0) break;
+            manager.update(5.0);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        manager.update(5.0);
+    }
+
+    void testLoadDedupCallbacksWait() {
+        std::printf("Carga, deduplicación, callbacks y wait\n");
+        FakeCounters counters;
+        ResourceManager manager;
+        manager.init(2);
+        const ResourceManager::Factory factory = fakeFactory(counters);
+
+        int readyA = 0, readyOther = 0;
+        ResourceState stateA = ResourceState::Unloaded;
+        const ResourceHandle a = manager.load("Assets/Moto/Repsol.obj", factory,
+            [&](ResourceHandle, ResourceState state) { ++readyA; stateA = state; });
+        const ResourceHandle sameA = manager.load("assets\\moto\\REPSOL.OBJ", factory,
+            [&](ResourceHandle, ResourceState) { ++readyOther; });
+        check(a.valid() && a == sameA, "la misma ruta (mayúsculas y separadores) da el mismo handle");
+        check(manager.find("ASSETS/moto/repsol.obj") == a, "find normaliza la ruta");
+        check(counters.created == 1, "la fábrica se llama una vez por ruta");
+
+        check(manager.wait(a) == ResourceState::Loaded, "wait devuelve Loaded");
+        check(manager.get(a) != nullptr && manager.get<FakeResource>(a) != nullptr, "get tras wait");
+        check(readyA == 1 && readyOther == 1 && stateA == ResourceState::Loaded,
+            "wait cumple los callbacks de todos los que pidieron la ruta, una vez");
+        check(manager.getFuture(a).get() == ResourceState::Loaded, "el future queda cumplido");
+
+        // Pedir una ruta ya cargada no carga de nuevo; el callback llega en el próximo update
+        int late = 0;
+        check(manager.load("Assets/Moto/Repsol.obj", factory,
+            [&](ResourceHandle handle, ResourceState state) { late += handle == a && state == ResourceState::Loaded; }) == a,
+            "load de una ruta cargada devuelve su handle");
+        check(late == 0, "el callback tardío no se llama dentro de load");
+        manager.update();
+        check(late == 1, "el callback tardío se llama en update");
+
+        int failedCallbacks = 0;
+        const ResourceHandle bad = manager.load("Assets/bad.obj", factory,
+            [&](ResourceHandle, ResourceState state) { failedCallbacks += state == ResourceState::Failed; });
+        check(manager.wait(bad) == ResourceState::Failed && failedCallbacks == 1, "una carga fallida avisa con Failed");
+        check(manager.get(bad) == nullptr, "get de un recurso fallido es nullptr");
+
+        // Muchas rutas a la vez: update las termina a todas sin wait
+        std::vector<ResourceHandle> many;
+        int manyReady = 0;
+        for (int i = 0; i < 16; ++i) {
+            many.push_back(manager.load("Assets/tex" + std::to_string(i) + ".png", factory,
+                [&](ResourceHandle, ResourceState state) { manyReady += state == ResourceState::Loaded; }));
+        }
+        drain(manager);
+        bool allLoaded = manyReady == 16;
+        for (ResourceHandle handle : many) allLoaded = allLoaded && manager.getState(handle) == ResourceState::Loaded;
+        check(allLoaded, "update termina todas las cargas y llama a sus callbacks");
+
+        const ResourceManagerStats stats = manager.getStats();
+        check(stats.requests == 20 && stats.deduplicated == 2, "requests y deduplicated");
+        check(stats.loaded == 17 && stats.failed == 1, "loaded y failed");
+        check(counters.loads == 18 && counters.created == 18, "una carga por ruta distinta");
+
+        // release: el handle deja de resolver aunque su índice se reutilice
+        manager.release(many[0]);
+        check(manager.get(many[0]) == nullptr && manager.getState(many[0]) == ResourceState::Unloaded,
+            "un handle liberado no resuelve");
+        const ResourceHandle again = manager.load("Assets/tex0.png", factory);
+        check(again.valid() && again != many[0], "la ruta liberada se vuelve a registrar con otro handle");
+        check(manager.wait(again) == ResourceState::Loaded && manager.get(many[0]) == nullptr,
+            "el handle viejo sigue sin resolver");
+
+        manager.shutdown();
+        check(counters.unloads == 19, "release y shutdown descargan cada recurso registrado una vez");
+    }
+
+    void testBudgetEviction() {
+        std::printf("Presupuesto de memoria: orden de desalojo y recarga\n");
+        FakeCounters counters;
+        ResourceManager manager;
+        manager.init(1);
+        const ResourceManager::Factory factory = fakeFactory(counters, 100);
+
+        // Frame 1: cinco texturas de 100 bytes, sin presupuesto todavía
+        std::vector<ResourceHandle> t;
+        for (int i = 0; i < 5; ++i) {
+            t.push_back(manager.load("tex" + std::to_string(i), factory));
+            manager.wait(t.back());
+        }
+        const ResourceTypeMemory& textures = manager.getMemoryReport()[ResourceType::Texture];
+
+        // Último uso: t3 y t4 en el frame 1, t0 en el 2, t1 en el 3 y t2 en el 4; t4 queda fijada
+        manager.update();
+        manager.touch(t[0]);
+        manager.update();
+        manager.get(t[1]);
+        manager.update();
+        manager.touch(t[2]);
+        manager.pin(t[4]);
+        check(textures.resident == 5 && textures.cpuBytes == 500 && textures.evictions == 0,
+            "sin presupuesto no se desaloja nada");
+
+        // Frame 5: con 350 bytes sobran 150; se van los dos menos usados que se pueden desalojar
+        manager.setBudget(ResourceType::Texture, 350, 0);
+        manager.update();
+        check(manager.getState(t[3]) == ResourceState::Unloaded && manager.getState(t[0]) == ResourceState::Unloaded,
+            "se desalojan primero los de uso más antiguo (t3 y luego t0)");
+        check(manager.getState(t[1]) == ResourceState::Loaded && manager.getState(t[2]) == ResourceState::Loaded &&
+            manager.getState(t[4]) == ResourceState::Loaded, "quedan los usados después y el fijado");
+        check(textures.resident == 3 && textures.cpuBytes == 300 && textures.evictions == 2 && !textures.overBudget,
+            "el informe refleja el desalojo");
+        check(counters.unloads == 2, "cada desalojo llama a unload");
+
+        // Recarga: get de un desalojado lo vuelve a encolar con el mismo handle; load por ruta también
+        check(manager.get(t[0]) == nullptr && manager.getState(t[0]) == ResourceState::Loading,
+            "get de un recurso desalojado lo vuelve a cargar");
+        check(manager.wait(t[0]) == ResourceState::Loaded && manager.get<FakeResource>(t[0]) != nullptr,
+            "tras wait el recurso desalojado vuelve a estar disponible");
+        check(manager.load("tex3", factory) == t[3] && manager.wait(t[3]) == ResourceState::Loaded,
+            "load de una ruta desalojada conserva el handle y recarga");
+        check(counters.loads == 7 && counters.created == 5, "recargar no crea instancias nuevas");
+
+        // Frame 6: lo recargado se usó en este frame y t4 está fijada; sólo pueden irse t1 y t2
+        manager.setBudget(ResourceType::Texture, 50, 0);
+        manager.update();
+        check(manager.getState(t[1]) == ResourceState::Unloaded && manager.getState(t[2]) == ResourceState::Unloaded,
+            "con el presupuesto mínimo se desaloja todo lo desalojable");
+        check(manager.getState(t[0]) == ResourceState::Loaded && manager.getState(t[3]) == ResourceState::Loaded &&
+            manager.getState(t[4]) == ResourceState::Loaded, "no se desaloja lo usado en el frame ni lo fijado");
+        check(textures.resident == 3 && textures.overBudget, "sigue excedido si lo que queda está en uso");
+
+        manager.unpin(t[4]);
+        manager.update();
+        manager.update();
+        check(textures.cpuBytes <= 50 && !textures.overBudget && manager.getState(t[4]) == ResourceState::Unloaded,
+            "sin usos ni pin se vuelve al presupuesto");
+        manager.shutdown();
+    }
+
+    void testRestart() {
+        std::printf("shutdown + init con el mismo manager\n");
+        FakeCounters counters;
+        ResourceManager manager;
+        const ResourceManager::Factory factory = fakeFactory(counters);
+
+        manager.init(1);
+        std::vector<ResourceHandle> before;
+        for (int i = 0; i < 3; ++i) before.push_back(manager.load("first" + std::to_string(i), factory));
+        manager.release(before[1]);  // Deja un índice en la lista libre de la tabla de handles
+        manager.wait(before[0]);
+        manager.shutdown();
+        check(counters.unloads == 3, "shutdown descarga lo que quedaba registrado");
+
+        // Los índices que devuelva la tabla tras reiniciar deben tener slot
+        manager.init(1);
+        std::vector<ResourceHandle> after;
+        for (int i = 0; i < 5; ++i) after.push_back(manager.load("second" + std::to_string(i), factory));
+        bool allLoaded = true;
+        for (ResourceHandle handle : after) {
+            allLoaded = allLoaded && manager.wait(handle) == ResourceState::Loaded && manager.get(handle) != nullptr;
+        }
+        check(allLoaded, "tras reiniciar se carga normalmente");
+        bool staleBefore = true;
+        for (ResourceHandle handle : before) staleBefore = staleBefore && manager.get(handle) == nullptr;
+        check(staleBefore, "los handles de antes del reinicio no resuelven");
+        check(!manager.find("first0").valid() && manager.find("second4") == after[4], "las rutas de antes se olvidan");
+        check(manager.getStats().requests == 5, "init reinicia los contadores");
+        manager.shutdown();
+        check(counters.unloads == 8, "el segundo shutdown descarga lo nuevo");
+    }
+}
+
+int main() {
+    testLoadDedupCallbacksWait();
+    testBudgetEviction();
+    testRestart();
+
+    std::printf(g_failures ? "%u fallos\n" : "OK\n", g_failures);
+    return g_failures ? 1 : 0;
+}